@@ -2,6 +2,7 @@
 #include <random>
 #include <algorithm>
 #include <mathematics/aabb.h>
+#include <mathematics/aabb_tree.h>
 #include <random_fill.h>
 
 const unsigned long fromRange = 2;
@@ -51,4 +52,188 @@ static void BM_Aabb2CheckContains(benchmark::State& state)
 
 BENCHMARK(BM_Aabb2CheckContains)->Range(fromRange, toRange);
 
+static void BM_Aabb3CheckIntersectOneToMany(benchmark::State& state)
+{
+    const size_t n = state.range(0);
+    std::vector<neko::Aabb3d> v(n);
+    for (auto& aabb : v) {
+        aabb.FromCenterExtends(neko::Vec3f(RandomFloat(), RandomFloat(), RandomFloat()), neko::Vec3f(RandomFloat(), RandomFloat(), RandomFloat()));
+    }
+    neko::Aabb3d other;
+    other.FromCenterExtends(neko::Vec3f(RandomFloat(), RandomFloat(), RandomFloat()), neko::Vec3f(RandomFloat(), RandomFloat(), RandomFloat()));
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < n; i++)
+        {
+            benchmark::DoNotOptimize(v[i].IntersectAabb(other));
+        }
+    }
+}
+
+BENCHMARK(BM_Aabb3CheckIntersectOneToMany)->Range(fromRange, toRange);
+
+static void BM_AabbSoA3CheckIntersect(benchmark::State& state)
+{
+    const size_t n = state.range(0);
+    neko::AabbSoA3d soa;
+    soa.Reserve(n);
+    for (size_t i = 0; i < n; i++) {
+        neko::Aabb3d aabb;
+        aabb.FromCenterExtends(neko::Vec3f(RandomFloat(), RandomFloat(), RandomFloat()), neko::Vec3f(RandomFloat(), RandomFloat(), RandomFloat()));
+        soa.PushBack(aabb);
+    }
+    neko::Aabb3d other;
+    other.FromCenterExtends(neko::Vec3f(RandomFloat(), RandomFloat(), RandomFloat()), neko::Vec3f(RandomFloat(), RandomFloat(), RandomFloat()));
+    neko::AabbBitmask result;
+    for (auto _ : state)
+    {
+        soa.IntersectAabb(other, result);
+        benchmark::DoNotOptimize(result.data());
+    }
+}
+
+BENCHMARK(BM_AabbSoA3CheckIntersect)->Range(fromRange, toRange);
+
+static void BM_Aabb3CheckRay(benchmark::State& state)
+{
+    const size_t n = state.range(0);
+    std::vector<neko::Aabb3d> v(n);
+    for (auto& aabb : v) {
+        aabb.FromCenterExtends(neko::Vec3f(RandomFloat(), RandomFloat(), RandomFloat()), neko::Vec3f(RandomFloat(), RandomFloat(), RandomFloat()));
+    }
+    const neko::Vec3f origin(RandomFloat(), RandomFloat(), RandomFloat());
+    const neko::Vec3f dirRay(1.0f, 0.5f, 0.25f);
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < n; i++)
+        {
+            benchmark::DoNotOptimize(v[i].IntersectRay(dirRay, origin));
+        }
+    }
+}
+
+BENCHMARK(BM_Aabb3CheckRay)->Range(fromRange, toRange);
+
+static void BM_AabbSoA3CheckRay(benchmark::State& state)
+{
+    const size_t n = state.range(0);
+    neko::AabbSoA3d soa;
+    soa.Reserve(n);
+    for (size_t i = 0; i < n; i++) {
+        neko::Aabb3d aabb;
+        aabb.FromCenterExtends(neko::Vec3f(RandomFloat(), RandomFloat(), RandomFloat()), neko::Vec3f(RandomFloat(), RandomFloat(), RandomFloat()));
+        soa.PushBack(aabb);
+    }
+    const neko::Vec3f origin(RandomFloat(), RandomFloat(), RandomFloat());
+    const neko::Vec3f dirRay(1.0f, 0.5f, 0.25f);
+    neko::AabbBitmask result;
+    for (auto _ : state)
+    {
+        soa.IntersectRay(dirRay, origin, result);
+        benchmark::DoNotOptimize(result.data());
+    }
+}
+
+BENCHMARK(BM_AabbSoA3CheckRay)->Range(fromRange, toRange);
+
+static void BM_AabbSoA3CheckFrustum(benchmark::State& state)
+{
+    const size_t n = state.range(0);
+    neko::AabbSoA3d soa;
+    soa.Reserve(n);
+    for (size_t i = 0; i < n; i++) {
+        neko::Aabb3d aabb;
+        aabb.FromCenterExtends(neko::Vec3f(RandomFloat(), RandomFloat(), RandomFloat()), neko::Vec3f(RandomFloat(), RandomFloat(), RandomFloat()));
+        soa.PushBack(aabb);
+    }
+    std::array<neko::Vec4f, 6> planes;
+    for (auto& plane : planes)
+    {
+        const neko::Vec3f normal = neko::Vec3f(RandomFloat(), RandomFloat(), RandomFloat()).Normalized();
+        plane = neko::Vec4f(normal, RandomFloat());
+    }
+    neko::AabbBitmask result;
+    for (auto _ : state)
+    {
+        soa.IntersectFrustum(planes.data(), planes.size(), result);
+        benchmark::DoNotOptimize(result.data());
+    }
+}
+
+BENCHMARK(BM_AabbSoA3CheckFrustum)->Range(fromRange, toRange);
+
+static void BM_AabbTree3QueryAabb(benchmark::State& state)
+{
+    const size_t n = state.range(0);
+    neko::AabbTree3d tree;
+    for (size_t i = 0; i < n; i++) {
+        neko::Aabb3d aabb;
+        aabb.FromCenterExtends(neko::Vec3f(RandomFloat(), RandomFloat(), RandomFloat()) * 100.0f, neko::Vec3f(RandomFloat(), RandomFloat(), RandomFloat()));
+        tree.CreateProxy(aabb, static_cast<neko::Index>(i));
+    }
+    neko::Aabb3d queryAabb;
+    queryAabb.FromCenterExtends(neko::Vec3f(RandomFloat(), RandomFloat(), RandomFloat()) * 100.0f, neko::Vec3f(5.0f, 5.0f, 5.0f));
+    for (auto _ : state)
+    {
+        size_t found = 0;
+        tree.QueryAabb(queryAabb, [&found](neko::AabbProxy)
+        {
+            found++;
+            return true;
+        });
+        benchmark::DoNotOptimize(found);
+    }
+}
+
+BENCHMARK(BM_AabbTree3QueryAabb)->Range(fromRange, toRange);
+
+static void BM_AabbTree3RayCast(benchmark::State& state)
+{
+    const size_t n = state.range(0);
+    neko::AabbTree3d tree;
+    for (size_t i = 0; i < n; i++) {
+        neko::Aabb3d aabb;
+        aabb.FromCenterExtends(neko::Vec3f(RandomFloat(), RandomFloat(), RandomFloat()) * 100.0f, neko::Vec3f(RandomFloat(), RandomFloat(), RandomFloat()));
+        tree.CreateProxy(aabb, static_cast<neko::Index>(i));
+    }
+    const neko::Vec3f origin(RandomFloat(), RandomFloat(), RandomFloat());
+    const neko::Vec3f dirRay = neko::Vec3f(1.0f, 0.5f, 0.25f).Normalized();
+    for (auto _ : state)
+    {
+        size_t found = 0;
+        tree.RayCast(origin, dirRay, 1000.0f, [&found](neko::AabbProxy)
+        {
+            found++;
+            return true;
+        });
+        benchmark::DoNotOptimize(found);
+    }
+}
+
+BENCHMARK(BM_AabbTree3RayCast)->Range(fromRange, toRange);
+
+static void BM_AabbTree3MoveProxy(benchmark::State& state)
+{
+    const size_t n = state.range(0);
+    neko::AabbTree3d tree;
+    std::vector<neko::Aabb3d> aabbs(n);
+    std::vector<neko::AabbProxy> proxies(n);
+    for (size_t i = 0; i < n; i++) {
+        aabbs[i].FromCenterExtends(neko::Vec3f(RandomFloat(), RandomFloat(), RandomFloat()) * 100.0f, neko::Vec3f(RandomFloat(), RandomFloat(), RandomFloat()));
+        proxies[i] = tree.CreateProxy(aabbs[i], static_cast<neko::Index>(i));
+    }
+    const neko::Vec3f displacement(0.5f, 0.0f, -0.5f);
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < n; i++)
+        {
+            aabbs[i].lowerLeftBound += displacement;
+            aabbs[i].upperRightBound += displacement;
+            benchmark::DoNotOptimize(tree.MoveProxy(proxies[i], aabbs[i], displacement));
+        }
+    }
+}
+
+BENCHMARK(BM_AabbTree3MoveProxy)->Range(fromRange, toRange);
+
 BENCHMARK_MAIN();
\ No newline at end of file
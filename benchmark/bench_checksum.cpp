@@ -0,0 +1,82 @@
+#include <benchmark/benchmark.h>
+#include <random>
+#include <vector>
+#include <mathematics/checksum.h>
+#include <random_fill.h>
+
+const unsigned long fromRange = 64;
+const unsigned long toRange = 1 << 20;
+
+static std::vector<std::uint8_t> RandomBytes(size_t n)
+{
+    std::vector<std::uint8_t> bytes(n);
+    for (auto& byte : bytes)
+    {
+        byte = static_cast<std::uint8_t>(RandomFloat());
+    }
+    return bytes;
+}
+
+static void BM_ChecksumAccumulate(benchmark::State& state)
+{
+    const size_t n = state.range(0);
+    const auto bytes = RandomBytes(n);
+    for (auto _ : state)
+    {
+        std::uint8_t checksum = 0;
+        for (auto byte : bytes)
+        {
+            checksum += neko::Checksum<std::uint8_t>(byte);
+        }
+        benchmark::DoNotOptimize(checksum);
+    }
+    state.SetBytesProcessed(state.iterations() * n);
+}
+
+BENCHMARK(BM_ChecksumAccumulate)->Range(fromRange, toRange);
+
+static void BM_Crc32c(benchmark::State& state)
+{
+    const size_t n = state.range(0);
+    const auto bytes = RandomBytes(n);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(neko::Crc32c(bytes.data(), n));
+    }
+    state.SetBytesProcessed(state.iterations() * n);
+}
+
+BENCHMARK(BM_Crc32c)->Range(fromRange, toRange);
+
+static void BM_Hash64(benchmark::State& state)
+{
+    const size_t n = state.range(0);
+    const auto bytes = RandomBytes(n);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(neko::Hash64(bytes.data(), n));
+    }
+    state.SetBytesProcessed(state.iterations() * n);
+}
+
+BENCHMARK(BM_Hash64)->Range(fromRange, toRange);
+
+static void BM_ChunkedChecksumOneDirtyRange(benchmark::State& state)
+{
+    const size_t n = state.range(0);
+    auto bytes = RandomBytes(n);
+    neko::ChunkedChecksum checksum;
+    checksum.Update(bytes.data(), n);
+    size_t offset = 0;
+    for (auto _ : state)
+    {
+        bytes[offset] ^= 1u;
+        checksum.SetDirty(offset, 1);
+        benchmark::DoNotOptimize(checksum.Update(bytes.data(), n));
+        offset = (offset + 4099) % n;
+    }
+}
+
+BENCHMARK(BM_ChunkedChecksumOneDirtyRange)->Range(fromRange, toRange);
+
+BENCHMARK_MAIN();
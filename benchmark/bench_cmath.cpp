@@ -48,7 +48,8 @@ float fabs_cmath(float n)
     return fabs(n);
 }
 
-float sin_table(const neko::FuncTable<float>& funcTable, float x)
+template<typename Table>
+float sin_table(const Table& funcTable, float x)
 {
     return funcTable.GetValue(x);
 }
@@ -126,7 +127,6 @@ BENCHMARK(BM_FabsCmath)->RangeMultiplier(2)->Range(fromRange, toRange);
 static void BM_SinTable(benchmark::State& state)
 {
     neko::FuncTable<float> sinFuncTable(0.0f, M_PI, [](float x){return sinf(x);});
-    sinFuncTable.GenerateTable();
     std::vector<float> local_numbers(state.range(0));
     RandomFill(local_numbers, 0.0f, M_PI);
     for (auto _ : state)
@@ -150,10 +150,98 @@ static void BM_SinCmath(benchmark::State& state)
 }
 BENCHMARK(BM_SinCmath)->RangeMultiplier(2)->Range(fromRange, toRange);
 
+static void BM_SinTableCubic(benchmark::State& state)
+{
+    constexpr neko::FuncTable<float, 512, neko::FuncTableInterpolation::CUBIC> sinFuncTable(0.0f, float(M_PI),
+        [](float x){return static_cast<float>(neko::ConstexprSin(x));});
+    std::vector<float> local_numbers(state.range(0));
+    RandomFill(local_numbers, 0.0f, M_PI);
+    for (auto _ : state)
+    {
+        for(auto v : local_numbers)
+            benchmark::DoNotOptimize(sin_table(sinFuncTable, v));
+    }
+}
+BENCHMARK(BM_SinTableCubic)->RangeMultiplier(2)->Range(fromRange, toRange);
+
+static void BM_SinTableBatch(benchmark::State& state)
+{
+    std::vector<float> local_numbers(state.range(0));
+    std::vector<float> results(state.range(0));
+    RandomFill(local_numbers, 0.0f, 2.0f * M_PI);
+    for (auto _ : state)
+    {
+        neko::sinTable.GetValues(local_numbers.data(), results.data(), local_numbers.size());
+        benchmark::DoNotOptimize(results.data());
+    }
+}
+BENCHMARK(BM_SinTableBatch)->RangeMultiplier(2)->Range(fromRange, toRange);
+
+static void BM_SinLut(benchmark::State& state)
+{
+    std::vector<float> local_numbers(state.range(0));
+    RandomFill(local_numbers);
+    for (auto _ : state)
+    {
+        for(auto v : local_numbers)
+            benchmark::DoNotOptimize(neko::SinLut(neko::radian_t(v)));
+    }
+}
+BENCHMARK(BM_SinLut)->RangeMultiplier(2)->Range(fromRange, toRange);
+
+static void BM_Atan2Lut(benchmark::State& state)
+{
+    std::vector<float> local_numbers(state.range(0) * 2);
+    RandomFill(local_numbers);
+    const size_t n = state.range(0);
+    for (auto _ : state)
+    {
+        for(size_t i = 0; i < n; i++)
+            benchmark::DoNotOptimize(neko::Atan2Lut(local_numbers[i], local_numbers[n + i]));
+    }
+}
+BENCHMARK(BM_Atan2Lut)->RangeMultiplier(2)->Range(fromRange, toRange);
+
+static void BM_Atan2Cmath(benchmark::State& state)
+{
+    std::vector<float> local_numbers(state.range(0) * 2);
+    RandomFill(local_numbers);
+    const size_t n = state.range(0);
+    for (auto _ : state)
+    {
+        for(size_t i = 0; i < n; i++)
+            benchmark::DoNotOptimize(atan2f(local_numbers[i], local_numbers[n + i]));
+    }
+}
+BENCHMARK(BM_Atan2Cmath)->RangeMultiplier(2)->Range(fromRange, toRange);
+
+static void BM_ExpLut(benchmark::State& state)
+{
+    std::vector<float> local_numbers(state.range(0));
+    RandomFill(local_numbers, -80.0f, 80.0f);
+    for (auto _ : state)
+    {
+        for(auto v : local_numbers)
+            benchmark::DoNotOptimize(neko::ExpLut(v));
+    }
+}
+BENCHMARK(BM_ExpLut)->RangeMultiplier(2)->Range(fromRange, toRange);
+
+static void BM_ExpCmath(benchmark::State& state)
+{
+    std::vector<float> local_numbers(state.range(0));
+    RandomFill(local_numbers, -80.0f, 80.0f);
+    for (auto _ : state)
+    {
+        for(auto v : local_numbers)
+            benchmark::DoNotOptimize(expf(v));
+    }
+}
+BENCHMARK(BM_ExpCmath)->RangeMultiplier(2)->Range(fromRange, toRange);
+
 static void BM_LogTable(benchmark::State& state)
 {
     neko::FuncTable<float> sinFuncTable(0.0f, maxNmb, [](float x){return logf(x);});
-    sinFuncTable.GenerateTable();
     std::vector<float> local_numbers(state.range(0));
     RandomFill(local_numbers, 0.0f, maxNmb);
     for (auto _ : state)
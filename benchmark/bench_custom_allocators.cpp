@@ -5,6 +5,8 @@
 #include <random>
 #include <vector>
 #include <iostream>
+#include <array>
+#include <memory>
 #include <benchmark/benchmark.h>
 #include "engine/custom_allocator.h"
 
@@ -102,4 +104,130 @@ static void BM_PoolAllocate(benchmark::State& state)
     free(values);
 }
 
-BENCHMARK(BM_PoolAllocate)->Range(fromRange, toRange);
\ No newline at end of file
+BENCHMARK(BM_PoolAllocate)->Range(fromRange, toRange);
+const long churnFromRange = 64;
+const long churnToRange = 1 << 12;
+
+/**
+ * \brief Mixed-size churn, keeping size live allocations and replacing a random one on each iteration
+ */
+template<typename AllocatorT>
+static void AllocatorChurn(benchmark::State& state)
+{
+    const size_t size = state.range(0);
+    const size_t memorySize = size * 1024 * 2;
+    void* memory = calloc(memorySize, 1);
+    AllocatorT allocator(memorySize, memory);
+    std::mt19937 g(0);
+    std::uniform_int_distribution<size_t> sizeDistribution(8, 1024);
+    std::uniform_int_distribution<size_t> indexDistribution(0, size - 1);
+    std::vector<void*> allocations(size);
+    for (auto& allocation : allocations)
+    {
+        allocation = allocator.Allocate(sizeDistribution(g), alignof(std::max_align_t));
+    }
+    for (auto _ : state)
+    {
+        const size_t index = indexDistribution(g);
+        allocator.Deallocate(allocations[index]);
+        allocations[index] = allocator.Allocate(sizeDistribution(g), alignof(std::max_align_t));
+        benchmark::DoNotOptimize(allocations[index]);
+    }
+    for (auto* allocation : allocations)
+    {
+        allocator.Deallocate(allocation);
+    }
+    free(memory);
+}
+
+static void BM_FreeListChurn(benchmark::State& state)
+{
+    AllocatorChurn<neko::FreeListAllocator>(state);
+}
+
+BENCHMARK(BM_FreeListChurn)->Range(churnFromRange, churnToRange);
+
+static void BM_TlsfChurn(benchmark::State& state)
+{
+    AllocatorChurn<neko::TlsfAllocator>(state);
+}
+
+BENCHMARK(BM_TlsfChurn)->Range(churnFromRange, churnToRange);
+
+static void BM_MallocChurn(benchmark::State& state)
+{
+    const size_t size = state.range(0);
+    std::mt19937 g(0);
+    std::uniform_int_distribution<size_t> sizeDistribution(8, 1024);
+    std::uniform_int_distribution<size_t> indexDistribution(0, size - 1);
+    std::vector<void*> allocations(size);
+    for (auto& allocation : allocations)
+    {
+        allocation = malloc(sizeDistribution(g));
+    }
+    for (auto _ : state)
+    {
+        const size_t index = indexDistribution(g);
+        free(allocations[index]);
+        allocations[index] = malloc(sizeDistribution(g));
+        benchmark::DoNotOptimize(allocations[index]);
+    }
+    for (auto* allocation : allocations)
+    {
+        free(allocation);
+    }
+}
+
+BENCHMARK(BM_MallocChurn)->Range(churnFromRange, churnToRange);
+
+const size_t concurrentBatchSize = 64;
+static std::unique_ptr<neko::ConcurrentPoolAllocator<size_t>> concurrentPoolAllocator;
+static std::vector<size_t> concurrentPoolMemory;
+
+static void BM_ConcurrentPoolAllocate(benchmark::State& state)
+{
+    if (state.thread_index == 0)
+    {
+        concurrentPoolMemory.resize(concurrentBatchSize * state.threads * 2);
+        concurrentPoolAllocator = std::make_unique<neko::ConcurrentPoolAllocator<size_t>>(
+                concurrentPoolMemory.size() * sizeof(size_t), concurrentPoolMemory.data());
+    }
+    std::array<size_t*, concurrentBatchSize> values{};
+    for (auto _ : state)
+    {
+        for (auto& v : values)
+        {
+            v = (size_t*) concurrentPoolAllocator->Allocate(sizeof(size_t), alignof(size_t));
+            benchmark::DoNotOptimize(v);
+        }
+        for (auto* v : values)
+        {
+            concurrentPoolAllocator->Deallocate(v);
+        }
+    }
+    if (state.thread_index == 0)
+    {
+        concurrentPoolAllocator = nullptr;
+    }
+}
+
+BENCHMARK(BM_ConcurrentPoolAllocate)->ThreadRange(1, 8);
+
+static void BM_ConcurrentMalloc(benchmark::State& state)
+{
+    std::array<size_t*, concurrentBatchSize> values{};
+    for (auto _ : state)
+    {
+        for (auto& v : values)
+        {
+            v = (size_t*) malloc(sizeof(size_t));
+            benchmark::DoNotOptimize(v);
+        }
+        for (auto* v : values)
+        {
+            free(v);
+        }
+    }
+}
+
+BENCHMARK(BM_ConcurrentMalloc)->ThreadRange(1, 8);
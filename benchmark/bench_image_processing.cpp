@@ -0,0 +1,86 @@
+#include <benchmark/benchmark.h>
+#include <random>
+#include <vector>
+#include <graphics/image_processing.h>
+#include <random_fill.h>
+
+const long fromRange = 64;
+const long toRange = 2048;
+
+static std::vector<unsigned char> RandomPixels(size_t n)
+{
+    static std::mt19937 g(std::random_device{}());
+    std::uniform_int_distribution<int> dist(0, 255);
+    std::vector<unsigned char> pixels(n);
+    for (auto& pixel : pixels)
+    {
+        pixel = static_cast<unsigned char>(dist(g));
+    }
+    return pixels;
+}
+
+static void BM_DownsampleBox(benchmark::State& state)
+{
+    const int size = state.range(0);
+    const auto src = RandomPixels(size * size * 4);
+    std::vector<unsigned char> dst(size / 2 * size / 2 * 4);
+    for (auto _ : state)
+    {
+        neko::DownsampleImageLevel(src.data(), size, size, dst.data(), 4, false);
+        benchmark::DoNotOptimize(dst.data());
+    }
+    state.SetBytesProcessed(state.iterations() * src.size());
+}
+
+BENCHMARK(BM_DownsampleBox)->Range(fromRange, toRange);
+
+static void BM_DownsampleBoxSrgb(benchmark::State& state)
+{
+    const int size = state.range(0);
+    const auto src = RandomPixels(size * size * 4);
+    std::vector<unsigned char> dst(size / 2 * size / 2 * 4);
+    for (auto _ : state)
+    {
+        neko::DownsampleImageLevel(src.data(), size, size, dst.data(), 4, false, true);
+        benchmark::DoNotOptimize(dst.data());
+    }
+    state.SetBytesProcessed(state.iterations() * src.size());
+}
+
+BENCHMARK(BM_DownsampleBoxSrgb)->Range(fromRange, toRange);
+
+static void BM_DownsampleKaiser(benchmark::State& state)
+{
+    const int size = state.range(0);
+    const auto src = RandomPixels(size * size * 4);
+    std::vector<unsigned char> dst(size / 2 * size / 2 * 4);
+    for (auto _ : state)
+    {
+        neko::DownsampleImageLevel(src.data(), size, size, dst.data(), 4, false, false, neko::MipFilter::KAISER);
+        benchmark::DoNotOptimize(dst.data());
+    }
+    state.SetBytesProcessed(state.iterations() * src.size());
+}
+
+BENCHMARK(BM_DownsampleKaiser)->Range(fromRange, toRange);
+
+static void BM_FloatToHalf(benchmark::State& state)
+{
+    const size_t n = state.range(0) * state.range(0);
+    std::vector<float> src(n);
+    for (auto& value : src)
+    {
+        value = RandomFloat();
+    }
+    std::vector<std::uint16_t> dst(n);
+    for (auto _ : state)
+    {
+        neko::ConvertFloatToHalf(src.data(), dst.data(), n);
+        benchmark::DoNotOptimize(dst.data());
+    }
+    state.SetBytesProcessed(state.iterations() * n * sizeof(float));
+}
+
+BENCHMARK(BM_FloatToHalf)->Range(fromRange, toRange);
+
+BENCHMARK_MAIN();
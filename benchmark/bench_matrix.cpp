@@ -6,6 +6,7 @@
 #include "random_fill.h"
 #include <benchmark/benchmark.h>
 #include "mathematics/matrix.h"
+#include "mathematics/matrix_batch.h"
 
 const long fromRange = 8;
 const long toRange = 1 << 10;
@@ -133,6 +134,97 @@ static void BM_MatrixMultIntrinsics(benchmark::State& state)
 
 BENCHMARK(BM_MatrixMultIntrinsics)->Range(fromRange, toRange);
 
+template<neko::SimdLevel level>
+static void BM_MatrixMultBatch(benchmark::State& state)
+{
+    if (!neko::SetMat4BatchLevel(level))
+    {
+        state.SkipWithError("Unsupported instruction set");
+        return;
+    }
+    const size_t n = state.range(0);
+    std::vector<neko::Mat4f> v1(n, neko::Mat4f::Identity);
+    std::vector<neko::Mat4f> v2(n, neko::Mat4f::Identity);
+    std::vector<neko::Mat4f> result(n);
+
+    std::for_each(v1.begin(), v1.end(), [](neko::Mat4f& m) { RandomFill(m); });
+    std::for_each(v2.begin(), v2.end(), [](neko::Mat4f& m) { RandomFill(m); });
+    for (auto _ : state)
+    {
+        neko::MultiplyMat4Batch(v1.data(), v2.data(), result.data(), n);
+        benchmark::ClobberMemory();
+    }
+    neko::SetMat4BatchLevel(neko::GetCpuSimdLevel());
+}
+
+BENCHMARK_TEMPLATE(BM_MatrixMultBatch, neko::SimdLevel::SCALAR)->Range(fromRange, toRange);
+BENCHMARK_TEMPLATE(BM_MatrixMultBatch, neko::SimdLevel::SSE4)->Range(fromRange, toRange);
+BENCHMARK_TEMPLATE(BM_MatrixMultBatch, neko::SimdLevel::AVX2)->Range(fromRange, toRange);
+BENCHMARK_TEMPLATE(BM_MatrixMultBatch, neko::SimdLevel::AVX512)->Range(fromRange, toRange);
+BENCHMARK_TEMPLATE(BM_MatrixMultBatch, neko::SimdLevel::NEON)->Range(fromRange, toRange);
+
+template<neko::SimdLevel level>
+static void BM_TransformPointsBatch(benchmark::State& state)
+{
+    if (!neko::SetMat4BatchLevel(level))
+    {
+        state.SkipWithError("Unsupported instruction set");
+        return;
+    }
+    const size_t n = state.range(0);
+    neko::Mat4f transform;
+    RandomFill(transform);
+    std::vector<neko::Vec4f> points(n);
+    std::for_each(points.begin(), points.end(), [](neko::Vec4f& v) { RandomFill(v); });
+    std::vector<neko::Vec4f> result(n);
+    for (auto _ : state)
+    {
+        neko::TransformPointsBatch(transform, points.data(), result.data(), n);
+        benchmark::ClobberMemory();
+    }
+    neko::SetMat4BatchLevel(neko::GetCpuSimdLevel());
+}
+
+BENCHMARK_TEMPLATE(BM_TransformPointsBatch, neko::SimdLevel::SCALAR)->Range(fromRange, toRange);
+BENCHMARK_TEMPLATE(BM_TransformPointsBatch, neko::SimdLevel::SSE4)->Range(fromRange, toRange);
+BENCHMARK_TEMPLATE(BM_TransformPointsBatch, neko::SimdLevel::AVX2)->Range(fromRange, toRange);
+BENCHMARK_TEMPLATE(BM_TransformPointsBatch, neko::SimdLevel::AVX512)->Range(fromRange, toRange);
+BENCHMARK_TEMPLATE(BM_TransformPointsBatch, neko::SimdLevel::NEON)->Range(fromRange, toRange);
+
+template<neko::SimdLevel level>
+static void BM_ComposeTrsBatch(benchmark::State& state)
+{
+    if (!neko::SetMat4BatchLevel(level))
+    {
+        state.SkipWithError("Unsupported instruction set");
+        return;
+    }
+    const size_t n = state.range(0);
+    std::vector<float> components[10];
+    for (auto& component : components)
+    {
+        component.resize(n);
+        std::generate(component.begin(), component.end(), RandomFloat);
+    }
+    const neko::TrsSoA trs{
+        components[0].data(), components[1].data(), components[2].data(),
+        components[3].data(), components[4].data(), components[5].data(), components[6].data(),
+        components[7].data(), components[8].data(), components[9].data() };
+    std::vector<neko::Mat4f> result(n);
+    for (auto _ : state)
+    {
+        neko::ComposeTrsBatch(trs, result.data(), n);
+        benchmark::ClobberMemory();
+    }
+    neko::SetMat4BatchLevel(neko::GetCpuSimdLevel());
+}
+
+BENCHMARK_TEMPLATE(BM_ComposeTrsBatch, neko::SimdLevel::SCALAR)->Range(fromRange, toRange);
+BENCHMARK_TEMPLATE(BM_ComposeTrsBatch, neko::SimdLevel::SSE4)->Range(fromRange, toRange);
+BENCHMARK_TEMPLATE(BM_ComposeTrsBatch, neko::SimdLevel::AVX2)->Range(fromRange, toRange);
+BENCHMARK_TEMPLATE(BM_ComposeTrsBatch, neko::SimdLevel::AVX512)->Range(fromRange, toRange);
+BENCHMARK_TEMPLATE(BM_ComposeTrsBatch, neko::SimdLevel::NEON)->Range(fromRange, toRange);
+
 
 
 BENCHMARK_MAIN();
\ No newline at end of file
@@ -0,0 +1,134 @@
+/*
+ MIT License
+
+ Copyright (c) 2020 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#include <string>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "engine/engine.h"
+#include "graphics/obj_loader.h"
+#include "utilities/file_utility.h"
+
+#ifdef NEKO_ASSIMP
+#include <assimp/Importer.hpp>
+#include <assimp/scene.h>
+#include <assimp/postprocess.h>
+#endif
+
+namespace
+{
+const std::vector<std::string> objModels =
+{
+    "model/rock/rock.obj",
+    "model/nanosuit2/nanosuit.obj",
+    "model/dragon/dragon.obj"
+};
+
+class BenchEngine : public neko::BasicEngine
+{
+public:
+    explicit BenchEngine(neko::Configuration* config = nullptr) : BasicEngine(config) {}
+    void ManageEvent() override {}
+};
+
+std::string GetObjPath(benchmark::State& state)
+{
+    const auto& model = objModels[state.range(0)];
+    state.SetLabel(model);
+    const std::string path = neko::Configuration().dataRootPath + model;
+    if (!neko::FileExists(path))
+    {
+        state.SkipWithError(("Missing model file: " + path).c_str());
+        return {};
+    }
+    return path;
+}
+
+void LoadObj(benchmark::State& state, const std::string& path)
+{
+    for (auto _ : state)
+    {
+        neko::ObjModel model;
+        if (!neko::LoadObj(path, model))
+        {
+            state.SkipWithError("Could not load the obj model");
+            break;
+        }
+        benchmark::DoNotOptimize(model.meshes.data());
+    }
+}
+}
+
+static void BM_ObjLoaderSingleThread(benchmark::State& state)
+{
+    const auto path = GetObjPath(state);
+    if (path.empty())
+    {
+        return;
+    }
+    LoadObj(state, path);
+}
+
+BENCHMARK(BM_ObjLoaderSingleThread)->DenseRange(0, int(objModels.size()) - 1)->Unit(benchmark::kMillisecond);
+
+static void BM_ObjLoaderJobSystem(benchmark::State& state)
+{
+    const auto path = GetObjPath(state);
+    if (path.empty())
+    {
+        return;
+    }
+    BenchEngine engine;
+    engine.Init();
+    LoadObj(state, path);
+    engine.Destroy();
+}
+
+BENCHMARK(BM_ObjLoaderJobSystem)->DenseRange(0, int(objModels.size()) - 1)->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+#ifdef NEKO_ASSIMP
+static void BM_ObjAssimp(benchmark::State& state)
+{
+    const auto path = GetObjPath(state);
+    if (path.empty())
+    {
+        return;
+    }
+    for (auto _ : state)
+    {
+        //Same post processing as assimp::Model
+        Assimp::Importer import;
+        const aiScene* scene = import.ReadFile(path, aiProcess_Triangulate | aiProcess_FlipUVs |
+            aiProcess_GenNormals | aiProcess_CalcTangentSpace);
+        if (scene == nullptr)
+        {
+            state.SkipWithError(import.GetErrorString());
+            break;
+        }
+        benchmark::DoNotOptimize(scene->mMeshes);
+    }
+}
+
+BENCHMARK(BM_ObjAssimp)->DenseRange(0, int(objModels.size()) - 1)->Unit(benchmark::kMillisecond);
+#endif
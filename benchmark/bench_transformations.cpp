@@ -3,6 +3,7 @@
 // #include "random_fill.h"
 #include <benchmark/benchmark.h>
 #include <mathematics/transform.h>
+#include <mathematics/matrix_batch.h>
 
 using namespace neko;
 
@@ -155,4 +156,84 @@ static void BM_RotateUsingQuaternion(benchmark::State& s)
 
 BENCHMARK(BM_RotateUsingQuaternion)->Range(from, to);
 
+static void BM_TrsUsingEulerChain(benchmark::State& s)
+{
+    int arraySize = s.range(0);
+    std::vector<Mat4f> transforms(arraySize);
+    std::vector<Vec3f> positions(arraySize);
+    std::vector<EulerAngles> angles(arraySize);
+    std::vector<Vec3f> scales(arraySize);
+
+    for (int i = 0; i < arraySize; ++i)
+    {
+        positions[i] = Vec3f(rand(), rand(), rand());
+        angles[i] = EulerAngles(degree_t(rand()), degree_t(rand()), degree_t(rand()));
+        scales[i] = Vec3f(rand(), rand(), rand());
+    }
+
+    for (auto _ : s)
+    {
+        for (int i = 0; i < arraySize; ++i)
+        {
+            Mat4f transform = Transform3d::Rotate(Mat4f::Identity, angles[i]);
+            transform = Transform3d::Scale(transform, scales[i]);
+            transforms[i] = Transform3d::Translate(transform, positions[i]);
+        }
+        benchmark::DoNotOptimize(transforms.data());
+    }
+}
+
+BENCHMARK(BM_TrsUsingEulerChain)->Range(from, to);
+
+static void BM_TrsUsingQuaternion(benchmark::State& s)
+{
+    int arraySize = s.range(0);
+    std::vector<Mat4f> transforms(arraySize);
+    std::vector<Vec3f> positions(arraySize);
+    std::vector<Quaternion> quaternions(arraySize);
+    std::vector<Vec3f> scales(arraySize);
+
+    for (int i = 0; i < arraySize; ++i)
+    {
+        positions[i] = Vec3f(rand(), rand(), rand());
+        quaternions[i] = Quaternion::Normalized(Quaternion(rand(), rand(), rand(), rand()));
+        scales[i] = Vec3f(rand(), rand(), rand());
+    }
+
+    for (auto _ : s)
+    {
+        for (int i = 0; i < arraySize; ++i)
+        {
+            transforms[i] = Transform3d::TrsMatrixFrom(positions[i], quaternions[i], scales[i]);
+        }
+        benchmark::DoNotOptimize(transforms.data());
+    }
+}
+
+BENCHMARK(BM_TrsUsingQuaternion)->Range(from, to);
+
+static void BM_TrsUsingQuaternionBatch(benchmark::State& s)
+{
+    int arraySize = s.range(0);
+    std::vector<Mat4f> transforms(arraySize);
+    std::vector<float> trs(arraySize * 10);
+
+    for (auto& value : trs)
+    {
+        value = static_cast<float>(rand()) / RAND_MAX;
+    }
+    const TrsSoA trsSoA{
+        &trs[0], &trs[arraySize], &trs[2 * arraySize],
+        &trs[3 * arraySize], &trs[4 * arraySize], &trs[5 * arraySize], &trs[6 * arraySize],
+        &trs[7 * arraySize], &trs[8 * arraySize], &trs[9 * arraySize] };
+
+    for (auto _ : s)
+    {
+        ComposeTrsBatch(trsSoA, transforms.data(), arraySize);
+        benchmark::DoNotOptimize(transforms.data());
+    }
+}
+
+BENCHMARK(BM_TrsUsingQuaternionBatch)->Range(from, to);
+
 BENCHMARK_MAIN();
\ No newline at end of file
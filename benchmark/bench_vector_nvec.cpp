@@ -37,7 +37,6 @@ static void BM_SquareMagnitude(benchmark::State& state)
 }
 
 BENCHMARK(BM_SquareMagnitude);
-/*
 static void BM_SquareMagnitudeIntrinsics(benchmark::State& state)
 {
     std::array<neko::Vec4f, 8> array;
@@ -56,7 +55,6 @@ static void BM_SquareMagnitudeIntrinsics(benchmark::State& state)
 
 
 BENCHMARK(BM_SquareMagnitudeIntrinsics);
-*/
 static void BM_MagnitudeSimple(benchmark::State& state)
 {
     std::array<neko::Vec4f, 8> array;
@@ -93,7 +91,6 @@ static void BM_Magnitude(benchmark::State& state)
 }
 
 BENCHMARK(BM_Magnitude);
-/*
 static void BM_MagnitudeIntrinsics(benchmark::State& state)
 {
     std::array<neko::Vec4f, 8> array;
@@ -112,7 +109,6 @@ static void BM_MagnitudeIntrinsics(benchmark::State& state)
 }
 
 BENCHMARK(BM_MagnitudeIntrinsics);
-*/
 static void BM_DotSimple(benchmark::State& state)
 {
     std::array<neko::Vec4f, 8> array1;
@@ -161,7 +157,6 @@ static void BM_Dot(benchmark::State& state)
 }
 
 BENCHMARK(BM_Dot);
-/*
 static void BM_DotIntrinsics(benchmark::State& state)
 {
     std::array<neko::Vec4f, 8> array1;
@@ -185,7 +180,6 @@ static void BM_DotIntrinsics(benchmark::State& state)
 }
 
 BENCHMARK(BM_DotIntrinsics);
-*/
 static void BM_ReflectSimple(benchmark::State& state)
 {
     std::array<neko::Vec3f, 8> array1;
@@ -234,7 +228,6 @@ static void BM_Reflect(benchmark::State& state)
 }
 
 BENCHMARK(BM_Reflect);
-/*
 static void BM_ReflectIntrinsics(benchmark::State& state)
 {
     std::array<neko::Vec3f, 8> array1;
@@ -258,5 +251,79 @@ static void BM_ReflectIntrinsics(benchmark::State& state)
 }
 
 BENCHMARK(BM_ReflectIntrinsics);
-*/
+template<int N>
+static void BM_CrossSimple(benchmark::State& state)
+{
+    std::array<neko::Vec3f, N> array1;
+    array1.fill(neko::Vec3f(1, 2, 3));
+    std::array<neko::Vec3f, N> array2;
+    array2.fill(neko::Vec3f(-3, 1, 2));
+
+    for (auto _ : state)
+    {
+        for (int i = 0; i < N; ++i)
+        {
+            benchmark::DoNotOptimize(neko::Vec3f::Cross(array1[i], array2[i]));
+        }
+    }
+}
+
+BENCHMARK_TEMPLATE(BM_CrossSimple, 4);
+BENCHMARK_TEMPLATE(BM_CrossSimple, 8);
+BENCHMARK_TEMPLATE(BM_CrossSimple, 16);
+
+template<int N>
+static void BM_CrossIntrinsics(benchmark::State& state)
+{
+    std::array<neko::Vec3f, N> array1;
+    array1.fill(neko::Vec3f(1, 2, 3));
+    const neko::NVec3<float, N> test1(array1);
+    std::array<neko::Vec3f, N> array2;
+    array2.fill(neko::Vec3f(-3, 1, 2));
+    const neko::NVec3<float, N> test2(array2);
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(neko::NVec3<float, N>::CrossIntrinsics(test1, test2));
+    }
+}
+
+BENCHMARK_TEMPLATE(BM_CrossIntrinsics, 4);
+BENCHMARK_TEMPLATE(BM_CrossIntrinsics, 8);
+BENCHMARK_TEMPLATE(BM_CrossIntrinsics, 16);
+
+template<int N>
+static void BM_MultiplyAdd(benchmark::State& state)
+{
+    std::array<neko::Vec4f, N> array;
+    array.fill(neko::Vec4f(5, 5, 5, 5));
+    const neko::NVec4<float, N> test(array);
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(neko::NVec4<float, N>::MultiplyAdd(test, test, test));
+    }
+}
+
+BENCHMARK_TEMPLATE(BM_MultiplyAdd, 4);
+BENCHMARK_TEMPLATE(BM_MultiplyAdd, 8);
+BENCHMARK_TEMPLATE(BM_MultiplyAdd, 16);
+
+template<int N>
+static void BM_MultiplyAddIntrinsics(benchmark::State& state)
+{
+    std::array<neko::Vec4f, N> array;
+    array.fill(neko::Vec4f(5, 5, 5, 5));
+    const neko::NVec4<float, N> test(array);
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(neko::NVec4<float, N>::MultiplyAddIntrinsics(test, test, test));
+    }
+}
+
+BENCHMARK_TEMPLATE(BM_MultiplyAddIntrinsics, 4);
+BENCHMARK_TEMPLATE(BM_MultiplyAddIntrinsics, 8);
+BENCHMARK_TEMPLATE(BM_MultiplyAddIntrinsics, 16);
+
 BENCHMARK_MAIN();
@@ -23,6 +23,8 @@
  SOFTWARE.
  */
 
+#include <atomic>
+#include <memory>
 #include <vector>
 
 #include "assimp/material.h"
@@ -30,26 +32,23 @@
 #include "gl/shader.h"
 #include "gl/texture.h"
 #include "mathematics/circle.h"
+#include "graphics/cooked_model.h"
+#include "graphics/obj_loader.h"
+#include "graphics/vertex_quantization.h"
 
 struct aiMesh;
-struct aiScene;
 
 namespace neko::assimp
 {
 
-	struct Vertex
-	{
-		Vec3f position;
-		Vec3f normal;
-		Vec2f texCoords;
-        Vec3f tangent;
-        Vec3f bitangent;
-    };
+	using Vertex = MeshVertex;
 	struct Texture
 	{
 		Texture() = default;
 		TextureId textureId = INVALID_TEXTURE_ID;
-		TextureName textureName = INVALID_TEXTURE_NAME;
+		TextureHandle textureHandle = INVALID_TEXTURE_HANDLE;
+		//Relative to the model folder, written in the cooked model
+		std::string path;
 		enum class TextureType : std::uint8_t
 		{
 			DIFFUSE,
@@ -62,29 +61,85 @@ namespace neko::assimp
 	{
 	public:
 		Mesh();
+		/**
+		 * \brief Adds the upload of the vertices and indices to the pre-render jobs, once they are all set.
+		 * With vertex compression, the vertices are quantized first on the calling thread.
+		 */
+		void ScheduleGpuUpload();
+		/**
+		 * \brief Uploads QuantizedVertex instead of MeshVertex, the mesh must then be drawn with a shader
+		 * decoding them (see model_quantized.vert). The float vertices stay on the CPU for the cooking.
+		 */
+		void SetVertexCompression(bool compressVertices) { compressVertices_ = compressVertices; }
+		/**
+		 * \brief Adds a texture loaded callback for each texture, which sets its name. The mesh must outlive
+		 * its GPU upload job, the texture loads can finish after it is destroyed.
+		 */
 		void Init();
 		void Draw(const gl::Shader& shader) const;
         void BindTextures(const gl::Shader& shader) const;
 		void Destroy();
 
-		void ProcessMesh(const aiMesh* mesh, const aiScene* scene,
+		/**
+		 * \brief Converts the vertices and flattens the indices of the mesh, it does not use the texture manager
+		 * and can run on any thread
+		 */
+		void ProcessMesh(const aiMesh* mesh);
+		void ProcessMaterial(const aiMaterial* material, const std::string_view directory);
+		/**
+		 * \brief Points the mesh at the vertices and indices of the mapped cooked model, which must outlive the mesh
+		 */
+		void LoadCooked(const CookedModel::MeshView& mesh, const CookedModel& cookedModel,
 			const std::string_view directory);
+		/**
+		 * \brief Takes the vertices and indices of the native obj mesh and loads the textures of its material
+		 */
+		void ProcessObjMesh(ObjMesh& mesh, const ObjMaterial& material, const std::string_view directory);
+		[[nodiscard]] CookedMeshSource GetCookedSource() const;
 		bool IsLoaded() const;
 
 
 		[[nodiscard]] unsigned int GetVao() const {return VAO;}
-		[[nodiscard]] size_t GetElementsCount() const {return indices_.size();}
+		[[nodiscard]] size_t GetElementsCount() const {return indexCount_;}
+		/**
+		 * \brief Size of the vertex and index buffers, set once the mesh is uploaded
+		 */
+		[[nodiscard]] size_t GetGpuByteSize() const {return gpuByteSize_;}
 
 		[[nodiscard]] Sphere GenerateBoundingSphere() const;
 	protected:
 
-		void LoadMaterialTextures(aiMaterial* material, aiTextureType aiTexture, Texture::TextureType texture,
+		void LoadMaterialTextures(const aiMaterial* material, aiTextureType aiTexture, Texture::TextureType texture,
 			const std::string_view directory);
+		void LoadTexture(std::string_view relativePath, Texture::TextureType type, const std::string_view directory);
 		std::vector<Vertex> vertices_;
 		std::vector<unsigned int> indices_;
+		//Either the vectors above or the cooked model mapping
+		const Vertex* vertexData_ = nullptr;
+		size_t vertexCount_ = 0;
+		const unsigned int* indexData_ = nullptr;
+		size_t indexCount_ = 0;
 		std::vector<Texture> textures_;
 		float specularExponent_ = 0.0f;
+		/**
+		 * \brief Written by the texture loaded callbacks, which can run on another thread than Init.
+		 * The callbacks share it instead of pointing to the mesh, so they can outlive a destroyed mesh.
+		 */
+		struct TextureLoadState
+		{
+			std::vector<TextureName> names;
+			std::atomic<size_t> pendingCount{0};
+		};
+		std::shared_ptr<TextureLoadState> textureLoadState_ = std::make_shared<TextureLoadState>();
 		Vec3f min_, max_;
+		bool compressVertices_ = false;
+		//Only the position decoding is kept after the upload
+		QuantizedMesh quantizedMesh_;
+		size_t gpuByteSize_ = 0;
+		//Reported to the MESH memory budget, the cooked model mapping is not owned by the mesh
+		size_t cpuByteSize_ = 0;
+		size_t quantizedByteSize_ = 0;
+		bool shortIndices_ = false;
 		Job loadMeshToGpu;
 		//  render data
 		unsigned int VAO = 0, VBO = 0, EBO = 0;
@@ -92,5 +147,6 @@ namespace neko::assimp
 		 * \brief This function is called on the render thread as a pre-render job
 		 */
 		void SetupMesh();
+		void SetupQuantizedBuffers();
 	};
 }
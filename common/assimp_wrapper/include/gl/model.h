@@ -23,6 +23,8 @@
  SOFTWARE.
  */
 
+#include <memory>
+
 #include "gl/mesh.h"
 #include "gl/shader.h"
 #include <assimp/scene.h>
@@ -30,11 +32,22 @@
 namespace neko::assimp
 {
 
+/**
+ * \brief Imports a model with Assimp or the native obj loader, or reads its cooked .nmesh file.
+ * With Configuration::modelCachePath, the first import is cooked in the cache folder and the next loads
+ * only map the cooked file. The cooked file is keyed by the content of the model file, not of its materials.
+ * The disk load runs on the RESOURCE_THREAD and schedules the processing on the OTHER_THREAD when done,
+ * no thread waits for another.
+ */
 class Model
 {
 public:
     Model();
     void LoadModel(std::string_view path);
+    /**
+     * \brief Set before LoadModel, the meshes are uploaded as QuantizedVertex with 16-bit indices when possible
+     */
+    void SetVertexCompression(bool compressVertices) { compressVertices_ = compressVertices; }
     bool IsLoaded() const;
     void Draw(const gl::Shader& shader);
     void Destroy();
@@ -46,14 +59,32 @@ public:
     {
 	    return meshes_[index];
     };
+    [[nodiscard]] size_t GetGpuByteSize() const;
 private:
     // model data
     std::vector<Mesh> meshes_;
     std::string directory_;
     std::string path_;
+    Job loadModelJob_;
     Job processModelJob_;
-	
+    CookedModel cookedModel_;
+    //Results of the disk load, one of them is set for the processing
+    std::unique_ptr<aiScene> scene_;
+    ObjModel objModel_;
+    std::string cookedPath_;
+    bool compressVertices_ = false;
+
+    void LoadFromDisk();
     void ProcessModel();
-    void ProcessNode(aiNode* node, const aiScene* scene);
+    /**
+     * \brief Gathers the meshes of the node tree in depth-first order
+     */
+    void ProcessNode(const aiNode* node, const aiScene* scene, std::vector<const aiMesh*>& sceneMeshes);
+    /**
+     * \brief Maps the .nmesh model or the cooked file of the model in the cache, cookedPath is then set
+     * to where the imported model should be cooked
+     */
+    bool LoadCookedModel(std::string& cookedPath);
+    void CookModel(std::string_view cookedPath) const;
 };
 }
@@ -23,6 +23,8 @@
  */
 
 #include "gl/mesh.h"
+#include <algorithm>
+#include <array>
 #include "assimp/mesh.h"
 #include "assimp/scene.h"
 #include "assimp/material.h"
@@ -31,6 +33,9 @@
 #include "gl/gles3_include.h"
 #include "graphics/graphics.h"
 #include "graphics/texture.h"
+#include "engine/log.h"
+#include "engine/memory_budget.h"
+#include <fmt/format.h>
 
 #ifdef EASY_PROFILE_USE
 #include "easy/profiler.h"
@@ -45,29 +50,48 @@ Mesh::Mesh() : loadMeshToGpu([this]
 {
 }
 
-void Mesh::Init()
+void Mesh::ScheduleGpuUpload()
 {
-#ifdef NEKO_SAMETHREAD
-    loadMeshToGpu.Execute();
-    const TextureManagerInterface& textureManager = TextureManagerLocator::get();
-    for (auto& texture : textures_)
+    auto& memoryBudget = MemoryBudgetLocator::get();
+    cpuByteSize_ = vertices_.size() * sizeof(Vertex) + indices_.size() * sizeof(unsigned int);
+    if (cpuByteSize_ > 0)
     {
-        texture.textureName = textureManager.GetTexture(texture.textureId).name;
+        memoryBudget.RecordAllocation(MemoryTag::MESH, this, cpuByteSize_, NEKO_ALLOCATION_SITE);
     }
-
+    if (compressVertices_)
+    {
+        QuantizeMesh(vertexData_, vertexCount_, indexData_, indexCount_, quantizedMesh_);
+        quantizedByteSize_ = quantizedMesh_.GetByteSize();
+        memoryBudget.RecordAllocation(MemoryTag::MESH, &quantizedMesh_, quantizedByteSize_, NEKO_ALLOCATION_SITE);
+    }
+#ifdef NEKO_SAMETHREAD
+    loadMeshToGpu.Execute();
 #else
     RendererLocator::get().AddPreRenderJob(&loadMeshToGpu);
-    const TextureManagerInterface& textureManager = TextureManagerLocator::get();
-    for (auto& texture : textures_)
+#endif
+}
+
+void Mesh::Init()
+{
+    TextureManagerInterface& textureManager = TextureManagerLocator::get();
+    auto& loadState = *textureLoadState_;
+    loadState.names.assign(textures_.size(), INVALID_TEXTURE_NAME);
+    loadState.pendingCount.store(textures_.size(), std::memory_order_relaxed);
+    for (size_t i = 0; i < textures_.size(); i++)
     {
-    	//Waiting for texture to be loaded
-    	while(!textureManager.IsTextureLoaded(texture.textureId))
-    	{
-    		
-    	}
-        texture.textureName = textureManager.GetTexture(texture.textureId).name;
+        //The texture name is patched by the texture manager once uploaded, instead of waiting for it here
+        const bool isPending = textureManager.AddTextureLoadedCallback(textures_[i].textureHandle,
+            [state = textureLoadState_, i](const neko::Texture& texture)
+        {
+            state->names[i] = texture.name;
+            state->pendingCount.fetch_sub(1, std::memory_order_release);
+        });
+        if (!isPending)
+        {
+            logDebug(fmt::format("[Error] Mesh texture {} could not be loaded", textures_[i].path));
+            loadState.pendingCount.fetch_sub(1, std::memory_order_release);
+        }
     }
-#endif
 }
 
 
@@ -75,8 +99,13 @@ void Mesh::Draw(const gl::Shader& shader) const
 {
     BindTextures(shader);
     // draw mesh
+    if (compressVertices_)
+    {
+        shader.SetVec3("positionOffset", quantizedMesh_.positionOffset);
+        shader.SetVec3("positionScale", quantizedMesh_.positionScale);
+    }
     glBindVertexArray(VAO);
-    glDrawElements(GL_TRIANGLES, indices_.size(), GL_UNSIGNED_INT, 0);
+    glDrawElements(GL_TRIANGLES, indexCount_, shortIndices_ ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT, 0);
     glBindVertexArray(0);
 }
 
@@ -86,108 +115,185 @@ void Mesh::Destroy()
     glDeleteBuffers(1, &VBO);
     glDeleteBuffers(1, &EBO);
 
-	for(auto& texture : textures_)
+	for(const auto textureName : textureLoadState_->names)
 	{
-        gl::DestroyTexture(texture.textureName);
+        gl::DestroyTexture(textureName);
 	}
     textures_.clear();
+    //The callbacks still pending keep the old state alive
+    textureLoadState_ = std::make_shared<TextureLoadState>();
+    auto& memoryBudget = MemoryBudgetLocator::get();
+    if (cpuByteSize_ > 0)
+    {
+        memoryBudget.RecordDeallocation(MemoryTag::MESH, this, cpuByteSize_);
+        cpuByteSize_ = 0;
+    }
+    if (quantizedByteSize_ > 0)
+    {
+        memoryBudget.RecordDeallocation(MemoryTag::MESH, &quantizedMesh_, quantizedByteSize_);
+        quantizedByteSize_ = 0;
+    }
     vertices_.clear();
     indices_.clear();
+    vertexData_ = nullptr;
+    vertexCount_ = 0;
+    indexData_ = nullptr;
+    indexCount_ = 0;
+    quantizedMesh_ = QuantizedMesh();
+    shortIndices_ = false;
+    gpuByteSize_ = 0;
 
     loadMeshToGpu.Reset();
 }
 
 
-void Mesh::ProcessMesh(
-    const aiMesh* mesh, 
-    const aiScene* scene,
-    const std::string_view directory)
+void Mesh::ProcessMesh(const aiMesh* mesh)
 {
 #ifdef EASY_PROFILE_USE
     EASY_BLOCK("Process Assimp Mesh");
 #endif
-
-    min_ = Vec3f(mesh->mAABB.mMin);
-    max_ = Vec3f(mesh->mAABB.mMax);
-	
+    //The importer does not generate the aiMesh AABB, it is computed with the vertex conversion
+    min_ = max_ = mesh->mNumVertices > 0 ? Vec3f(mesh->mVertices[0]) : Vec3f::zero;
+    vertices_.resize(mesh->mNumVertices);
     for (unsigned int i = 0; i < mesh->mNumVertices; i++)
     {
-        Vertex vertex;
+        Vertex& vertex = vertices_[i];
         // process vertex positions, normals and texture coordinates
-        Vec3f vector;
-        vector.x = mesh->mVertices[i].x;
-        vector.y = mesh->mVertices[i].y;
-        vector.z = mesh->mVertices[i].z;
-        vertex.position = vector;
-
-        vector.x = mesh->mNormals[i].x;
-        vector.y = mesh->mNormals[i].y;
-        vector.z = mesh->mNormals[i].z;
-        vertex.normal = vector;
+        vertex.position = Vec3f(mesh->mVertices[i]);
+        vertex.normal = Vec3f(mesh->mNormals[i]);
     	//TODO: why is tangent sometimes null even with CalcTangent
         if (mesh->mTangents != nullptr)
         {
-            vector.x = mesh->mTangents[i].x;
-            vector.y = mesh->mTangents[i].y;
-            vector.z = mesh->mTangents[i].z;
-            vertex.tangent = vector;
+            vertex.tangent = Vec3f(mesh->mTangents[i]);
+        }
+        if (mesh->mBitangents != nullptr)
+        {
+            vertex.bitangent = Vec3f(mesh->mBitangents[i]);
         }
         if (mesh->mTextureCoords[0]) // does the mesh contain texture coordinates?
         {
-            Vec2f vec;
-            vec.x = mesh->mTextureCoords[0][i].x;
-            vec.y = mesh->mTextureCoords[0][i].y;
-            vertex.texCoords = vec;
+            vertex.texCoords = Vec2f(mesh->mTextureCoords[0][i].x, mesh->mTextureCoords[0][i].y);
         }
         else
             vertex.texCoords = Vec2f(0.0f, 0.0f);
 
-        vertices_.push_back(vertex);
+        const auto& p = vertex.position;
+        min_ = Vec3f(std::min(min_.x, p.x), std::min(min_.y, p.y), std::min(min_.z, p.z));
+        max_ = Vec3f(std::max(max_.x, p.x), std::max(max_.y, p.y), std::max(max_.z, p.z));
     }
-    // process indices
+    // process indices, the faces are triangulated but points and lines are kept
+    size_t indexCount = 0;
     for (unsigned int i = 0; i < mesh->mNumFaces; i++)
     {
-	    const aiFace face = mesh->mFaces[i];
-        for (unsigned int j = 0; j < face.mNumIndices; j++)
-            indices_.push_back(face.mIndices[j]);
+        indexCount += mesh->mFaces[i].mNumIndices;
     }
-
-    // process material
-    if (mesh->mMaterialIndex >= 0)
+    indices_.resize(indexCount);
+    auto* index = indices_.data();
+    for (unsigned int i = 0; i < mesh->mNumFaces; i++)
     {
-        aiMaterial* material = scene->mMaterials[mesh->mMaterialIndex];
+	    const aiFace& face = mesh->mFaces[i];
+        index = std::copy(face.mIndices, face.mIndices + face.mNumIndices, index);
+    }
+    vertexData_ = vertices_.data();
+    vertexCount_ = vertices_.size();
+    indexData_ = indices_.data();
+    indexCount_ = indices_.size();
+}
 
-        textures_.reserve(
+void Mesh::ProcessMaterial(const aiMaterial* material, const std::string_view directory)
+{
+    textures_.reserve(
         material->GetTextureCount(aiTextureType_SPECULAR) +
-	        material->GetTextureCount(aiTextureType_DIFFUSE) + 
-            material->GetTextureCount(aiTextureType_HEIGHT));
-    	
-        material->Get(AI_MATKEY_SHININESS, specularExponent_);
-        LoadMaterialTextures(material,
-            aiTextureType_DIFFUSE, Texture::TextureType::DIFFUSE, directory);
-        LoadMaterialTextures(material,
-            aiTextureType_SPECULAR, Texture::TextureType::SPECULAR, directory);
-        LoadMaterialTextures(material,
-            aiTextureType_HEIGHT, Texture::TextureType::HEIGHT, directory);
-    }
+        material->GetTextureCount(aiTextureType_DIFFUSE) +
+        material->GetTextureCount(aiTextureType_HEIGHT));
+
+    material->Get(AI_MATKEY_SHININESS, specularExponent_);
+    LoadMaterialTextures(material,
+        aiTextureType_DIFFUSE, Texture::TextureType::DIFFUSE, directory);
+    LoadMaterialTextures(material,
+        aiTextureType_SPECULAR, Texture::TextureType::SPECULAR, directory);
+    LoadMaterialTextures(material,
+        aiTextureType_HEIGHT, Texture::TextureType::HEIGHT, directory);
 }
 
-bool Mesh::IsLoaded() const
+void Mesh::LoadCooked(
+    const CookedModel::MeshView& mesh,
+    const CookedModel& cookedModel,
+    const std::string_view directory)
 {
-    if (!loadMeshToGpu.IsDone())
+#ifdef EASY_PROFILE_USE
+    EASY_BLOCK("Load Cooked Mesh");
+#endif
+    const auto& entry = *mesh.entry;
+    min_ = entry.aabbMin;
+    max_ = entry.aabbMax;
+    specularExponent_ = entry.specularExponent;
+    vertexData_ = mesh.vertices;
+    vertexCount_ = entry.vertexCount;
+    indexData_ = mesh.indices;
+    indexCount_ = entry.indexCount;
+
+    textures_.reserve(entry.textureCount);
+    for (std::uint32_t i = 0; i < entry.textureCount; i++)
     {
-        return false;
+        LoadTexture(cookedModel.GetTexturePath(mesh.textures[i]),
+            static_cast<Texture::TextureType>(mesh.textures[i].type), directory);
     }
-    const TextureManagerInterface& textureManager = TextureManagerLocator::get();
-	for(const auto& texture : textures_)
-	{
-        if (!textureManager.IsTextureLoaded(texture.textureId))
+}
+
+void Mesh::ProcessObjMesh(
+    ObjMesh& mesh,
+    const ObjMaterial& material,
+    const std::string_view directory)
+{
+#ifdef EASY_PROFILE_USE
+    EASY_BLOCK("Process Obj Mesh");
+#endif
+    min_ = mesh.aabbMin;
+    max_ = mesh.aabbMax;
+    vertices_ = std::move(mesh.vertices);
+    indices_ = std::move(mesh.indices);
+    vertexData_ = vertices_.data();
+    vertexCount_ = vertices_.size();
+    indexData_ = indices_.data();
+    indexCount_ = indices_.size();
+
+    specularExponent_ = material.specularExponent;
+    //Same texture order as the assimp materials
+    const std::array<std::pair<const std::string*, Texture::TextureType>, 3> materialTextures =
+    {{
+        {&material.diffuseMap, Texture::TextureType::DIFFUSE},
+        {&material.specularMap, Texture::TextureType::SPECULAR},
+        {&material.heightMap, Texture::TextureType::HEIGHT}
+    }};
+    for (const auto& [texturePath, type] : materialTextures)
+    {
+        if (!texturePath->empty())
         {
-            return false;
+            LoadTexture(*texturePath, type, directory);
         }
+    }
+}
 
-	}
-    return true;
+CookedMeshSource Mesh::GetCookedSource() const
+{
+    CookedMeshSource source;
+    source.vertices = vertexData_;
+    source.vertexCount = vertexCount_;
+    source.indices = indexData_;
+    source.indexCount = indexCount_;
+    source.specularExponent = specularExponent_;
+    source.textures.reserve(textures_.size());
+    for (const auto& texture : textures_)
+    {
+        source.textures.push_back({texture.path, static_cast<std::uint32_t>(texture.type)});
+    }
+    return source;
+}
+
+bool Mesh::IsLoaded() const
+{
+    return loadMeshToGpu.IsDone() && textureLoadState_->pendingCount.load(std::memory_order_acquire) == 0;
 }
 
 void Mesh::SetupMesh()
@@ -217,14 +323,22 @@ void Mesh::SetupMesh()
     EASY_BLOCK("Copy Buffers");
 #endif
     glBindVertexArray(VAO);
+    if (compressVertices_)
+    {
+        SetupQuantizedBuffers();
+        glBindVertexArray(0);
+        glCheckError();
+        return;
+    }
     glBindBuffer(GL_ARRAY_BUFFER, VBO);
     glCheckError();
-    glBufferData(GL_ARRAY_BUFFER, vertices_.size() * sizeof(Vertex), &vertices_[0], GL_STATIC_DRAW);
+    glBufferData(GL_ARRAY_BUFFER, vertexCount_ * sizeof(Vertex), vertexData_, GL_STATIC_DRAW);
     glCheckError();
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices_.size() * sizeof(unsigned int),
-        &indices_[0], GL_STATIC_DRAW);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexCount_ * sizeof(unsigned int),
+        indexData_, GL_STATIC_DRAW);
         glCheckError();
+    gpuByteSize_ = vertexCount_ * sizeof(Vertex) + indexCount_ * sizeof(unsigned int);
 #ifdef EASY_PROFILE_USE
     EASY_END_BLOCK;
     EASY_BLOCK("Vertex Attrib");
@@ -250,6 +364,53 @@ void Mesh::SetupMesh()
     glCheckError();
 }
 
+void Mesh::SetupQuantizedBuffers()
+{
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, quantizedMesh_.vertices.size() * sizeof(QuantizedVertex),
+        quantizedMesh_.vertices.data(), GL_STATIC_DRAW);
+    glCheckError();
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+    shortIndices_ = quantizedMesh_.HasShortIndices();
+    if (shortIndices_)
+    {
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, quantizedMesh_.shortIndices.size() * sizeof(std::uint16_t),
+            quantizedMesh_.shortIndices.data(), GL_STATIC_DRAW);
+    }
+    else
+    {
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, quantizedMesh_.indices.size() * sizeof(std::uint32_t),
+            quantizedMesh_.indices.data(), GL_STATIC_DRAW);
+    }
+    glCheckError();
+    gpuByteSize_ = quantizedMesh_.GetByteSize();
+
+    // vertex positions in the mesh AABB, w is the bitangent sign
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 4, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(QuantizedVertex),
+        (void*)offsetof(QuantizedVertex, position));
+    // vertex texture coords
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 2, GL_HALF_FLOAT, GL_FALSE, sizeof(QuantizedVertex),
+        (void*)offsetof(QuantizedVertex, texCoords));
+    // octahedral vertex normals
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 2, GL_SHORT, GL_TRUE, sizeof(QuantizedVertex),
+        (void*)offsetof(QuantizedVertex, normal));
+    // octahedral vertex tangent
+    glEnableVertexAttribArray(3);
+    glVertexAttribPointer(3, 2, GL_SHORT, GL_TRUE, sizeof(QuantizedVertex),
+        (void*)offsetof(QuantizedVertex, tangent));
+    glCheckError();
+
+    //The GPU keeps its copy, the position decoding is needed to draw
+    quantizedMesh_.vertices = {};
+    quantizedMesh_.shortIndices = {};
+    quantizedMesh_.indices = {};
+    MemoryBudgetLocator::get().RecordDeallocation(MemoryTag::MESH, &quantizedMesh_, quantizedByteSize_);
+    quantizedByteSize_ = 0;
+}
+
 Sphere Mesh::GenerateBoundingSphere() const
 {
     Sphere s;
@@ -259,28 +420,37 @@ Sphere Mesh::GenerateBoundingSphere() const
 }
 
 void Mesh::LoadMaterialTextures(
-    aiMaterial* material,
+    const aiMaterial* material,
     aiTextureType aiTexture,
     Texture::TextureType texture,
     const std::string_view directory)
 {
-    auto& textureManager = TextureManagerLocator::get();
     for (unsigned int i = 0; i < material->GetTextureCount(aiTexture); i++)
     {
         aiString str;
         material->GetTexture(aiTexture, i, &str);
-        
-        textures_.emplace_back();
-        auto& assTexture = textures_.back();
-        assTexture.type = texture;
-        std::string path = directory.data();
-        path += '/';
-    	path += str.C_Str();
-    	
-        assTexture.textureId = textureManager.LoadTexture(path);
+        LoadTexture(str.C_Str(), texture, directory);
     }
 }
 
+void Mesh::LoadTexture(
+    std::string_view relativePath,
+    Texture::TextureType type,
+    const std::string_view directory)
+{
+    auto& textureManager = TextureManagerLocator::get();
+    textures_.emplace_back();
+    auto& assTexture = textures_.back();
+    assTexture.type = type;
+    assTexture.path = relativePath;
+    std::string path(directory);
+    path += '/';
+    path += relativePath;
+
+    assTexture.textureId = textureManager.LoadTexture(path);
+    assTexture.textureHandle = textureManager.GetTextureHandle(assTexture.textureId);
+}
+
 void Mesh::BindTextures(const gl::Shader& shader) const
 {
     glCheckError();
@@ -311,7 +481,7 @@ void Mesh::BindTextures(const gl::Shader& shader) const
             default: ;
         }
         shader.SetInt("material." + name + number, i);
-        glBindTexture(GL_TEXTURE_2D, textures_[i].textureName);
+        glBindTexture(GL_TEXTURE_2D, textureLoadState_->names[i]);
     }
     shader.SetFloat("material.shininess", specularExponent_);
     shader.SetBool("enableNormalMap", normalNr > 1);
@@ -25,7 +25,9 @@
 #include "gl/model.h"
 #include "gl/texture.h"
 
+#include <cstdio>
 #include <sstream>
+#include <thread>
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
@@ -33,6 +35,7 @@
 
 #include "io_system.h"
 #include "engine/engine.h"
+#include "utilities/file_utility.h"
 
 #include <fmt/format.h>
 
@@ -48,17 +51,35 @@ void Model::Draw(const gl::Shader& shader)
 		mesh.Draw(shader);
 }
 
+size_t Model::GetGpuByteSize() const
+{
+	size_t byteSize = 0;
+	for (const auto& mesh : meshes_)
+		byteSize += mesh.GetGpuByteSize();
+	return byteSize;
+}
+
 void Model::Destroy()
 {
 	for (auto& mesh : meshes_)
 		mesh.Destroy();
 	meshes_.clear();
+	cookedModel_.Destroy();
+	loadModelJob_.Reset();
 	processModelJob_.Reset();
 }
 
 
 
-	Model::Model() : processModelJob_([this]
+	Model::Model() : loadModelJob_([this]
+	{
+		LoadFromDisk();
+#ifdef NEKO_SAMETHREAD
+		processModelJob_.Execute();
+#else
+		BasicEngine::GetInstance()->ScheduleJob(&processModelJob_, JobThreadType::OTHER_THREAD);
+#endif
+	}), processModelJob_([this]
 	{
 		ProcessModel();
 	})
@@ -71,9 +92,9 @@ void Model::Destroy()
 		directory_ = path.substr(0, path.find_last_of('/'));
 		logDebug(fmt::format("ASSIMP: Loading model: {}",path_));
 #ifdef NEKO_SAMETHREAD
-		processModelJob_.Execute();
+		loadModelJob_.Execute();
 #else
-		BasicEngine::GetInstance()->ScheduleJob(&processModelJob_, JobThreadType::OTHER_THREAD);
+		BasicEngine::GetInstance()->ScheduleJob(&loadModelJob_, JobThreadType::RESOURCE_THREAD);
 #endif
 	}
 
@@ -93,59 +114,98 @@ void Model::Destroy()
 		return true;
 	}
 
-	void Model::ProcessModel()
+	void Model::LoadFromDisk()
 	{
 #ifdef EASY_PROFILE_USE
-		EASY_BLOCK("Process 3d Model");
-		EASY_BLOCK("Load 3d Model");
+		EASY_BLOCK("Model Disk Load");
 #endif
+		if (LoadCookedModel(cookedPath_))
+		{
+			return;
+		}
+		//The native parser falls back to Assimp on the obj files it cannot read
+		if (GetFilenameExtension(path_) == ".obj" && LoadObj(path_, objModel_))
+		{
+			return;
+		}
 		Assimp::Importer import;
-		const aiScene* scene = nullptr;
-#ifdef NEKO_SAMETHREAD
-        //assimp delete automatically the IO System
-        NekoIOSystem* ioSystem = new NekoIOSystem();
-        import.SetIOHandler(ioSystem);
+		//assimp delete automatically the IO System
+		NekoIOSystem* ioSystem = new NekoIOSystem();
+		import.SetIOHandler(ioSystem);
 
-        scene = import.ReadFile(path_.data(),
-                                aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_GenNormals |
-                                aiProcess_CalcTangentSpace);
-#else
-		Job loadingModelJob = Job([this, &import, &scene]
-		{
-#ifdef EASY_PROFILE_USE
-		EASY_BLOCK("Model Disk Load");
-#endif
-				//assimp delete automatically the IO System
-			NekoIOSystem* ioSystem = new NekoIOSystem();
-			import.SetIOHandler(ioSystem);
-
-			scene = import.ReadFile(path_.data(),
-			aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_GenNormals |
-				aiProcess_CalcTangentSpace);
-		});
-		BasicEngine::GetInstance()->ScheduleJob(&loadingModelJob, JobThreadType::RESOURCE_THREAD);
-#endif
-#ifndef NEKO_SAMETHREAD
-		loadingModelJob.Join();
-#endif
-#ifdef EASY_PROFILE_USE
-		EASY_END_BLOCK;
-#endif
+		const aiScene* scene = import.ReadFile(path_.data(),
+		aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_GenNormals |
+			aiProcess_CalcTangentSpace);
 		if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode)
 		{
 			logDebug(fmt::format("[ERROR] ASSIMP {}", import.GetErrorString()));
 			return;
 		}
-		meshes_.reserve(scene->mNumMeshes);
+		//The scene outlives the importer until the processing job
+		scene_.reset(import.GetOrphanedScene());
+	}
+
+	void Model::ProcessModel()
+	{
 #ifdef EASY_PROFILE_USE
-		EASY_BLOCK("Process Nodes");
+		EASY_BLOCK("Process 3d Model");
 #endif
-		ProcessNode(scene->mRootNode, scene);
+		const std::string cookedPath = std::move(cookedPath_);
+		ObjModel objModel = std::move(objModel_);
+		const std::unique_ptr<aiScene> scene = std::move(scene_);
+		//The meshes are constructed in place, their jobs point to them
+		if (cookedModel_.IsLoaded())
+		{
+			meshes_.resize(cookedModel_.GetMeshCount());
+			for (size_t i = 0; i < meshes_.size(); i++)
+			{
+				meshes_[i].LoadCooked(cookedModel_.GetMesh(i), cookedModel_, directory_);
+				meshes_[i].SetVertexCompression(compressVertices_);
+				meshes_[i].ScheduleGpuUpload();
+			}
+		}
+		else if (!objModel.meshes.empty())
+		{
+			meshes_.resize(objModel.meshes.size());
+			for (size_t i = 0; i < meshes_.size(); i++)
+			{
+				auto& objMesh = objModel.meshes[i];
+				meshes_[i].ProcessObjMesh(objMesh, objModel.materials[objMesh.materialIndex], directory_);
+				meshes_[i].SetVertexCompression(compressVertices_);
+				meshes_[i].ScheduleGpuUpload();
+			}
+		}
+		else if (scene != nullptr)
+		{
 #ifdef EASY_PROFILE_USE
-		EASY_END_BLOCK;
+			EASY_BLOCK("Process Nodes");
 #endif
+			std::vector<const aiMesh*> sceneMeshes;
+			sceneMeshes.reserve(scene->mNumMeshes);
+			ProcessNode(scene->mRootNode, scene.get(), sceneMeshes);
+			meshes_.resize(sceneMeshes.size());
+			//One task per mesh, each mesh is uploaded as soon as it is converted
+			RunParallelTasks(sceneMeshes.size(), [this, &sceneMeshes](std::size_t i)
+			{
+				meshes_[i].ProcessMesh(sceneMeshes[i]);
+				meshes_[i].SetVertexCompression(compressVertices_);
+				meshes_[i].ScheduleGpuUpload();
+			});
+			//The texture manager is not thread-safe, the textures are requested in mesh order
+			for (size_t i = 0; i < meshes_.size(); i++)
+			{
+				meshes_[i].ProcessMaterial(scene->mMaterials[sceneMeshes[i]->mMaterialIndex], directory_);
+			}
+#ifdef EASY_PROFILE_USE
+			EASY_END_BLOCK;
+#endif
+		}
+		if (!cookedModel_.IsLoaded() && !cookedPath.empty() && !meshes_.empty())
+		{
+			CookModel(cookedPath);
+		}
 #ifdef EASY_PROFILE_USE
-		EASY_BLOCK("Schedule Mesh Job");
+		EASY_BLOCK("Add Mesh Texture Callbacks");
 #endif
 		for(auto& mesh : meshes_)
 		{
@@ -153,21 +213,70 @@ void Model::Destroy()
 		}
 	}
 
-	void Model::ProcessNode(aiNode* node, const aiScene* scene)
+	bool Model::LoadCookedModel(std::string& cookedPath)
 	{
-		// process all the node's meshes (if any)
-		for (unsigned int i = 0; i < node->mNumMeshes; i++)
+		if (GetFilenameExtension(path_) == CookedModel::cookedExtension)
+		{
+			return cookedModel_.Load(path_);
+		}
+		const auto* engine = BasicEngine::GetInstance();
+		if (engine == nullptr || engine->config.modelCachePath.empty())
 		{
-			meshes_.emplace_back();
-			auto& mesh = meshes_.back();
+			return false;
+		}
+		BufferFile sourceFile;
+		sourceFile.Load(path_);
+		if (sourceFile.dataBuffer == nullptr)
+		{
+			return false;
+		}
+		cookedPath = CookedModel::GetCookedPath(engine->config.modelCachePath, sourceFile);
+		sourceFile.Destroy();
+		return cookedModel_.Load(cookedPath);
+	}
 
-			aiMesh* assMesh = scene->mMeshes[node->mMeshes[i]];
-			mesh.ProcessMesh(assMesh, scene, directory_);
+	void Model::CookModel(std::string_view cookedPath) const
+	{
+#ifdef EASY_PROFILE_USE
+		EASY_BLOCK("Cook Model");
+#endif
+		const std::string cookedFile(cookedPath);
+		const std::string cacheFolder = cookedFile.substr(0, cookedFile.find_last_of('/'));
+		if (!IsDirectory(cacheFolder) && !CreateDirectory(cacheFolder))
+		{
+			logDebug(fmt::format("[Error] Could not create model cache folder: {}", cacheFolder));
+			return;
+		}
+		std::vector<CookedMeshSource> meshes;
+		meshes.reserve(meshes_.size());
+		for (const auto& mesh : meshes_)
+		{
+			meshes.push_back(mesh.GetCookedSource());
+		}
+		//Several models can cook the same content at once, the rename makes the cooked file appear whole
+		const auto tmpPath = fmt::format("{}.{}.tmp", cookedFile,
+			std::hash<std::thread::id>{}(std::this_thread::get_id()));
+		if (WriteCookedModel(tmpPath, meshes) && std::rename(tmpPath.c_str(), cookedFile.c_str()) == 0)
+		{
+			logDebug(fmt::format("ASSIMP: Cooked {} meshes of {} into {}", meshes.size(), path_, cookedFile));
+		}
+		else
+		{
+			std::remove(tmpPath.c_str());
+		}
+	}
+
+	void Model::ProcessNode(const aiNode* node, const aiScene* scene, std::vector<const aiMesh*>& sceneMeshes)
+	{
+		// gather all the node's meshes (if any)
+		for (unsigned int i = 0; i < node->mNumMeshes; i++)
+		{
+			sceneMeshes.push_back(scene->mMeshes[node->mMeshes[i]]);
 		}
 		// then do the same for each of its children
 		for (unsigned int i = 0; i < node->mNumChildren; i++)
 		{
-			ProcessNode(node->mChildren[i], scene);
+			ProcessNode(node->mChildren[i], scene, sceneMeshes);
 		}
 	}
 
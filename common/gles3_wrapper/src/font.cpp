@@ -25,6 +25,7 @@
 #include "gl/font.h"
 #include "mathematics/transform.h"
 #include "engine/engine.h"
+#include "utilities/asset_database.h"
 #ifdef EASY_PROFILE_USE
 #include "easy/profiler.h"
 #endif
@@ -55,17 +56,22 @@ FontId FontManager::LoadFont(std::string_view fontName, int pixelHeight)
 #ifdef EASY_PROFILE_USE
     EASY_BLOCK("Load Font");
 #endif
-    const std::string metaPath = std::string(fontName) + ".meta";
-    auto metaJson = LoadJson(metaPath);
     FontId fontId = INVALID_FONT_ID;
-    if (CheckJsonExists(metaJson, "uuid"))
+    auto& assetDatabase = AssetDatabaseLocator::get();
+    AssetRecord asset;
+    if (assetDatabase.FindAsset(fontName, asset))
     {
-        fontId = sole::rebuild(metaJson["uuid"].get<std::string>());
+        fontId = asset.GetId();
     }
     else
     {
-        logDebug("[Error] Could not find font id in json file");
-        return fontId;
+        std::uint32_t flags = AssetArchiveEntry::NONE;
+        if (!LoadAssetMeta(fontName, fontId, flags))
+        {
+            logDebug("[Error] Could not find font id in json file");
+            return INVALID_FONT_ID;
+        }
+        assetDatabase.AddAsset(fontName, fontId, AssetType::FONT, flags);
     }
 
     if (fontId == INVALID_FONT_ID)
@@ -88,7 +94,10 @@ FontId FontManager::LoadFont(std::string_view fontName, int pixelHeight)
     }
     FT_Face face;
     BufferFile fontFile;
-    fontFile.Load(fontName);
+    if (!AssetArchiveLocator::get().LoadBufferFile(fontName, fontFile))
+    {
+        fontFile.Load(fontName);
+    }
     if (FT_New_Memory_Face(ft,
                            fontFile.dataBuffer,
                            fontFile.dataLength,
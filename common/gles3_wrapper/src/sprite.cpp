@@ -50,6 +50,7 @@ void SpriteManager::Destroy()
     for (auto& sprite : components_)
     {
         sprite.textureId = INVALID_TEXTURE_ID;
+        sprite.textureHandle = INVALID_TEXTURE_HANDLE;
         sprite.texture.name = INVALID_TEXTURE_NAME;
     }
     spriteQuad_.Destroy();
@@ -77,7 +78,7 @@ void SpriteManager::Render()
             else
             {
                 const auto& transform = transformManager_.GetComponent(entity);
-                spriteShader_.SetMat4("model", transform);
+                spriteShader_.SetMat4("model", transform.ToMat4());
             }
             const auto& sprite = GetComponent(entity);
             spriteShader_.SetTexture("spriteTexture", sprite.texture.name);
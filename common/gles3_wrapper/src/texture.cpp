@@ -44,12 +44,11 @@ namespace neko::gl
 {
 void TextureManager::CreateTexture()
 {
-    const auto textureId = currentUploadedTexture_.textureId;
     const auto flags = currentUploadedTexture_.flags;
     auto& image = currentUploadedTexture_.image;
     if (image.data == nullptr)
     {
-        textureMap_[textureId] = {};
+        currentUploadedTexture_.texture = {};
         return;
     }
 #ifdef EASY_PROFILE_USE
@@ -146,22 +145,23 @@ void TextureManager::CreateTexture()
             break;
         }
     }
-    if (!(flags & Texture::HDR))
+    const GLenum dataType = flags & Texture::HDR ? GL_FLOAT : GL_UNSIGNED_BYTE;
+    //The rows of the small mip levels are not aligned on 4 bytes
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    for (int level = 0; level < image.mipLevels; level++)
     {
-        glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, image.width, image.height, 0, dataFormat, GL_UNSIGNED_BYTE, image.data);
-        glCheckError();
-    }
-    else
-    {
-        glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, image.width, image.height, 0, dataFormat, GL_FLOAT, (float*)image.data);
+        glTexImage2D(GL_TEXTURE_2D, level, internalFormat, image.GetLevelWidth(level), image.GetLevelHeight(level), 0,
+            dataFormat, dataType, image.data + image.GetLevelOffset(level));
         glCheckError();
     }
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
 
 #ifdef EASY_PROFILE_USE
     EASY_END_BLOCK;
 #endif
 
-    if (flags & Texture::MIPMAPS_TEXTURE)
+    //Cooked textures come with their mip chain
+    if (flags & Texture::MIPMAPS_TEXTURE && image.mipLevels == 1)
     {
 #ifdef EASY_PROFILE_USE
         EASY_BLOCK("Generate Mipmaps");
@@ -170,17 +170,23 @@ void TextureManager::CreateTexture()
         glCheckError();
     }
     glBindTexture(GL_TEXTURE_2D, 0);
-    textureMap_[textureId] = {texture, {currentUploadedTexture_.image.width, currentUploadedTexture_.image.height}};
+    currentUploadedTexture_.texture = {texture, {image.width, image.height}};
 
 }
 
 	void TextureManager::Destroy()
 	{
-		for(auto& textureName : textureMap_)
+#ifndef NEKO_SAMETHREAD
+        std::unique_lock<std::mutex> lock(loadedMutex_);
+#endif
+		textures_.ForEach([](LoadedTexture& loadedTexture)
 		{
-            DestroyTexture(textureName.second.name);
-            textureName.second.name = INVALID_TEXTURE_NAME;
-		}
+            DestroyTexture(loadedTexture.texture.name);
+            loadedTexture.texture.name = INVALID_TEXTURE_NAME;
+		});
+#ifndef NEKO_SAMETHREAD
+        lock.unlock();
+#endif
         neko::TextureManager::Destroy();
 	}
 
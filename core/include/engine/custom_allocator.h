@@ -28,6 +28,13 @@
 #include "engine/assert.h"
 #include <imgui.h>
 #include <vector>
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <mutex>
+#include <new>
 
 namespace neko
 {
@@ -89,7 +96,7 @@ public:
 			CalculateAlignForwardAdjustmentWithHeader(address, alignment, headerSize));
 	}
 
-	size_t GetUsedMemory() const
+	virtual size_t GetUsedMemory() const
 	{
 		return usedMemory_;
 	}
@@ -224,6 +231,87 @@ protected:
 	FreeBlock* freeBlocks_ = nullptr;
 };
 
+/**
+ * \brief Two-Level Segregated Fit allocator, allocation and deallocation are O(1) with immediate coalescing.
+ * Free blocks are indexed by a first level (power of two) and a second level (linear subdivision) bitmap.
+ */
+class TlsfAllocator : public Allocator
+{
+public:
+	TlsfAllocator(size_t size, void* start);
+
+	~TlsfAllocator() override
+	{
+		firstBlock_ = nullptr;
+	}
+
+	TlsfAllocator(const TlsfAllocator&) = delete;
+
+	TlsfAllocator& operator=(const TlsfAllocator&) = delete;
+
+	void* Allocate(size_t allocatedSize, size_t alignment) override;
+
+	void Deallocate(void* p) override;
+
+	void Profile() override;
+
+protected:
+	struct BlockHeader
+	{
+		/**
+		 * \brief Previous block in memory, used for coalescing
+		 */
+		BlockHeader* prevPhysBlock = nullptr;
+		/**
+		 * \brief Size of the block payload, the two low bits store the free flags
+		 */
+		size_t size = 0;
+		//Only valid when the block is free, overlapping the payload
+		BlockHeader* nextFree = nullptr;
+		BlockHeader* prevFree = nullptr;
+	};
+
+	static constexpr size_t blockAlignmentLog2 = 4;
+	static constexpr size_t blockAlignment = size_t(1) << blockAlignmentLog2;
+	static constexpr size_t blockHeaderOverhead = blockAlignment;
+	static constexpr size_t minBlockSize = blockAlignment;
+	static constexpr int slIndexCountLog2 = 4;
+	static constexpr int slIndexCount = 1 << slIndexCountLog2;
+	static constexpr int flIndexMax = 38;
+	static constexpr int flIndexShift = slIndexCountLog2 + static_cast<int>(blockAlignmentLog2);
+	static constexpr int flIndexCount = flIndexMax - flIndexShift + 1;
+	static constexpr size_t smallBlockSize = size_t(1) << flIndexShift;
+	static constexpr size_t blockFreeFlag = 1u << 0u;
+	static constexpr size_t blockPrevFreeFlag = 1u << 1u;
+	static_assert(sizeof(BlockHeader*) + sizeof(size_t) <= blockHeaderOverhead, "TLSF block header does not fit in the header overhead");
+	static_assert(sizeof(BlockHeader) <= blockHeaderOverhead + minBlockSize, "TLSF free block links do not fit in the smallest block");
+
+	static size_t GetBlockSize(const BlockHeader* block) { return block->size & ~(blockFreeFlag | blockPrevFreeFlag); }
+	static void SetBlockSize(BlockHeader* block, size_t size);
+	static bool IsFree(const BlockHeader* block) { return block->size & blockFreeFlag; }
+	static void SetFree(BlockHeader* block, bool isFree);
+	static bool IsPrevFree(const BlockHeader* block) { return block->size & blockPrevFreeFlag; }
+	static void SetPrevFree(BlockHeader* block, bool isPrevFree);
+	static void* GetPayload(const BlockHeader* block);
+	static BlockHeader* GetNextPhysBlock(const BlockHeader* block);
+	static size_t AdjustRequestSize(size_t size);
+	static void MappingInsert(size_t size, int& fl, int& sl);
+	static void MappingSearch(size_t size, int& fl, int& sl);
+	/**
+	 * \brief Split the block at size bytes of payload and return the remaining block, flags are set by the caller
+	 */
+	static BlockHeader* SplitBlock(BlockHeader* block, size_t size);
+
+	BlockHeader* LocateFreeBlock(size_t size);
+	void InsertFreeBlock(BlockHeader* block);
+	void RemoveFreeBlock(BlockHeader* block);
+
+	BlockHeader* firstBlock_ = nullptr;
+	std::uint32_t flBitmap_ = 0;
+	std::uint32_t slBitmaps_[flIndexCount]{};
+	BlockHeader* freeBlocks_[flIndexCount][slIndexCount]{};
+};
+
 template<typename T>
 class PoolAllocator : public Allocator
 {
@@ -318,6 +406,333 @@ void PoolAllocator<T>::Profile()
 	}
 }
 
+/**
+ * \brief Index of the calling thread used to select its cache in concurrent allocators.
+ * The index is released when the thread exits and given to the next new thread.
+ */
+std::uint32_t GetThreadCacheIndex();
+
+/**
+ * \brief Allocator keeping per-thread caches, the cache of an exiting thread is flushed before its
+ * index is reused so no memory is stranded in it
+ */
+class ThreadCacheOwner
+{
+public:
+	virtual ~ThreadCacheOwner() = default;
+	/**
+	 * \brief Called on the exiting thread, which owns the cache at this index
+	 */
+	virtual void FlushThreadCache(std::uint32_t threadIndex) = 0;
+};
+
+void RegisterThreadCacheOwner(ThreadCacheOwner* owner);
+void UnregisterThreadCacheOwner(ThreadCacheOwner* owner);
+
+/**
+ * \brief Thread-safe pool allocator, objects can be allocated on one thread and released on another.
+ * Each thread allocates and releases through its own magazine without atomic read-modify-write,
+ * magazines are refilled from and flushed to a shared lock-free stack using tagged indices.
+ * When growth is enabled, chunks of the same capacity are allocated from the heap once the pool is empty.
+ */
+template<typename T>
+class ConcurrentPoolAllocator : public Allocator, public ThreadCacheOwner
+{
+	static_assert(sizeof(T) >= sizeof(std::uint32_t));
+public:
+	static constexpr size_t magazineSize = 32;
+	static constexpr size_t maxThreadNmb = 64;
+	static constexpr size_t maxChunkNmb = 64;
+
+	ConcurrentPoolAllocator(size_t size, void* mem, bool canGrow = false);
+
+	~ConcurrentPoolAllocator() override;
+
+	ConcurrentPoolAllocator(const ConcurrentPoolAllocator&) = delete;
+
+	ConcurrentPoolAllocator& operator=(const ConcurrentPoolAllocator&) = delete;
+
+	void* Allocate(size_t allocatedSize, size_t alignment) override;
+
+	void Deallocate(void* p) override;
+
+	[[nodiscard]] size_t GetUsedMemory() const override;
+
+	[[nodiscard]] size_t GetChunkNmb() const { return chunkNmb_.load(std::memory_order_acquire); }
+
+	void FlushThreadCache(std::uint32_t threadIndex) override;
+
+	void Profile() override;
+protected:
+	static constexpr std::uint32_t invalidIndex = std::numeric_limits<std::uint32_t>::max();
+
+	struct FreeBlock
+	{
+		std::atomic<std::uint32_t> next{ invalidIndex };
+	};
+
+	struct alignas(64) Magazine
+	{
+		std::array<void*, magazineSize> blocks{};
+		size_t count = 0;
+		/**
+		 * \brief Only written by the owning thread, atomic to be read by GetUsedMemory
+		 */
+		std::atomic<std::int64_t> usedMemory{ 0 };
+	};
+
+	void* PopBlock();
+	/**
+	 * \brief Link the blocks together and push them on the shared stack with one CAS
+	 */
+	void PushBlocks(void* const* blocks, size_t count);
+	void PushChain(std::uint32_t firstIndex, FreeBlock* lastBlock);
+	void LinkChunk(size_t chunkIndex);
+	bool Grow();
+	[[nodiscard]] void* GetBlock(std::uint32_t index) const;
+	[[nodiscard]] std::uint32_t GetIndex(const void* p) const;
+
+	size_t chunkCapacity_ = 0;
+	bool canGrow_ = false;
+	std::array<std::atomic<std::uint8_t*>, maxChunkNmb> chunks_{};
+	std::array<void*, maxChunkNmb> grownMemory_{};
+	std::atomic<size_t> chunkNmb_{ 0 };
+	/**
+	 * \brief Top of the shared stack, the high 32 bits are a tag incremented on each change against ABA
+	 */
+	std::atomic<std::uint64_t> head_{ invalidIndex };
+	std::mutex growMutex_;
+	std::array<Magazine, maxThreadNmb> magazines_{};
+	std::atomic<std::int64_t> sharedUsedMemory_{ 0 };
+};
+
+template<typename T>
+ConcurrentPoolAllocator<T>::ConcurrentPoolAllocator(size_t size, void* mem, bool canGrow) :
+	Allocator(size, mem), canGrow_(canGrow)
+{
+	const auto adjustment = CalculateAlignForwardAdjustment(mem, alignof(T));
+	chunkCapacity_ = (size - adjustment) / sizeof(T);
+	neko_assert(chunkCapacity_ > 0, "Concurrent Pool Allocator cannot be empty");
+	neko_assert(chunkCapacity_ * maxChunkNmb < invalidIndex, "Concurrent Pool Allocator is too big to be indexed");
+	chunks_[0].store((std::uint8_t*)((std::uint64_t) mem + adjustment), std::memory_order_relaxed);
+	chunkNmb_.store(1, std::memory_order_release);
+	LinkChunk(0);
+	RegisterThreadCacheOwner(this);
+}
+
+template<typename T>
+ConcurrentPoolAllocator<T>::~ConcurrentPoolAllocator()
+{
+	UnregisterThreadCacheOwner(this);
+	neko_assert(GetUsedMemory() == 0, "Allocator should be emptied before destruction");
+	for (auto* memory : grownMemory_)
+	{
+		std::free(memory);
+	}
+}
+
+template<typename T>
+void* ConcurrentPoolAllocator<T>::Allocate(size_t allocatedSize, [[maybe_unused]] size_t alignment)
+{
+	neko_assert(allocatedSize == sizeof(T) && alignment == alignof(T), "Pool Allocator can only allocate one Object pooled at once");
+	const auto threadIndex = GetThreadCacheIndex();
+	if (threadIndex >= maxThreadNmb)
+	{
+		void* p = PopBlock();
+		neko_assert(p != nullptr, "Concurrent Pool Allocator is full");
+		sharedUsedMemory_.fetch_add(sizeof(T), std::memory_order_relaxed);
+		return p;
+	}
+	Magazine& magazine = magazines_[threadIndex];
+	if (magazine.count == 0)
+	{
+		//Refilling half of the magazine from the shared stack
+		while (magazine.count < magazineSize / 2)
+		{
+			void* block = PopBlock();
+			if (block == nullptr)
+				break;
+			magazine.blocks[magazine.count++] = block;
+		}
+		if (magazine.count == 0)
+		{
+			neko_assert(false, "Concurrent Pool Allocator is full");
+			return nullptr;
+		}
+	}
+	magazine.usedMemory.store(magazine.usedMemory.load(std::memory_order_relaxed) + sizeof(T), std::memory_order_relaxed);
+	return magazine.blocks[--magazine.count];
+}
+
+template<typename T>
+void ConcurrentPoolAllocator<T>::Deallocate(void* p)
+{
+	neko_assert(p != nullptr, "Concurrent Pool Allocator cannot deallocate nullptr");
+	const auto threadIndex = GetThreadCacheIndex();
+	if (threadIndex >= maxThreadNmb)
+	{
+		PushBlocks(&p, 1);
+		sharedUsedMemory_.fetch_sub(sizeof(T), std::memory_order_relaxed);
+		return;
+	}
+	Magazine& magazine = magazines_[threadIndex];
+	if (magazine.count == magazineSize)
+	{
+		//Flushing the oldest half of the magazine to the shared stack
+		constexpr size_t flushCount = magazineSize / 2;
+		PushBlocks(magazine.blocks.data(), flushCount);
+		std::move(magazine.blocks.begin() + flushCount, magazine.blocks.end(), magazine.blocks.begin());
+		magazine.count -= flushCount;
+	}
+	magazine.blocks[magazine.count++] = p;
+	magazine.usedMemory.store(magazine.usedMemory.load(std::memory_order_relaxed) - sizeof(T), std::memory_order_relaxed);
+}
+
+template<typename T>
+void ConcurrentPoolAllocator<T>::FlushThreadCache(std::uint32_t threadIndex)
+{
+	if (threadIndex >= maxThreadNmb)
+		return;
+	Magazine& magazine = magazines_[threadIndex];
+	if (magazine.count > 0)
+	{
+		PushBlocks(magazine.blocks.data(), magazine.count);
+		magazine.count = 0;
+	}
+}
+
+template<typename T>
+size_t ConcurrentPoolAllocator<T>::GetUsedMemory() const
+{
+	//Blocks can be released by another thread than the one allocating them, only the sum is meaningful
+	std::int64_t usedMemory = sharedUsedMemory_.load(std::memory_order_relaxed);
+	for (const auto& magazine : magazines_)
+	{
+		usedMemory += magazine.usedMemory.load(std::memory_order_relaxed);
+	}
+	return usedMemory > 0 ? static_cast<size_t>(usedMemory) : 0;
+}
+
+template<typename T>
+void ConcurrentPoolAllocator<T>::Profile()
+{
+	ImGui::LabelText("Type", "Concurrent Pool Allocator");
+	ImGui::Text("Chunks: %zu", GetChunkNmb());
+	ImGui::Text("Used Memory: %zuB for chunk size: %zuB", GetUsedMemory(), chunkCapacity_ * sizeof(T));
+}
+
+template<typename T>
+void* ConcurrentPoolAllocator<T>::PopBlock()
+{
+	auto head = head_.load(std::memory_order_acquire);
+	while (true)
+	{
+		const auto index = static_cast<std::uint32_t>(head);
+		if (index == invalidIndex)
+		{
+			if (!canGrow_ || !Grow())
+				return nullptr;
+			head = head_.load(std::memory_order_acquire);
+			continue;
+		}
+		auto* block = static_cast<FreeBlock*>(GetBlock(index));
+		//The block might be popped and reused concurrently, the tag makes the CAS fail in that case
+		const auto next = block->next.load(std::memory_order_relaxed);
+		const std::uint64_t newHead = (((head >> 32u) + 1u) << 32u) | next;
+		if (head_.compare_exchange_weak(head, newHead, std::memory_order_acq_rel, std::memory_order_acquire))
+		{
+			return block;
+		}
+	}
+}
+
+template<typename T>
+void ConcurrentPoolAllocator<T>::PushBlocks(void* const* blocks, size_t count)
+{
+	FreeBlock* block = new(blocks[0]) FreeBlock();
+	for (size_t i = 1; i < count; i++)
+	{
+		block->next.store(GetIndex(blocks[i]), std::memory_order_relaxed);
+		block = new(blocks[i]) FreeBlock();
+	}
+	PushChain(GetIndex(blocks[0]), block);
+}
+
+template<typename T>
+void ConcurrentPoolAllocator<T>::PushChain(std::uint32_t firstIndex, FreeBlock* lastBlock)
+{
+	auto head = head_.load(std::memory_order_relaxed);
+	std::uint64_t newHead = 0;
+	do
+	{
+		lastBlock->next.store(static_cast<std::uint32_t>(head), std::memory_order_relaxed);
+		newHead = (((head >> 32u) + 1u) << 32u) | firstIndex;
+	} while (!head_.compare_exchange_weak(head, newHead, std::memory_order_release, std::memory_order_relaxed));
+}
+
+template<typename T>
+void ConcurrentPoolAllocator<T>::LinkChunk(size_t chunkIndex)
+{
+	const auto firstIndex = static_cast<std::uint32_t>(chunkIndex * chunkCapacity_);
+	FreeBlock* block = new(GetBlock(firstIndex)) FreeBlock();
+	for (std::uint32_t i = 1; i < chunkCapacity_; i++)
+	{
+		block->next.store(firstIndex + i, std::memory_order_relaxed);
+		block = new(GetBlock(firstIndex + i)) FreeBlock();
+	}
+	PushChain(firstIndex, block);
+}
+
+template<typename T>
+bool ConcurrentPoolAllocator<T>::Grow()
+{
+	std::lock_guard<std::mutex> lock(growMutex_);
+	if (static_cast<std::uint32_t>(head_.load(std::memory_order_acquire)) != invalidIndex)
+	{
+		//Another thread already grew the pool
+		return true;
+	}
+	const auto chunkIndex = chunkNmb_.load(std::memory_order_relaxed);
+	if (chunkIndex == maxChunkNmb)
+	{
+		return false;
+	}
+	void* memory = std::malloc(chunkCapacity_ * sizeof(T) + alignof(T));
+	if (memory == nullptr)
+	{
+		return false;
+	}
+	grownMemory_[chunkIndex] = memory;
+	chunks_[chunkIndex].store(static_cast<std::uint8_t*>(AlignForward(memory, alignof(T))), std::memory_order_release);
+	chunkNmb_.store(chunkIndex + 1, std::memory_order_release);
+	LinkChunk(chunkIndex);
+	return true;
+}
+
+template<typename T>
+void* ConcurrentPoolAllocator<T>::GetBlock(std::uint32_t index) const
+{
+	std::uint8_t* chunk = chunks_[index / chunkCapacity_].load(std::memory_order_acquire);
+	return chunk + (index % chunkCapacity_) * sizeof(T);
+}
+
+template<typename T>
+std::uint32_t ConcurrentPoolAllocator<T>::GetIndex(const void* p) const
+{
+	const auto chunkNmb = GetChunkNmb();
+	for (size_t chunkIndex = 0; chunkIndex < chunkNmb; chunkIndex++)
+	{
+		const std::uint8_t* chunk = chunks_[chunkIndex].load(std::memory_order_acquire);
+		const auto offset = (std::uint64_t) p - (std::uint64_t) chunk;
+		if (p >= chunk && offset < chunkCapacity_ * sizeof(T))
+		{
+			return static_cast<std::uint32_t>(chunkIndex * chunkCapacity_ + offset / sizeof(T));
+		}
+	}
+	neko_assert(false, "Concurrent Pool Allocator does not own this pointer");
+	return invalidIndex;
+}
+
 class ProxyAllocator : public Allocator
 {
 public:
@@ -337,4 +752,65 @@ public:
 protected:
 	Allocator& allocator_;
 };
+
+/**
+ * \brief STL-compatible allocator adapter forwarding to a neko Allocator,
+ * so engine containers can be backed by a preallocated arena.
+ * The underlying Allocator needs to outlive every container using it.
+ * An exhausted arena aborts, there is no exception to report it to the container.
+ */
+template<typename T>
+class StlAllocator
+{
+public:
+	using value_type = T;
+
+	explicit StlAllocator(Allocator& allocator) noexcept : allocator_(&allocator)
+	{
+	}
+
+	template<typename U>
+	StlAllocator(const StlAllocator<U>& other) noexcept : allocator_(&other.GetAllocator())
+	{
+	}
+
+	T* allocate(std::size_t n)
+	{
+		void* p = allocator_->Allocate(n * sizeof(T), alignof(T));
+		if (p == nullptr)
+		{
+			std::cerr << "[Error] StlAllocator: the allocator has no room for " << n * sizeof(T) << " bytes\n";
+			std::abort();
+		}
+		return static_cast<T*>(p);
+	}
+
+	void deallocate(T* p, [[maybe_unused]] std::size_t n)
+	{
+		allocator_->Deallocate(p);
+	}
+
+	[[nodiscard]] Allocator& GetAllocator() const noexcept
+	{
+		return *allocator_;
+	}
+
+private:
+	Allocator* allocator_ = nullptr;
+};
+
+template<typename T, typename U>
+bool operator==(const StlAllocator<T>& lhs, const StlAllocator<U>& rhs) noexcept
+{
+	return &lhs.GetAllocator() == &rhs.GetAllocator();
+}
+
+template<typename T, typename U>
+bool operator!=(const StlAllocator<T>& lhs, const StlAllocator<U>& rhs) noexcept
+{
+	return !(lhs == rhs);
+}
+
+template<typename T>
+using AllocatorVector = std::vector<T, StlAllocator<T>>;
 }
\ No newline at end of file
@@ -28,7 +28,10 @@
 #include <utilities/action_utility.h>
 #include <graphics/color.h>
 #include <utilities/time_utility.h>
+#include <utilities/asset_archive.h>
+#include <utilities/asset_database.h>
 #include <mathematics/vector.h>
+#include <engine/memory_budget.h>
 
 #include "jobsystem.h"
 
@@ -56,6 +59,17 @@ struct Configuration
 #else
     std::string dataRootPath = "../../data/";
 #endif
+    //Asset archive packed from dataRootPath by the asset_packer, loose files are used when empty
+    std::string dataArchivePath = "";
+    //Asset database written by the asset_packer, the .meta files are parsed on first load without it
+    std::string assetDatabasePath = "";
+    //Folder of the cooked textures, the textures are cooked on their first load, decoded every time when empty
+    std::string textureCachePath = "";
+    //Folder of the cooked models, the models are cooked after their first import, imported every time when empty
+    std::string modelCachePath = "";
+    //Per subsystem memory accounting, shown in the Memory Budgets window and logged at the period when positive
+    bool trackMemoryBudgets = false;
+    float memoryBudgetLogPeriod = 0.0f;
 };
 
 
@@ -90,6 +104,7 @@ public:
     static BasicEngine* GetInstance(){return instance_;}
 
     void ScheduleJob(Job* job, JobThreadType threadType);
+    bool CancelJob(const Job* job, JobThreadType threadType);
     //template <typename T = BasicEngine>
     //static T* GetInstance(){ return dynamic_cast<T*>(instance_);};
 protected:
@@ -97,6 +112,9 @@ protected:
     Renderer* renderer_ = nullptr;
     Window* window_ = nullptr;
     JobSystem jobSystem_;
+    AssetArchive assetArchive_;
+    AssetDatabase assetDatabase_;
+    MemoryBudgetManager memoryBudgetManager_;
 	bool isRunning_;
     float dt_ = 0.0f;
     Action<> initAction_;
@@ -106,4 +124,11 @@ protected:
 
 };
 
+/**
+ * \brief Runs func(task) for the tasks [0, taskCount) on the OTHER_THREAD workers and the calling thread,
+ * which takes the tasks nobody started. It can be called from a job: the helper jobs still queued when the
+ * caller runs out of tasks are cancelled instead of waited for. Without engine, the tasks run in order
+ * on the calling thread.
+ */
+void RunParallelTasks(std::size_t taskCount, const std::function<void(std::size_t)>& func);
 }
@@ -133,6 +133,11 @@ public:
     void SetDirty(Entity entity);
 
     void UpdateDirtyEntities();
+    /**
+     * \brief Adds the children of the dirty entities and swaps the dirty list into dirtyEntities,
+     * for managers that update their dirty components in batch instead of one callback per entity
+     */
+    void PopDirtyEntities(std::vector<Entity>& dirtyEntities);
 	
     template<typename T, EntityMask componentType>
     void RegisterComponentManager(ComponentManager<T, componentType>* componentManager)
@@ -146,6 +151,7 @@ private:
     std::reference_wrapper<EntityManager> entityManager_;
     Action<Entity> updateDirtyEntity;
     std::vector<Entity> dirtyEntities_;
+    std::vector<Entity> updatedEntities_;
 };
 
 class OnChangeParentInterface
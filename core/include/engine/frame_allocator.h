@@ -0,0 +1,114 @@
+#pragma once
+
+/*
+ MIT License
+
+ Copyright (c) 2020 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#include <array>
+#include <atomic>
+#include <vector>
+#include "engine/custom_allocator.h"
+
+namespace neko
+{
+
+/**
+ * \brief Linear allocator used as one frame buffer, Deallocate does nothing
+ * as the memory is only reclaimed when the frame is reset
+ */
+class FrameLinearAllocator : public LinearAllocator
+{
+public:
+	using LinearAllocator::LinearAllocator;
+
+	~FrameLinearAllocator() override
+	{
+		Clear();
+	}
+
+	void Deallocate(void* p) override;
+
+	/**
+	 * \brief Clear the frame, in debug the freed memory is poisoned to catch dangling use
+	 */
+	void Reset();
+};
+
+/**
+ * \brief Double-buffered linear arena owned by one thread.
+ * Allocations made during frame N stay valid during frame N+1 and are reclaimed at the start of frame N+2.
+ * Use FrameAllocator::Get() to access the arena of the calling thread.
+ */
+class FrameAllocator
+{
+public:
+	static constexpr size_t frameSize = 1u << 20u;
+	static constexpr std::uint8_t poisonValue = 0xDD;
+
+	explicit FrameAllocator(size_t size = frameSize);
+
+	FrameAllocator(const FrameAllocator&) = delete;
+
+	FrameAllocator& operator=(const FrameAllocator&) = delete;
+
+	void* Allocate(size_t allocatedSize, size_t alignment);
+
+	/**
+	 * \brief Allocator of the current frame, can be given to a StlAllocator
+	 */
+	Allocator& GetCurrentAllocator();
+
+	[[nodiscard]] std::uint32_t GetFrameIndex() const { return frameIndex_; }
+
+	/**
+	 * \brief Frame arena of the calling thread, created on first use
+	 */
+	static FrameAllocator& Get();
+
+	/**
+	 * \brief Frame boundary, called once per frame by the BasicEngine.
+	 * Each thread swaps its arena lazily on its next access so no thread touches another one's memory.
+	 */
+	static void NewFrame();
+
+	[[nodiscard]] static std::uint32_t GetGlobalFrameIndex() { return globalFrameIndex_.load(std::memory_order_acquire); }
+
+private:
+	void SyncFrame();
+
+	static std::atomic<std::uint32_t> globalFrameIndex_;
+
+	std::vector<std::uint8_t> memory_;
+	std::array<FrameLinearAllocator, 2> frames_;
+	std::uint32_t frameIndex_ = 0;
+};
+
+/**
+ * \brief StlAllocator bound to the frame arena of the calling thread
+ */
+template<typename T>
+StlAllocator<T> GetFrameStlAllocator()
+{
+	return StlAllocator<T>(FrameAllocator::Get().GetCurrentAllocator());
+}
+}
@@ -42,4 +42,29 @@ typedef float v4f __attribute__ ((vector_size (16)));
 typedef float v4f __attribute__ ((vector_size (16)));
 #endif
 
+#include <cstdint>
 
+namespace neko
+{
+/**
+ * \brief Widest vector instruction set usable by runtime-dispatched kernels, ordered from narrowest to widest on x86.
+ */
+enum class SimdLevel : std::uint8_t
+{
+	SCALAR = 0,
+	SSE4,
+	AVX2,
+	AVX512,
+	NEON,
+};
+
+/**
+ * \brief Queries the CPU (CPUID on x86) once and returns the widest supported level.
+ * AVX2 implies FMA support and the OS saving the extended register state.
+ */
+SimdLevel GetCpuSimdLevel();
+
+bool IsSimdLevelSupported(SimdLevel level);
+
+const char* GetSimdLevelName(SimdLevel level);
+}
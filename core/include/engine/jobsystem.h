@@ -29,7 +29,7 @@
 #include <future>
 #include <condition_variable>
 #endif
-#include <queue>
+#include <deque>
 #include "engine/system.h"
 
 namespace neko
@@ -108,7 +108,7 @@ struct JobQueue
     std::mutex mutex_;
     std::condition_variable cv_;
 #endif
-    std::queue<Job*> jobs_;
+    std::deque<Job*> jobs_;
 };
 
 class JobSystem : SystemInterface
@@ -123,6 +123,10 @@ public:
     JobSystem();
     ~JobSystem() override;
     void ScheduleJob(Job* func, JobThreadType threadType);
+    /**
+     * \brief Takes back a scheduled job that no worker picked yet, false when it already left the queue
+     */
+    bool CancelJob(const Job* job, JobThreadType threadType);
     void Init() override;
 
     void Update([[maybe_unused]]seconds dt) override{}
@@ -0,0 +1,201 @@
+#pragma once
+
+/*
+ MIT License
+
+ Copyright (c) 2020 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "engine/custom_allocator.h"
+#include "engine/system.h"
+#include "utilities/service_locator.h"
+#include "utilities/time_utility.h"
+
+namespace neko
+{
+
+/**
+ * \brief Engine subsystems owning a memory budget
+ */
+enum class MemoryTag : std::uint8_t
+{
+	ROLLBACK,
+	TEXTURE,
+	MESH,
+	OTHER,
+	LENGTH
+};
+
+constexpr std::array<std::string_view, static_cast<size_t>(MemoryTag::LENGTH)> memoryTagNames =
+{
+	"Rollback",
+	"Texture",
+	"Mesh",
+	"Other"
+};
+
+struct MemoryTagStats
+{
+	std::string_view name;
+	size_t budget = 0;
+	size_t currentMemory = 0;
+	size_t peakMemory = 0;
+	size_t allocationNmb = 0;
+	/**
+	 * \brief Allocations per second since the previous snapshot
+	 */
+	float allocationRate = 0.0f;
+};
+
+using MemoryBudgetSnapshot = std::array<MemoryTagStats, static_cast<size_t>(MemoryTag::LENGTH)>;
+
+class MemoryBudgetManagerInterface
+{
+public:
+	virtual ~MemoryBudgetManagerInterface() = default;
+	/**
+	 * \brief Record an allocation of size bytes, site is only kept in debug builds and can be nullptr
+	 */
+	virtual void RecordAllocation(MemoryTag tag, const void* p, size_t size, const char* site = nullptr) = 0;
+	virtual void RecordDeallocation(MemoryTag tag, const void* p, size_t size) = 0;
+};
+
+class NullMemoryBudgetManager final : public MemoryBudgetManagerInterface
+{
+public:
+	void RecordAllocation([[maybe_unused]] MemoryTag tag, [[maybe_unused]] const void* p,
+		[[maybe_unused]] size_t size, [[maybe_unused]] const char* site = nullptr) override {}
+	void RecordDeallocation([[maybe_unused]] MemoryTag tag, [[maybe_unused]] const void* p,
+		[[maybe_unused]] size_t size) override {}
+};
+
+/**
+ * \brief Thread-safe memory accounting per subsystem with named budgets.
+ * Registered as a System, it takes a stats snapshot at a fixed period and sends it to the snapshot callback.
+ */
+class MemoryBudgetManager : public MemoryBudgetManagerInterface, public SystemInterface, public DrawImGuiInterface
+{
+public:
+	using OverrunCallback = std::function<void(MemoryTag tag, size_t currentMemory, size_t budget)>;
+	using SnapshotCallback = std::function<void(const MemoryBudgetSnapshot& snapshot)>;
+
+	MemoryBudgetManager();
+
+	void Init() override;
+	void Update(seconds dt) override;
+	void Destroy() override;
+	void DrawImGui() override;
+
+	void RecordAllocation(MemoryTag tag, const void* p, size_t size, const char* site = nullptr) override;
+	void RecordDeallocation(MemoryTag tag, const void* p, size_t size) override;
+
+	/**
+	 * \brief Set the budget of a subsystem in bytes, 0 means no budget
+	 */
+	void SetBudget(MemoryTag tag, size_t budget);
+	/**
+	 * \brief Called on the allocating thread when a subsystem goes over its budget
+	 */
+	void SetOverrunCallback(OverrunCallback callback) { overrunCallback_ = std::move(callback); }
+	void SetSnapshotCallback(seconds period, SnapshotCallback callback);
+
+	[[nodiscard]] MemoryTagStats GetStats(MemoryTag tag) const;
+	/**
+	 * \brief Current stats of all subsystems, allocation rates are computed since the previous snapshot
+	 */
+	MemoryBudgetSnapshot TakeSnapshot();
+	/**
+	 * \brief Live memory per allocation site of a subsystem, only filled in debug builds
+	 */
+	[[nodiscard]] std::unordered_map<std::string_view, size_t> GetAllocationSites(MemoryTag tag) const;
+private:
+	struct TagCounters
+	{
+		std::atomic<size_t> budget{ 0 };
+		std::atomic<size_t> currentMemory{ 0 };
+		std::atomic<size_t> peakMemory{ 0 };
+		std::atomic<size_t> allocationNmb{ 0 };
+		size_t lastSnapshotAllocationNmb = 0;
+	};
+	std::array<TagCounters, static_cast<size_t>(MemoryTag::LENGTH)> counters_{};
+	OverrunCallback overrunCallback_;
+	SnapshotCallback snapshotCallback_;
+	Timer snapshotTimer_{ seconds(0.0f), seconds(0.0f) };
+	std::mutex snapshotMutex_;
+	std::chrono::steady_clock::time_point lastSnapshotTime_;
+#ifdef __neko_dbg__
+	struct LiveAllocation
+	{
+		MemoryTag tag = MemoryTag::OTHER;
+		size_t size = 0;
+		std::string_view site;
+	};
+	mutable std::mutex siteMutex_;
+	std::unordered_map<const void*, LiveAllocation> liveAllocations_;
+#endif
+};
+
+using MemoryBudgetLocator = Locator<MemoryBudgetManagerInterface, NullMemoryBudgetManager>;
+
+/**
+ * \brief One line per subsystem with a current memory, for the periodic snapshot logs
+ */
+std::string FormatMemoryBudgetSnapshot(const MemoryBudgetSnapshot& snapshot);
+
+/**
+ * \brief Proxy allocator reporting the memory used by its allocator to the subsystem budget
+ */
+class TaggedAllocator : public ProxyAllocator
+{
+public:
+	TaggedAllocator(Allocator& allocator, MemoryTag tag) : ProxyAllocator(allocator), tag_(tag)
+	{
+	}
+
+	void* Allocate(size_t allocatedSize, size_t alignment) override;
+
+	/**
+	 * \brief Allocate and record the allocation site, use NEKO_ALLOCATION_SITE as site
+	 */
+	void* AllocateFrom(size_t allocatedSize, size_t alignment, const char* site);
+
+	void Deallocate(void* p) override;
+
+	void Profile() override;
+
+	[[nodiscard]] MemoryTag GetTag() const { return tag_; }
+protected:
+	MemoryTag tag_;
+};
+
+#define NEKO_ALLOCATION_SITE_STR(x) #x
+#define NEKO_ALLOCATION_SITE_LINE(x) NEKO_ALLOCATION_SITE_STR(x)
+#define NEKO_ALLOCATION_SITE __FILE__ ":" NEKO_ALLOCATION_SITE_LINE(__LINE__)
+}
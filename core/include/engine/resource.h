@@ -24,7 +24,10 @@
  SOFTWARE.
  */
 
-#include <map>
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <vector>
 #include "sole.hpp"
 #include "utilities/json_utility.h"
 #include "utilities/file_utility.h"
@@ -32,6 +35,9 @@
 namespace neko
 {
 
+/**
+ * \brief Serialized identifier of a resource, the runtime accesses go through a ResourceHandle
+ */
 using ResourceId = sole::uuid;
 const ResourceId INVALID_RESOURCE_ID = sole::uuid();
 
@@ -49,25 +55,157 @@ struct Resource
     std::string assetPath;
 };
 
+/**
+ * \brief Index of a slot in a ResourceTable, the generation detects a handle to a removed resource
+ * whose slot was reused since. The default handle is never valid.
+ */
+template<class T>
+struct ResourceHandle
+{
+    std::uint32_t index = std::numeric_limits<std::uint32_t>::max();
+    std::uint32_t generation = 0;
+
+    bool operator==(const ResourceHandle& other) const
+    {
+        return index == other.index && generation == other.generation;
+    }
+    bool operator!=(const ResourceHandle& other) const
+    {
+        return !(*this == other);
+    }
+};
+
+/**
+ * \brief Dense array of resources addressed by generational handles, lookups are an index and a compare.
+ * Removed slots are reused with a new generation. The handles are typed by HandleT when the stored
+ * value wraps the resource. Not thread safe.
+ */
+template<class T, class HandleT = T>
+class ResourceTable
+{
+public:
+    using Handle = ResourceHandle<HandleT>;
+
+    Handle Add(T&& value)
+    {
+        std::uint32_t index;
+        if (!freeSlots_.empty())
+        {
+            index = freeSlots_.back();
+            freeSlots_.pop_back();
+        }
+        else
+        {
+            index = static_cast<std::uint32_t>(slots_.size());
+            slots_.emplace_back();
+        }
+        auto& slot = slots_[index];
+        slot.value = std::move(value);
+        slot.isAlive = true;
+        return { index, slot.generation };
+    }
+
+    bool Remove(Handle handle)
+    {
+        if (!IsValid(handle))
+        {
+            return false;
+        }
+        ReleaseSlot(handle.index);
+        return true;
+    }
+    /**
+     * \brief Removes all the resources, the handles given before stay invalid
+     */
+    void Clear()
+    {
+        for (std::uint32_t index = 0; index < slots_.size(); index++)
+        {
+            if (slots_[index].isAlive)
+            {
+                ReleaseSlot(index);
+            }
+        }
+    }
+
+    [[nodiscard]] bool IsValid(Handle handle) const
+    {
+        return handle.index < slots_.size() && slots_[handle.index].generation == handle.generation &&
+            slots_[handle.index].isAlive;
+    }
+
+    [[nodiscard]] T* Get(Handle handle)
+    {
+        return IsValid(handle) ? &slots_[handle.index].value : nullptr;
+    }
+
+    [[nodiscard]] const T* Get(Handle handle) const
+    {
+        return IsValid(handle) ? &slots_[handle.index].value : nullptr;
+    }
+
+    [[nodiscard]] size_t Size() const { return slots_.size() - freeSlots_.size(); }
+
+    template<class Func>
+    void ForEach(Func func)
+    {
+        for (auto& slot : slots_)
+        {
+            if (slot.isAlive)
+            {
+                func(slot.value);
+            }
+        }
+    }
+private:
+    struct Slot
+    {
+        T value{};
+        //Starts at 1 so that the default handle is invalid
+        std::uint32_t generation = 1;
+        bool isAlive = false;
+    };
+
+    void ReleaseSlot(std::uint32_t index)
+    {
+        auto& slot = slots_[index];
+        slot.value = T{};
+        slot.isAlive = false;
+        slot.generation = slot.generation == std::numeric_limits<std::uint32_t>::max() ? 1 : slot.generation + 1;
+        freeSlots_.push_back(index);
+    }
+
+    std::vector<Slot> slots_;
+    std::vector<std::uint32_t> freeSlots_;
+};
+
 template<class T=Resource>
 class ResourceManager
 {
-    const T* GetResource(ResourceId resourceId)
+public:
+    using Handle = ResourceHandle<T>;
+
+    const T* GetResource(Handle resourceHandle) const
+    {
+        return resources_.Get(resourceHandle);
+    }
+
+    Handle GetResourceHandle(ResourceId resourceId) const
     {
-        const auto resourcePair = resourceMap_.find(resourceId);
-        if (resourcePair != resourceMap_.end())
+        const auto it = resourceHandles_.find(resourceId);
+        if (it != resourceHandles_.end())
         {
-            return resourcePair->second;
+            return it->second;
         }
-        return nullptr;
+        return {};
     }
 
-    ResourceId LoadResource(const std::string_view assetPath)
+    Handle LoadResource(const std::string_view assetPath)
     {
         const std::string resourceMetaPath = std::string(assetPath.data()) + resourceMetafile_.data();
         const json resourceMetaJson = LoadJson(assetPath);
         const auto resourceId = LoadResource(resourceMetaJson);
-        return resourceId;
+        return GetResourceHandle(resourceId);
     }
 
 protected:
@@ -75,8 +213,8 @@ protected:
 
     virtual ResourceId LoadResource(const json& resoureceMetaJson) = 0;
 
-    std::map<ResourceId, T> resourceMap_;
-    std::map<ResourceId, std::string> resourcePathMap_;
+    ResourceTable<T> resources_;
+    std::unordered_map<ResourceId, Handle> resourceHandles_;
 };
 
 template<class T>
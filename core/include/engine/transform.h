@@ -30,6 +30,7 @@
 #include "graphics/graphics.h"
 #include "mathematics/vector.h"
 #include "mathematics/quaternion.h"
+#include "mathematics/affine2d.h"
 
 namespace neko
 {
@@ -60,9 +61,11 @@ class Position3dManager : public ComponentManager<Vec3f, EntityMask(ComponentTyp
 };
 
 
-class Rotation3dManager : public ComponentManager<EulerAngles, EntityMask(ComponentType::ROTATION3D)>
+class Rotation3dManager : public ComponentManager<Quaternion, EntityMask(ComponentType::ROTATION3D)>
 {
+public:
     using ComponentManager::ComponentManager;
+    void AddComponent(Entity entity) override;
 };
 
 class Scale3dManager : public ComponentManager<Vec3f, EntityMask(ComponentType::SCALE3D)>
@@ -83,8 +86,11 @@ protected:
     virtual void UpdateTransform(Entity entity) = 0;
 };
 
+/**
+ * \brief Stores the 2D world transforms as 2x3 Affine2f, use Affine2f::ToMat4 when uploading them
+ */
 class Transform2dManager :
-        public ComponentManager<Mat4f, EntityMask(ComponentType::TRANSFORM2D)>,
+        public ComponentManager<Affine2f, EntityMask(ComponentType::TRANSFORM2D)>,
         public TransformManagerInterface
 {
 public:
@@ -95,6 +101,11 @@ public:
     [[nodiscard]] Vec2f GetPosition(Entity entity) const;
     [[nodiscard]] Vec2f GetScale(Entity entity) const;
     [[nodiscard]] degree_t GetRotation(Entity entity) const;
+    /**
+     * \brief Copies the local and world transforms of an entity from another manager sharing the same entities,
+     * without going through the dirty entities
+     */
+    void CopyTransform(Entity entity, const Transform2dManager& other);
     void OnChangeParent(Entity entity, Entity newParent, Entity oldParent) override;
     void UpdateDirtyComponent(Entity entity) override;
     void Update() override;
@@ -118,10 +129,15 @@ public:
     void Init();
     void SetPosition(Entity entity, Vec3f position);
     void SetScale(Entity entity, Vec3f scale);
+    /**
+     * \brief Euler angles are converted to a quaternion, kept for the editor and the scene setup
+     */
     void SetRotation(Entity entity, EulerAngles angles);
+    void SetRotation(Entity entity, const Quaternion& rotation);
     [[nodiscard]]Vec3f GetPosition(Entity entity) const;
     [[nodiscard]] Vec3f GetScale(Entity entity) const;
     [[nodiscard]] EulerAngles GetAngles(Entity entity) const;
+    [[nodiscard]] const Quaternion& GetRotation(Entity entity) const;
     void OnChangeParent(Entity entity, Entity newParent, Entity oldParent) override;
 	/**
 	 * \brief This function is called by the Dirty Manager
@@ -132,10 +148,19 @@ public:
 protected:
 
     void UpdateTransform(Entity entity) override;
+    /**
+     * \brief Builds the local TRS matrices of all the dirty entities with ComposeTrsBatch, then applies the parents
+     */
+    void UpdateTransforms(const std::vector<Entity>& entities);
     Position3dManager position3DManager_;
     Scale3dManager scale3DManager_;
     Rotation3dManager rotation3DManager_;
     DirtyManager dirtyManager_;
+
+    std::vector<Entity> dirtyEntities_;
+    //Structure of arrays input of ComposeTrsBatch, ten blocks of dirtyEntities_.size() floats
+    std::vector<float> trsBuffer_;
+    std::vector<Mat4f> localTransforms_;
 };
 
 class Transform3dViewer : public DrawImGuiInterface
@@ -0,0 +1,152 @@
+#pragma once
+/*
+ MIT License
+
+ Copyright (c) 2020 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "mathematics/circle.h"
+#include "mathematics/vector.h"
+#include "utilities/file_utility.h"
+
+namespace neko
+{
+/**
+ * \brief Interleaved vertex of the model meshes, the cooked models store it as is
+ */
+struct MeshVertex
+{
+    Vec3f position;
+    Vec3f normal;
+    Vec2f texCoords;
+    Vec3f tangent;
+    Vec3f bitangent;
+};
+static_assert(sizeof(MeshVertex) == 14 * sizeof(float), "Mesh vertex must be tightly packed");
+
+/**
+ * \brief Cooked model file header, followed by the mesh entries, the texture entries, the string table,
+ * the vertex blobs and the index blobs. The offsets are from the start of the file.
+ */
+struct CookedModelHeader
+{
+    static constexpr std::array<char, 8> identifierValue = {'N', 'E', 'K', 'O', 'M', 'S', 'H', '\n'};
+    std::array<char, 8> identifier = identifierValue;
+    std::uint32_t version = 0;
+    std::uint32_t meshCount = 0;
+    std::uint32_t textureCount = 0;
+    std::uint32_t stringTableByteLength = 0;
+    std::uint64_t stringTableOffset = 0;
+};
+static_assert(sizeof(CookedModelHeader) == 32, "Cooked model header must be 32 bytes");
+
+struct CookedMeshEntry
+{
+    std::uint64_t vertexOffset = 0;
+    std::uint64_t indexOffset = 0;
+    std::uint32_t vertexCount = 0;
+    std::uint32_t indexCount = 0;
+    std::uint32_t firstTexture = 0;
+    std::uint32_t textureCount = 0;
+    Vec3f aabbMin;
+    Vec3f aabbMax;
+    Sphere boundingSphere{};
+    float specularExponent = 0.0f;
+    std::uint32_t padding = 0;
+};
+static_assert(sizeof(CookedMeshEntry) == 80, "Cooked mesh entry must be 80 bytes");
+
+struct CookedMeshTexture
+{
+    //In the string table, relative to the folder of the model
+    std::uint32_t pathOffset = 0;
+    std::uint32_t pathLength = 0;
+    std::uint32_t type = 0;
+    std::uint32_t padding = 0;
+};
+
+/**
+ * \brief Mesh given to WriteCookedModel, the vertices and indices are not copied
+ */
+struct CookedMeshSource
+{
+    struct TextureSource
+    {
+        std::string path;
+        std::uint32_t type = 0;
+    };
+    const MeshVertex* vertices = nullptr;
+    size_t vertexCount = 0;
+    const std::uint32_t* indices = nullptr;
+    size_t indexCount = 0;
+    std::vector<TextureSource> textures;
+    float specularExponent = 0.0f;
+};
+
+/**
+ * \brief Writes the meshes in the cooked model format, the bounds are computed from the vertices
+ */
+bool WriteCookedModel(std::string_view path, const std::vector<CookedMeshSource>& meshes);
+
+/**
+ * \brief Memory-mapped cooked model, the meshes point in the mapping until Destroy
+ */
+class CookedModel
+{
+public:
+    static constexpr std::string_view cookedExtension = ".nmesh";
+    //Bumped when the layout changes, old cooked files are then ignored
+    static constexpr std::uint32_t formatVersion = 1;
+
+    struct MeshView
+    {
+        const CookedMeshEntry* entry = nullptr;
+        const MeshVertex* vertices = nullptr;
+        const std::uint32_t* indices = nullptr;
+        const CookedMeshTexture* textures = nullptr;
+    };
+
+    /**
+     * \brief Maps the file and checks that every offset is inside it and every index inside its mesh,
+     * false on a missing or invalid file
+     */
+    bool Load(std::string_view path);
+    void Destroy();
+    [[nodiscard]] bool IsLoaded() const { return file_.dataBuffer != nullptr; }
+    [[nodiscard]] size_t GetMeshCount() const { return meshes_.size(); }
+    [[nodiscard]] const MeshView& GetMesh(size_t index) const { return meshes_[index]; }
+    [[nodiscard]] std::string_view GetTexturePath(const CookedMeshTexture& texture) const;
+    /**
+     * \brief Path of the cooked model in the cache folder, keyed by the content hash of the source model
+     */
+    [[nodiscard]] static std::string GetCookedPath(std::string_view cacheFolder, const BufferFile& sourceFile);
+private:
+    BufferFile file_;
+    std::vector<MeshView> meshes_;
+    const char* stringTable_ = nullptr;
+};
+}
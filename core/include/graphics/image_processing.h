@@ -0,0 +1,73 @@
+#pragma once
+/*
+ MIT License
+
+ Copyright (c) 2020 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+#include <cstddef>
+#include <cstdint>
+
+#include "graphics/texture.h"
+
+namespace neko
+{
+enum class MipFilter : std::uint8_t
+{
+    //2x2 average
+    BOX,
+    //6x6 Kaiser windowed sinc, sharper than the box filter with less aliasing
+    KAISER
+};
+
+/**
+ * \brief Number of levels of a full mip chain down to 1x1
+ */
+int GetMipLevelCount(int width, int height);
+/**
+ * \brief Halves a 8-bit or float level of nbChannels interleaved channels, the odd last row and column are clamped.
+ * sRGB colors are filtered in linear space, alpha is always linear. The rows are split in bands on the workers.
+ */
+void DownsampleImageLevel(const unsigned char* src, int srcWidth, int srcHeight, unsigned char* dst,
+    int nbChannels, bool hdr, bool srgb = false, MipFilter filter = MipFilter::BOX);
+/**
+ * \brief Appends the mip chain to the level 0 of the image
+ */
+void GenerateMipChain(Image& image, bool srgb = false, MipFilter filter = MipFilter::BOX);
+/**
+ * \brief Adds an opaque alpha channel to a 3 channels image and all its mip levels
+ */
+void ExpandRgbToRgba(Image& image);
+/**
+ * \brief Multiplies the colors of a 4 channels image by their alpha, in linear space for sRGB colors
+ */
+void PremultiplyAlpha(Image& image, bool srgb = false);
+/**
+ * \brief Round to nearest even conversion to IEEE half floats, out of range values become infinities
+ */
+void ConvertFloatToHalf(const float* src, std::uint16_t* dst, std::size_t count);
+void ConvertHalfToFloat(const std::uint16_t* src, float* dst, std::size_t count);
+
+float Srgb8ToLinear(std::uint8_t value);
+/**
+ * \brief Nearest 8-bit sRGB value of a linear value clamped to [0, 1]
+ */
+std::uint8_t LinearToSrgb8(float value);
+}
@@ -0,0 +1,82 @@
+#pragma once
+/*
+ MIT License
+
+ Copyright (c) 2020 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "graphics/cooked_model.h"
+
+namespace neko
+{
+struct ObjMaterial
+{
+    std::string name;
+    //Texture paths relative to the folder of the obj file, empty when the material has none
+    std::string diffuseMap;
+    std::string specularMap;
+    std::string heightMap;
+    float specularExponent = 0.0f;
+};
+
+/**
+ * \brief Faces of an obj object or group using one material, triangulated and indexed like the assimp meshes
+ */
+struct ObjMesh
+{
+    std::string name;
+    //Index in ObjModel::materials, the faces without usemtl use the default material at 0
+    std::uint32_t materialIndex = 0;
+    std::vector<MeshVertex> vertices;
+    std::vector<std::uint32_t> indices;
+    Vec3f aabbMin;
+    Vec3f aabbMax;
+};
+
+struct ObjModel
+{
+    std::vector<ObjMesh> meshes;
+    std::vector<ObjMaterial> materials;
+};
+
+/**
+ * \brief Parses the obj text in line-aligned chunks on the OTHER_THREAD workers, then builds the meshes in
+ * parallel: polygons are fanned into triangles, the identical vertex/uv/normal corners share a vertex, missing
+ * normals are smoothed from the faces and the tangents come from the uvs. The v texture coordinates are
+ * flipped when flipUVs is set, as the models are imported with aiProcess_FlipUVs.
+ * The used materials only get their name, the material libraries are added to mtlLibraries without being loaded.
+ */
+bool ParseObj(std::string_view objText, ObjModel& model, std::vector<std::string>& mtlLibraries,
+    bool flipUVs = true);
+/**
+ * \brief Fills the materials named like a newmtl of the mtl text
+ */
+void ParseMtl(std::string_view mtlText, std::vector<ObjMaterial>& materials);
+/**
+ * \brief Maps the obj file, parses it and its material libraries found next to it
+ */
+bool LoadObj(std::string_view path, ObjModel& model, bool flipUVs = true);
+}
@@ -38,6 +38,7 @@ struct Sprite
     ~Sprite() = default;
     Color4 color = Color4(Color::white, 1.0f);
     TextureId textureId = INVALID_TEXTURE_ID;
+    TextureHandle textureHandle = INVALID_TEXTURE_HANDLE;
     Texture texture{};
 };
 
@@ -23,7 +23,15 @@
  SOFTWARE.
  */
 #include <queue>
-#include <map>
+#include <unordered_map>
+#include <memory>
+#include <algorithm>
+#include <vector>
+#include <atomic>
+#include <functional>
+#ifndef NEKO_SAMETHREAD
+#include <mutex>
+#endif
 #include "engine/assert.h"
 #include <engine/log.h>
 #include <engine/resource.h>
@@ -40,7 +48,7 @@ using TextureName = std::uint32_t;
 const TextureName INVALID_TEXTURE_NAME = 0;
 /**
  * \brief Unique identifier (16 bytes UUID for the texture in the texture manager.
- * Generated at compile time and loaded at init.
+ * Generated at compile time and loaded at init. Kept for serialization, the runtime uses the TextureHandle.
  */
 using TextureId = sole::uuid;
 const TextureId INVALID_TEXTURE_ID = sole::uuid();
@@ -59,7 +67,18 @@ struct Image
     unsigned char* data = nullptr;
     int width = -1, height = -1;
     int nbChannels = 0;
+    //Cooked images store their mip chain after the level 0 in the same buffer
+    int mipLevels = 1;
+    bool hdr = false;
     void Destroy();
+    /**
+     * \brief Size of the decoded pixels with all the mip levels, hdr images are stored as floats
+     */
+    [[nodiscard]] size_t GetByteSize() const;
+    [[nodiscard]] size_t GetLevelByteSize(int level) const;
+    [[nodiscard]] size_t GetLevelOffset(int level) const;
+    [[nodiscard]] int GetLevelWidth(int level) const { return std::max(1, width >> level); }
+    [[nodiscard]] int GetLevelHeight(int level) const { return std::max(1, height >> level); }
 };
 
 Image StbImageConvert(const BufferFile& imageFile, bool flipY=false, bool hdr = false);
@@ -85,6 +104,16 @@ struct Texture
     TextureName name = INVALID_TEXTURE_NAME;
     Vec2i size;
 };
+/**
+ * \brief Dense handle issued by the texture manager when a texture is loaded, a handle from before
+ * the texture manager was destroyed is detected as stale
+ */
+using TextureHandle = ResourceHandle<Texture>;
+const TextureHandle INVALID_TEXTURE_HANDLE = TextureHandle();
+/**
+ * \brief Continuation of a texture load, called with the texture once it is on the GPU
+ */
+using TextureLoadedCallback = std::function<void(const Texture&)>;
 
 class TextureManagerInterface
 {
@@ -93,6 +122,14 @@ public:
 	virtual TextureId LoadTexture(std::string_view path, Texture::TextureFlags flags = Texture::DEFAULT) = 0;
     [[nodiscard]] virtual Texture GetTexture(TextureId index) const = 0;
     [[nodiscard]] virtual bool IsTextureLoaded(TextureId textureId) const = 0;
+    [[nodiscard]] virtual TextureHandle GetTextureHandle(TextureId textureId) const = 0;
+    [[nodiscard]] virtual Texture GetTexture(TextureHandle textureHandle) const = 0;
+    [[nodiscard]] virtual bool IsTextureLoaded(TextureHandle textureHandle) const = 0;
+    /**
+     * \brief Calls onLoaded when the texture is uploaded, right away when it already is.
+     * Returns false for an invalid or stale handle, the callback is then dropped.
+     */
+    virtual bool AddTextureLoadedCallback(TextureHandle textureHandle, TextureLoadedCallback onLoaded) = 0;
 };
 
 class NullTextureManager : public TextureManagerInterface
@@ -111,9 +148,26 @@ public:
 	    return {};
     }
     [[nodiscard]] bool IsTextureLoaded([[maybe_unused]] TextureId textureId) const override  { return false; }
+    [[nodiscard]] TextureHandle GetTextureHandle([[maybe_unused]] TextureId textureId) const override
+    {
+        return INVALID_TEXTURE_HANDLE;
+    }
+    [[nodiscard]] Texture GetTexture([[maybe_unused]] TextureHandle textureHandle) const override
+    {
+        neko_assert(false, "[Warning] Using NullTextureManager to Get Texture Handle");
+        logDebug("[Warning] Using NullTextureManager to Get Texture Handle");
+        return {};
+    }
+    [[nodiscard]] bool IsTextureLoaded([[maybe_unused]] TextureHandle textureHandle) const override { return false; }
+    bool AddTextureLoadedCallback([[maybe_unused]] TextureHandle textureHandle,
+        [[maybe_unused]] TextureLoadedCallback onLoaded) override
+    {
+        return false;
+    }
 };
 
 class TextureManager;
+class TextureCooker;
 	
 class TextureLoader
 {
@@ -121,29 +175,51 @@ public:
     explicit TextureLoader(TextureManager& textureManager);
 
     void SetTextureFlags(Texture::TextureFlags textureFlags) { flags_ = textureFlags; }
-    void SetTextureId(TextureId textureId);
+    void SetTextureHandle(TextureHandle textureHandle);
 	/**
 	 * \brief This function schedules the resource load from disk and the image conversion.
-	 * Must be called after setting the texture id 
+	 * Must be called after setting the texture handle. The source and cooked files are read on the
+	 * RESOURCE_THREAD, the conversion on the OTHER_THREAD only decodes or cooks and a new cooked file
+	 * is written back on the RESOURCE_THREAD.
 	 */
     void LoadFromDisk();
 
+    /**
+     * \brief The write job is scheduled last by the conversion, even with nothing to write
+     */
     [[nodiscard]] bool IsLoaded() const
     {
-        return diskLoadJob_.IsDone() && convertImageJob_.IsDone();
+        return writeCookedJob_.IsDone();
     }
     [[nodiscard]] bool HasStarted() const
     {
-        return textureId_ != INVALID_TEXTURE_ID && diskLoadJob_.HasStarted();
+        return textureHandle_ != INVALID_TEXTURE_HANDLE && diskLoadJob_.HasStarted();
+    }
+    /**
+     * \brief A loader can take a new texture when it never loaded one or when its jobs are done,
+     * a scheduled but not yet started load keeps it busy
+     */
+    [[nodiscard]] bool IsAvailable() const
+    {
+        return !isLoading_ || IsLoaded();
     }
     void Reset();
 private:
     TextureManager& textureManager_;
+    bool isLoading_ = false;
     Texture::TextureFlags flags_ = Texture::DEFAULT;
+    Job diskLoadJob_;
     Job convertImageJob_;
-    ResourceJob diskLoadJob_;
+    Job writeCookedJob_;
+    std::string path_;
+    BufferFile sourceFile_;
+    //Set by the disk load when the texture cache is enabled, the cooked file is only loaded if it exists
+    std::string cookedPath_;
+    BufferFile cookedFile_;
+    //Encoded by the conversion when the texture is cooked on load
+    std::vector<unsigned char> cookedData_;
     Image image_;
-    TextureId textureId_ = INVALID_TEXTURE_ID;
+    TextureHandle textureHandle_ = INVALID_TEXTURE_HANDLE;
 };
 
 struct TextureInfo
@@ -155,25 +231,43 @@ struct TextureInfo
     TextureInfo(const TextureInfo&) = delete;
     TextureInfo& operator= (const TextureInfo&) = delete;
 	
-    TextureId textureId = INVALID_TEXTURE_ID;
+    TextureHandle textureHandle = INVALID_TEXTURE_HANDLE;
     Image image;
     Texture::TextureFlags flags = Texture::DEFAULT;
+    //Set by CreateTexture
+    Texture texture{};
 };
 
+/**
+ * \brief Loads the textures with a pool of TextureLoader, the disk reads are on the RESOURCE_THREAD
+ * and the image conversions fan out on the OTHER_THREAD workers.
+ * New loads wait while the decoded images waiting for the GPU are over the memory budget.
+ * With a texture cache, the loaders read the cooked mip chains instead of decoding the sources.
+ */
 class TextureManager : public TextureManagerInterface, public SystemInterface
 {
 public:
+    static constexpr size_t defaultMaxLoadingTextures = 8;
+    static constexpr size_t defaultDecodedMemoryBudget = 256u * 1024u * 1024u;
+    static constexpr size_t defaultMaxUploadsPerFrame = 8;
+
     TextureManager();
+    ~TextureManager() override;
     /**
      * \brief Open the meta file of the texture file to get the Texture Id. If not already loaded
      * it will put the loading texture into the texturesToLoad queue.
+     * Can be called from any thread, the models request their textures from the workers.
      */
     TextureId LoadTexture(std::string_view path, Texture::TextureFlags flags = Texture::DEFAULT) override;
     std::string GetPath(TextureId textureId) const;
+    std::string GetPath(TextureHandle textureHandle) const;
     void Init() override;
 	void Update(seconds dt) override;
 	
     void Destroy() override;
+    /**
+     * \brief Called by the loaders on the worker threads when the image is converted
+     */
     virtual void UploadToGpu(TextureInfo&& texture);
     /**
      * \brief When the loading texture with the TextureId is uploaded to the GPU, the returned Texture
@@ -181,18 +275,85 @@ public:
      */
 	Texture GetTexture(TextureId index) const override;
 	bool IsTextureLoaded(TextureId textureId) const override;
+    /**
+     * \brief The handle of a texture given to LoadTexture, invalid for the unknown ids
+     */
+    TextureHandle GetTextureHandle(TextureId textureId) const override;
+    /**
+     * \brief Array lookup under the loaded mutex for the per frame accesses, a stale handle returns an empty Texture
+     */
+    Texture GetTexture(TextureHandle textureHandle) const override;
+    bool IsTextureLoaded(TextureHandle textureHandle) const override;
+    /**
+     * \brief Can be called from any thread, the callbacks of the pending textures run on the main thread
+     * in Update, when the uploaded textures are added to the texture table
+     */
+    bool AddTextureLoadedCallback(TextureHandle textureHandle, TextureLoadedCallback onLoaded) override;
+
+    void SetMaxLoadingTextures(size_t maxLoadingTextures);
+    void SetDecodedMemoryBudget(size_t decodedMemoryBudget) { decodedMemoryBudget_ = decodedMemoryBudget; }
+    void SetMaxUploadsPerFrame(size_t maxUploadsPerFrame) { maxUploadsPerFrame_ = std::max<size_t>(1, maxUploadsPerFrame); }
+    /**
+     * \brief The loaders prefer the cooked textures of the cache folder, with cookOnLoad the first load of
+     * a texture cooks it, an empty folder disables the cache
+     */
+    void SetTextureCache(std::string_view cacheFolder, bool cookOnLoad = true);
+    [[nodiscard]] const TextureCooker& GetTextureCooker() const { return *textureCooker_; }
+    [[nodiscard]] bool IsCookingOnLoad() const { return cookOnLoad_; }
+    /**
+     * \brief For the platforms without GPU mip generation, the loaders build the mip chains of the decoded textures
+     */
+    void SetGenerateMipmapsOnCpu(bool generateMipmapsOnCpu) { generateMipmapsOnCpu_ = generateMipmapsOnCpu; }
+    [[nodiscard]] bool IsGeneratingMipmapsOnCpu() const { return generateMipmapsOnCpu_; }
+    /**
+     * \brief Bytes of the decoded images that are not uploaded to the GPU yet
+     */
+    [[nodiscard]] size_t GetDecodedMemory() const { return decodedMemory_.load(std::memory_order_relaxed); }
+    /**
+     * \brief Textures waiting for a loader, being loaded or waiting for the GPU
+     */
+    [[nodiscard]] size_t GetLoadingTextureCount() const;
 protected:
 	/**
-	 * \brief Called on the renderer pre render
+	 * \brief Called on the renderer pre render for every uploaded texture, with currentUploadedTexture_ set.
+	 * The created texture goes in currentUploadedTexture_.texture.
 	 */
     virtual void CreateTexture() = 0;
-    std::map<TextureId, std::string> texturePathMap_;
-    std::map<TextureId, Texture> textureMap_;
+    void UploadTextures();
+    /**
+     * \brief Copies the textures created by the last upload in the texture table, on the main thread
+     */
+    void FinishUploadingTextures();
+
+    struct LoadedTexture
+    {
+        Texture texture{};
+        bool isLoaded = false;
+        std::vector<TextureLoadedCallback> onLoaded;
+    };
+    ResourceTable<LoadedTexture, Texture> textures_;
+    std::unordered_map<TextureId, TextureHandle> textureHandles_;
+    //Indexed by the handle index
+    std::vector<std::string> texturePaths_;
     std::queue<TextureInfo> texturesToLoad_;
     std::queue<TextureInfo> texturesToUpload_;
-    TextureLoader textureLoader_;
+    std::vector<std::unique_ptr<TextureLoader>> textureLoaders_;
+    std::vector<TextureInfo> uploadingTextures_;
     TextureInfo currentUploadedTexture_;
     Job uploadToGpuJob_;
+    bool isUploading_ = false;
+    size_t maxLoadingTextures_ = defaultMaxLoadingTextures;
+    size_t decodedMemoryBudget_ = defaultDecodedMemoryBudget;
+    size_t maxUploadsPerFrame_ = defaultMaxUploadsPerFrame;
+    std::atomic<size_t> decodedMemory_{0};
+    std::unique_ptr<TextureCooker> textureCooker_;
+    bool cookOnLoad_ = false;
+    bool generateMipmapsOnCpu_ = false;
+#ifndef NEKO_SAMETHREAD
+    mutable std::mutex uploadMutex_;
+    //Guards the texture table, the id and path maps and the load queue, LoadTexture runs on the workers
+    mutable std::mutex loadedMutex_;
+#endif
 };
 using TextureManagerLocator = Locator<TextureManagerInterface, NullTextureManager>;
 
@@ -0,0 +1,134 @@
+#pragma once
+/*
+ MIT License
+
+ Copyright (c) 2020 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "graphics/image_processing.h"
+#include "graphics/texture.h"
+
+namespace neko
+{
+/**
+ * \brief KTX2 file header followed by the level index, the data format descriptor and the mip levels
+ * from the smallest to the largest
+ */
+struct Ktx2Header
+{
+    static constexpr std::array<std::uint8_t, 12> identifierValue =
+        {0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n'};
+    enum SupercompressionScheme : std::uint32_t
+    {
+        NONE = 0,
+        ZSTD = 2
+    };
+    std::array<std::uint8_t, 12> identifier = identifierValue;
+    std::uint32_t vkFormat = 0;
+    std::uint32_t typeSize = 1;
+    std::uint32_t pixelWidth = 0;
+    std::uint32_t pixelHeight = 0;
+    std::uint32_t pixelDepth = 0;
+    std::uint32_t layerCount = 0;
+    std::uint32_t faceCount = 1;
+    std::uint32_t levelCount = 1;
+    std::uint32_t supercompressionScheme = NONE;
+    std::uint32_t dfdByteOffset = 0;
+    std::uint32_t dfdByteLength = 0;
+    std::uint32_t kvdByteOffset = 0;
+    std::uint32_t kvdByteLength = 0;
+    std::uint64_t sgdByteOffset = 0;
+    std::uint64_t sgdByteLength = 0;
+};
+static_assert(sizeof(Ktx2Header) == 80, "KTX2 header must be 80 bytes");
+
+struct Ktx2LevelIndex
+{
+    std::uint64_t byteOffset = 0;
+    std::uint64_t byteLength = 0;
+    std::uint64_t uncompressedByteLength = 0;
+};
+static_assert(sizeof(Ktx2LevelIndex) == 24, "KTX2 level index must be 24 bytes");
+
+/**
+ * \brief Encodes the image and its mip levels as a KTX2 file in memory, the levels are supercompressed with zstd
+ * when available. Returns an empty vector on failure.
+ */
+std::vector<unsigned char> EncodeKtx2(const Image& image, bool srgb = false, bool supercompress = true);
+bool WriteKtx2(std::string_view path, const Image& image, bool srgb = false, bool supercompress = true);
+/**
+ * \brief Reads the mip chain of an uncompressed KTX2 file, returns an image without data on failure
+ */
+Image LoadKtx2(const BufferFile& ktxFile);
+
+/**
+ * \brief Decodes the source images once and stores their GPU-ready mip chains in a cache folder.
+ * The cooked files are keyed by the content hash of the source and the flags changing the pixels,
+ * so an edited source gets a new cooked file.
+ */
+class TextureCooker
+{
+public:
+    static constexpr std::string_view cookedExtension = ".ktx2";
+    //Bumped when the cooked pixels change, old cooked files are then ignored
+    static constexpr std::uint32_t cookVersion = 2;
+
+    /**
+     * \brief Creates the cache folder if needed, an empty folder disables the cache
+     */
+    void SetCacheFolder(std::string_view cacheFolder);
+    void SetSupercompression(bool supercompress) { supercompress_ = supercompress; }
+    void SetMipFilter(MipFilter mipFilter) { mipFilter_ = mipFilter; }
+    [[nodiscard]] bool IsEnabled() const { return !cacheFolder_.empty(); }
+    [[nodiscard]] const std::string& GetCacheFolder() const { return cacheFolder_; }
+
+    [[nodiscard]] static std::uint64_t GetCookKey(const BufferFile& sourceFile, Texture::TextureFlags flags,
+        MipFilter mipFilter = MipFilter::BOX);
+    [[nodiscard]] std::string GetCookedPath(const BufferFile& sourceFile, Texture::TextureFlags flags) const;
+    /**
+     * \brief Decodes the source image, generates its mip chain if needed and encodes it in cookedData,
+     * without touching the disk. cookedData is left empty when the image cannot be cooked.
+     */
+    Image Cook(const BufferFile& sourceFile, Texture::TextureFlags flags, std::vector<unsigned char>& cookedData) const;
+    /**
+     * \brief Cooks the source image and writes it to the cooked path
+     * \return the cooked image, the write failing only costs the next load a decode
+     */
+    Image Cook(const BufferFile& sourceFile, Texture::TextureFlags flags, std::string_view cookedPath) const;
+    /**
+     * \brief Writes through a temporary file renamed at the end, so a cooked file is never seen half written
+     */
+    static bool WriteCookedFile(std::string_view cookedPath, const std::vector<unsigned char>& cookedData);
+    /**
+     * \brief Offline cooking, skips the sources with an up to date cooked file
+     */
+    bool CookFile(std::string_view sourcePath, Texture::TextureFlags flags) const;
+private:
+    std::string cacheFolder_;
+    bool supercompress_ = true;
+    MipFilter mipFilter_ = MipFilter::BOX;
+};
+}
@@ -0,0 +1,95 @@
+#pragma once
+/*
+ MIT License
+
+ Copyright (c) 2020 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "graphics/cooked_model.h"
+
+namespace neko
+{
+/**
+ * \brief Compressed MeshVertex, 20 bytes instead of 56. The bitangent is rebuilt as cross(normal, tangent)
+ * times the sign stored in the position w.
+ */
+struct QuantizedVertex
+{
+    //Unsigned normalized in the mesh AABB, w is 0 for a negative bitangent sign and 65535 for a positive one
+    std::array<std::uint16_t, 4> position{};
+    //Octahedral encoded unit vectors, signed normalized
+    std::array<std::int16_t, 2> normal{};
+    std::array<std::int16_t, 2> tangent{};
+    //Half floats
+    std::array<std::uint16_t, 2> texCoords{};
+};
+static_assert(sizeof(QuantizedVertex) == 20, "Quantized vertex must be tightly packed");
+
+struct QuantizedMesh
+{
+    std::vector<QuantizedVertex> vertices;
+    //16-bit indices when the vertex count allows it, the other vector stays empty
+    std::vector<std::uint16_t> shortIndices;
+    std::vector<std::uint32_t> indices;
+    //position = positionOffset + quantized position / 65535 * positionScale
+    Vec3f positionOffset = Vec3f::zero;
+    Vec3f positionScale = Vec3f::zero;
+
+    [[nodiscard]] bool HasShortIndices() const { return !shortIndices.empty(); }
+    [[nodiscard]] std::size_t GetIndexCount() const { return shortIndices.size() + indices.size(); }
+    /**
+     * \brief Size of the vertex and index buffers uploaded to the GPU
+     */
+    [[nodiscard]] std::size_t GetByteSize() const;
+};
+
+/**
+ * \brief Largest decoding errors of a quantized mesh, the angles are in radians
+ */
+struct QuantizationError
+{
+    float position = 0.0f;
+    float normalAngle = 0.0f;
+    float tangentAngle = 0.0f;
+    float bitangentAngle = 0.0f;
+    float texCoords = 0.0f;
+};
+
+std::array<std::int16_t, 2> EncodeOctahedral(const Vec3f& direction);
+Vec3f DecodeOctahedral(const std::array<std::int16_t, 2>& octahedral);
+
+/**
+ * \brief The position AABB is computed from the vertices, the normals and tangents are normalized
+ * before being encoded. A zero tangent is decoded as an arbitrary unit vector.
+ */
+void QuantizeMesh(const MeshVertex* vertices, std::size_t vertexCount, const std::uint32_t* indices,
+    std::size_t indexCount, QuantizedMesh& quantizedMesh);
+MeshVertex DequantizeVertex(const QuantizedVertex& vertex, const QuantizedMesh& quantizedMesh);
+/**
+ * \brief Compares the decoded vertices with the source ones, the zero normals and tangents are skipped
+ */
+QuantizationError MeasureQuantizationError(const MeshVertex* vertices, const QuantizedMesh& quantizedMesh);
+}
@@ -23,6 +23,9 @@
  SOFTWARE.
  */
 
+#include <cstdint>
+#include <vector>
+
 #include "mathematics/vector.h"
 #include "matrix.h"
 #include "const.h"
@@ -595,4 +598,72 @@ struct Aabb3d {
     Vec3f upperRightBound = Vec3f::zero; // the upper vertex
 };
 
+/**
+ * \brief One bit per box written by the AabbSoA kernels, bit i % 64 of word i / 64 is set when box i passes the test
+ */
+using AabbBitmask = std::vector<std::uint64_t>;
+
+inline bool IsBitSet(const AabbBitmask& mask, std::size_t index)
+{
+    return (mask[index / 64] >> (index % 64)) & 1u;
+}
+
+/**
+ * \brief Structure of arrays of Aabb2d tested against one shape at a time.
+ * Arrays are padded to a multiple of the widest vector so the kernels never need a scalar tail.
+ */
+class AabbSoA2d
+{
+public:
+    void Reserve(std::size_t capacity);
+    void Clear();
+    std::size_t Size() const { return size_; }
+
+    void PushBack(const Aabb2d& aabb);
+    void Set(std::size_t index, const Aabb2d& aabb);
+    Aabb2d Get(std::size_t index) const;
+
+    void IntersectAabb(const Aabb2d& aabb, AabbBitmask& result) const;
+    void IntersectRay(const Vec2f& dirRay, const Vec2f& origin, AabbBitmask& result) const;
+
+    std::vector<float> lowerXs;
+    std::vector<float> lowerYs;
+    std::vector<float> upperXs;
+    std::vector<float> upperYs;
+private:
+    std::size_t size_ = 0;
+};
+
+/**
+ * \brief Structure of arrays of Aabb3d tested against one shape at a time.
+ * Arrays are padded to a multiple of the widest vector so the kernels never need a scalar tail.
+ */
+class AabbSoA3d
+{
+public:
+    void Reserve(std::size_t capacity);
+    void Clear();
+    std::size_t Size() const { return size_; }
+
+    void PushBack(const Aabb3d& aabb);
+    void Set(std::size_t index, const Aabb3d& aabb);
+    Aabb3d Get(std::size_t index) const;
+
+    void IntersectAabb(const Aabb3d& aabb, AabbBitmask& result) const;
+    void IntersectRay(const Vec3f& dirRay, const Vec3f& origin, AabbBitmask& result) const;
+    /**
+     * \brief Sets the bit of the boxes that are at least partially inside all the planes.
+     * A plane is stored as (normal, w) and a point p is inside when Dot(normal, p) + w >= 0.
+     */
+    void IntersectFrustum(const Vec4f* planes, std::size_t planeCount, AabbBitmask& result) const;
+
+    std::vector<float> lowerXs;
+    std::vector<float> lowerYs;
+    std::vector<float> lowerZs;
+    std::vector<float> upperXs;
+    std::vector<float> upperYs;
+    std::vector<float> upperZs;
+private:
+    std::size_t size_ = 0;
+};
 }
@@ -0,0 +1,607 @@
+#pragma once
+/*
+ MIT License
+
+ Copyright (c) 2020 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "engine/assert.h"
+#include "engine/globals.h"
+#include "mathematics/aabb.h"
+
+namespace neko
+{
+using AabbProxy = std::int32_t;
+const AabbProxy INVALID_AABB_PROXY = -1;
+
+template<typename AabbT>
+struct AabbTreeTraits;
+
+template<>
+struct AabbTreeTraits<Aabb2d>
+{
+    using Vec = Vec2f;
+    ///\brief Line stored as (normal.x, normal.y, offset), a point p is inside when Dot(normal, p) + offset >= 0
+    using Plane = Vec3f;
+    static constexpr int dimension = 2;
+};
+
+template<>
+struct AabbTreeTraits<Aabb3d>
+{
+    using Vec = Vec3f;
+    ///\brief Plane stored as (normal, offset), a point p is inside when Dot(normal, p) + offset >= 0
+    using Plane = Vec4f;
+    static constexpr int dimension = 3;
+};
+
+/**
+ * \brief Dynamic bounding volume hierarchy over fat AABBs.
+ * Leaves store an enlarged AABB so small moves do not touch the tree. Insertion picks the sibling
+ * with the surface area heuristic and the tree is kept balanced with AVL rotations.
+ * Query callbacks receive the proxy and return false to stop the query.
+ */
+template<typename AabbT>
+class DynamicAabbTree
+{
+public:
+    using Traits = AabbTreeTraits<AabbT>;
+    using Vec = typename Traits::Vec;
+    using Plane = typename Traits::Plane;
+    static constexpr int dimension = Traits::dimension;
+
+    /**
+     * \param fatMargin added on each side of the AABB of a proxy
+     * \param displacementMultiplier how far ahead along its displacement a moved proxy is enlarged
+     */
+    explicit DynamicAabbTree(float fatMargin = 0.1f, float displacementMultiplier = 2.0f)
+            : fatMargin_(fatMargin), displacementMultiplier_(displacementMultiplier)
+    {
+    }
+
+    AabbProxy CreateProxy(const AabbT& aabb, Index userData)
+    {
+        const AabbProxy proxy = AllocateNode();
+        Node& node = nodes_[proxy];
+        node.aabb = Fatten(aabb);
+        node.userData = userData;
+        node.height = 0;
+        proxyCount_++;
+        InsertLeaf(proxy);
+        return proxy;
+    }
+
+    void DestroyProxy(AabbProxy proxy)
+    {
+        neko_assert(IsValidLeaf(proxy), "Invalid AABB tree proxy");
+        RemoveLeaf(proxy);
+        FreeNode(proxy);
+        proxyCount_--;
+    }
+
+    /**
+     * \brief Updates the AABB of a proxy, the tree is only modified when it leaves its fat AABB.
+     * \return true if the proxy was reinserted
+     */
+    bool MoveProxy(AabbProxy proxy, const AabbT& aabb, const Vec& displacement = Vec())
+    {
+        neko_assert(IsValidLeaf(proxy), "Invalid AABB tree proxy");
+        if (Contains(nodes_[proxy].aabb, aabb))
+        {
+            return false;
+        }
+        RemoveLeaf(proxy);
+        AabbT fatAabb = Fatten(aabb);
+        //Predict the next move so a proxy moving steadily is not reinserted every frame
+        for (int axis = 0; axis < dimension; axis++)
+        {
+            const float d = displacement[axis] * displacementMultiplier_;
+            if (d < 0.0f)
+                fatAabb.lowerLeftBound[axis] += d;
+            else
+                fatAabb.upperRightBound[axis] += d;
+        }
+        nodes_[proxy].aabb = fatAabb;
+        InsertLeaf(proxy);
+        return true;
+    }
+
+    Index GetUserData(AabbProxy proxy) const { return nodes_[proxy].userData; }
+    const AabbT& GetFatAabb(AabbProxy proxy) const { return nodes_[proxy].aabb; }
+    size_t GetProxyCount() const { return proxyCount_; }
+    int GetHeight() const { return root_ == INVALID_AABB_PROXY ? 0 : nodes_[root_].height; }
+
+    void Clear()
+    {
+        nodes_.clear();
+        root_ = INVALID_AABB_PROXY;
+        freeList_ = INVALID_AABB_PROXY;
+        proxyCount_ = 0;
+    }
+
+    template<typename Callback>
+    void QueryAabb(const AabbT& aabb, Callback callback) const
+    {
+        Traverse([&aabb](const AabbT& nodeAabb) { return Overlap(nodeAabb, aabb); }, callback);
+    }
+
+    template<typename Callback>
+    void QueryPoint(const Vec& point, Callback callback) const
+    {
+        Traverse([&point](const AabbT& nodeAabb)
+        {
+            for (int axis = 0; axis < dimension; axis++)
+            {
+                if (point[axis] < nodeAabb.lowerLeftBound[axis] || point[axis] > nodeAabb.upperRightBound[axis])
+                    return false;
+            }
+            return true;
+        }, callback);
+    }
+
+    /**
+     * \brief Reports the proxies whose fat AABB is hit by the segment from origin to origin + dirRay * maxDistance
+     */
+    template<typename Callback>
+    void RayCast(const Vec& origin, const Vec& dirRay, float maxDistance, Callback callback) const
+    {
+        Vec invDir;
+        for (int axis = 0; axis < dimension; axis++)
+        {
+            invDir[axis] = dirRay[axis] != 0.0f ? 1.0f / dirRay[axis] : std::numeric_limits<float>::infinity();
+        }
+        Traverse([&](const AabbT& nodeAabb)
+        {
+            float tMin = 0.0f;
+            float tMax = maxDistance;
+            for (int axis = 0; axis < dimension; axis++)
+            {
+                if (dirRay[axis] == 0.0f)
+                {
+                    if (origin[axis] < nodeAabb.lowerLeftBound[axis] || origin[axis] > nodeAabb.upperRightBound[axis])
+                        return false;
+                    continue;
+                }
+                float t1 = (nodeAabb.lowerLeftBound[axis] - origin[axis]) * invDir[axis];
+                float t2 = (nodeAabb.upperRightBound[axis] - origin[axis]) * invDir[axis];
+                if (t1 > t2)
+                    std::swap(t1, t2);
+                tMin = std::max(tMin, t1);
+                tMax = std::min(tMax, t2);
+                if (tMin > tMax)
+                    return false;
+            }
+            return true;
+        }, callback);
+    }
+
+    /**
+     * \brief Reports the proxies whose fat AABB is at least partially inside all the planes
+     */
+    template<typename Callback>
+    void QueryFrustum(const Plane* planes, size_t planeCount, Callback callback) const
+    {
+        Traverse([planes, planeCount](const AabbT& nodeAabb)
+        {
+            for (size_t i = 0; i < planeCount; i++)
+            {
+                const Plane& plane = planes[i];
+                //Only the corner furthest along the normal needs to be tested
+                float distance = plane[dimension];
+                for (int axis = 0; axis < dimension; axis++)
+                {
+                    distance += plane[axis] * (plane[axis] >= 0.0f ?
+                            nodeAabb.upperRightBound[axis] : nodeAabb.lowerLeftBound[axis]);
+                }
+                if (distance < 0.0f)
+                    return false;
+            }
+            return true;
+        }, callback);
+    }
+
+    /**
+     * \brief Reports each pair of proxies with overlapping fat AABBs once, with the smaller proxy first
+     */
+    template<typename Callback>
+    void QueryOverlapPairs(Callback callback) const
+    {
+        bool running = true;
+        for (AabbProxy proxy = 0; proxy < static_cast<AabbProxy>(nodes_.size()) && running; proxy++)
+        {
+            if (!IsValidLeaf(proxy))
+                continue;
+            QueryAabb(nodes_[proxy].aabb, [&](AabbProxy other)
+            {
+                if (other > proxy)
+                {
+                    running = callback(proxy, other);
+                }
+                return running;
+            });
+        }
+    }
+
+    /**
+     * \brief Checks parent links, heights and that every node encloses its children, used by tests
+     */
+    bool Validate() const
+    {
+        if (root_ == INVALID_AABB_PROXY)
+            return proxyCount_ == 0;
+        size_t leafCount = 0;
+        return nodes_[root_].parent == INVALID_AABB_PROXY && ValidateNode(root_, leafCount) && leafCount == proxyCount_;
+    }
+
+private:
+    struct Node
+    {
+        bool IsLeaf() const { return child1 == INVALID_AABB_PROXY; }
+
+        AabbT aabb;
+        Index userData = INVALID_INDEX;
+        ///\brief Parent in the tree, or next free node when the node is in the free list
+        AabbProxy parent = INVALID_AABB_PROXY;
+        AabbProxy child1 = INVALID_AABB_PROXY;
+        AabbProxy child2 = INVALID_AABB_PROXY;
+        ///\brief 0 for leaves, -1 for free nodes
+        std::int32_t height = -1;
+    };
+
+    /**
+     * \brief Traversal stack on the call stack, only balanced trees deeper than the array allocate
+     */
+    class NodeStack
+    {
+    public:
+        void Push(AabbProxy node)
+        {
+            if (count_ < fixed_.size())
+                fixed_[count_] = node;
+            else
+                overflow_.push_back(node);
+            count_++;
+        }
+
+        AabbProxy Pop()
+        {
+            count_--;
+            if (count_ < fixed_.size())
+                return fixed_[count_];
+            const AabbProxy node = overflow_.back();
+            overflow_.pop_back();
+            return node;
+        }
+
+        bool Empty() const { return count_ == 0; }
+    private:
+        std::array<AabbProxy, 256> fixed_;
+        std::vector<AabbProxy> overflow_;
+        size_t count_ = 0;
+    };
+
+    template<typename Test, typename Callback>
+    void Traverse(Test test, Callback& callback) const
+    {
+        if (root_ == INVALID_AABB_PROXY)
+            return;
+        NodeStack stack;
+        stack.Push(root_);
+        while (!stack.Empty())
+        {
+            const AabbProxy index = stack.Pop();
+            const Node& node = nodes_[index];
+            if (!test(node.aabb))
+                continue;
+            if (node.IsLeaf())
+            {
+                if (!callback(index))
+                    return;
+            }
+            else
+            {
+                stack.Push(node.child1);
+                stack.Push(node.child2);
+            }
+        }
+    }
+
+    static AabbT Union(const AabbT& a, const AabbT& b)
+    {
+        AabbT result;
+        for (int axis = 0; axis < dimension; axis++)
+        {
+            result.lowerLeftBound[axis] = std::min(a.lowerLeftBound[axis], b.lowerLeftBound[axis]);
+            result.upperRightBound[axis] = std::max(a.upperRightBound[axis], b.upperRightBound[axis]);
+        }
+        return result;
+    }
+
+    ///\brief Perimeter in 2d and surface area in 3d, the quantity the SAH minimizes
+    static float Cost(const AabbT& aabb)
+    {
+        const Vec size = aabb.upperRightBound - aabb.lowerLeftBound;
+        if constexpr (dimension == 2)
+            return 2.0f * (size[0] + size[1]);
+        else
+            return 2.0f * (size[0] * size[1] + size[1] * size[2] + size[2] * size[0]);
+    }
+
+    static bool Overlap(const AabbT& a, const AabbT& b)
+    {
+        for (int axis = 0; axis < dimension; axis++)
+        {
+            if (a.upperRightBound[axis] < b.lowerLeftBound[axis] || b.upperRightBound[axis] < a.lowerLeftBound[axis])
+                return false;
+        }
+        return true;
+    }
+
+    static bool Contains(const AabbT& outer, const AabbT& inner)
+    {
+        for (int axis = 0; axis < dimension; axis++)
+        {
+            if (inner.lowerLeftBound[axis] < outer.lowerLeftBound[axis] || inner.upperRightBound[axis] > outer.upperRightBound[axis])
+                return false;
+        }
+        return true;
+    }
+
+    AabbT Fatten(const AabbT& aabb) const
+    {
+        AabbT result = aabb;
+        for (int axis = 0; axis < dimension; axis++)
+        {
+            result.lowerLeftBound[axis] -= fatMargin_;
+            result.upperRightBound[axis] += fatMargin_;
+        }
+        return result;
+    }
+
+    bool IsValidLeaf(AabbProxy proxy) const
+    {
+        return proxy >= 0 && proxy < static_cast<AabbProxy>(nodes_.size()) &&
+               nodes_[proxy].height == 0;
+    }
+
+    AabbProxy AllocateNode()
+    {
+        if (freeList_ == INVALID_AABB_PROXY)
+        {
+            nodes_.emplace_back();
+            return static_cast<AabbProxy>(nodes_.size() - 1);
+        }
+        const AabbProxy index = freeList_;
+        freeList_ = nodes_[index].parent;
+        nodes_[index] = Node();
+        return index;
+    }
+
+    void FreeNode(AabbProxy index)
+    {
+        nodes_[index].parent = freeList_;
+        nodes_[index].height = -1;
+        freeList_ = index;
+    }
+
+    void InsertLeaf(AabbProxy leaf)
+    {
+        if (root_ == INVALID_AABB_PROXY)
+        {
+            root_ = leaf;
+            nodes_[leaf].parent = INVALID_AABB_PROXY;
+            return;
+        }
+
+        //Go down the tree following the cheapest sibling according to the surface area heuristic
+        const AabbT leafAabb = nodes_[leaf].aabb;
+        AabbProxy index = root_;
+        while (!nodes_[index].IsLeaf())
+        {
+            const Node& node = nodes_[index];
+            const float area = Cost(node.aabb);
+            const float combinedArea = Cost(Union(node.aabb, leafAabb));
+            //Cost of creating a new parent for this node and the leaf
+            const float cost = 2.0f * combinedArea;
+            //Minimum cost pushed to the ancestors when descending further
+            const float inheritanceCost = 2.0f * (combinedArea - area);
+            const auto childCost = [&](AabbProxy child)
+            {
+                const Node& childNode = nodes_[child];
+                const float unionCost = Cost(Union(leafAabb, childNode.aabb));
+                return (childNode.IsLeaf() ? unionCost : unionCost - Cost(childNode.aabb)) + inheritanceCost;
+            };
+            const float cost1 = childCost(node.child1);
+            const float cost2 = childCost(node.child2);
+            if (cost < cost1 && cost < cost2)
+                break;
+            index = cost1 < cost2 ? node.child1 : node.child2;
+        }
+
+        const AabbProxy sibling = index;
+        const AabbProxy oldParent = nodes_[sibling].parent;
+        const AabbProxy newParent = AllocateNode();
+        nodes_[newParent].parent = oldParent;
+        nodes_[newParent].aabb = Union(leafAabb, nodes_[sibling].aabb);
+        nodes_[newParent].height = nodes_[sibling].height + 1;
+        nodes_[newParent].child1 = sibling;
+        nodes_[newParent].child2 = leaf;
+        nodes_[sibling].parent = newParent;
+        nodes_[leaf].parent = newParent;
+        if (oldParent == INVALID_AABB_PROXY)
+        {
+            root_ = newParent;
+        }
+        else if (nodes_[oldParent].child1 == sibling)
+        {
+            nodes_[oldParent].child1 = newParent;
+        }
+        else
+        {
+            nodes_[oldParent].child2 = newParent;
+        }
+        Refit(newParent);
+    }
+
+    void RemoveLeaf(AabbProxy leaf)
+    {
+        if (leaf == root_)
+        {
+            root_ = INVALID_AABB_PROXY;
+            return;
+        }
+        const AabbProxy parent = nodes_[leaf].parent;
+        const AabbProxy grandParent = nodes_[parent].parent;
+        const AabbProxy sibling = nodes_[parent].child1 == leaf ? nodes_[parent].child2 : nodes_[parent].child1;
+        FreeNode(parent);
+        nodes_[sibling].parent = grandParent;
+        if (grandParent == INVALID_AABB_PROXY)
+        {
+            root_ = sibling;
+            return;
+        }
+        if (nodes_[grandParent].child1 == parent)
+            nodes_[grandParent].child1 = sibling;
+        else
+            nodes_[grandParent].child2 = sibling;
+        Refit(grandParent);
+    }
+
+    ///\brief Rebalances and updates the AABBs and heights from index up to the root
+    void Refit(AabbProxy index)
+    {
+        while (index != INVALID_AABB_PROXY)
+        {
+            index = Balance(index);
+            Node& node = nodes_[index];
+            const Node& child1 = nodes_[node.child1];
+            const Node& child2 = nodes_[node.child2];
+            node.height = 1 + std::max(child1.height, child2.height);
+            node.aabb = Union(child1.aabb, child2.aabb);
+            index = node.parent;
+        }
+    }
+
+    /**
+     * \brief Rotates the taller child of A up if the subtree is imbalanced
+     * \return the new root of the subtree
+     */
+    AabbProxy Balance(AabbProxy iA)
+    {
+        Node& a = nodes_[iA];
+        if (a.IsLeaf() || a.height < 2)
+            return iA;
+        const AabbProxy iB = a.child1;
+        const AabbProxy iC = a.child2;
+        const std::int32_t balance = nodes_[iC].height - nodes_[iB].height;
+        if (balance > 1)
+            return Rotate(iA, iC, false);
+        if (balance < -1)
+            return Rotate(iA, iB, true);
+        return iA;
+    }
+
+    /**
+     * \brief Moves the child up in place of A, A keeps the shortest grandchild
+     * \param isChild1 whether the child is child1 of A
+     */
+    AabbProxy Rotate(AabbProxy iA, AabbProxy iChild, bool isChild1)
+    {
+        Node& a = nodes_[iA];
+        Node& child = nodes_[iChild];
+        const AabbProxy iOther = isChild1 ? a.child2 : a.child1;
+        const AabbProxy iF = child.child1;
+        const AabbProxy iG = child.child2;
+
+        child.child1 = iA;
+        child.parent = a.parent;
+        a.parent = iChild;
+        if (child.parent == INVALID_AABB_PROXY)
+        {
+            root_ = iChild;
+        }
+        else if (nodes_[child.parent].child1 == iA)
+        {
+            nodes_[child.parent].child1 = iChild;
+        }
+        else
+        {
+            nodes_[child.parent].child2 = iChild;
+        }
+
+        //The tallest grandchild stays under the rotated child, the other one goes to A
+        const bool keepF = nodes_[iF].height > nodes_[iG].height;
+        const AabbProxy iKept = keepF ? iF : iG;
+        const AabbProxy iMoved = keepF ? iG : iF;
+        child.child2 = iKept;
+        if (isChild1)
+            a.child1 = iMoved;
+        else
+            a.child2 = iMoved;
+        nodes_[iMoved].parent = iA;
+
+        const Node& other = nodes_[iOther];
+        const Node& moved = nodes_[iMoved];
+        const Node& kept = nodes_[iKept];
+        a.aabb = Union(other.aabb, moved.aabb);
+        a.height = 1 + std::max(other.height, moved.height);
+        child.aabb = Union(a.aabb, kept.aabb);
+        child.height = 1 + std::max(a.height, kept.height);
+        return iChild;
+    }
+
+    bool ValidateNode(AabbProxy index, size_t& leafCount) const
+    {
+        const Node& node = nodes_[index];
+        if (node.IsLeaf())
+        {
+            leafCount++;
+            return node.height == 0 && node.child2 == INVALID_AABB_PROXY;
+        }
+        const Node& child1 = nodes_[node.child1];
+        const Node& child2 = nodes_[node.child2];
+        if (child1.parent != index || child2.parent != index)
+            return false;
+        if (node.height != 1 + std::max(child1.height, child2.height))
+            return false;
+        if (!Contains(node.aabb, child1.aabb) || !Contains(node.aabb, child2.aabb))
+            return false;
+        return ValidateNode(node.child1, leafCount) && ValidateNode(node.child2, leafCount);
+    }
+
+    std::vector<Node> nodes_;
+    AabbProxy root_ = INVALID_AABB_PROXY;
+    AabbProxy freeList_ = INVALID_AABB_PROXY;
+    size_t proxyCount_ = 0;
+    float fatMargin_;
+    float displacementMultiplier_;
+};
+
+using AabbTree2d = DynamicAabbTree<Aabb2d>;
+using AabbTree3d = DynamicAabbTree<Aabb3d>;
+}
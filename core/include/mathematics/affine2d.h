@@ -0,0 +1,106 @@
+#pragma once
+/*
+ MIT License
+
+ Copyright (c) 2020 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#include "mathematics/matrix.h"
+#include "mathematics/vector.h"
+#include "mathematics/angle.h"
+#include "mathematics/trigo.h"
+
+namespace neko
+{
+/**
+ * \brief 2D affine transform stored as the two basis columns and the translation of a 2x3 matrix.
+ * It is a third of a Mat4, and is expanded to a Mat4 only when it is uploaded to the GPU.
+ */
+template<typename T>
+class Affine2
+{
+public:
+    Affine2() = default;
+    Affine2(const Vec2<T>& xAxis, const Vec2<T>& yAxis, const Vec2<T>& translation) noexcept :
+        xAxis_(xAxis), yAxis_(yAxis), translation_(translation)
+    {
+    }
+
+    /**
+     * \brief Builds Translation * Rotation * Scale, with a counter-clockwise angle
+     */
+    static Affine2 FromTrs(const Vec2<T>& translation, radian_t angle, const Vec2<T>& scale)
+    {
+        const T c = Cos(angle);
+        const T s = Sin(angle);
+        return Affine2(
+            Vec2<T>(c * scale.x, s * scale.x),
+            Vec2<T>(-s * scale.y, c * scale.y),
+            translation);
+    }
+
+    [[nodiscard]] const Vec2<T>& GetXAxis() const { return xAxis_; }
+    [[nodiscard]] const Vec2<T>& GetYAxis() const { return yAxis_; }
+    [[nodiscard]] const Vec2<T>& GetTranslation() const { return translation_; }
+
+    [[nodiscard]] Vec2<T> TransformPoint(const Vec2<T>& point) const
+    {
+        return xAxis_ * point.x + yAxis_ * point.y + translation_;
+    }
+
+    [[nodiscard]] Vec2<T> TransformVector(const Vec2<T>& vector) const
+    {
+        return xAxis_ * vector.x + yAxis_ * vector.y;
+    }
+
+    Affine2 operator*(const Affine2& rhs) const
+    {
+        return Affine2(
+            TransformVector(rhs.xAxis_),
+            TransformVector(rhs.yAxis_),
+            TransformPoint(rhs.translation_));
+    }
+
+    /**
+     * \brief Expands to a column-major Mat4 acting on the xy plane, z is left untouched
+     */
+    [[nodiscard]] Mat4<T> ToMat4() const
+    {
+        return Mat4<T>(std::array<Vec4<T>, 4>{
+            Vec4<T>(xAxis_.x, xAxis_.y, 0, 0),
+            Vec4<T>(yAxis_.x, yAxis_.y, 0, 0),
+            Vec4<T>(0, 0, 1, 0),
+            Vec4<T>(translation_.x, translation_.y, 0, 1)});
+    }
+
+    const static Affine2 Identity;
+private:
+    Vec2<T> xAxis_{1, 0};
+    Vec2<T> yAxis_{0, 1};
+    Vec2<T> translation_{0, 0};
+};
+
+template<typename T>
+inline Affine2<T> const Affine2<T>::Identity = Affine2<T>();
+
+using Affine2f = Affine2<float>;
+static_assert(sizeof(Affine2f) == 6 * sizeof(float), "Affine2f should stay a packed 2x3 matrix");
+}
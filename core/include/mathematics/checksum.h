@@ -2,6 +2,8 @@
 #include <vector>
 #include <numeric>
 #include <cstring>
+#include <cstddef>
+#include <cstdint>
 
 namespace neko
 {
@@ -15,4 +17,55 @@ returnT Checksum(T arg)
     std::memcpy(resultPtr, tPtr, sizeof(T));
     return std::accumulate(result.cbegin(), result.cend(), 0);
 }
+
+/**
+ * \brief CRC32C (Castagnoli) of a buffer, using the SSE4.2 or ARMv8 crc32 instructions when they are enabled.
+ * Pass the previous result as crc to continue a checksum: Crc32c(b, Crc32c(a)) == Crc32c(a + b)
+ */
+std::uint32_t Crc32c(const void* data, std::size_t size, std::uint32_t crc = 0);
+
+/**
+ * \brief 64 bits xxh3-style hash of a buffer, with AVX2 accumulation when it is enabled.
+ * All the paths give the same result, so it can be compared between machines to detect desyncs.
+ */
+std::uint64_t Hash64(const void* data, std::size_t size, std::uint64_t seed = 0);
+
+template<typename T>
+std::uint64_t Hash64(const std::vector<T>& values, std::uint64_t seed = 0)
+{
+    return Hash64(values.data(), values.size() * sizeof(T), seed);
+}
+
+/**
+ * \brief Hashes a buffer as fixed-size chunks and only rehashes the chunks of the dirty ranges,
+ * the chunk hashes are then combined into one Hash64.
+ * Typically one per component array or serialized snapshot, to compare the game state every frame.
+ */
+class ChunkedChecksum
+{
+public:
+    static constexpr std::size_t defaultChunkSize = 4096;
+    /**
+     * \brief A chunk size of zero asserts, and falls back to the default size without the asserts
+     */
+    explicit ChunkedChecksum(std::size_t chunkSize = defaultChunkSize);
+    /**
+     * \brief Marks bytes [offset, offset + size) as modified since the last Update
+     */
+    void SetDirty(std::size_t offset, std::size_t size);
+    void SetAllDirty();
+    /**
+     * \brief Rehashes the dirty chunks of data, chunks are also rehashed when the buffer size changes
+     */
+    std::uint64_t Update(const void* data, std::size_t size);
+    [[nodiscard]] std::uint64_t GetHash() const { return hash_; }
+    [[nodiscard]] std::size_t GetChunkSize() const { return chunkSize_; }
+private:
+    std::size_t chunkSize_;
+    std::size_t size_ = 0;
+    std::uint64_t hash_ = 0;
+    std::vector<std::uint64_t> chunkHashes_;
+    std::vector<bool> dirtyChunks_;
+    bool allDirty_ = true;
+};
 }
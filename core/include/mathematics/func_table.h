@@ -22,41 +22,284 @@
  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
  SOFTWARE.
  */
-#include <functional>
 #include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "engine/intrinsincs.h"
+#include "mathematics/angle.h"
 
 namespace neko
 {
-template<typename T = float, size_t resolution = 512>
+/**
+ * \brief Double precision sine usable in constant expressions, to generate tables at compile time
+ */
+constexpr double ConstexprSin(double x)
+{
+    constexpr double twoPi = 6.283185307179586476925;
+    //Reduce to [-pi, pi]
+    const double turns = x / twoPi;
+    const auto rounded = static_cast<double>(static_cast<std::int64_t>(turns + (turns < 0.0 ? -0.5 : 0.5)));
+    x -= rounded * twoPi;
+    double term = x;
+    double result = x;
+    for (int k = 1; k < 25; k++)
+    {
+        term *= -x * x / static_cast<double>((2 * k) * (2 * k + 1));
+        result += term;
+    }
+    return result;
+}
+
+constexpr double ConstexprCos(double x)
+{
+    return ConstexprSin(x + 1.570796326794896619231);
+}
+
+/**
+ * \brief Double precision exponential usable in constant expressions, to generate tables at compile time
+ */
+constexpr double ConstexprExp(double x)
+{
+    constexpr double ln2 = 0.693147180559945309417;
+    //exp(x) = 2^n * exp(r) with r in [0, ln2)
+    auto n = static_cast<std::int64_t>(x / ln2);
+    if (static_cast<double>(n) * ln2 > x)
+        n--;
+    const double r = x - static_cast<double>(n) * ln2;
+    double term = 1.0;
+    double result = 1.0;
+    for (int k = 1; k < 30; k++)
+    {
+        term *= r / static_cast<double>(k);
+        result += term;
+    }
+    for (; n > 0; n--)
+        result *= 2.0;
+    for (; n < 0; n++)
+        result *= 0.5;
+    return result;
+}
+
+/**
+ * \brief Double precision arc tangent usable in constant expressions, to generate tables at compile time.
+ * Uses the Euler series that converges for every x, quickly when |x| <= 1.
+ */
+constexpr double ConstexprAtan(double x)
+{
+    const double x2 = x * x;
+    const double ratio = x2 / (1.0 + x2);
+    double term = x / (1.0 + x2);
+    double result = term;
+    for (int n = 1; n < 200 && term * term > 1e-40; n++)
+    {
+        term *= ratio * static_cast<double>(2 * n) / static_cast<double>(2 * n + 1);
+        result += term;
+    }
+    return result;
+}
+
+enum class FuncTableInterpolation : std::uint8_t
+{
+    LINEAR,
+    //Catmull-Rom spline through the four nearest samples
+    CUBIC
+};
+
+/**
+ * \brief Samples func at resolution + 1 evenly spaced points of [start, end] in its constexpr constructor,
+ * so a constexpr FuncTable is generated at compile time. Values outside of [start, end] are clamped.
+ * Linear interpolation error is below step^2 / 8 * max|f''|, cubic (Catmull-Rom) interpolation error is of order step^3.
+ */
+template<typename T = float, std::size_t resolution = 512,
+    FuncTableInterpolation interpolation = FuncTableInterpolation::LINEAR>
 class FuncTable
 {
 public:
-    FuncTable(T start, T end, std::function<T(T)> func) : start_(start), end_(end), func_(func)
-    {
+    static_assert(resolution >= 2, "FuncTable needs at least two intervals");
 
+    template<typename Func>
+    constexpr FuncTable(T start, T end, Func func) :
+        start_(start),
+        end_(end),
+        step_((end - start) / T(resolution)),
+        invStep_(T(resolution) / (end - start))
+    {
+        //One sample before start and one after end for the cubic interpolation
+        for (std::size_t i = 0; i < funcTable_.size(); i++)
+        {
+            funcTable_[i] = func(start_ + step_ * (T(i) - T(1)));
+        }
+        //Keep the bounds exact despite the rounding of start + step * i
+        funcTable_[1] = func(start_);
+        funcTable_[resolution + 1] = func(end_);
     }
 
-    void GenerateTable()
+    [[nodiscard]] T GetValue(T x) const
     {
-        size_t i = 0;
-        std::generate(funcTable_.begin(), funcTable_.end(), [this, &i]()
+        T t = (x - start_) * invStep_;
+        //A NaN fails both comparisons and is clamped to the start before the integer cast
+        t = t > T(0) ? t : T(0);
+        t = t < T(resolution) ? t : T(resolution);
+        std::size_t index = static_cast<std::size_t>(t);
+        index = index < resolution ? index : resolution - 1;
+        const T frac = t - T(index);
+        const T* samples = &funcTable_[index];
+        if constexpr (interpolation == FuncTableInterpolation::LINEAR)
+        {
+            return samples[1] + frac * (samples[2] - samples[1]);
+        }
+        else
         {
-            T x = T(i) / T(resolution) * (end_ - start_);
-            i++;
-            return func_(x);
-        });
+            return CatmullRom(samples[0], samples[1], samples[2], samples[3], frac);
+        }
     }
 
-    T GetValue(T x) const
+    /**
+     * \brief Evaluates count values, with AVX2 gathers for float tables
+     */
+    void GetValues(const T* x, T* result, std::size_t count) const
     {
-        size_t index = size_t(x / (end_ - start_) * resolution);
-        return funcTable_[index];
+        std::size_t i = 0;
+#ifdef __AVX2__
+        if constexpr (std::is_same_v<T, float>)
+        {
+            const __m256 start = _mm256_set1_ps(start_);
+            const __m256 invStep = _mm256_set1_ps(invStep_);
+            const __m256 maxT = _mm256_set1_ps(float(resolution));
+            const __m256i maxIndex = _mm256_set1_epi32(static_cast<int>(resolution - 1));
+            for (; i + 8 <= count; i += 8)
+            {
+                __m256 t = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(x + i), start), invStep);
+                //max_ps returns its second operand for a NaN, the index is also clamped from below
+                t = _mm256_min_ps(_mm256_max_ps(t, _mm256_setzero_ps()), maxT);
+                const __m256i index = _mm256_max_epi32(
+                    _mm256_min_epi32(_mm256_cvttps_epi32(t), maxIndex), _mm256_setzero_si256());
+                const __m256 frac = _mm256_sub_ps(t, _mm256_cvtepi32_ps(index));
+                const __m256 p1 = _mm256_i32gather_ps(funcTable_.data() + 1, index, sizeof(float));
+                const __m256 p2 = _mm256_i32gather_ps(funcTable_.data() + 2, index, sizeof(float));
+                if constexpr (interpolation == FuncTableInterpolation::LINEAR)
+                {
+                    _mm256_storeu_ps(result + i, _mm256_fmadd_ps(frac, _mm256_sub_ps(p2, p1), p1));
+                }
+                else
+                {
+                    const __m256 p0 = _mm256_i32gather_ps(funcTable_.data(), index, sizeof(float));
+                    const __m256 p3 = _mm256_i32gather_ps(funcTable_.data() + 3, index, sizeof(float));
+                    const __m256 half = _mm256_set1_ps(0.5f);
+                    //Horner form of the Catmull-Rom polynomial
+                    const __m256 a = _mm256_sub_ps(
+                        _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(3.0f), _mm256_sub_ps(p1, p2)), p3), p0);
+                    const __m256 b = _mm256_sub_ps(
+                        _mm256_add_ps(_mm256_add_ps(p0, p0), _mm256_mul_ps(_mm256_set1_ps(4.0f), p2)),
+                        _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(5.0f), p1), p3));
+                    const __m256 c = _mm256_sub_ps(p2, p0);
+                    __m256 value = _mm256_fmadd_ps(a, frac, b);
+                    value = _mm256_fmadd_ps(value, frac, c);
+                    value = _mm256_fmadd_ps(value, frac, _mm256_add_ps(p1, p1));
+                    _mm256_storeu_ps(result + i, _mm256_mul_ps(value, half));
+                }
+            }
+        }
+#endif
+        for (; i < count; i++)
+        {
+            result[i] = GetValue(x[i]);
+        }
     }
 
+    [[nodiscard]] constexpr T GetStart() const { return start_; }
+    [[nodiscard]] constexpr T GetEnd() const { return end_; }
 private:
+    static T CatmullRom(T p0, T p1, T p2, T p3, T t)
+    {
+        const T a = T(3) * (p1 - p2) + p3 - p0;
+        const T b = T(2) * p0 - T(5) * p1 + T(4) * p2 - p3;
+        const T c = p2 - p0;
+        return T(0.5) * (((a * t + b) * t + c) * t + T(2) * p1);
+    }
+
     T start_ = 0.0f;
     T end_ = 1.0f;
-    std::array<T, resolution> funcTable_;
-    std::function<T(T)> func_;
+    T step_ = 1.0f;
+    T invStep_ = 1.0f;
+    std::array<T, resolution + 3> funcTable_{};
 };
-}
\ No newline at end of file
+
+/**
+ * \brief 1024 intervals of sin on [0, 2pi], max absolute error 5e-6
+ */
+inline constexpr FuncTable<float, 1024> sinTable(0.0f, 6.283185307179586f,
+    [](float x) { return static_cast<float>(ConstexprSin(x)); });
+/**
+ * \brief 512 intervals of atan on [0, 1], max absolute error 6e-7
+ */
+inline constexpr FuncTable<float, 512> atanTable(0.0f, 1.0f,
+    [](float x) { return static_cast<float>(ConstexprAtan(x)); });
+/**
+ * \brief 256 intervals of exp on [0, ln2], max relative error 2e-6
+ */
+inline constexpr FuncTable<float, 256> expTable(0.0f, 0.6931471805599453f,
+    [](float x) { return static_cast<float>(ConstexprExp(x)); });
+
+/**
+ * \brief Table sine, max absolute error 5e-6
+ */
+inline float SinLut(radian_t angle)
+{
+    //The reduction is done in double, in float it would dominate the error for large angles
+    constexpr double twoPi = 6.283185307179586;
+    constexpr double invTwoPi = 0.15915494309189535;
+    const double x = angle.value();
+    return sinTable.GetValue(static_cast<float>(x - twoPi * std::floor(x * invTwoPi)));
+}
+
+/**
+ * \brief Table cosine, same error bound as SinLut
+ */
+inline float CosLut(radian_t angle)
+{
+    constexpr double twoPi = 6.283185307179586;
+    constexpr double invTwoPi = 0.15915494309189535;
+    const double x = static_cast<double>(angle.value()) + 1.5707963267948966;
+    return sinTable.GetValue(static_cast<float>(x - twoPi * std::floor(x * invTwoPi)));
+}
+
+/**
+ * \brief Table atan2, max absolute error 6e-7 rad, returns 0 for (0, 0)
+ */
+inline radian_t Atan2Lut(float y, float x)
+{
+    constexpr float halfPi = 1.5707963267948966f;
+    constexpr float pi = 3.141592653589793f;
+    const float absX = std::abs(x);
+    const float absY = std::abs(y);
+    const float maxAbs = absX > absY ? absX : absY;
+    if (maxAbs == 0.0f)
+        return radian_t(0.0f);
+    const float minAbs = absX > absY ? absY : absX;
+    float result = atanTable.GetValue(minAbs / maxAbs);
+    if (absY > absX)
+        result = halfPi - result;
+    if (x < 0.0f)
+        result = pi - result;
+    if (y < 0.0f)
+        result = -result;
+    return radian_t(result);
+}
+
+/**
+ * \brief Table exponential, max relative error 2e-6 when the result is a normal float
+ */
+inline float ExpLut(float x)
+{
+    //ln2 split in two so that n * ln2Hi is exact in float
+    constexpr float ln2Hi = 0.693145751953125f;
+    constexpr float ln2Lo = 1.428606820309417e-6f;
+    constexpr float invLn2 = 1.4426950408889634f;
+    const float n = std::floor(x * invLn2);
+    return std::ldexp(expTable.GetValue(x - n * ln2Hi - n * ln2Lo), static_cast<int>(n));
+}
+}
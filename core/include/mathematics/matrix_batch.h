@@ -0,0 +1,80 @@
+#pragma once
+
+/*
+ MIT License
+
+ Copyright (c) 2020 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#include <cstddef>
+
+#include "engine/intrinsincs.h"
+#include "mathematics/matrix.h"
+#include "mathematics/vector.h"
+
+namespace neko
+{
+/**
+ * \brief Structure of arrays input for ComposeTrsBatch, every array must hold at least count elements.
+ * Rotations are unit quaternions.
+ */
+struct TrsSoA
+{
+	const float* positionX = nullptr;
+	const float* positionY = nullptr;
+	const float* positionZ = nullptr;
+	const float* rotationX = nullptr;
+	const float* rotationY = nullptr;
+	const float* rotationZ = nullptr;
+	const float* rotationW = nullptr;
+	const float* scaleX = nullptr;
+	const float* scaleY = nullptr;
+	const float* scaleZ = nullptr;
+};
+
+/**
+ * \brief Returns the instruction set used by the batch kernels, selected at the first call from GetCpuSimdLevel
+ */
+SimdLevel GetMat4BatchLevel();
+/**
+ * \brief Forces the instruction set of the batch kernels, used by tests and benchmarks to compare the variants.
+ * Returns false and keeps the current kernels if the CPU does not support the level.
+ */
+bool SetMat4BatchLevel(SimdLevel level);
+
+/**
+ * \brief result[i] = lhs[i] * rhs[i], result can alias lhs or rhs
+ */
+void MultiplyMat4Batch(const Mat4f* lhs, const Mat4f* rhs, Mat4f* result, std::size_t count);
+/**
+ * \brief result[i] = transform * points[i], result can alias points
+ */
+void TransformPointsBatch(const Mat4f& transform, const Vec4f* points, Vec4f* result, std::size_t count);
+/**
+ * \brief Transforms positions with an implicit w of 1, result can alias points
+ */
+void TransformPointsBatch(const Mat4f& transform, const Vec3f* points, Vec3f* result, std::size_t count);
+/**
+ * \brief result[i] = Translation * Rotation * Scale for each entity.
+ * The rotation columns are the rotated basis axes, like the OpenGL column-major convention.
+ */
+void ComposeTrsBatch(const TrsSoA& trs, Mat4f* result, std::size_t count);
+}
@@ -22,6 +22,8 @@
  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
  SOFTWARE.
  */
+#include <algorithm>
+
 #include <engine/component.h>
 #include <mathematics/vector.h>
 #include "mathematics/trigo.h"
@@ -154,6 +156,20 @@ struct Quaternion
 		);
 	}
 
+	/*
+	Returns the euler angles of a unit quaternion built as
+	AngleAxis(z, forward) * AngleAxis(y, up) * AngleAxis(x, right),
+	that rotates around the x axis, then the y axis, then the z axis
+	*/
+	EulerAngles ToEuler() const
+	{
+		const float sinY = std::clamp(2.0f * (w * y - z * x), -1.0f, 1.0f);
+		return EulerAngles(
+			Atan2(2.0f * (w * x + y * z), 1.0f - 2.0f * (x * x + y * y)),
+			Asin(sinY),
+			Atan2(2.0f * (w * z + x * y), 1.0f - 2.0f * (y * y + z * z)));
+	}
+
 	static Quaternion Identity()
 	{
 		return Quaternion(0, 0, 0, 1);
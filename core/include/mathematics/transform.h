@@ -39,6 +39,12 @@ Mat4<float> const RotationMatrixFrom(const EulerAngles cardinalRotation);
 
 Mat4f const RotationMatrixFrom(const Quaternion& quaternion);
 
+/**
+ * \brief Builds Translation * Rotation * Scale directly from a unit quaternion, without intermediate matrix multiplications.
+ * The rotation columns are the rotated basis axes, see ComposeTrsBatch for the batched version.
+ */
+Mat4f const TrsMatrixFrom(const Vec3f& translation, const Quaternion& rotation, const Vec3f& scale);
+
 
 
 Mat4f Translate(const Mat4f& transform, const Vec3f translation);
@@ -23,6 +23,7 @@
  SOFTWARE.
  */
 
+#include <algorithm>
 #include <mathematics/vector.h>
 #include "engine/intrinsincs.h"
 namespace neko
@@ -86,31 +87,35 @@ public:
     //-----------------------------------------------------------------------------
     NVec2<T, N> operator+(const Vec2<T>& rhs) const
     {
-        NVec2<T, N> v = this;
-        std::for_each(v.xs.begin(), v.xs.end(), [rhs](T x) { return x + rhs.x; });
-        std::for_each(v.ys.begin(), v.ys.end(), [rhs](T y) { return y + rhs.y; });
+        NVec2<T, N> v = *this;
+        v += rhs;
         return v;
     }
 
     NVec2<T, N>& operator+=(const Vec2<T>& rhs)
     {
-        std::for_each(xs.begin(), xs.end(), [rhs](T x) { return x + rhs.x; });
-        std::for_each(ys.begin(), ys.end(), [rhs](T y) { return y + rhs.y; });
+        for (int i = 0; i < N; i++)
+        {
+            xs[i] += rhs.x;
+            ys[i] += rhs.y;
+        }
         return *this;
     }
 
     NVec2<T, N> operator-(const Vec2<T>& rhs) const
     {
-        NVec2<T, N> v = this;
-        std::for_each(v.xs.begin(), v.xs.end(), [rhs](T x) { return x - rhs.x; });
-        std::for_each(v.ys.begin(), v.ys.end(), [rhs](T y) { return y - rhs.y; });
+        NVec2<T, N> v = *this;
+        v -= rhs;
         return v;
     }
 
     NVec2<T, N>& operator-=(const Vec2<T>& rhs)
     {
-        std::for_each(xs.begin(), xs.end(), [rhs](T x) { return x - rhs.x; });
-        std::for_each(ys.begin(), ys.end(), [rhs](T y) { return y - rhs.y; });
+        for (int i = 0; i < N; i++)
+        {
+            xs[i] -= rhs.x;
+            ys[i] -= rhs.y;
+        }
         return *this;
     }
 
@@ -197,11 +202,23 @@ public:
         return result;
     }
 
-    static std::array<T, N> DotIntrinsics(NVec2<T, N> v1, NVec2<T, N> v2);
-    static std::array<T, N> DotIntrinsics(NVec2<T, N> v1, Vec2<T> v2);
-    std::array<T, N> SquareMagnitudeIntrinsics() const;
-    std::array<T, N> MagnitudeIntrinsics() const;
-    NVec2<T, N> NormalizedIntrinsics();
+    static std::array<T, N> Dot(NVec2<T, N> v1, Vec2<T> v2)
+    {
+        std::array<T, N> result;
+        for (int i = 0; i < N; i++)
+        {
+            result[i] = v1.xs[i] * v2.x +
+                        v1.ys[i] * v2.y;
+        }
+        return result;
+    }
+
+    //Intrinsics versions are specialized for each available vector width, the others use the scalar formulas
+    static std::array<T, N> DotIntrinsics(NVec2<T, N> v1, NVec2<T, N> v2) { return Dot(v1, v2); }
+    static std::array<T, N> DotIntrinsics(NVec2<T, N> v1, Vec2<T> v2) { return Dot(v1, v2); }
+    std::array<T, N> SquareMagnitudeIntrinsics() const { return SquareMagnitude(); }
+    std::array<T, N> MagnitudeIntrinsics() const { return Magnitude(); }
+    NVec2<T, N> NormalizedIntrinsics() { return Normalized(); }
 };
 
 //-----------------------------------------------------------------------------
@@ -240,8 +257,8 @@ inline std::array<float, 4> FourVec2f::DotIntrinsics(FourVec2f v1, Vec2f v2)
     auto x1 = _mm_load_ps(v1.xs.data());
     auto y1 = _mm_load_ps(v1.ys.data());
 
-    auto x2 = _mm_load_ps(&v2.x);
-    auto y2 = _mm_load_ps(&v2.y);
+    auto x2 = _mm_set1_ps(v2.x);
+    auto y2 = _mm_set1_ps(v2.y);
 
     x1 = _mm_mul_ps(x1, x2);
     y1 = _mm_mul_ps(y1, y2);
@@ -288,7 +305,9 @@ inline FourVec2f FourVec2f::NormalizedIntrinsics()
     auto x = _mm_load_ps(xs.data());
     auto y = _mm_load_ps(ys.data());
 
-    auto mag = _mm_load_ps(MagnitudeIntrinsics().data());
+    alignas(4 * sizeof(float))
+    const std::array<float, 4> magnitudes = MagnitudeIntrinsics();
+    auto mag = _mm_load_ps(magnitudes.data());
 
     x = _mm_div_ps(x, mag);
     y = _mm_div_ps(y, mag);
@@ -306,17 +325,17 @@ inline std::array<float, 8> EightVec2f::DotIntrinsics(EightVec2f v1, EightVec2f
 {
     alignas(8 * sizeof(float))
     std::array<float, 8> result;
-    auto x1 = _mm_load_ps(v1.xs.data());
-    auto y1 = _mm_load_ps(v1.ys.data());
+    auto x1 = _mm256_load_ps(v1.xs.data());
+    auto y1 = _mm256_load_ps(v1.ys.data());
 
-    auto x2 = _mm_load_ps(v2.xs.data());
-    auto y2 = _mm_load_ps(v2.ys.data());
+    auto x2 = _mm256_load_ps(v2.xs.data());
+    auto y2 = _mm256_load_ps(v2.ys.data());
 
-    x1 = _mm_mul_ps(x1, x2);
-    y1 = _mm_mul_ps(y1, y2);
+    x1 = _mm256_mul_ps(x1, x2);
+    y1 = _mm256_mul_ps(y1, y2);
 
-    x1 = _mm_add_ps(x1, y1);
-    _mm_store_ps(result.data(), x1);
+    x1 = _mm256_add_ps(x1, y1);
+    _mm256_store_ps(result.data(), x1);
     return result;
 }
 template <>
@@ -324,17 +343,17 @@ inline std::array<float, 8> EightVec2f::DotIntrinsics(EightVec2f v1, Vec2f v2)
 {
     alignas(8 * sizeof(float))
     std::array<float, 8> result;
-    auto x1 = _mm_load_ps(v1.xs.data());
-    auto y1 = _mm_load_ps(v1.ys.data());
+    auto x1 = _mm256_load_ps(v1.xs.data());
+    auto y1 = _mm256_load_ps(v1.ys.data());
 
-    auto x2 = _mm_load_ps(&v2.x);
-    auto y2 = _mm_load_ps(&v2.y);
+    auto x2 = _mm256_set1_ps(v2.x);
+    auto y2 = _mm256_set1_ps(v2.y);
 
-    x1 = _mm_mul_ps(x1, x2);
-    y1 = _mm_mul_ps(y1, y2);
+    x1 = _mm256_mul_ps(x1, x2);
+    y1 = _mm256_mul_ps(y1, y2);
 
-    x1 = _mm_add_ps(x1, y1);
-    _mm_store_ps(result.data(), x1);
+    x1 = _mm256_add_ps(x1, y1);
+    _mm256_store_ps(result.data(), x1);
     return result;
 }
 template<>
@@ -372,15 +391,17 @@ template<>
 inline EightVec2f EightVec2f::NormalizedIntrinsics()
 {
     EightVec2f result;
-    auto x = _mm_load_ps(xs.data());
-    auto y = _mm_load_ps(ys.data());
-    auto mag = _mm_load_ps(MagnitudeIntrinsics().data());
+    auto x = _mm256_load_ps(xs.data());
+    auto y = _mm256_load_ps(ys.data());
+    alignas(8 * sizeof(float))
+    const std::array<float, 8> magnitudes = MagnitudeIntrinsics();
+    auto mag = _mm256_load_ps(magnitudes.data());
 
-    x = _mm_div_ps(x, mag);
-    y = _mm_div_ps(y, mag);
+    x = _mm256_div_ps(x, mag);
+    y = _mm256_div_ps(y, mag);
 
-    _mm_store_ps(result.xs.data(), x);
-    _mm_store_ps(result.ys.data(), y);
+    _mm256_store_ps(result.xs.data(), x);
+    _mm256_store_ps(result.ys.data(), y);
 
     return result;
 }
@@ -445,43 +466,107 @@ public:
         }
     }
 
+    /// \brief Packs count AoS vectors, the remaining lanes are set to zero
+    NVec3(const Vec3<T>* aosV, int count)
+            : xs{}, ys{}, zs{}
+    {
+        for (int i = 0; i < count && i < N; i++)
+        {
+            xs[i] = aosV[i].x;
+            ys[i] = aosV[i].y;
+            zs[i] = aosV[i].z;
+        }
+    }
+
+    /// \brief Unpacks the first count lanes back to AoS vectors
+    void Store(Vec3<T>* aosV, int count = N) const
+    {
+        for (int i = 0; i < count && i < N; i++)
+        {
+            aosV[i] = Vec3<T>(xs[i], ys[i], zs[i]);
+        }
+    }
+
+    Vec3<T> Get(int i) const
+    {
+        return Vec3<T>(xs[i], ys[i], zs[i]);
+    }
+
     //-----------------------------------------------------------------------------
     // Operators
     //-----------------------------------------------------------------------------
     NVec3<T, N> operator+(const Vec3<T>& rhs) const
     {
-        NVec3<T, N> v = this;
-        std::for_each(v.xs.begin(), v.xs.end(), [rhs](T x) { return x + rhs.x; });
-        std::for_each(v.ys.begin(), v.ys.end(), [rhs](T y) { return y + rhs.y; });
-        std::for_each(v.zs.begin(), v.zs.end(), [rhs](T z) { return z + rhs.z; });
+        NVec3<T, N> v = *this;
+        v += rhs;
         return v;
     }
 
     NVec3<T, N>& operator+=(const Vec3<T>& rhs)
     {
-        std::for_each(xs.begin(), xs.end(), [rhs](T x) { return x + rhs.x; });
-        std::for_each(ys.begin(), ys.end(), [rhs](T y) { return y + rhs.y; });
-        std::for_each(zs.begin(), zs.end(), [rhs](T z) { return z + rhs.z; });
+        for (int i = 0; i < N; i++)
+        {
+            xs[i] += rhs.x;
+            ys[i] += rhs.y;
+            zs[i] += rhs.z;
+        }
         return *this;
     }
 
     NVec3<T, N> operator-(const Vec3<T>& rhs) const
     {
-        NVec3<T, N> v = this;
-        std::for_each(v.xs.begin(), v.xs.end(), [rhs](T x) { return x - rhs.x; });
-        std::for_each(v.ys.begin(), v.ys.end(), [rhs](T y) { return y - rhs.y; });
-        std::for_each(v.zs.begin(), v.zs.end(), [rhs](T z) { return z - rhs.z; });
+        NVec3<T, N> v = *this;
+        v -= rhs;
         return v;
     }
 
     NVec3<T, N>& operator-=(const Vec3<T>& rhs)
     {
-        std::for_each(xs.begin(), xs.end(), [rhs](T x) { return x - rhs.x; });
-        std::for_each(ys.begin(), ys.end(), [rhs](T y) { return y - rhs.y; });
-        std::for_each(zs.begin(), zs.end(), [rhs](T z) { return z - rhs.z; });
+        for (int i = 0; i < N; i++)
+        {
+            xs[i] -= rhs.x;
+            ys[i] -= rhs.y;
+            zs[i] -= rhs.z;
+        }
         return *this;
     }
 
+    NVec3<T, N> operator+(const NVec3<T, N>& rhs) const
+    {
+        NVec3<T, N> v;
+        for (int i = 0; i < N; i++)
+        {
+            v.xs[i] = xs[i] + rhs.xs[i];
+            v.ys[i] = ys[i] + rhs.ys[i];
+            v.zs[i] = zs[i] + rhs.zs[i];
+        }
+        return v;
+    }
+
+    NVec3<T, N> operator-(const NVec3<T, N>& rhs) const
+    {
+        NVec3<T, N> v;
+        for (int i = 0; i < N; i++)
+        {
+            v.xs[i] = xs[i] - rhs.xs[i];
+            v.ys[i] = ys[i] - rhs.ys[i];
+            v.zs[i] = zs[i] - rhs.zs[i];
+        }
+        return v;
+    }
+
+    NVec3<T, N> operator*(T rhs) const
+    {
+        NVec3<T, N> v;
+        for (int i = 0; i < N; i++)
+        {
+            v.xs[i] = xs[i] * rhs;
+            v.ys[i] = ys[i] * rhs;
+            v.zs[i] = zs[i] * rhs;
+        }
+        return v;
+    }
+
     //-----------------------------------------------------------------------------
     // Formulas
     //-----------------------------------------------------------------------------
@@ -497,6 +582,30 @@ public:
         return result;
     }
 
+    static std::array<T, N> Dot(NVec3<T, N> v1, Vec3<T> v2)
+    {
+        std::array<T, N> result;
+        for (int i = 0; i < N; i++)
+        {
+            result[i] = v1.xs[i] * v2.x +
+                        v1.ys[i] * v2.y +
+                        v1.zs[i] * v2.z;
+        }
+        return result;
+    }
+
+    static NVec3<T, N> Cross(const NVec3<T, N>& v1, const NVec3<T, N>& v2)
+    {
+        NVec3<T, N> result;
+        for (int i = 0; i < N; i++)
+        {
+            result.xs[i] = v1.ys[i] * v2.zs[i] - v1.zs[i] * v2.ys[i];
+            result.ys[i] = v1.zs[i] * v2.xs[i] - v1.xs[i] * v2.zs[i];
+            result.zs[i] = v1.xs[i] * v2.ys[i] - v1.ys[i] * v2.xs[i];
+        }
+        return result;
+    }
+
     std::array<T, N> SquareMagnitude() const
     {
         std::array<T, N> result;
@@ -531,6 +640,43 @@ public:
         return result;
     }
 
+    static NVec3<T, N> Min(const NVec3<T, N>& v1, const NVec3<T, N>& v2)
+    {
+        NVec3<T, N> result;
+        for (int i = 0; i < N; i++)
+        {
+            result.xs[i] = std::min(v1.xs[i], v2.xs[i]);
+            result.ys[i] = std::min(v1.ys[i], v2.ys[i]);
+            result.zs[i] = std::min(v1.zs[i], v2.zs[i]);
+        }
+        return result;
+    }
+
+    static NVec3<T, N> Max(const NVec3<T, N>& v1, const NVec3<T, N>& v2)
+    {
+        NVec3<T, N> result;
+        for (int i = 0; i < N; i++)
+        {
+            result.xs[i] = std::max(v1.xs[i], v2.xs[i]);
+            result.ys[i] = std::max(v1.ys[i], v2.ys[i]);
+            result.zs[i] = std::max(v1.zs[i], v2.zs[i]);
+        }
+        return result;
+    }
+
+    /// \brief Component-wise v1 * v2 + v3
+    static NVec3<T, N> MultiplyAdd(const NVec3<T, N>& v1, const NVec3<T, N>& v2, const NVec3<T, N>& v3)
+    {
+        NVec3<T, N> result;
+        for (int i = 0; i < N; i++)
+        {
+            result.xs[i] = v1.xs[i] * v2.xs[i] + v3.xs[i];
+            result.ys[i] = v1.ys[i] * v2.ys[i] + v3.ys[i];
+            result.zs[i] = v1.zs[i] * v2.zs[i] + v3.zs[i];
+        }
+        return result;
+    }
+
     static NVec3<T, N> Lerp(const NVec3<T, N>& v1, const NVec3<T, N>& v2, T t)
     {
         NVec3<T, N> result;
@@ -547,7 +693,7 @@ public:
     {
         NVec3<T, N> result;
         NVec3<T, N> normalized = normal.Normalized();
-        std::array<T, N> dot = Dot(inVec, normal);
+        std::array<T, N> dot = Dot(inVec, normalized);
         for (int i = 0; i < N; i++)
         {
             result.xs[i] = inVec.xs[i] - normalized.xs[i] * 2 * dot[i];
@@ -557,12 +703,21 @@ public:
         return result;
     }
 
-    static std::array<T, N> DotIntrinsics(NVec3<T, N> v1, NVec3<T, N> v2);
-    static std::array<T, N> DotIntrinsics(NVec3<T, N> v1, Vec3<T> v2);
-    std::array<T, N> SquareMagnitudeIntrinsics() const;
-    std::array<T, N> MagnitudeIntrinsics() const;
-    NVec3<T, N> NormalizedIntrinsics();
-    static NVec3<T, N> ReflectIntrinsics(NVec3<T, N> inVec, NVec3<T, N> normal);
+    //Intrinsics versions are specialized for each available vector width, the others use the scalar formulas
+    static std::array<T, N> DotIntrinsics(NVec3<T, N> v1, NVec3<T, N> v2) { return Dot(v1, v2); }
+    static std::array<T, N> DotIntrinsics(NVec3<T, N> v1, Vec3<T> v2) { return Dot(v1, v2); }
+    std::array<T, N> SquareMagnitudeIntrinsics() const { return SquareMagnitude(); }
+    std::array<T, N> MagnitudeIntrinsics() const { return Magnitude(); }
+    NVec3<T, N> NormalizedIntrinsics() { return Normalized(); }
+    static NVec3<T, N> ReflectIntrinsics(NVec3<T, N> inVec, NVec3<T, N> normal) { return Reflect(inVec, normal); }
+    static NVec3<T, N> CrossIntrinsics(const NVec3<T, N>& v1, const NVec3<T, N>& v2) { return Cross(v1, v2); }
+    static NVec3<T, N> MinIntrinsics(const NVec3<T, N>& v1, const NVec3<T, N>& v2) { return Min(v1, v2); }
+    static NVec3<T, N> MaxIntrinsics(const NVec3<T, N>& v1, const NVec3<T, N>& v2) { return Max(v1, v2); }
+    static NVec3<T, N> MultiplyAddIntrinsics(const NVec3<T, N>& v1, const NVec3<T, N>& v2, const NVec3<T, N>& v3)
+    {
+        return MultiplyAdd(v1, v2, v3);
+    }
+    static NVec3<T, N> LerpIntrinsics(const NVec3<T, N>& v1, const NVec3<T, N>& v2, T t) { return Lerp(v1, v2, t); }
 };
 
 //-----------------------------------------------------------------------------
@@ -570,6 +725,7 @@ public:
 //-----------------------------------------------------------------------------
 using FourVec3f = NVec3<float, 4>;
 using EightVec3f = NVec3<float, 8>;
+using SixteenVec3f = NVec3<float, 16>;
 
 //-----------------------------------------------------------------------------
 // NVec3 Implementations
@@ -606,9 +762,9 @@ inline std::array<float, 4> FourVec3f::DotIntrinsics(FourVec3f v1, Vec3f v2)
     auto y1 = _mm_load_ps(v1.ys.data());
     auto z1 = _mm_load_ps(v1.zs.data());
 
-    auto x2 = _mm_load_ps(&v2.x);
-    auto y2 = _mm_load_ps(&v2.y);
-    auto z2 = _mm_load_ps(&v2.z);
+    auto x2 = _mm_set1_ps(v2.x);
+    auto y2 = _mm_set1_ps(v2.y);
+    auto z2 = _mm_set1_ps(v2.z);
 
     x1 = _mm_mul_ps(x1, x2);
     y1 = _mm_mul_ps(y1, y2);
@@ -664,7 +820,9 @@ inline FourVec3f FourVec3f::NormalizedIntrinsics()
     auto y = _mm_load_ps(ys.data());
     auto z = _mm_load_ps(zs.data());
 
-    auto mag = _mm_load_ps(MagnitudeIntrinsics().data());
+    alignas(4 * sizeof(float))
+    const std::array<float, 4> magnitudes = MagnitudeIntrinsics();
+    auto mag = _mm_load_ps(magnitudes.data());
 
     x = _mm_div_ps(x, mag);
     y = _mm_div_ps(y, mag);
@@ -686,18 +844,18 @@ inline FourVec3f FourVec3f::ReflectIntrinsics(FourVec3f inVec, FourVec3f normal)
     auto yi = _mm_load_ps(inVec.ys.data());
     auto zi = _mm_load_ps(inVec.zs.data());
 
-    auto dot = _mm_load_ps(DotIntrinsics(inVec, normal).data());
+    alignas(4 * sizeof(float))
+    const std::array<float, 4> dots = DotIntrinsics(inVec, normal);
+    auto dot = _mm_load_ps(dots.data());
 
     auto xn = _mm_load_ps(normal.xs.data());
     auto yn = _mm_load_ps(normal.ys.data());
     auto zn = _mm_load_ps(normal.zs.data());
-    const float multiplier = 2.0f;
-    const auto twos = _mm_load1_ps(&multiplier);
+    const auto twos = _mm_set1_ps(2.0f);
 
     xn = _mm_mul_ps(xn, twos);
     yn = _mm_mul_ps(yn, twos);
     zn = _mm_mul_ps(zn, twos);
-
     xn = _mm_mul_ps(xn, dot);
     yn = _mm_mul_ps(yn, dot);
     zn = _mm_mul_ps(zn, dot);
@@ -712,6 +870,87 @@ inline FourVec3f FourVec3f::ReflectIntrinsics(FourVec3f inVec, FourVec3f normal)
 
     return result;
 }
+template<>
+inline FourVec3f FourVec3f::CrossIntrinsics(const FourVec3f& v1, const FourVec3f& v2)
+{
+    FourVec3f result;
+    auto x1 = _mm_load_ps(v1.xs.data());
+    auto y1 = _mm_load_ps(v1.ys.data());
+    auto z1 = _mm_load_ps(v1.zs.data());
+
+    auto x2 = _mm_load_ps(v2.xs.data());
+    auto y2 = _mm_load_ps(v2.ys.data());
+    auto z2 = _mm_load_ps(v2.zs.data());
+
+    auto x = _mm_sub_ps(_mm_mul_ps(y1, z2), _mm_mul_ps(z1, y2));
+    auto y = _mm_sub_ps(_mm_mul_ps(z1, x2), _mm_mul_ps(x1, z2));
+    auto z = _mm_sub_ps(_mm_mul_ps(x1, y2), _mm_mul_ps(y1, x2));
+
+    _mm_store_ps(result.xs.data(), x);
+    _mm_store_ps(result.ys.data(), y);
+    _mm_store_ps(result.zs.data(), z);
+
+    return result;
+}
+template<>
+inline FourVec3f FourVec3f::MinIntrinsics(const FourVec3f& v1, const FourVec3f& v2)
+{
+    FourVec3f result;
+    _mm_store_ps(result.xs.data(), _mm_min_ps(_mm_load_ps(v1.xs.data()), _mm_load_ps(v2.xs.data())));
+    _mm_store_ps(result.ys.data(), _mm_min_ps(_mm_load_ps(v1.ys.data()), _mm_load_ps(v2.ys.data())));
+    _mm_store_ps(result.zs.data(), _mm_min_ps(_mm_load_ps(v1.zs.data()), _mm_load_ps(v2.zs.data())));
+
+    return result;
+}
+template<>
+inline FourVec3f FourVec3f::MaxIntrinsics(const FourVec3f& v1, const FourVec3f& v2)
+{
+    FourVec3f result;
+    _mm_store_ps(result.xs.data(), _mm_max_ps(_mm_load_ps(v1.xs.data()), _mm_load_ps(v2.xs.data())));
+    _mm_store_ps(result.ys.data(), _mm_max_ps(_mm_load_ps(v1.ys.data()), _mm_load_ps(v2.ys.data())));
+    _mm_store_ps(result.zs.data(), _mm_max_ps(_mm_load_ps(v1.zs.data()), _mm_load_ps(v2.zs.data())));
+
+    return result;
+}
+template<>
+inline FourVec3f FourVec3f::MultiplyAddIntrinsics(const FourVec3f& v1, const FourVec3f& v2, const FourVec3f& v3)
+{
+    FourVec3f result;
+#ifdef __FMA__
+    auto x = _mm_fmadd_ps(_mm_load_ps(v1.xs.data()), _mm_load_ps(v2.xs.data()), _mm_load_ps(v3.xs.data()));
+    auto y = _mm_fmadd_ps(_mm_load_ps(v1.ys.data()), _mm_load_ps(v2.ys.data()), _mm_load_ps(v3.ys.data()));
+    auto z = _mm_fmadd_ps(_mm_load_ps(v1.zs.data()), _mm_load_ps(v2.zs.data()), _mm_load_ps(v3.zs.data()));
+#else
+    auto x = _mm_add_ps(_mm_mul_ps(_mm_load_ps(v1.xs.data()), _mm_load_ps(v2.xs.data())), _mm_load_ps(v3.xs.data()));
+    auto y = _mm_add_ps(_mm_mul_ps(_mm_load_ps(v1.ys.data()), _mm_load_ps(v2.ys.data())), _mm_load_ps(v3.ys.data()));
+    auto z = _mm_add_ps(_mm_mul_ps(_mm_load_ps(v1.zs.data()), _mm_load_ps(v2.zs.data())), _mm_load_ps(v3.zs.data()));
+#endif
+
+    _mm_store_ps(result.xs.data(), x);
+    _mm_store_ps(result.ys.data(), y);
+    _mm_store_ps(result.zs.data(), z);
+
+    return result;
+}
+template<>
+inline FourVec3f FourVec3f::LerpIntrinsics(const FourVec3f& v1, const FourVec3f& v2, float t)
+{
+    FourVec3f result;
+    const auto ts = _mm_set1_ps(t);
+
+    auto x1 = _mm_load_ps(v1.xs.data());
+    auto x = _mm_add_ps(x1, _mm_mul_ps(_mm_sub_ps(_mm_load_ps(v2.xs.data()), x1), ts));
+    auto y1 = _mm_load_ps(v1.ys.data());
+    auto y = _mm_add_ps(y1, _mm_mul_ps(_mm_sub_ps(_mm_load_ps(v2.ys.data()), y1), ts));
+    auto z1 = _mm_load_ps(v1.zs.data());
+    auto z = _mm_add_ps(z1, _mm_mul_ps(_mm_sub_ps(_mm_load_ps(v2.zs.data()), z1), ts));
+
+    _mm_store_ps(result.xs.data(), x);
+    _mm_store_ps(result.ys.data(), y);
+    _mm_store_ps(result.zs.data(), z);
+
+    return result;
+}
 #endif
 
 #ifdef __AVX2__
@@ -720,21 +959,21 @@ inline std::array<float, 8> EightVec3f::DotIntrinsics(EightVec3f v1, EightVec3f
 {
     alignas(8 * sizeof(float))
     std::array<float, 8> result;
-    auto x1 = _mm_load_ps(v1.xs.data());
-    auto y1 = _mm_load_ps(v1.ys.data());
-    auto z1 = _mm_load_ps(v1.zs.data());
+    auto x1 = _mm256_load_ps(v1.xs.data());
+    auto y1 = _mm256_load_ps(v1.ys.data());
+    auto z1 = _mm256_load_ps(v1.zs.data());
 
-    auto x2 = _mm_load_ps(v2.xs.data());
-    auto y2 = _mm_load_ps(v2.ys.data());
-    auto z2 = _mm_load_ps(v2.zs.data());
+    auto x2 = _mm256_load_ps(v2.xs.data());
+    auto y2 = _mm256_load_ps(v2.ys.data());
+    auto z2 = _mm256_load_ps(v2.zs.data());
 
-    x1 = _mm_mul_ps(x1, x2);
-    y1 = _mm_mul_ps(y1, y2);
-    z1 = _mm_mul_ps(z1, z2);
+    x1 = _mm256_mul_ps(x1, x2);
+    y1 = _mm256_mul_ps(y1, y2);
+    z1 = _mm256_mul_ps(z1, z2);
 
-    x1 = _mm_add_ps(x1, y1);
-    x1 = _mm_add_ps(x1, z1);
-    _mm_store_ps(result.data(), x1);
+    x1 = _mm256_add_ps(x1, y1);
+    x1 = _mm256_add_ps(x1, z1);
+    _mm256_store_ps(result.data(), x1);
     return result;
 }
 template <>
@@ -742,21 +981,21 @@ inline std::array<float, 8> EightVec3f::DotIntrinsics(EightVec3f v1, Vec3f v2)
 {
     alignas(8 * sizeof(float))
     std::array<float, 8> result;
-    auto x1 = _mm_load_ps(v1.xs.data());
-    auto y1 = _mm_load_ps(v1.ys.data());
-    auto z1 = _mm_load_ps(v1.zs.data());
+    auto x1 = _mm256_load_ps(v1.xs.data());
+    auto y1 = _mm256_load_ps(v1.ys.data());
+    auto z1 = _mm256_load_ps(v1.zs.data());
 
-    auto x2 = _mm_load_ps(&v2.x);
-    auto y2 = _mm_load_ps(&v2.y);
-    auto z2 = _mm_load_ps(&v2.z);
+    auto x2 = _mm256_set1_ps(v2.x);
+    auto y2 = _mm256_set1_ps(v2.y);
+    auto z2 = _mm256_set1_ps(v2.z);
 
-    x1 = _mm_mul_ps(x1, x2);
-    y1 = _mm_mul_ps(y1, y2);
-    z1 = _mm_mul_ps(z1, z2);
+    x1 = _mm256_mul_ps(x1, x2);
+    y1 = _mm256_mul_ps(y1, y2);
+    z1 = _mm256_mul_ps(z1, z2);
 
-    x1 = _mm_add_ps(x1, y1);
-    x1 = _mm_add_ps(x1, z1);
-    _mm_store_ps(result.data(), x1);
+    x1 = _mm256_add_ps(x1, y1);
+    x1 = _mm256_add_ps(x1, z1);
+    _mm256_store_ps(result.data(), x1);
     return result;
 }
 template<>
@@ -800,19 +1039,21 @@ template<>
 inline EightVec3f EightVec3f::NormalizedIntrinsics()
 {
     EightVec3f result;
-    auto x = _mm_load_ps(xs.data());
-    auto y = _mm_load_ps(ys.data());
-    auto z = _mm_load_ps(zs.data());
+    auto x = _mm256_load_ps(xs.data());
+    auto y = _mm256_load_ps(ys.data());
+    auto z = _mm256_load_ps(zs.data());
 
-    auto mag = _mm_load_ps(MagnitudeIntrinsics().data());
+    alignas(8 * sizeof(float))
+    const std::array<float, 8> magnitudes = MagnitudeIntrinsics();
+    auto mag = _mm256_load_ps(magnitudes.data());
 
-    x = _mm_div_ps(x, mag);
-    y = _mm_div_ps(y, mag);
-    z = _mm_div_ps(z, mag);
+    x = _mm256_div_ps(x, mag);
+    y = _mm256_div_ps(y, mag);
+    z = _mm256_div_ps(z, mag);
 
-    _mm_store_ps(result.xs.data(), x);
-    _mm_store_ps(result.ys.data(), y);
-    _mm_store_ps(result.zs.data(), z);
+    _mm256_store_ps(result.xs.data(), x);
+    _mm256_store_ps(result.ys.data(), y);
+    _mm256_store_ps(result.zs.data(), z);
 
     return result;
 }
@@ -822,31 +1063,331 @@ inline EightVec3f EightVec3f::ReflectIntrinsics(EightVec3f inVec, EightVec3f nor
     EightVec3f result;
     normal = normal.NormalizedIntrinsics();
 
-    auto xi = _mm_load_ps(inVec.xs.data());
-    auto yi = _mm_load_ps(inVec.ys.data());
-    auto zi = _mm_load_ps(inVec.zs.data());
+    auto xi = _mm256_load_ps(inVec.xs.data());
+    auto yi = _mm256_load_ps(inVec.ys.data());
+    auto zi = _mm256_load_ps(inVec.zs.data());
 
-    auto dot = _mm_load_ps(DotIntrinsics(inVec, normal).data());
+    alignas(8 * sizeof(float))
+    const std::array<float, 8> dots = DotIntrinsics(inVec, normal);
+    auto dot = _mm256_load_ps(dots.data());
 
-    auto xn = _mm_load_ps(normal.xs.data());
-    auto yn = _mm_load_ps(normal.ys.data());
-    auto zn = _mm_load_ps(normal.zs.data());
-    const float multiplier = 2.0f;
-    const auto twos = _mm_load1_ps(&multiplier);
-    xn = _mm_mul_ps(xn, twos);
-    yn = _mm_mul_ps(yn, twos);
-    zn = _mm_mul_ps(zn, twos);
-    xn = _mm_mul_ps(xn, dot);
-    yn = _mm_mul_ps(yn, dot);
-    zn = _mm_mul_ps(zn, dot);
+    auto xn = _mm256_load_ps(normal.xs.data());
+    auto yn = _mm256_load_ps(normal.ys.data());
+    auto zn = _mm256_load_ps(normal.zs.data());
+    const auto twos = _mm256_set1_ps(2.0f);
 
-    xi = _mm_sub_ps(xi, xn);
-    yi = _mm_sub_ps(yi, yn);
-    zi = _mm_sub_ps(zi, zn);
+    xn = _mm256_mul_ps(xn, twos);
+    yn = _mm256_mul_ps(yn, twos);
+    zn = _mm256_mul_ps(zn, twos);
+    xn = _mm256_mul_ps(xn, dot);
+    yn = _mm256_mul_ps(yn, dot);
+    zn = _mm256_mul_ps(zn, dot);
 
-    _mm_store_ps(result.xs.data(), xi);
-    _mm_store_ps(result.ys.data(), yi);
-    _mm_store_ps(result.zs.data(), zi);
+    xi = _mm256_sub_ps(xi, xn);
+    yi = _mm256_sub_ps(yi, yn);
+    zi = _mm256_sub_ps(zi, zn);
+
+    _mm256_store_ps(result.xs.data(), xi);
+    _mm256_store_ps(result.ys.data(), yi);
+    _mm256_store_ps(result.zs.data(), zi);
+
+    return result;
+}
+template<>
+inline EightVec3f EightVec3f::CrossIntrinsics(const EightVec3f& v1, const EightVec3f& v2)
+{
+    EightVec3f result;
+    auto x1 = _mm256_load_ps(v1.xs.data());
+    auto y1 = _mm256_load_ps(v1.ys.data());
+    auto z1 = _mm256_load_ps(v1.zs.data());
+
+    auto x2 = _mm256_load_ps(v2.xs.data());
+    auto y2 = _mm256_load_ps(v2.ys.data());
+    auto z2 = _mm256_load_ps(v2.zs.data());
+
+    auto x = _mm256_sub_ps(_mm256_mul_ps(y1, z2), _mm256_mul_ps(z1, y2));
+    auto y = _mm256_sub_ps(_mm256_mul_ps(z1, x2), _mm256_mul_ps(x1, z2));
+    auto z = _mm256_sub_ps(_mm256_mul_ps(x1, y2), _mm256_mul_ps(y1, x2));
+
+    _mm256_store_ps(result.xs.data(), x);
+    _mm256_store_ps(result.ys.data(), y);
+    _mm256_store_ps(result.zs.data(), z);
+
+    return result;
+}
+template<>
+inline EightVec3f EightVec3f::MinIntrinsics(const EightVec3f& v1, const EightVec3f& v2)
+{
+    EightVec3f result;
+    _mm256_store_ps(result.xs.data(), _mm256_min_ps(_mm256_load_ps(v1.xs.data()), _mm256_load_ps(v2.xs.data())));
+    _mm256_store_ps(result.ys.data(), _mm256_min_ps(_mm256_load_ps(v1.ys.data()), _mm256_load_ps(v2.ys.data())));
+    _mm256_store_ps(result.zs.data(), _mm256_min_ps(_mm256_load_ps(v1.zs.data()), _mm256_load_ps(v2.zs.data())));
+
+    return result;
+}
+template<>
+inline EightVec3f EightVec3f::MaxIntrinsics(const EightVec3f& v1, const EightVec3f& v2)
+{
+    EightVec3f result;
+    _mm256_store_ps(result.xs.data(), _mm256_max_ps(_mm256_load_ps(v1.xs.data()), _mm256_load_ps(v2.xs.data())));
+    _mm256_store_ps(result.ys.data(), _mm256_max_ps(_mm256_load_ps(v1.ys.data()), _mm256_load_ps(v2.ys.data())));
+    _mm256_store_ps(result.zs.data(), _mm256_max_ps(_mm256_load_ps(v1.zs.data()), _mm256_load_ps(v2.zs.data())));
+
+    return result;
+}
+template<>
+inline EightVec3f EightVec3f::MultiplyAddIntrinsics(const EightVec3f& v1, const EightVec3f& v2, const EightVec3f& v3)
+{
+    EightVec3f result;
+#ifdef __FMA__
+    auto x = _mm256_fmadd_ps(_mm256_load_ps(v1.xs.data()), _mm256_load_ps(v2.xs.data()), _mm256_load_ps(v3.xs.data()));
+    auto y = _mm256_fmadd_ps(_mm256_load_ps(v1.ys.data()), _mm256_load_ps(v2.ys.data()), _mm256_load_ps(v3.ys.data()));
+    auto z = _mm256_fmadd_ps(_mm256_load_ps(v1.zs.data()), _mm256_load_ps(v2.zs.data()), _mm256_load_ps(v3.zs.data()));
+#else
+    auto x = _mm256_add_ps(_mm256_mul_ps(_mm256_load_ps(v1.xs.data()), _mm256_load_ps(v2.xs.data())), _mm256_load_ps(v3.xs.data()));
+    auto y = _mm256_add_ps(_mm256_mul_ps(_mm256_load_ps(v1.ys.data()), _mm256_load_ps(v2.ys.data())), _mm256_load_ps(v3.ys.data()));
+    auto z = _mm256_add_ps(_mm256_mul_ps(_mm256_load_ps(v1.zs.data()), _mm256_load_ps(v2.zs.data())), _mm256_load_ps(v3.zs.data()));
+#endif
+
+    _mm256_store_ps(result.xs.data(), x);
+    _mm256_store_ps(result.ys.data(), y);
+    _mm256_store_ps(result.zs.data(), z);
+
+    return result;
+}
+template<>
+inline EightVec3f EightVec3f::LerpIntrinsics(const EightVec3f& v1, const EightVec3f& v2, float t)
+{
+    EightVec3f result;
+    const auto ts = _mm256_set1_ps(t);
+
+    auto x1 = _mm256_load_ps(v1.xs.data());
+    auto x = _mm256_add_ps(x1, _mm256_mul_ps(_mm256_sub_ps(_mm256_load_ps(v2.xs.data()), x1), ts));
+    auto y1 = _mm256_load_ps(v1.ys.data());
+    auto y = _mm256_add_ps(y1, _mm256_mul_ps(_mm256_sub_ps(_mm256_load_ps(v2.ys.data()), y1), ts));
+    auto z1 = _mm256_load_ps(v1.zs.data());
+    auto z = _mm256_add_ps(z1, _mm256_mul_ps(_mm256_sub_ps(_mm256_load_ps(v2.zs.data()), z1), ts));
+
+    _mm256_store_ps(result.xs.data(), x);
+    _mm256_store_ps(result.ys.data(), y);
+    _mm256_store_ps(result.zs.data(), z);
+
+    return result;
+}
+#endif
+
+#ifdef __AVX512F__
+template <>
+inline std::array<float, 16> SixteenVec3f::DotIntrinsics(SixteenVec3f v1, SixteenVec3f v2)
+{
+    alignas(16 * sizeof(float))
+    std::array<float, 16> result;
+    auto x1 = _mm512_load_ps(v1.xs.data());
+    auto y1 = _mm512_load_ps(v1.ys.data());
+    auto z1 = _mm512_load_ps(v1.zs.data());
+
+    auto x2 = _mm512_load_ps(v2.xs.data());
+    auto y2 = _mm512_load_ps(v2.ys.data());
+    auto z2 = _mm512_load_ps(v2.zs.data());
+
+    x1 = _mm512_mul_ps(x1, x2);
+    y1 = _mm512_mul_ps(y1, y2);
+    z1 = _mm512_mul_ps(z1, z2);
+
+    x1 = _mm512_add_ps(x1, y1);
+    x1 = _mm512_add_ps(x1, z1);
+    _mm512_store_ps(result.data(), x1);
+    return result;
+}
+template <>
+inline std::array<float, 16> SixteenVec3f::DotIntrinsics(SixteenVec3f v1, Vec3f v2)
+{
+    alignas(16 * sizeof(float))
+    std::array<float, 16> result;
+    auto x1 = _mm512_load_ps(v1.xs.data());
+    auto y1 = _mm512_load_ps(v1.ys.data());
+    auto z1 = _mm512_load_ps(v1.zs.data());
+
+    auto x2 = _mm512_set1_ps(v2.x);
+    auto y2 = _mm512_set1_ps(v2.y);
+    auto z2 = _mm512_set1_ps(v2.z);
+
+    x1 = _mm512_mul_ps(x1, x2);
+    y1 = _mm512_mul_ps(y1, y2);
+    z1 = _mm512_mul_ps(z1, z2);
+
+    x1 = _mm512_add_ps(x1, y1);
+    x1 = _mm512_add_ps(x1, z1);
+    _mm512_store_ps(result.data(), x1);
+    return result;
+}
+template<>
+inline std::array<float, 16> SixteenVec3f::SquareMagnitudeIntrinsics() const
+{
+    alignas(16 * sizeof(float))
+    std::array<float, 16> result;
+    auto x = _mm512_load_ps(xs.data());
+    auto y = _mm512_load_ps(ys.data());
+    auto z = _mm512_load_ps(zs.data());
+
+    x = _mm512_mul_ps(x, x);
+    y = _mm512_mul_ps(y, y);
+    z = _mm512_mul_ps(z, z);
+
+    x = _mm512_add_ps(x, y);
+    x = _mm512_add_ps(x, z);
+    _mm512_store_ps(result.data(), x);
+    return result;
+}
+template<>
+inline std::array<float, 16> SixteenVec3f::MagnitudeIntrinsics() const
+{
+    alignas(16 * sizeof(float))
+    std::array<float, 16> result;
+    auto x = _mm512_load_ps(xs.data());
+    auto y = _mm512_load_ps(ys.data());
+    auto z = _mm512_load_ps(zs.data());
+
+    x = _mm512_mul_ps(x, x);
+    y = _mm512_mul_ps(y, y);
+    z = _mm512_mul_ps(z, z);
+
+    x = _mm512_add_ps(x, y);
+    x = _mm512_add_ps(x, z);
+    x = _mm512_sqrt_ps(x);
+    _mm512_store_ps(result.data(), x);
+    return result;
+}
+template<>
+inline SixteenVec3f SixteenVec3f::NormalizedIntrinsics()
+{
+    SixteenVec3f result;
+    auto x = _mm512_load_ps(xs.data());
+    auto y = _mm512_load_ps(ys.data());
+    auto z = _mm512_load_ps(zs.data());
+
+    alignas(16 * sizeof(float))
+    const std::array<float, 16> magnitudes = MagnitudeIntrinsics();
+    auto mag = _mm512_load_ps(magnitudes.data());
+
+    x = _mm512_div_ps(x, mag);
+    y = _mm512_div_ps(y, mag);
+    z = _mm512_div_ps(z, mag);
+
+    _mm512_store_ps(result.xs.data(), x);
+    _mm512_store_ps(result.ys.data(), y);
+    _mm512_store_ps(result.zs.data(), z);
+
+    return result;
+}
+template<>
+inline SixteenVec3f SixteenVec3f::ReflectIntrinsics(SixteenVec3f inVec, SixteenVec3f normal)
+{
+    SixteenVec3f result;
+    normal = normal.NormalizedIntrinsics();
+
+    auto xi = _mm512_load_ps(inVec.xs.data());
+    auto yi = _mm512_load_ps(inVec.ys.data());
+    auto zi = _mm512_load_ps(inVec.zs.data());
+
+    alignas(16 * sizeof(float))
+    const std::array<float, 16> dots = DotIntrinsics(inVec, normal);
+    auto dot = _mm512_load_ps(dots.data());
+
+    auto xn = _mm512_load_ps(normal.xs.data());
+    auto yn = _mm512_load_ps(normal.ys.data());
+    auto zn = _mm512_load_ps(normal.zs.data());
+    const auto twos = _mm512_set1_ps(2.0f);
+
+    xn = _mm512_mul_ps(xn, twos);
+    yn = _mm512_mul_ps(yn, twos);
+    zn = _mm512_mul_ps(zn, twos);
+    xn = _mm512_mul_ps(xn, dot);
+    yn = _mm512_mul_ps(yn, dot);
+    zn = _mm512_mul_ps(zn, dot);
+
+    xi = _mm512_sub_ps(xi, xn);
+    yi = _mm512_sub_ps(yi, yn);
+    zi = _mm512_sub_ps(zi, zn);
+
+    _mm512_store_ps(result.xs.data(), xi);
+    _mm512_store_ps(result.ys.data(), yi);
+    _mm512_store_ps(result.zs.data(), zi);
+
+    return result;
+}
+template<>
+inline SixteenVec3f SixteenVec3f::CrossIntrinsics(const SixteenVec3f& v1, const SixteenVec3f& v2)
+{
+    SixteenVec3f result;
+    auto x1 = _mm512_load_ps(v1.xs.data());
+    auto y1 = _mm512_load_ps(v1.ys.data());
+    auto z1 = _mm512_load_ps(v1.zs.data());
+
+    auto x2 = _mm512_load_ps(v2.xs.data());
+    auto y2 = _mm512_load_ps(v2.ys.data());
+    auto z2 = _mm512_load_ps(v2.zs.data());
+
+    auto x = _mm512_sub_ps(_mm512_mul_ps(y1, z2), _mm512_mul_ps(z1, y2));
+    auto y = _mm512_sub_ps(_mm512_mul_ps(z1, x2), _mm512_mul_ps(x1, z2));
+    auto z = _mm512_sub_ps(_mm512_mul_ps(x1, y2), _mm512_mul_ps(y1, x2));
+
+    _mm512_store_ps(result.xs.data(), x);
+    _mm512_store_ps(result.ys.data(), y);
+    _mm512_store_ps(result.zs.data(), z);
+
+    return result;
+}
+template<>
+inline SixteenVec3f SixteenVec3f::MinIntrinsics(const SixteenVec3f& v1, const SixteenVec3f& v2)
+{
+    SixteenVec3f result;
+    _mm512_store_ps(result.xs.data(), _mm512_min_ps(_mm512_load_ps(v1.xs.data()), _mm512_load_ps(v2.xs.data())));
+    _mm512_store_ps(result.ys.data(), _mm512_min_ps(_mm512_load_ps(v1.ys.data()), _mm512_load_ps(v2.ys.data())));
+    _mm512_store_ps(result.zs.data(), _mm512_min_ps(_mm512_load_ps(v1.zs.data()), _mm512_load_ps(v2.zs.data())));
+
+    return result;
+}
+template<>
+inline SixteenVec3f SixteenVec3f::MaxIntrinsics(const SixteenVec3f& v1, const SixteenVec3f& v2)
+{
+    SixteenVec3f result;
+    _mm512_store_ps(result.xs.data(), _mm512_max_ps(_mm512_load_ps(v1.xs.data()), _mm512_load_ps(v2.xs.data())));
+    _mm512_store_ps(result.ys.data(), _mm512_max_ps(_mm512_load_ps(v1.ys.data()), _mm512_load_ps(v2.ys.data())));
+    _mm512_store_ps(result.zs.data(), _mm512_max_ps(_mm512_load_ps(v1.zs.data()), _mm512_load_ps(v2.zs.data())));
+
+    return result;
+}
+template<>
+inline SixteenVec3f SixteenVec3f::MultiplyAddIntrinsics(const SixteenVec3f& v1, const SixteenVec3f& v2, const SixteenVec3f& v3)
+{
+    SixteenVec3f result;
+    auto x = _mm512_fmadd_ps(_mm512_load_ps(v1.xs.data()), _mm512_load_ps(v2.xs.data()), _mm512_load_ps(v3.xs.data()));
+    auto y = _mm512_fmadd_ps(_mm512_load_ps(v1.ys.data()), _mm512_load_ps(v2.ys.data()), _mm512_load_ps(v3.ys.data()));
+    auto z = _mm512_fmadd_ps(_mm512_load_ps(v1.zs.data()), _mm512_load_ps(v2.zs.data()), _mm512_load_ps(v3.zs.data()));
+
+    _mm512_store_ps(result.xs.data(), x);
+    _mm512_store_ps(result.ys.data(), y);
+    _mm512_store_ps(result.zs.data(), z);
+
+    return result;
+}
+template<>
+inline SixteenVec3f SixteenVec3f::LerpIntrinsics(const SixteenVec3f& v1, const SixteenVec3f& v2, float t)
+{
+    SixteenVec3f result;
+    const auto ts = _mm512_set1_ps(t);
+
+    auto x1 = _mm512_load_ps(v1.xs.data());
+    auto x = _mm512_add_ps(x1, _mm512_mul_ps(_mm512_sub_ps(_mm512_load_ps(v2.xs.data()), x1), ts));
+    auto y1 = _mm512_load_ps(v1.ys.data());
+    auto y = _mm512_add_ps(y1, _mm512_mul_ps(_mm512_sub_ps(_mm512_load_ps(v2.ys.data()), y1), ts));
+    auto z1 = _mm512_load_ps(v1.zs.data());
+    auto z = _mm512_add_ps(z1, _mm512_mul_ps(_mm512_sub_ps(_mm512_load_ps(v2.zs.data()), z1), ts));
+
+    _mm512_store_ps(result.xs.data(), x);
+    _mm512_store_ps(result.ys.data(), y);
+    _mm512_store_ps(result.zs.data(), z);
 
     return result;
 }
@@ -916,47 +1457,113 @@ public:
         }
     }
 
+    /// \brief Packs count AoS vectors, the remaining lanes are set to zero
+    NVec4(const Vec4<T>* aosV, int count)
+            : xs{}, ys{}, zs{}, ws{}
+    {
+        for (int i = 0; i < count && i < N; i++)
+        {
+            xs[i] = aosV[i].x;
+            ys[i] = aosV[i].y;
+            zs[i] = aosV[i].z;
+            ws[i] = aosV[i].w;
+        }
+    }
+
+    /// \brief Unpacks the first count lanes back to AoS vectors
+    void Store(Vec4<T>* aosV, int count = N) const
+    {
+        for (int i = 0; i < count && i < N; i++)
+        {
+            aosV[i] = Vec4<T>(xs[i], ys[i], zs[i], ws[i]);
+        }
+    }
+
+    Vec4<T> Get(int i) const
+    {
+        return Vec4<T>(xs[i], ys[i], zs[i], ws[i]);
+    }
+
     //-----------------------------------------------------------------------------
     // Operators
     //-----------------------------------------------------------------------------
     NVec4<T, N> operator+(const Vec4<T>& rhs) const
     {
-        NVec4<T, N> v = this;
-        std::for_each(v.xs.begin(), v.xs.end(), [rhs](T x) { return x + rhs.x; });
-        std::for_each(v.ys.begin(), v.ys.end(), [rhs](T y) { return y + rhs.y; });
-        std::for_each(v.zs.begin(), v.zs.end(), [rhs](T z) { return z + rhs.z; });
-        std::for_each(v.ws.begin(), v.ws.end(), [rhs](T w) { return w + rhs.w; });
+        NVec4<T, N> v = *this;
+        v += rhs;
         return v;
     }
 
     NVec4<T, N>& operator+=(const Vec4<T>& rhs)
     {
-        std::for_each(xs.begin(), xs.end(), [rhs](T x) { return x + rhs.x; });
-        std::for_each(ys.begin(), ys.end(), [rhs](T y) { return y + rhs.y; });
-        std::for_each(zs.begin(), zs.end(), [rhs](T z) { return z + rhs.z; });
-        std::for_each(ws.begin(), ws.end(), [rhs](T w) { return w + rhs.w; });
+        for (int i = 0; i < N; i++)
+        {
+            xs[i] += rhs.x;
+            ys[i] += rhs.y;
+            zs[i] += rhs.z;
+            ws[i] += rhs.w;
+        }
         return *this;
     }
 
     NVec4<T, N> operator-(const Vec4<T>& rhs) const
     {
-        NVec4<T, N> v = this;
-        std::for_each(v.xs.begin(), v.xs.end(), [rhs](T x) { return x - rhs.x; });
-        std::for_each(v.ys.begin(), v.ys.end(), [rhs](T y) { return y - rhs.y; });
-        std::for_each(v.zs.begin(), v.zs.end(), [rhs](T z) { return z - rhs.z; });
-        std::for_each(v.ws.begin(), v.ws.end(), [rhs](T w) { return w - rhs.w; });
+        NVec4<T, N> v = *this;
+        v -= rhs;
         return v;
     }
 
     NVec4<T, N>& operator-=(const Vec4<T>& rhs)
     {
-        std::for_each(xs.begin(), xs.end(), [rhs](T x) { return x - rhs.x; });
-        std::for_each(ys.begin(), ys.end(), [rhs](T y) { return y - rhs.y; });
-        std::for_each(zs.begin(), zs.end(), [rhs](T z) { return z - rhs.z; });
-        std::for_each(ws.begin(), ws.end(), [rhs](T w) { return w - rhs.w; });
+        for (int i = 0; i < N; i++)
+        {
+            xs[i] -= rhs.x;
+            ys[i] -= rhs.y;
+            zs[i] -= rhs.z;
+            ws[i] -= rhs.w;
+        }
         return *this;
     }
 
+    NVec4<T, N> operator+(const NVec4<T, N>& rhs) const
+    {
+        NVec4<T, N> v;
+        for (int i = 0; i < N; i++)
+        {
+            v.xs[i] = xs[i] + rhs.xs[i];
+            v.ys[i] = ys[i] + rhs.ys[i];
+            v.zs[i] = zs[i] + rhs.zs[i];
+            v.ws[i] = ws[i] + rhs.ws[i];
+        }
+        return v;
+    }
+
+    NVec4<T, N> operator-(const NVec4<T, N>& rhs) const
+    {
+        NVec4<T, N> v;
+        for (int i = 0; i < N; i++)
+        {
+            v.xs[i] = xs[i] - rhs.xs[i];
+            v.ys[i] = ys[i] - rhs.ys[i];
+            v.zs[i] = zs[i] - rhs.zs[i];
+            v.ws[i] = ws[i] - rhs.ws[i];
+        }
+        return v;
+    }
+
+    NVec4<T, N> operator*(T rhs) const
+    {
+        NVec4<T, N> v;
+        for (int i = 0; i < N; i++)
+        {
+            v.xs[i] = xs[i] * rhs;
+            v.ys[i] = ys[i] * rhs;
+            v.zs[i] = zs[i] * rhs;
+            v.ws[i] = ws[i] * rhs;
+        }
+        return v;
+    }
+
     //-----------------------------------------------------------------------------
     // Formulas
     //-----------------------------------------------------------------------------
@@ -973,6 +1580,19 @@ public:
         return result;
     }
 
+    static std::array<T, N> Dot(NVec4<T, N> v1, Vec4<T> v2)
+    {
+        std::array<T, N> result;
+        for (int i = 0; i < N; i++)
+        {
+            result[i] = v1.xs[i] * v2.x +
+                        v1.ys[i] * v2.y +
+                        v1.zs[i] * v2.z +
+                        v1.ws[i] * v2.w;
+        }
+        return result;
+    }
+
     static std::array<T, N> Dot3(NVec4<T, N> v1, NVec4<T, N> v2)
     {
         std::array<T, N> result;
@@ -1020,7 +1640,47 @@ public:
         return result;
     }
 
-    static NVec4<T, N> Lerp(NVec4<T, N> v1, NVec4<T, N> v2, T t)
+    static NVec4<T, N> Min(const NVec4<T, N>& v1, const NVec4<T, N>& v2)
+    {
+        NVec4<T, N> result;
+        for (int i = 0; i < N; i++)
+        {
+            result.xs[i] = std::min(v1.xs[i], v2.xs[i]);
+            result.ys[i] = std::min(v1.ys[i], v2.ys[i]);
+            result.zs[i] = std::min(v1.zs[i], v2.zs[i]);
+            result.ws[i] = std::min(v1.ws[i], v2.ws[i]);
+        }
+        return result;
+    }
+
+    static NVec4<T, N> Max(const NVec4<T, N>& v1, const NVec4<T, N>& v2)
+    {
+        NVec4<T, N> result;
+        for (int i = 0; i < N; i++)
+        {
+            result.xs[i] = std::max(v1.xs[i], v2.xs[i]);
+            result.ys[i] = std::max(v1.ys[i], v2.ys[i]);
+            result.zs[i] = std::max(v1.zs[i], v2.zs[i]);
+            result.ws[i] = std::max(v1.ws[i], v2.ws[i]);
+        }
+        return result;
+    }
+
+    /// \brief Component-wise v1 * v2 + v3
+    static NVec4<T, N> MultiplyAdd(const NVec4<T, N>& v1, const NVec4<T, N>& v2, const NVec4<T, N>& v3)
+    {
+        NVec4<T, N> result;
+        for (int i = 0; i < N; i++)
+        {
+            result.xs[i] = v1.xs[i] * v2.xs[i] + v3.xs[i];
+            result.ys[i] = v1.ys[i] * v2.ys[i] + v3.ys[i];
+            result.zs[i] = v1.zs[i] * v2.zs[i] + v3.zs[i];
+            result.ws[i] = v1.ws[i] * v2.ws[i] + v3.ws[i];
+        }
+        return result;
+    }
+
+    static NVec4<T, N> Lerp(const NVec4<T, N>& v1, const NVec4<T, N>& v2, T t)
     {
         NVec4<T, N> result;
         for (int i = 0; i < N; i++)
@@ -1033,11 +1693,19 @@ public:
         return result;
     }
 
-    static std::array<T, N> DotIntrinsics(NVec4<T, N> v1, NVec4<T, N> v2);
-    static std::array<T, N> DotIntrinsics(NVec4<T, N> v1, Vec4<T> v2);
-    std::array<T, N> SquareMagnitudeIntrinsics() const;
-    std::array<T, N> MagnitudeIntrinsics() const;
-    NVec4<T, N> NormalizedIntrinsics();
+    //Intrinsics versions are specialized for each available vector width, the others use the scalar formulas
+    static std::array<T, N> DotIntrinsics(NVec4<T, N> v1, NVec4<T, N> v2) { return Dot(v1, v2); }
+    static std::array<T, N> DotIntrinsics(NVec4<T, N> v1, Vec4<T> v2) { return Dot(v1, v2); }
+    std::array<T, N> SquareMagnitudeIntrinsics() const { return SquareMagnitude(); }
+    std::array<T, N> MagnitudeIntrinsics() const { return Magnitude(); }
+    NVec4<T, N> NormalizedIntrinsics() { return Normalized(); }
+    static NVec4<T, N> MinIntrinsics(const NVec4<T, N>& v1, const NVec4<T, N>& v2) { return Min(v1, v2); }
+    static NVec4<T, N> MaxIntrinsics(const NVec4<T, N>& v1, const NVec4<T, N>& v2) { return Max(v1, v2); }
+    static NVec4<T, N> MultiplyAddIntrinsics(const NVec4<T, N>& v1, const NVec4<T, N>& v2, const NVec4<T, N>& v3)
+    {
+        return MultiplyAdd(v1, v2, v3);
+    }
+    static NVec4<T, N> LerpIntrinsics(const NVec4<T, N>& v1, const NVec4<T, N>& v2, T t) { return Lerp(v1, v2, t); }
 };
 
 //-----------------------------------------------------------------------------
@@ -1045,6 +1713,7 @@ public:
 //-----------------------------------------------------------------------------
 using FourVec4f = NVec4<float, 4>;
 using EightVec4f = NVec4<float, 8>;
+using SixteenVec4f = NVec4<float, 16>;
 
 //-----------------------------------------------------------------------------
 // NVec4 Implementations
@@ -1113,10 +1782,10 @@ inline std::array<float, 4> FourVec4f::DotIntrinsics(FourVec4f v1, Vec4f v2)
     auto z1 = _mm_load_ps(v1.zs.data());
     auto w1 = _mm_load_ps(v1.ws.data());
 
-    auto x2 = _mm_load1_ps(&v2.x);
-    auto y2 = _mm_load1_ps(&v2.y);
-    auto z2 = _mm_load1_ps(&v2.z);
-    auto w2 = _mm_load1_ps(&v2.w);
+    auto x2 = _mm_set1_ps(v2.x);
+    auto y2 = _mm_set1_ps(v2.y);
+    auto z2 = _mm_set1_ps(v2.z);
+    auto w2 = _mm_set1_ps(v2.w);
 
     x1 = _mm_mul_ps(x1, x2);
     y1 = _mm_mul_ps(y1, y2);
@@ -1179,16 +1848,88 @@ inline FourVec4f FourVec4f::NormalizedIntrinsics()
     auto x = _mm_load_ps(xs.data());
     auto y = _mm_load_ps(ys.data());
     auto z = _mm_load_ps(zs.data());
+    auto w = _mm_load_ps(ws.data());
 
-    auto mag = _mm_load_ps(MagnitudeIntrinsics().data());
+    alignas(4 * sizeof(float))
+    const std::array<float, 4> magnitudes = MagnitudeIntrinsics();
+    auto mag = _mm_load_ps(magnitudes.data());
 
     x = _mm_div_ps(x, mag);
     y = _mm_div_ps(y, mag);
     z = _mm_div_ps(z, mag);
+    w = _mm_div_ps(w, mag);
 
     _mm_store_ps(result.xs.data(), x);
     _mm_store_ps(result.ys.data(), y);
     _mm_store_ps(result.zs.data(), z);
+    _mm_store_ps(result.ws.data(), w);
+
+    return result;
+}
+template<>
+inline FourVec4f FourVec4f::MinIntrinsics(const FourVec4f& v1, const FourVec4f& v2)
+{
+    FourVec4f result;
+    _mm_store_ps(result.xs.data(), _mm_min_ps(_mm_load_ps(v1.xs.data()), _mm_load_ps(v2.xs.data())));
+    _mm_store_ps(result.ys.data(), _mm_min_ps(_mm_load_ps(v1.ys.data()), _mm_load_ps(v2.ys.data())));
+    _mm_store_ps(result.zs.data(), _mm_min_ps(_mm_load_ps(v1.zs.data()), _mm_load_ps(v2.zs.data())));
+    _mm_store_ps(result.ws.data(), _mm_min_ps(_mm_load_ps(v1.ws.data()), _mm_load_ps(v2.ws.data())));
+
+    return result;
+}
+template<>
+inline FourVec4f FourVec4f::MaxIntrinsics(const FourVec4f& v1, const FourVec4f& v2)
+{
+    FourVec4f result;
+    _mm_store_ps(result.xs.data(), _mm_max_ps(_mm_load_ps(v1.xs.data()), _mm_load_ps(v2.xs.data())));
+    _mm_store_ps(result.ys.data(), _mm_max_ps(_mm_load_ps(v1.ys.data()), _mm_load_ps(v2.ys.data())));
+    _mm_store_ps(result.zs.data(), _mm_max_ps(_mm_load_ps(v1.zs.data()), _mm_load_ps(v2.zs.data())));
+    _mm_store_ps(result.ws.data(), _mm_max_ps(_mm_load_ps(v1.ws.data()), _mm_load_ps(v2.ws.data())));
+
+    return result;
+}
+template<>
+inline FourVec4f FourVec4f::MultiplyAddIntrinsics(const FourVec4f& v1, const FourVec4f& v2, const FourVec4f& v3)
+{
+    FourVec4f result;
+#ifdef __FMA__
+    auto x = _mm_fmadd_ps(_mm_load_ps(v1.xs.data()), _mm_load_ps(v2.xs.data()), _mm_load_ps(v3.xs.data()));
+    auto y = _mm_fmadd_ps(_mm_load_ps(v1.ys.data()), _mm_load_ps(v2.ys.data()), _mm_load_ps(v3.ys.data()));
+    auto z = _mm_fmadd_ps(_mm_load_ps(v1.zs.data()), _mm_load_ps(v2.zs.data()), _mm_load_ps(v3.zs.data()));
+    auto w = _mm_fmadd_ps(_mm_load_ps(v1.ws.data()), _mm_load_ps(v2.ws.data()), _mm_load_ps(v3.ws.data()));
+#else
+    auto x = _mm_add_ps(_mm_mul_ps(_mm_load_ps(v1.xs.data()), _mm_load_ps(v2.xs.data())), _mm_load_ps(v3.xs.data()));
+    auto y = _mm_add_ps(_mm_mul_ps(_mm_load_ps(v1.ys.data()), _mm_load_ps(v2.ys.data())), _mm_load_ps(v3.ys.data()));
+    auto z = _mm_add_ps(_mm_mul_ps(_mm_load_ps(v1.zs.data()), _mm_load_ps(v2.zs.data())), _mm_load_ps(v3.zs.data()));
+    auto w = _mm_add_ps(_mm_mul_ps(_mm_load_ps(v1.ws.data()), _mm_load_ps(v2.ws.data())), _mm_load_ps(v3.ws.data()));
+#endif
+
+    _mm_store_ps(result.xs.data(), x);
+    _mm_store_ps(result.ys.data(), y);
+    _mm_store_ps(result.zs.data(), z);
+    _mm_store_ps(result.ws.data(), w);
+
+    return result;
+}
+template<>
+inline FourVec4f FourVec4f::LerpIntrinsics(const FourVec4f& v1, const FourVec4f& v2, float t)
+{
+    FourVec4f result;
+    const auto ts = _mm_set1_ps(t);
+
+    auto x1 = _mm_load_ps(v1.xs.data());
+    auto x = _mm_add_ps(x1, _mm_mul_ps(_mm_sub_ps(_mm_load_ps(v2.xs.data()), x1), ts));
+    auto y1 = _mm_load_ps(v1.ys.data());
+    auto y = _mm_add_ps(y1, _mm_mul_ps(_mm_sub_ps(_mm_load_ps(v2.ys.data()), y1), ts));
+    auto z1 = _mm_load_ps(v1.zs.data());
+    auto z = _mm_add_ps(z1, _mm_mul_ps(_mm_sub_ps(_mm_load_ps(v2.zs.data()), z1), ts));
+    auto w1 = _mm_load_ps(v1.ws.data());
+    auto w = _mm_add_ps(w1, _mm_mul_ps(_mm_sub_ps(_mm_load_ps(v2.ws.data()), w1), ts));
+
+    _mm_store_ps(result.xs.data(), x);
+    _mm_store_ps(result.ys.data(), y);
+    _mm_store_ps(result.zs.data(), z);
+    _mm_store_ps(result.ws.data(), w);
 
     return result;
 }
@@ -1231,10 +1972,10 @@ inline std::array<float, 8> EightVec4f::DotIntrinsics(EightVec4f v1, Vec4f v2)
     auto z1 = _mm256_load_ps(v1.zs.data());
     auto w1 = _mm256_load_ps(v1.ws.data());
 
-    auto x2 = _mm256_broadcast_ss(&v2.x);
-    auto y2 = _mm256_broadcast_ss(&v2.y);
-    auto z2 = _mm256_broadcast_ss(&v2.z);
-    auto w2 = _mm256_broadcast_ss(&v2.w);
+    auto x2 = _mm256_set1_ps(v2.x);
+    auto y2 = _mm256_set1_ps(v2.y);
+    auto z2 = _mm256_set1_ps(v2.z);
+    auto w2 = _mm256_set1_ps(v2.w);
 
     x1 = _mm256_mul_ps(x1, x2);
     y1 = _mm256_mul_ps(y1, y2);
@@ -1294,19 +2035,274 @@ template<>
 inline EightVec4f EightVec4f::NormalizedIntrinsics()
 {
     EightVec4f result;
-    auto x = _mm_load_ps(xs.data());
-    auto y = _mm_load_ps(ys.data());
-    auto z = _mm_load_ps(zs.data());
+    auto x = _mm256_load_ps(xs.data());
+    auto y = _mm256_load_ps(ys.data());
+    auto z = _mm256_load_ps(zs.data());
+    auto w = _mm256_load_ps(ws.data());
 
-    auto mag = _mm_load_ps(MagnitudeIntrinsics().data());
+    alignas(8 * sizeof(float))
+    const std::array<float, 8> magnitudes = MagnitudeIntrinsics();
+    auto mag = _mm256_load_ps(magnitudes.data());
 
-    x = _mm_div_ps(x, mag);
-    y = _mm_div_ps(y, mag);
-    z = _mm_div_ps(z, mag);
+    x = _mm256_div_ps(x, mag);
+    y = _mm256_div_ps(y, mag);
+    z = _mm256_div_ps(z, mag);
+    w = _mm256_div_ps(w, mag);
 
-    _mm_store_ps(result.xs.data(), x);
-    _mm_store_ps(result.ys.data(), y);
-    _mm_store_ps(result.zs.data(), z);
+    _mm256_store_ps(result.xs.data(), x);
+    _mm256_store_ps(result.ys.data(), y);
+    _mm256_store_ps(result.zs.data(), z);
+    _mm256_store_ps(result.ws.data(), w);
+
+    return result;
+}
+template<>
+inline EightVec4f EightVec4f::MinIntrinsics(const EightVec4f& v1, const EightVec4f& v2)
+{
+    EightVec4f result;
+    _mm256_store_ps(result.xs.data(), _mm256_min_ps(_mm256_load_ps(v1.xs.data()), _mm256_load_ps(v2.xs.data())));
+    _mm256_store_ps(result.ys.data(), _mm256_min_ps(_mm256_load_ps(v1.ys.data()), _mm256_load_ps(v2.ys.data())));
+    _mm256_store_ps(result.zs.data(), _mm256_min_ps(_mm256_load_ps(v1.zs.data()), _mm256_load_ps(v2.zs.data())));
+    _mm256_store_ps(result.ws.data(), _mm256_min_ps(_mm256_load_ps(v1.ws.data()), _mm256_load_ps(v2.ws.data())));
+
+    return result;
+}
+template<>
+inline EightVec4f EightVec4f::MaxIntrinsics(const EightVec4f& v1, const EightVec4f& v2)
+{
+    EightVec4f result;
+    _mm256_store_ps(result.xs.data(), _mm256_max_ps(_mm256_load_ps(v1.xs.data()), _mm256_load_ps(v2.xs.data())));
+    _mm256_store_ps(result.ys.data(), _mm256_max_ps(_mm256_load_ps(v1.ys.data()), _mm256_load_ps(v2.ys.data())));
+    _mm256_store_ps(result.zs.data(), _mm256_max_ps(_mm256_load_ps(v1.zs.data()), _mm256_load_ps(v2.zs.data())));
+    _mm256_store_ps(result.ws.data(), _mm256_max_ps(_mm256_load_ps(v1.ws.data()), _mm256_load_ps(v2.ws.data())));
+
+    return result;
+}
+template<>
+inline EightVec4f EightVec4f::MultiplyAddIntrinsics(const EightVec4f& v1, const EightVec4f& v2, const EightVec4f& v3)
+{
+    EightVec4f result;
+#ifdef __FMA__
+    auto x = _mm256_fmadd_ps(_mm256_load_ps(v1.xs.data()), _mm256_load_ps(v2.xs.data()), _mm256_load_ps(v3.xs.data()));
+    auto y = _mm256_fmadd_ps(_mm256_load_ps(v1.ys.data()), _mm256_load_ps(v2.ys.data()), _mm256_load_ps(v3.ys.data()));
+    auto z = _mm256_fmadd_ps(_mm256_load_ps(v1.zs.data()), _mm256_load_ps(v2.zs.data()), _mm256_load_ps(v3.zs.data()));
+    auto w = _mm256_fmadd_ps(_mm256_load_ps(v1.ws.data()), _mm256_load_ps(v2.ws.data()), _mm256_load_ps(v3.ws.data()));
+#else
+    auto x = _mm256_add_ps(_mm256_mul_ps(_mm256_load_ps(v1.xs.data()), _mm256_load_ps(v2.xs.data())), _mm256_load_ps(v3.xs.data()));
+    auto y = _mm256_add_ps(_mm256_mul_ps(_mm256_load_ps(v1.ys.data()), _mm256_load_ps(v2.ys.data())), _mm256_load_ps(v3.ys.data()));
+    auto z = _mm256_add_ps(_mm256_mul_ps(_mm256_load_ps(v1.zs.data()), _mm256_load_ps(v2.zs.data())), _mm256_load_ps(v3.zs.data()));
+    auto w = _mm256_add_ps(_mm256_mul_ps(_mm256_load_ps(v1.ws.data()), _mm256_load_ps(v2.ws.data())), _mm256_load_ps(v3.ws.data()));
+#endif
+
+    _mm256_store_ps(result.xs.data(), x);
+    _mm256_store_ps(result.ys.data(), y);
+    _mm256_store_ps(result.zs.data(), z);
+    _mm256_store_ps(result.ws.data(), w);
+
+    return result;
+}
+template<>
+inline EightVec4f EightVec4f::LerpIntrinsics(const EightVec4f& v1, const EightVec4f& v2, float t)
+{
+    EightVec4f result;
+    const auto ts = _mm256_set1_ps(t);
+
+    auto x1 = _mm256_load_ps(v1.xs.data());
+    auto x = _mm256_add_ps(x1, _mm256_mul_ps(_mm256_sub_ps(_mm256_load_ps(v2.xs.data()), x1), ts));
+    auto y1 = _mm256_load_ps(v1.ys.data());
+    auto y = _mm256_add_ps(y1, _mm256_mul_ps(_mm256_sub_ps(_mm256_load_ps(v2.ys.data()), y1), ts));
+    auto z1 = _mm256_load_ps(v1.zs.data());
+    auto z = _mm256_add_ps(z1, _mm256_mul_ps(_mm256_sub_ps(_mm256_load_ps(v2.zs.data()), z1), ts));
+    auto w1 = _mm256_load_ps(v1.ws.data());
+    auto w = _mm256_add_ps(w1, _mm256_mul_ps(_mm256_sub_ps(_mm256_load_ps(v2.ws.data()), w1), ts));
+
+    _mm256_store_ps(result.xs.data(), x);
+    _mm256_store_ps(result.ys.data(), y);
+    _mm256_store_ps(result.zs.data(), z);
+    _mm256_store_ps(result.ws.data(), w);
+
+    return result;
+}
+#endif
+
+#ifdef __AVX512F__
+template <>
+inline std::array<float, 16> SixteenVec4f::DotIntrinsics(SixteenVec4f v1, SixteenVec4f v2)
+{
+    alignas(16 * sizeof(float))
+    std::array<float, 16> result;
+    auto x1 = _mm512_load_ps(v1.xs.data());
+    auto y1 = _mm512_load_ps(v1.ys.data());
+    auto z1 = _mm512_load_ps(v1.zs.data());
+    auto w1 = _mm512_load_ps(v1.ws.data());
+
+    auto x2 = _mm512_load_ps(v2.xs.data());
+    auto y2 = _mm512_load_ps(v2.ys.data());
+    auto z2 = _mm512_load_ps(v2.zs.data());
+    auto w2 = _mm512_load_ps(v2.ws.data());
+
+    x1 = _mm512_mul_ps(x1, x2);
+    y1 = _mm512_mul_ps(y1, y2);
+    z1 = _mm512_mul_ps(z1, z2);
+    w1 = _mm512_mul_ps(w1, w2);
+
+    x1 = _mm512_add_ps(x1, y1);
+    z1 = _mm512_add_ps(z1, w1);
+    x1 = _mm512_add_ps(x1, z1);
+    _mm512_store_ps(result.data(), x1);
+    return result;
+}
+template <>
+inline std::array<float, 16> SixteenVec4f::DotIntrinsics(SixteenVec4f v1, Vec4f v2)
+{
+    alignas(16 * sizeof(float))
+    std::array<float, 16> result;
+    auto x1 = _mm512_load_ps(v1.xs.data());
+    auto y1 = _mm512_load_ps(v1.ys.data());
+    auto z1 = _mm512_load_ps(v1.zs.data());
+    auto w1 = _mm512_load_ps(v1.ws.data());
+
+    auto x2 = _mm512_set1_ps(v2.x);
+    auto y2 = _mm512_set1_ps(v2.y);
+    auto z2 = _mm512_set1_ps(v2.z);
+    auto w2 = _mm512_set1_ps(v2.w);
+
+    x1 = _mm512_mul_ps(x1, x2);
+    y1 = _mm512_mul_ps(y1, y2);
+    z1 = _mm512_mul_ps(z1, z2);
+    w1 = _mm512_mul_ps(w1, w2);
+
+    x1 = _mm512_add_ps(x1, y1);
+    z1 = _mm512_add_ps(z1, w1);
+    x1 = _mm512_add_ps(x1, z1);
+    _mm512_store_ps(result.data(), x1);
+    return result;
+}
+template<>
+inline std::array<float, 16> SixteenVec4f::SquareMagnitudeIntrinsics() const
+{
+    alignas(16 * sizeof(float))
+    std::array<float, 16> result;
+    auto x = _mm512_load_ps(xs.data());
+    auto y = _mm512_load_ps(ys.data());
+    auto z = _mm512_load_ps(zs.data());
+    auto w = _mm512_load_ps(ws.data());
+
+    x = _mm512_mul_ps(x, x);
+    y = _mm512_mul_ps(y, y);
+    z = _mm512_mul_ps(z, z);
+    w = _mm512_mul_ps(w, w);
+
+    x = _mm512_add_ps(x, y);
+    z = _mm512_add_ps(z, w);
+    x = _mm512_add_ps(x, z);
+    _mm512_store_ps(result.data(), x);
+    return result;
+}
+template<>
+inline std::array<float, 16> SixteenVec4f::MagnitudeIntrinsics() const
+{
+    alignas(16 * sizeof(float))
+    std::array<float, 16> result;
+    auto x = _mm512_load_ps(xs.data());
+    auto y = _mm512_load_ps(ys.data());
+    auto z = _mm512_load_ps(zs.data());
+    auto w = _mm512_load_ps(ws.data());
+
+    x = _mm512_mul_ps(x, x);
+    y = _mm512_mul_ps(y, y);
+    z = _mm512_mul_ps(z, z);
+    w = _mm512_mul_ps(w, w);
+
+    x = _mm512_add_ps(x, y);
+    z = _mm512_add_ps(z, w);
+    x = _mm512_add_ps(x, z);
+    x = _mm512_sqrt_ps(x);
+    _mm512_store_ps(result.data(), x);
+    return result;
+}
+template<>
+inline SixteenVec4f SixteenVec4f::NormalizedIntrinsics()
+{
+    SixteenVec4f result;
+    auto x = _mm512_load_ps(xs.data());
+    auto y = _mm512_load_ps(ys.data());
+    auto z = _mm512_load_ps(zs.data());
+    auto w = _mm512_load_ps(ws.data());
+
+    alignas(16 * sizeof(float))
+    const std::array<float, 16> magnitudes = MagnitudeIntrinsics();
+    auto mag = _mm512_load_ps(magnitudes.data());
+
+    x = _mm512_div_ps(x, mag);
+    y = _mm512_div_ps(y, mag);
+    z = _mm512_div_ps(z, mag);
+    w = _mm512_div_ps(w, mag);
+
+    _mm512_store_ps(result.xs.data(), x);
+    _mm512_store_ps(result.ys.data(), y);
+    _mm512_store_ps(result.zs.data(), z);
+    _mm512_store_ps(result.ws.data(), w);
+
+    return result;
+}
+template<>
+inline SixteenVec4f SixteenVec4f::MinIntrinsics(const SixteenVec4f& v1, const SixteenVec4f& v2)
+{
+    SixteenVec4f result;
+    _mm512_store_ps(result.xs.data(), _mm512_min_ps(_mm512_load_ps(v1.xs.data()), _mm512_load_ps(v2.xs.data())));
+    _mm512_store_ps(result.ys.data(), _mm512_min_ps(_mm512_load_ps(v1.ys.data()), _mm512_load_ps(v2.ys.data())));
+    _mm512_store_ps(result.zs.data(), _mm512_min_ps(_mm512_load_ps(v1.zs.data()), _mm512_load_ps(v2.zs.data())));
+    _mm512_store_ps(result.ws.data(), _mm512_min_ps(_mm512_load_ps(v1.ws.data()), _mm512_load_ps(v2.ws.data())));
+
+    return result;
+}
+template<>
+inline SixteenVec4f SixteenVec4f::MaxIntrinsics(const SixteenVec4f& v1, const SixteenVec4f& v2)
+{
+    SixteenVec4f result;
+    _mm512_store_ps(result.xs.data(), _mm512_max_ps(_mm512_load_ps(v1.xs.data()), _mm512_load_ps(v2.xs.data())));
+    _mm512_store_ps(result.ys.data(), _mm512_max_ps(_mm512_load_ps(v1.ys.data()), _mm512_load_ps(v2.ys.data())));
+    _mm512_store_ps(result.zs.data(), _mm512_max_ps(_mm512_load_ps(v1.zs.data()), _mm512_load_ps(v2.zs.data())));
+    _mm512_store_ps(result.ws.data(), _mm512_max_ps(_mm512_load_ps(v1.ws.data()), _mm512_load_ps(v2.ws.data())));
+
+    return result;
+}
+template<>
+inline SixteenVec4f SixteenVec4f::MultiplyAddIntrinsics(const SixteenVec4f& v1, const SixteenVec4f& v2, const SixteenVec4f& v3)
+{
+    SixteenVec4f result;
+    auto x = _mm512_fmadd_ps(_mm512_load_ps(v1.xs.data()), _mm512_load_ps(v2.xs.data()), _mm512_load_ps(v3.xs.data()));
+    auto y = _mm512_fmadd_ps(_mm512_load_ps(v1.ys.data()), _mm512_load_ps(v2.ys.data()), _mm512_load_ps(v3.ys.data()));
+    auto z = _mm512_fmadd_ps(_mm512_load_ps(v1.zs.data()), _mm512_load_ps(v2.zs.data()), _mm512_load_ps(v3.zs.data()));
+    auto w = _mm512_fmadd_ps(_mm512_load_ps(v1.ws.data()), _mm512_load_ps(v2.ws.data()), _mm512_load_ps(v3.ws.data()));
+
+    _mm512_store_ps(result.xs.data(), x);
+    _mm512_store_ps(result.ys.data(), y);
+    _mm512_store_ps(result.zs.data(), z);
+    _mm512_store_ps(result.ws.data(), w);
+
+    return result;
+}
+template<>
+inline SixteenVec4f SixteenVec4f::LerpIntrinsics(const SixteenVec4f& v1, const SixteenVec4f& v2, float t)
+{
+    SixteenVec4f result;
+    const auto ts = _mm512_set1_ps(t);
+
+    auto x1 = _mm512_load_ps(v1.xs.data());
+    auto x = _mm512_add_ps(x1, _mm512_mul_ps(_mm512_sub_ps(_mm512_load_ps(v2.xs.data()), x1), ts));
+    auto y1 = _mm512_load_ps(v1.ys.data());
+    auto y = _mm512_add_ps(y1, _mm512_mul_ps(_mm512_sub_ps(_mm512_load_ps(v2.ys.data()), y1), ts));
+    auto z1 = _mm512_load_ps(v1.zs.data());
+    auto z = _mm512_add_ps(z1, _mm512_mul_ps(_mm512_sub_ps(_mm512_load_ps(v2.zs.data()), z1), ts));
+    auto w1 = _mm512_load_ps(v1.ws.data());
+    auto w = _mm512_add_ps(w1, _mm512_mul_ps(_mm512_sub_ps(_mm512_load_ps(v2.ws.data()), w1), ts));
+
+    _mm512_store_ps(result.xs.data(), x);
+    _mm512_store_ps(result.ys.data(), y);
+    _mm512_store_ps(result.zs.data(), z);
+    _mm512_store_ps(result.ws.data(), w);
 
     return result;
 }
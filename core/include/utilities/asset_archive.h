@@ -0,0 +1,235 @@
+#pragma once
+/*
+ MIT License
+
+ Copyright (c) 2020 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "sole.hpp"
+#include "utilities/file_utility.h"
+#include "utilities/service_locator.h"
+
+namespace neko
+{
+/**
+ * \brief Same values as the AssetType of scripts/validator/asset_validator.py
+ */
+enum class AssetType : std::int32_t
+{
+    UNKNOWN = -1,
+    MTL = 0,
+    OBJ = 1,
+    TEXTURE = 2,
+    SCENE = 3,
+    VERT_SHADER = 4,
+    FRAG_SHADER = 5,
+    FONT = 6
+};
+
+AssetType GetAssetType(std::string_view path);
+
+/**
+ * \brief Path relative to the packed data folder, mountPath is that folder as the asset paths see it
+ */
+std::string MakeAssetPath(std::string_view path, std::string_view mountPath);
+
+/**
+ * \brief Parses the .meta file of the asset once for the uuid and the AssetArchiveEntry::Flags,
+ * returns false when there is no uuid
+ */
+bool LoadAssetMeta(std::string_view assetPath, sole::uuid& id, std::uint32_t& flags);
+
+/**
+ * \brief First bytes of an asset archive, followed by the entries sorted by uuid, the path index,
+ * the path table and the aligned data. All offsets are from the start of the archive.
+ */
+struct AssetArchiveHeader
+{
+    static constexpr std::array<char, 4> magicValue = {'N', 'K', 'P', 'K'};
+    static constexpr std::uint32_t currentVersion = 1;
+
+    std::array<char, 4> magic = magicValue;
+    std::uint32_t version = currentVersion;
+    std::uint32_t entryCount = 0;
+    std::uint32_t alignment = 0;
+    std::uint64_t entriesOffset = 0;
+    //Entry indices sorted by path hash
+    std::uint64_t pathIndexOffset = 0;
+    //Null-terminated paths relative to the packed folder
+    std::uint64_t pathTableOffset = 0;
+    std::uint64_t pathTableSize = 0;
+    std::uint64_t dataOffset = 0;
+    std::uint64_t archiveSize = 0;
+};
+static_assert(sizeof(AssetArchiveHeader) == 64, "The archive header is written as is");
+
+/**
+ * \brief Index entry of an asset archive with the meta data prebaked from the .meta file of the asset
+ */
+struct AssetArchiveEntry
+{
+    enum Flags : std::uint32_t
+    {
+        NONE = 0u,
+        //The data is zstd-compressed, size is the compressed size
+        COMPRESSED = 1u << 0u,
+        HAS_META = 1u << 1u,
+        LINEAR = 1u << 2u,
+        KTX2 = 1u << 3u,
+        GENMIPMAP = 1u << 4u
+    };
+
+    std::uint64_t uuidAb = 0;
+    std::uint64_t uuidCd = 0;
+    std::uint64_t pathHash = 0;
+    std::uint64_t offset = 0;
+    std::uint64_t size = 0;
+    std::uint64_t originalSize = 0;
+    std::uint32_t pathOffset = 0;
+    std::uint32_t pathLength = 0;
+    AssetType type = AssetType::UNKNOWN;
+    std::uint32_t flags = NONE;
+
+    [[nodiscard]] sole::uuid GetId() const;
+    [[nodiscard]] bool HasFlag(Flags flag) const { return (flags & flag) == flag; }
+};
+static_assert(sizeof(AssetArchiveEntry) == 64, "The archive entries are written as is");
+
+/**
+ * \brief Builds an asset archive, used by the packer in scripts/packer.
+ * The data of every entry is aligned and followed by at least one zero byte
+ * so the reader can serve null-terminated BufferFile views of it.
+ */
+class AssetArchiveWriter
+{
+public:
+    static constexpr std::uint32_t defaultAlignment = 64;
+    static constexpr int compressionLevel = 9;
+
+    explicit AssetArchiveWriter(std::uint32_t alignment = defaultAlignment);
+
+    /**
+     * \brief Adds the file stored as archivePath with the uuid and flags of its .meta file,
+     * compression is only kept when zstd is available and the data gets smaller
+     */
+    bool AddFile(std::string_view filePath, std::string_view archivePath, bool compress = false);
+    void AddData(
+        std::string_view archivePath,
+        const unsigned char* data,
+        size_t length,
+        const sole::uuid& id,
+        AssetType type,
+        std::uint32_t flags,
+        bool compress = false);
+    /**
+     * \brief Adds all the files of the folder except the .meta files, with paths relative to the folder
+     */
+    size_t AddDirectory(std::string_view folderPath, bool compress = false);
+    bool Write(std::string_view archivePath) const;
+
+    [[nodiscard]] size_t GetEntryCount() const { return entries_.size(); }
+private:
+    struct PendingEntry
+    {
+        AssetArchiveEntry entry;
+        std::string path;
+        std::vector<unsigned char> data;
+    };
+    std::vector<PendingEntry> entries_;
+    std::unordered_map<std::string, size_t> pathIndices_;
+    std::uint32_t alignment_;
+};
+
+class AssetArchiveInterface
+{
+public:
+    virtual ~AssetArchiveInterface() = default;
+    [[nodiscard]] virtual const AssetArchiveEntry* FindEntry(std::string_view path) const = 0;
+    [[nodiscard]] virtual const AssetArchiveEntry* FindEntry(const sole::uuid& id) const = 0;
+    /**
+     * \brief Gives a zero-copy view of the stored data, or a decompressed copy,
+     * returns false when the asset is not in the archive
+     */
+    virtual bool LoadBufferFile(std::string_view path, BufferFile& bufferFile) const = 0;
+};
+
+class NullAssetArchive : public AssetArchiveInterface
+{
+public:
+    [[nodiscard]] const AssetArchiveEntry* FindEntry([[maybe_unused]] std::string_view path) const override
+    {
+        return nullptr;
+    }
+    [[nodiscard]] const AssetArchiveEntry* FindEntry([[maybe_unused]] const sole::uuid& id) const override
+    {
+        return nullptr;
+    }
+    bool LoadBufferFile(
+        [[maybe_unused]] std::string_view path,
+        [[maybe_unused]] BufferFile& bufferFile) const override
+    {
+        return false;
+    }
+};
+
+/**
+ * \brief Memory-mapped asset archive, opening it costs a handful of syscalls
+ * and lookups are binary searches in the mapped index.
+ */
+class AssetArchive : public AssetArchiveInterface
+{
+public:
+    /**
+     * \brief mountPath is the folder the archive was packed from as the asset paths see it,
+     * like Configuration::dataRootPath, it is removed from the looked up paths
+     */
+    bool Open(std::string_view archivePath, std::string_view mountPath = "");
+    void Close();
+    [[nodiscard]] bool IsOpen() const { return header_ != nullptr; }
+
+    [[nodiscard]] const AssetArchiveEntry* FindEntry(std::string_view path) const override;
+    [[nodiscard]] const AssetArchiveEntry* FindEntry(const sole::uuid& id) const override;
+    bool LoadBufferFile(std::string_view path, BufferFile& bufferFile) const override;
+    bool LoadBufferFile(const AssetArchiveEntry& entry, BufferFile& bufferFile) const;
+
+    [[nodiscard]] std::string_view GetPath(const AssetArchiveEntry& entry) const;
+    [[nodiscard]] size_t GetEntryCount() const { return header_ == nullptr ? 0 : header_->entryCount; }
+    [[nodiscard]] const AssetArchiveEntry& GetEntry(size_t index) const { return entries_[index]; }
+private:
+    [[nodiscard]] bool Validate() const;
+
+    BufferFile archiveFile_;
+    const AssetArchiveHeader* header_ = nullptr;
+    const AssetArchiveEntry* entries_ = nullptr;
+    const std::uint32_t* pathIndex_ = nullptr;
+    const char* pathTable_ = nullptr;
+    std::string mountPath_;
+};
+
+using AssetArchiveLocator = Locator<AssetArchiveInterface, NullAssetArchive>;
+}
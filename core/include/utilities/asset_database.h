@@ -0,0 +1,144 @@
+#pragma once
+/*
+ MIT License
+
+ Copyright (c) 2020 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#ifndef NEKO_SAMETHREAD
+#include <mutex>
+#endif
+
+#include "sole.hpp"
+#include "utilities/asset_archive.h"
+#include "utilities/service_locator.h"
+
+namespace neko
+{
+/**
+ * \brief Meta data of an asset, flags are AssetArchiveEntry::Flags
+ */
+struct AssetRecord
+{
+    std::uint64_t uuidAb = 0;
+    std::uint64_t uuidCd = 0;
+    std::uint64_t pathHash = 0;
+    AssetType type = AssetType::UNKNOWN;
+    std::uint32_t flags = AssetArchiveEntry::NONE;
+    std::uint32_t pathOffset = 0;
+    std::uint32_t pathLength = 0;
+
+    [[nodiscard]] sole::uuid GetId() const;
+    [[nodiscard]] bool HasFlag(AssetArchiveEntry::Flags flag) const { return (flags & flag) == flag; }
+};
+static_assert(sizeof(AssetRecord) == 40, "The asset records are written as is");
+
+struct AssetDatabaseHeader
+{
+    static constexpr std::array<char, 4> magicValue = {'N', 'K', 'D', 'B'};
+    static constexpr std::uint32_t currentVersion = 1;
+
+    std::array<char, 4> magic = magicValue;
+    std::uint32_t version = currentVersion;
+    std::uint32_t recordCount = 0;
+    std::uint32_t pathTableSize = 0;
+};
+static_assert(sizeof(AssetDatabaseHeader) == 16, "The database header is written as is");
+
+class AssetDatabaseInterface
+{
+public:
+    virtual ~AssetDatabaseInterface() = default;
+    /**
+     * \brief Copies the record of the path, false when the path is unknown
+     */
+    [[nodiscard]] virtual bool FindAsset(std::string_view path, AssetRecord& record) const = 0;
+    virtual void AddAsset(std::string_view path, const sole::uuid& id, AssetType type, std::uint32_t flags) = 0;
+};
+
+class NullAssetDatabase : public AssetDatabaseInterface
+{
+public:
+    [[nodiscard]] bool FindAsset(
+        [[maybe_unused]] std::string_view path,
+        [[maybe_unused]] AssetRecord& record) const override
+    {
+        return false;
+    }
+    void AddAsset(
+        [[maybe_unused]] std::string_view path,
+        [[maybe_unused]] const sole::uuid& id,
+        [[maybe_unused]] AssetType type,
+        [[maybe_unused]] std::uint32_t flags) override
+    {
+    }
+};
+
+/**
+ * \brief Maps asset paths to their uuid, type and flags with one hashed lookup instead of a .meta parse.
+ * It is filled at startup from an asset archive or a database file, and by the loaders
+ * for the assets it does not know yet. The loaders run on the workers, so the records are
+ * only copied out under the database mutex.
+ * The binary file is a header, the records and the null-terminated paths.
+ */
+class AssetDatabase : public AssetDatabaseInterface
+{
+public:
+    /**
+     * \brief mountPath is the data folder as the asset paths see it, like Configuration::dataRootPath
+     */
+    void SetMountPath(std::string_view mountPath) { mountPath_ = mountPath; }
+    /**
+     * \brief Parses all the .meta files of the folder, paths are relative to the folder
+     */
+    size_t Build(std::string_view dataFolder);
+    size_t Build(const AssetArchive& assetArchive);
+    bool Load(std::string_view databasePath);
+    bool Write(std::string_view databasePath) const;
+    void Clear();
+
+    [[nodiscard]] bool FindAsset(std::string_view path, AssetRecord& record) const override;
+    void AddAsset(std::string_view path, const sole::uuid& id, AssetType type, std::uint32_t flags) override;
+
+    [[nodiscard]] std::string GetPath(const AssetRecord& record) const;
+    [[nodiscard]] size_t GetAssetCount() const;
+private:
+    //The private functions expect the mutex to be held
+    void AddRecord(std::string_view assetPath, const sole::uuid& id, AssetType type, std::uint32_t flags);
+    [[nodiscard]] std::string_view GetRecordPath(const AssetRecord& record) const;
+
+    std::vector<AssetRecord> records_;
+    std::string pathTable_;
+    std::unordered_map<std::uint64_t, std::uint32_t> pathHashMap_;
+    std::string mountPath_;
+#ifndef NEKO_SAMETHREAD
+    mutable std::mutex mutex_;
+#endif
+};
+
+using AssetDatabaseLocator = Locator<AssetDatabaseInterface, NullAssetDatabase>;
+}
@@ -23,6 +23,7 @@
  SOFTWARE.
  */
 
+#include <cstdint>
 #include <functional>
 
 #include <string>
@@ -44,10 +45,21 @@ Java_swiss_sae_gpr5300_MainActivity_load(JNIEnv *env, [[maybe_unused]] jclass cl
 namespace neko
 {
 /**
- * \brief Non RAII structure, please Destroy it
+ * \brief Non RAII structure, please Destroy it.
+ * The buffer is always null-terminated at dataLength. When it is memory-mapped it is read-only.
  */
 struct BufferFile
 {
+    enum class LoadMode : std::uint8_t
+    {
+        //Memory-map the files of at least mapSizeThreshold bytes where it is supported, read the others
+        AUTO,
+        READ,
+        //Memory-map where it is supported, whatever the size of the file
+        MAP
+    };
+    static constexpr size_t mapSizeThreshold = 256 * 1024;
+
     BufferFile() = default;
     ~BufferFile();
     BufferFile(BufferFile&& bufferFile) noexcept;
@@ -58,9 +70,23 @@ struct BufferFile
     unsigned char* dataBuffer = nullptr;
     size_t dataLength = 0;
 
-    void Load(std::string_view path);
+    void Load(std::string_view path, LoadMode loadMode = LoadMode::AUTO);
+    /**
+     * \brief Points at read-only memory owned by someone else (like an asset archive mapping),
+     * the memory needs to stay null-terminated at length and alive until Destroy
+     */
+    void LoadView(const unsigned char* data, size_t length);
     void Destroy();
+    [[nodiscard]] bool IsMapped() const { return isMapped_; }
+    [[nodiscard]] bool IsView() const { return isView_; }
+private:
+    /**
+     * \brief Maps the file read-only with sequential and will need hints, returns false to fall back on reading it
+     */
+    bool Map(std::string_view path, size_t minSize);
 
+    bool isMapped_ = false;
+    bool isView_ = false;
 };
 class ResourceJob : public Job
 {
@@ -69,10 +95,12 @@ public:
     void SetFilePath(std::string_view path);
     std::string GetFilePath() const {return filePath_; }
     const BufferFile& GetBufferFile() const {return bufferFile_;}
+    void SetLoadMode(BufferFile::LoadMode loadMode) { loadMode_ = loadMode; }
     void Reset() override;
 private:
     std::string filePath_;
     BufferFile bufferFile_;
+    BufferFile::LoadMode loadMode_ = BufferFile::LoadMode::AUTO;
 };
 
 bool FileExists(const std::string_view filename);
@@ -22,10 +22,45 @@
  SOFTWARE.
  */
 
+#include <algorithm>
 #include "engine/custom_allocator.h"
 
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
 namespace neko
 {
+namespace
+{
+/**
+ * \brief Index of the lowest set bit, word must not be zero
+ */
+int FindFirstSet(std::uint32_t word)
+{
+#if defined(_MSC_VER)
+	unsigned long index = 0;
+	_BitScanForward(&index, word);
+	return static_cast<int>(index);
+#else
+	return __builtin_ctz(word);
+#endif
+}
+
+/**
+ * \brief Index of the highest set bit, word must not be zero
+ */
+int FindLastSet(std::uint64_t word)
+{
+#if defined(_MSC_VER)
+	unsigned long index = 0;
+	_BitScanReverse64(&index, word);
+	return static_cast<int>(index);
+#else
+	return 63 - __builtin_clzll(word);
+#endif
+}
+}
 
 void* LinearAllocator::Allocate(size_t allocatedSize, size_t alignment)
 {
@@ -285,6 +320,340 @@ void FreeListAllocator::Profile()
 	}
 }
 
+TlsfAllocator::TlsfAllocator(size_t size, void* start) : Allocator(size, start)
+{
+	const auto adjustment = CalculateAlignForwardAdjustment(start, blockAlignment);
+	neko_assert(size > adjustment + 2 * blockHeaderOverhead + minBlockSize, "TLSF Allocator cannot be empty");
+	//Keeping space at the end for the sentinel block header
+	const size_t blockSize = (size - adjustment - 2 * blockHeaderOverhead) & ~(blockAlignment - 1);
+	neko_assert(std::uint64_t(blockSize) < (std::uint64_t(1) << flIndexMax), "TLSF Allocator is too big");
+
+	firstBlock_ = (BlockHeader*)((std::uint64_t) start + adjustment);
+	firstBlock_->prevPhysBlock = nullptr;
+	firstBlock_->size = blockSize;
+	SetFree(firstBlock_, true);
+
+	BlockHeader* sentinel = GetNextPhysBlock(firstBlock_);
+	sentinel->prevPhysBlock = firstBlock_;
+	sentinel->size = 0;
+	SetPrevFree(sentinel, true);
+
+	InsertFreeBlock(firstBlock_);
+}
+
+void* TlsfAllocator::Allocate(size_t allocatedSize, size_t alignment)
+{
+	neko_assert(allocatedSize != 0, "TLSF Allocator cannot allocate nothing");
+	neko_assert((alignment & (alignment - 1)) == 0, "Alignement needs to be a power of two");
+	const size_t size = AdjustRequestSize(allocatedSize);
+	//Smallest free block that can be split in front of an over-aligned payload
+	const size_t gapMinimum = blockHeaderOverhead + minBlockSize;
+	const size_t searchSize = alignment > blockAlignment ? AdjustRequestSize(size + alignment + gapMinimum) : size;
+
+	BlockHeader* block = LocateFreeBlock(searchSize);
+	if (block == nullptr)
+	{
+		neko_assert(false, "TLSF Allocator has not enough space for this allocation");
+		return nullptr;
+	}
+	RemoveFreeBlock(block);
+
+	if (alignment > blockAlignment)
+	{
+		void* payload = GetPayload(block);
+		size_t gap = CalculateAlignForwardAdjustment(payload, alignment);
+		if (gap != 0 && gap < gapMinimum)
+		{
+			gap = gapMinimum + CalculateAlignForwardAdjustment((void*)((std::uint64_t) payload + gapMinimum), alignment);
+		}
+		if (gap != 0)
+		{
+			//The leading gap goes back to the free blocks
+			BlockHeader* alignedBlock = SplitBlock(block, gap - blockHeaderOverhead);
+			SetPrevFree(alignedBlock, true);
+			InsertFreeBlock(block);
+			block = alignedBlock;
+		}
+	}
+
+	if (GetBlockSize(block) >= size + blockHeaderOverhead + minBlockSize)
+	{
+		BlockHeader* remainingBlock = SplitBlock(block, size);
+		SetFree(remainingBlock, true);
+		SetPrevFree(GetNextPhysBlock(remainingBlock), true);
+		InsertFreeBlock(remainingBlock);
+	}
+	SetFree(block, false);
+	SetPrevFree(GetNextPhysBlock(block), false);
+
+	usedMemory_ += GetBlockSize(block) + blockHeaderOverhead;
+	numAllocations_++;
+	void* alignedAddress = GetPayload(block);
+	neko_assert(CalculateAlignForwardAdjustment(alignedAddress, alignment) == 0, "TLSF Allocator: New generated block is not aligned");
+	return alignedAddress;
+}
+
+void TlsfAllocator::Deallocate(void* p)
+{
+	neko_assert(p != nullptr, "TLSF Allocator cannot deallocate nullptr");
+	auto* block = (BlockHeader*)((std::uint64_t) p - blockHeaderOverhead);
+	neko_assert(!IsFree(block), "TLSF Allocator block is already free");
+	usedMemory_ -= GetBlockSize(block) + blockHeaderOverhead;
+	numAllocations_--;
+	SetFree(block, true);
+
+	//Immediate coalescing with the physical neighbours
+	if (IsPrevFree(block))
+	{
+		BlockHeader* prevBlock = block->prevPhysBlock;
+		RemoveFreeBlock(prevBlock);
+		SetBlockSize(prevBlock, GetBlockSize(prevBlock) + blockHeaderOverhead + GetBlockSize(block));
+		block = prevBlock;
+		GetNextPhysBlock(block)->prevPhysBlock = block;
+	}
+	BlockHeader* nextBlock = GetNextPhysBlock(block);
+	if (IsFree(nextBlock))
+	{
+		RemoveFreeBlock(nextBlock);
+		SetBlockSize(block, GetBlockSize(block) + blockHeaderOverhead + GetBlockSize(nextBlock));
+		GetNextPhysBlock(block)->prevPhysBlock = block;
+	}
+	SetPrevFree(GetNextPhysBlock(block), true);
+	InsertFreeBlock(block);
+}
+
+void TlsfAllocator::Profile()
+{
+	ImGui::LabelText("Type", "TLSF Allocator");
+
+	const float totalWidth = ImGui::GetContentRegionAvailWidth();
+	BlockHeader* block = firstBlock_;
+	bool first = true;
+	while (GetBlockSize(block) != 0)
+	{
+		const size_t blockSize = GetBlockSize(block) + blockHeaderOverhead;
+		bool selected = !IsFree(block);
+		if (!first)
+		{
+			ImGui::SameLine();
+		}
+		first = false;
+		ImGui::PushID(block);
+		ImGui::Selectable(selected ? "Used Block" : "Free Block", &selected, 0, ImVec2(float(blockSize) * totalWidth / size_, 20));
+		ImGui::PopID();
+		block = GetNextPhysBlock(block);
+	}
+}
+
+void TlsfAllocator::SetBlockSize(BlockHeader* block, size_t size)
+{
+	block->size = size | (block->size & (blockFreeFlag | blockPrevFreeFlag));
+}
+
+void TlsfAllocator::SetFree(BlockHeader* block, bool isFree)
+{
+	block->size = isFree ? block->size | blockFreeFlag : block->size & ~blockFreeFlag;
+}
+
+void TlsfAllocator::SetPrevFree(BlockHeader* block, bool isPrevFree)
+{
+	block->size = isPrevFree ? block->size | blockPrevFreeFlag : block->size & ~blockPrevFreeFlag;
+}
+
+void* TlsfAllocator::GetPayload(const BlockHeader* block)
+{
+	return (void*)((std::uint64_t) block + blockHeaderOverhead);
+}
+
+TlsfAllocator::BlockHeader* TlsfAllocator::GetNextPhysBlock(const BlockHeader* block)
+{
+	return (BlockHeader*)((std::uint64_t) GetPayload(block) + GetBlockSize(block));
+}
+
+size_t TlsfAllocator::AdjustRequestSize(size_t size)
+{
+	const size_t alignedSize = (size + blockAlignment - 1) & ~(blockAlignment - 1);
+	return std::max(alignedSize, minBlockSize);
+}
+
+void TlsfAllocator::MappingInsert(size_t size, int& fl, int& sl)
+{
+	if (size < smallBlockSize)
+	{
+		//Small blocks are stored linearly in the first list
+		fl = 0;
+		sl = static_cast<int>(size / (smallBlockSize / slIndexCount));
+	}
+	else
+	{
+		fl = FindLastSet(size);
+		sl = static_cast<int>(size >> (fl - slIndexCountLog2)) ^ (1 << slIndexCountLog2);
+		fl -= flIndexShift - 1;
+	}
+}
+
+void TlsfAllocator::MappingSearch(size_t size, int& fl, int& sl)
+{
+	//Rounding up to the next list so that any block in it is big enough
+	if (size >= smallBlockSize)
+	{
+		size += (size_t(1) << (FindLastSet(size) - slIndexCountLog2)) - 1;
+	}
+	MappingInsert(size, fl, sl);
+}
+
+TlsfAllocator::BlockHeader* TlsfAllocator::SplitBlock(BlockHeader* block, size_t size)
+{
+	auto* remainingBlock = (BlockHeader*)((std::uint64_t) GetPayload(block) + size);
+	remainingBlock->size = GetBlockSize(block) - size - blockHeaderOverhead;
+	SetBlockSize(block, size);
+	remainingBlock->prevPhysBlock = block;
+	GetNextPhysBlock(remainingBlock)->prevPhysBlock = remainingBlock;
+	return remainingBlock;
+}
+
+TlsfAllocator::BlockHeader* TlsfAllocator::LocateFreeBlock(size_t size)
+{
+	int fl = 0;
+	int sl = 0;
+	MappingSearch(size, fl, sl);
+	if (fl >= flIndexCount)
+	{
+		return nullptr;
+	}
+	std::uint32_t slMap = slBitmaps_[fl] & (~0u << sl);
+	if (slMap == 0)
+	{
+		const std::uint32_t flMap = flBitmap_ & (~0u << (fl + 1));
+		if (flMap == 0)
+		{
+			return nullptr;
+		}
+		fl = FindFirstSet(flMap);
+		slMap = slBitmaps_[fl];
+	}
+	sl = FindFirstSet(slMap);
+	return freeBlocks_[fl][sl];
+}
+
+void TlsfAllocator::InsertFreeBlock(BlockHeader* block)
+{
+	int fl = 0;
+	int sl = 0;
+	MappingInsert(GetBlockSize(block), fl, sl);
+	BlockHeader* head = freeBlocks_[fl][sl];
+	block->nextFree = head;
+	block->prevFree = nullptr;
+	if (head != nullptr)
+	{
+		head->prevFree = block;
+	}
+	freeBlocks_[fl][sl] = block;
+	flBitmap_ |= 1u << fl;
+	slBitmaps_[fl] |= 1u << sl;
+}
+
+void TlsfAllocator::RemoveFreeBlock(BlockHeader* block)
+{
+	int fl = 0;
+	int sl = 0;
+	MappingInsert(GetBlockSize(block), fl, sl);
+	if (block->prevFree != nullptr)
+	{
+		block->prevFree->nextFree = block->nextFree;
+	}
+	if (block->nextFree != nullptr)
+	{
+		block->nextFree->prevFree = block->prevFree;
+	}
+	if (freeBlocks_[fl][sl] == block)
+	{
+		freeBlocks_[fl][sl] = block->nextFree;
+		if (block->nextFree == nullptr)
+		{
+			slBitmaps_[fl] &= ~(1u << sl);
+			if (slBitmaps_[fl] == 0)
+			{
+				flBitmap_ &= ~(1u << fl);
+			}
+		}
+	}
+}
+
+namespace
+{
+struct ThreadCacheRegistry
+{
+	std::mutex mutex;
+	std::vector<std::uint32_t> freeIndices;
+	std::uint32_t indexCount = 0;
+	std::vector<ThreadCacheOwner*> owners;
+};
+
+ThreadCacheRegistry& GetThreadCacheRegistry()
+{
+	static ThreadCacheRegistry registry;
+	return registry;
+}
+
+/**
+ * \brief Holds the cache index of a thread, destroyed with the thread
+ */
+class ThreadCacheSlot
+{
+public:
+	ThreadCacheSlot()
+	{
+		auto& registry = GetThreadCacheRegistry();
+		std::lock_guard<std::mutex> lock(registry.mutex);
+		if (registry.freeIndices.empty())
+		{
+			index_ = registry.indexCount++;
+		}
+		else
+		{
+			index_ = registry.freeIndices.back();
+			registry.freeIndices.pop_back();
+		}
+	}
+
+	~ThreadCacheSlot()
+	{
+		auto& registry = GetThreadCacheRegistry();
+		std::lock_guard<std::mutex> lock(registry.mutex);
+		for (auto* owner : registry.owners)
+		{
+			owner->FlushThreadCache(index_);
+		}
+		registry.freeIndices.push_back(index_);
+	}
+
+	[[nodiscard]] std::uint32_t GetIndex() const { return index_; }
+private:
+	std::uint32_t index_ = 0;
+};
+}
+
+std::uint32_t GetThreadCacheIndex()
+{
+	thread_local const ThreadCacheSlot slot;
+	return slot.GetIndex();
+}
+
+void RegisterThreadCacheOwner(ThreadCacheOwner* owner)
+{
+	auto& registry = GetThreadCacheRegistry();
+	std::lock_guard<std::mutex> lock(registry.mutex);
+	registry.owners.push_back(owner);
+}
+
+void UnregisterThreadCacheOwner(ThreadCacheOwner* owner)
+{
+	auto& registry = GetThreadCacheRegistry();
+	std::lock_guard<std::mutex> lock(registry.mutex);
+	registry.owners.erase(std::remove(registry.owners.begin(), registry.owners.end(), owner), registry.owners.end());
+}
+
 void* ProxyAllocator::Allocate(size_t allocatedSize, size_t alignment)
 {
 	numAllocations_++;
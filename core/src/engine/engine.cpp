@@ -25,10 +25,13 @@
 #include <emscripten.h>
 #endif
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <sstream>
 
 #include <engine/engine.h>
+#include <engine/frame_allocator.h>
 #include <engine/log.h>
 #include <utilities/file_utility.h>
 #include "graphics/graphics.h"
@@ -103,7 +106,32 @@ void BasicEngine::Init()
 #endif
 	instance_ = this;
 	logDebug("Current path: " + GetCurrentPath());
+    assetDatabase_.SetMountPath(config.dataRootPath);
+    if (!config.dataArchivePath.empty() && assetArchive_.Open(config.dataArchivePath, config.dataRootPath))
+    {
+        AssetArchiveLocator::provide(&assetArchive_);
+        assetDatabase_.Build(assetArchive_);
+    }
+    if (!config.assetDatabasePath.empty())
+    {
+        assetDatabase_.Load(config.assetDatabasePath);
+    }
+    AssetDatabaseLocator::provide(&assetDatabase_);
 	jobSystem_.Init();
+    if (config.trackMemoryBudgets)
+    {
+        memoryBudgetManager_.Init();
+        if (config.memoryBudgetLogPeriod > 0.0f)
+        {
+            memoryBudgetManager_.SetSnapshotCallback(seconds(config.memoryBudgetLogPeriod),
+                [](const MemoryBudgetSnapshot& snapshot)
+            {
+                logDebug(FormatMemoryBudgetSnapshot(snapshot));
+            });
+        }
+        updateAction_.RegisterCallback([this](seconds dt) { memoryBudgetManager_.Update(dt); });
+        RegisterOnDrawUi(memoryBudgetManager_);
+    }
 }
 
 void BasicEngine::Update(seconds dt)
@@ -112,6 +140,7 @@ void BasicEngine::Update(seconds dt)
 #ifdef EASY_PROFILE_USE
 	EASY_BLOCK("Basic Engine Update");
 #endif
+    FrameAllocator::NewFrame();
 
     renderer_->ResetJobs();
     window_->ResetJobs();
@@ -147,9 +176,24 @@ void BasicEngine::Update(seconds dt)
 void BasicEngine::Destroy()
 {
 	destroyAction_.Execute();
-    renderer_->Destroy();
-	window_->Destroy();
+    //Headless engines, like in the tests, have no renderer and no window
+    if (renderer_ != nullptr)
+    {
+        renderer_->Destroy();
+    }
+    if (window_ != nullptr)
+    {
+	    window_->Destroy();
+    }
 	jobSystem_.Destroy();
+    AssetDatabaseLocator::provide(nullptr);
+    assetDatabase_.Clear();
+    AssetArchiveLocator::provide(nullptr);
+    assetArchive_.Close();
+    if (config.trackMemoryBudgets)
+    {
+        memoryBudgetManager_.Destroy();
+    }
 	instance_ = nullptr;
 }
 
@@ -225,5 +269,50 @@ void BasicEngine::ScheduleJob(Job* job, JobThreadType threadType)
     jobSystem_.ScheduleJob(job, threadType);
 }
 
+bool BasicEngine::CancelJob(const Job* job, JobThreadType threadType)
+{
+    return jobSystem_.CancelJob(job, threadType);
+}
+
+void RunParallelTasks(std::size_t taskCount, const std::function<void(std::size_t)>& func)
+{
+#ifndef NEKO_SAMETHREAD
+    auto* engine = BasicEngine::GetInstance();
+    const std::size_t jobCount = std::min<std::size_t>(taskCount, std::thread::hardware_concurrency());
+    if (jobCount > 1 && engine != nullptr)
+    {
+        std::atomic<std::size_t> nextTask{0};
+        const auto runTasks = [&nextTask, taskCount, &func]
+        {
+            for (std::size_t task = nextTask++; task < taskCount; task = nextTask++)
+            {
+                func(task);
+            }
+        };
+        std::vector<Job> jobs;
+        jobs.reserve(jobCount - 1);
+        for (std::size_t i = 0; i + 1 < jobCount; i++)
+        {
+            jobs.emplace_back(runTasks);
+            engine->ScheduleJob(&jobs.back(), JobThreadType::OTHER_THREAD);
+        }
+        runTasks();
+        //A worker waiting for queued jobs could starve the pool, the popped jobs run right away
+        for (const auto& job : jobs)
+        {
+            if (!engine->CancelJob(&job, JobThreadType::OTHER_THREAD))
+            {
+                job.Join();
+            }
+        }
+        return;
+    }
+#endif
+    for (std::size_t task = 0; task < taskCount; task++)
+    {
+        func(task);
+    }
+}
+
 
 }
@@ -149,6 +149,15 @@ void DirtyManager::SetDirty(Entity entity)
 }
 
 void DirtyManager::UpdateDirtyEntities()
+{
+    PopDirtyEntities(updatedEntities_);
+    for (auto entity : updatedEntities_)
+    {
+        updateDirtyEntity.Execute(entity);
+    }
+}
+
+void DirtyManager::PopDirtyEntities(std::vector<Entity>& dirtyEntities)
 {
     //Fill the dirty entities with all the children in O(n)
     for (Entity entity = 0; entity < entityManager_.get().GetEntitiesSize(); entity++)
@@ -166,11 +175,8 @@ void DirtyManager::UpdateDirtyEntities()
             parent = entityManager_.get().GetEntityParent(parent);
         }
     }
-    for (auto entity : dirtyEntities_)
-    {
-        updateDirtyEntity.Execute(entity);
-    }
-    dirtyEntities_.clear();
+    dirtyEntities.clear();
+    std::swap(dirtyEntities, dirtyEntities_);
 }
 
 EntityHierarchy::EntityHierarchy(EntityManager& entityManager) : entityManager_(entityManager)
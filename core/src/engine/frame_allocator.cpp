@@ -0,0 +1,93 @@
+/*
+ MIT License
+
+ Copyright (c) 2020 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#include <cstring>
+#include "engine/frame_allocator.h"
+
+namespace neko
+{
+
+std::atomic<std::uint32_t> FrameAllocator::globalFrameIndex_{0};
+
+void FrameLinearAllocator::Deallocate([[maybe_unused]] void* p)
+{
+	//Memory is reclaimed when the frame is reset
+}
+
+void FrameLinearAllocator::Reset()
+{
+#ifdef __neko_dbg__
+	std::memset(start_, FrameAllocator::poisonValue, usedMemory_);
+#endif
+	Clear();
+}
+
+FrameAllocator::FrameAllocator(size_t size) :
+	memory_(size * 2),
+	frames_{ {FrameLinearAllocator(size, memory_.data()), FrameLinearAllocator(size, memory_.data() + size)} },
+	frameIndex_(GetGlobalFrameIndex())
+{
+}
+
+void* FrameAllocator::Allocate(size_t allocatedSize, size_t alignment)
+{
+	return GetCurrentAllocator().Allocate(allocatedSize, alignment);
+}
+
+Allocator& FrameAllocator::GetCurrentAllocator()
+{
+	SyncFrame();
+	return frames_[frameIndex_ % 2];
+}
+
+FrameAllocator& FrameAllocator::Get()
+{
+	thread_local FrameAllocator frameAllocator;
+	return frameAllocator;
+}
+
+void FrameAllocator::NewFrame()
+{
+	globalFrameIndex_.fetch_add(1, std::memory_order_acq_rel);
+}
+
+void FrameAllocator::SyncFrame()
+{
+	const auto globalFrameIndex = GetGlobalFrameIndex();
+	if (globalFrameIndex == frameIndex_)
+		return;
+	if (globalFrameIndex - frameIndex_ > 1)
+	{
+		//Both frames are older than the previous frame
+		frames_[0].Reset();
+		frames_[1].Reset();
+	}
+	else
+	{
+		//Keeping the previous frame alive, reusing the one before
+		frames_[globalFrameIndex % 2].Reset();
+	}
+	frameIndex_ = globalFrameIndex;
+}
+}
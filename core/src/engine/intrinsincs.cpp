@@ -0,0 +1,114 @@
+/*
+ MIT License
+
+ Copyright (c) 2020 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#include "engine/intrinsincs.h"
+
+namespace neko
+{
+namespace
+{
+SimdLevel DetectSimdLevel()
+{
+#if defined(__aarch64__)
+	//NEON is mandatory on AArch64
+	return SimdLevel::NEON;
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+	int info[4];
+	__cpuid(info, 0);
+	const int maxLeaf = info[0];
+	__cpuid(info, 1);
+	const bool sse41 = (info[2] & (1 << 19)) != 0;
+	const bool fma = (info[2] & (1 << 12)) != 0;
+	const bool osxsave = (info[2] & (1 << 27)) != 0;
+	const bool avx = (info[2] & (1 << 28)) != 0;
+	bool avx2 = false;
+	bool avx512f = false;
+	if (maxLeaf >= 7)
+	{
+		__cpuidex(info, 7, 0);
+		avx2 = (info[1] & (1 << 5)) != 0;
+		avx512f = (info[1] & (1 << 16)) != 0;
+	}
+	//The OS needs to save the ymm (and zmm) registers on context switch
+	const unsigned long long xcr0 = osxsave ? _xgetbv(0) : 0;
+	const bool ymmState = (xcr0 & 0x6) == 0x6;
+	const bool zmmState = (xcr0 & 0xE6) == 0xE6;
+	if (avx && avx2 && fma && avx512f && zmmState)
+		return SimdLevel::AVX512;
+	if (avx && avx2 && fma && ymmState)
+		return SimdLevel::AVX2;
+	if (sse41)
+		return SimdLevel::SSE4;
+	return SimdLevel::SCALAR;
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+	//libgcc also checks xgetbv for the OS support of the avx registers
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+		return SimdLevel::AVX512;
+	if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+		return SimdLevel::AVX2;
+	if (__builtin_cpu_supports("sse4.1"))
+		return SimdLevel::SSE4;
+	return SimdLevel::SCALAR;
+#else
+	return SimdLevel::SCALAR;
+#endif
+}
+}
+
+SimdLevel GetCpuSimdLevel()
+{
+	static const SimdLevel level = DetectSimdLevel();
+	return level;
+}
+
+bool IsSimdLevelSupported(SimdLevel level)
+{
+	const SimdLevel cpuLevel = GetCpuSimdLevel();
+	if (level == SimdLevel::SCALAR)
+		return true;
+	if (level == SimdLevel::NEON || cpuLevel == SimdLevel::NEON)
+		return level == cpuLevel;
+	return static_cast<std::uint8_t>(level) <= static_cast<std::uint8_t>(cpuLevel);
+}
+
+const char* GetSimdLevelName(SimdLevel level)
+{
+	switch (level)
+	{
+	case SimdLevel::SCALAR:
+		return "Scalar";
+	case SimdLevel::SSE4:
+		return "SSE4";
+	case SimdLevel::AVX2:
+		return "AVX2";
+	case SimdLevel::AVX512:
+		return "AVX-512";
+	case SimdLevel::NEON:
+		return "NEON";
+	default:
+		return "Unknown";
+	}
+}
+}
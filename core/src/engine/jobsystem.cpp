@@ -24,6 +24,7 @@
 
 #include <engine/jobsystem.h>
 
+#include <algorithm>
 #include <utility>
 
 #ifdef EASY_PROFILE_USE
@@ -32,7 +33,6 @@
 
 namespace neko
 {
-
 JobSystem::JobSystem()
 {
 
@@ -49,10 +49,10 @@ void JobSystem::ScheduleJob(Job* func, JobThreadType threadType)
     {
 #ifndef NEKO_SAMETHREAD
         std::unique_lock<std::mutex> lock(jobQueue.mutex_);
-        jobQueue.jobs_.push(func);
+        jobQueue.jobs_.push_back(func);
         jobQueue.cv_.notify_one();
 #else
-        jobQueue.jobs_.push(func);
+        jobQueue.jobs_.push_back(func);
 #endif
 
     };
@@ -81,6 +81,35 @@ void JobSystem::ScheduleJob(Job* func, JobThreadType threadType)
 	default: ;
 	}
 }
+bool JobSystem::CancelJob(const Job* job, JobThreadType threadType)
+{
+    JobQueue* jobQueue = nullptr;
+    switch (threadType)
+    {
+        case JobThreadType::RENDER_THREAD:
+            jobQueue = &renderJobs_;
+            break;
+        case JobThreadType::RESOURCE_THREAD:
+            jobQueue = &resourceJobs_;
+            break;
+        case JobThreadType::OTHER_THREAD:
+            jobQueue = &jobs_;
+            break;
+        default:
+            return false;
+    }
+#ifndef NEKO_SAMETHREAD
+    std::lock_guard<std::mutex> lock(jobQueue->mutex_);
+#endif
+    const auto it = std::find(jobQueue->jobs_.begin(), jobQueue->jobs_.end(), job);
+    if (it == jobQueue->jobs_.end())
+    {
+        return false;
+    }
+    jobQueue->jobs_.erase(it);
+    return true;
+}
+
 #ifdef NEKO_SAMETHREAD
 void JobSystem::KickJobs()
 {
@@ -107,7 +136,7 @@ void JobSystem::Work(JobQueue& jobQueue)
             if (!jobQueue.jobs_.empty())
             {
                 job = jobQueue.jobs_.front();
-                jobQueue.jobs_.pop();
+                jobQueue.jobs_.pop_front();
                 if (!job->CheckDependenciesStarted())
                 {
 #ifndef NEKO_SAMETHREAD
@@ -121,7 +150,7 @@ void JobSystem::Work(JobQueue& jobQueue)
 
                 	}
 #endif
-                    jobQueue.jobs_.push(job);
+                    jobQueue.jobs_.push_back(job);
                     continue;
                 }
             }
@@ -252,10 +281,10 @@ Job& Job::operator=(Job&& job) noexcept
 void Job::Join() const
 {
 #ifndef NEKO_SAMETHREAD
-    if(!IsDone())
-    {
-        taskDoneFuture_.get();
-    }
+    // Always wait on the future: DONE is set before the promise is fulfilled,
+    // so returning on IsDone() alone lets the caller destroy the job while
+    // the worker is still inside set_value.
+    taskDoneFuture_.get();
 #endif
 }
 
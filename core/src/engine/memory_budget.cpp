@@ -0,0 +1,216 @@
+/*
+ MIT License
+
+ Copyright (c) 2020 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#include "engine/memory_budget.h"
+#include "engine/log.h"
+
+#include <algorithm>
+
+#include <fmt/format.h>
+
+namespace neko
+{
+
+MemoryBudgetManager::MemoryBudgetManager()
+{
+	lastSnapshotTime_ = std::chrono::steady_clock::now();
+}
+
+void MemoryBudgetManager::Init()
+{
+	lastSnapshotTime_ = std::chrono::steady_clock::now();
+	MemoryBudgetLocator::provide(this);
+}
+
+void MemoryBudgetManager::Update(seconds dt)
+{
+	if (!snapshotCallback_ || snapshotTimer_.period.count() <= 0.0f)
+		return;
+	snapshotTimer_.Update(dt);
+	if (snapshotTimer_.IsOver())
+	{
+		snapshotCallback_(TakeSnapshot());
+		snapshotTimer_.Reset();
+	}
+}
+
+void MemoryBudgetManager::Destroy()
+{
+	MemoryBudgetLocator::provide(nullptr);
+}
+
+void MemoryBudgetManager::DrawImGui()
+{
+	ImGui::Begin("Memory Budgets");
+	for (size_t i = 0; i < counters_.size(); i++)
+	{
+		const auto stats = GetStats(static_cast<MemoryTag>(i));
+		const float ratio = stats.budget == 0 ? 0.0f : float(stats.currentMemory) / float(stats.budget);
+		const auto label = fmt::format("{}: {}B / {}B (peak {}B)",
+			stats.name, stats.currentMemory, stats.budget, stats.peakMemory);
+		ImGui::ProgressBar(ratio, ImVec2(-1.0f, 0.0f), label.c_str());
+	}
+	ImGui::End();
+}
+
+void MemoryBudgetManager::RecordAllocation(MemoryTag tag, [[maybe_unused]] const void* p, size_t size,
+	[[maybe_unused]] const char* site)
+{
+	auto& counters = counters_[static_cast<size_t>(tag)];
+	const size_t previousMemory = counters.currentMemory.fetch_add(size, std::memory_order_relaxed);
+	const size_t currentMemory = previousMemory + size;
+	counters.allocationNmb.fetch_add(1, std::memory_order_relaxed);
+
+	size_t peakMemory = counters.peakMemory.load(std::memory_order_relaxed);
+	while (peakMemory < currentMemory &&
+		!counters.peakMemory.compare_exchange_weak(peakMemory, currentMemory, std::memory_order_relaxed))
+	{
+	}
+
+	const size_t budget = counters.budget.load(std::memory_order_relaxed);
+	if (budget != 0 && previousMemory <= budget && currentMemory > budget && overrunCallback_)
+	{
+		overrunCallback_(tag, currentMemory, budget);
+	}
+#ifdef __neko_dbg__
+	std::lock_guard<std::mutex> lock(siteMutex_);
+	liveAllocations_[p] = { tag, size, site == nullptr ? std::string_view("Unknown") : std::string_view(site) };
+#endif
+}
+
+void MemoryBudgetManager::RecordDeallocation(MemoryTag tag, [[maybe_unused]] const void* p, size_t size)
+{
+	//Memory allocated before the manager was provided is freed without having been recorded
+	auto& currentMemory = counters_[static_cast<size_t>(tag)].currentMemory;
+	size_t previousMemory = currentMemory.load(std::memory_order_relaxed);
+	while (!currentMemory.compare_exchange_weak(previousMemory, previousMemory - std::min(previousMemory, size),
+		std::memory_order_relaxed))
+	{
+	}
+#ifdef __neko_dbg__
+	std::lock_guard<std::mutex> lock(siteMutex_);
+	liveAllocations_.erase(p);
+#endif
+}
+
+void MemoryBudgetManager::SetBudget(MemoryTag tag, size_t budget)
+{
+	counters_[static_cast<size_t>(tag)].budget.store(budget, std::memory_order_relaxed);
+}
+
+void MemoryBudgetManager::SetSnapshotCallback(seconds period, SnapshotCallback callback)
+{
+	snapshotTimer_ = Timer(period, period);
+	snapshotCallback_ = std::move(callback);
+}
+
+MemoryTagStats MemoryBudgetManager::GetStats(MemoryTag tag) const
+{
+	const auto& counters = counters_[static_cast<size_t>(tag)];
+	MemoryTagStats stats;
+	stats.name = memoryTagNames[static_cast<size_t>(tag)];
+	stats.budget = counters.budget.load(std::memory_order_relaxed);
+	stats.currentMemory = counters.currentMemory.load(std::memory_order_relaxed);
+	stats.peakMemory = counters.peakMemory.load(std::memory_order_relaxed);
+	stats.allocationNmb = counters.allocationNmb.load(std::memory_order_relaxed);
+	return stats;
+}
+
+MemoryBudgetSnapshot MemoryBudgetManager::TakeSnapshot()
+{
+	std::lock_guard<std::mutex> lock(snapshotMutex_);
+	const auto now = std::chrono::steady_clock::now();
+	const auto elapsed = std::chrono::duration_cast<seconds>(now - lastSnapshotTime_);
+	lastSnapshotTime_ = now;
+
+	MemoryBudgetSnapshot snapshot;
+	for (size_t i = 0; i < snapshot.size(); i++)
+	{
+		snapshot[i] = GetStats(static_cast<MemoryTag>(i));
+		auto& counters = counters_[i];
+		if (elapsed.count() > 0.0f)
+		{
+			snapshot[i].allocationRate = float(snapshot[i].allocationNmb - counters.lastSnapshotAllocationNmb) / elapsed.count();
+		}
+		counters.lastSnapshotAllocationNmb = snapshot[i].allocationNmb;
+	}
+	return snapshot;
+}
+
+std::unordered_map<std::string_view, size_t> MemoryBudgetManager::GetAllocationSites([[maybe_unused]] MemoryTag tag) const
+{
+	std::unordered_map<std::string_view, size_t> sites;
+#ifdef __neko_dbg__
+	std::lock_guard<std::mutex> lock(siteMutex_);
+	for (const auto& [p, allocation] : liveAllocations_)
+	{
+		if (allocation.tag == tag)
+		{
+			sites[allocation.site] += allocation.size;
+		}
+	}
+#endif
+	return sites;
+}
+
+std::string FormatMemoryBudgetSnapshot(const MemoryBudgetSnapshot& snapshot)
+{
+	std::string text = "[Memory Budget] Snapshot";
+	for (const auto& stats : snapshot)
+	{
+		if (stats.currentMemory == 0 && stats.peakMemory == 0)
+			continue;
+		text += fmt::format("\n{}: {}B / {}B (peak {}B, {:.1f} allocations/s)",
+			stats.name, stats.currentMemory, stats.budget, stats.peakMemory, stats.allocationRate);
+	}
+	return text;
+}
+
+void* TaggedAllocator::Allocate(size_t allocatedSize, size_t alignment)
+{
+	return AllocateFrom(allocatedSize, alignment, nullptr);
+}
+
+void* TaggedAllocator::AllocateFrom(size_t allocatedSize, size_t alignment, const char* site)
+{
+	const size_t previousMemory = usedMemory_;
+	void* p = ProxyAllocator::Allocate(allocatedSize, alignment);
+	MemoryBudgetLocator::get().RecordAllocation(tag_, p, usedMemory_ - previousMemory, site);
+	return p;
+}
+
+void TaggedAllocator::Deallocate(void* p)
+{
+	const size_t previousMemory = usedMemory_;
+	ProxyAllocator::Deallocate(p);
+	MemoryBudgetLocator::get().RecordDeallocation(tag_, p, previousMemory - usedMemory_);
+}
+
+void TaggedAllocator::Profile()
+{
+	ImGui::LabelText("Type", "Tagged Allocator");
+	ImGui::LabelText("Tag", "%s", memoryTagNames[static_cast<size_t>(tag_)].data());
+	allocator_.Profile();
+}
+}
@@ -25,6 +25,7 @@
 #include <engine/transform.h>
 #include "engine/globals.h"
 #include "mathematics/transform.h"
+#include "mathematics/matrix_batch.h"
 #include "imgui.h"
 #include "graphics/graphics.h"
 
@@ -46,9 +47,15 @@ void Scale3dManager::AddComponent(Entity entity)
 	return ComponentManager::AddComponent(entity);
 }
 
+void Rotation3dManager::AddComponent(Entity entity)
+{
+	ResizeIfNecessary(components_, entity, Quaternion::Identity());
+	return ComponentManager::AddComponent(entity);
+}
+
 
 Transform2dManager::Transform2dManager(EntityManager& entityManager) :
-	ComponentManager<Mat4f, EntityMask(neko::ComponentType::TRANSFORM2D)>(entityManager),
+	ComponentManager<Affine2f, EntityMask(neko::ComponentType::TRANSFORM2D)>(entityManager),
 	positionManager_(entityManager),
 	scaleManager_(entityManager),
     rotationManager_(entityManager),
@@ -112,13 +119,16 @@ void Transform2dManager::Update()
 
 void Transform2dManager::UpdateTransform(Entity entity)
 {
-    Mat4f transform = Mat4f::Identity;
-    const auto eulerAngles = EulerAngles(degree_t (0),degree_t (0),-rotationManager_.GetComponent(entity));
-    transform = Transform3d::Rotate(transform, eulerAngles);
+    const radian_t angle = rotationManager_.GetComponent(entity);
+    const float c = Cos(angle);
+    const float s = Sin(angle);
     const auto scale = scaleManager_.GetComponent(entity);
-    transform = Transform3d::Scale(transform, Vec3f(scale, 1.0f));
-    const auto position = positionManager_.GetComponent(entity);
-    transform = Transform3d::Translate(transform, Vec3f(position, 0.0f));
+    //Same matrix as the former Rotate(EulerAngles(0, 0, -angle)), Scale, Translate chain on a Mat4f:
+    //the rotation is clockwise with a flipped y axis and the scale is applied on the world axes
+    Affine2f transform(
+        Vec2f(scale.x * c, -scale.y * s),
+        Vec2f(-scale.x * s, -scale.y * c),
+        positionManager_.GetComponent(entity));
 
     const auto parent = entityManager_.get().GetEntityParent(entity);
     if (parent != INVALID_ENTITY)
@@ -129,6 +139,14 @@ void Transform2dManager::UpdateTransform(Entity entity)
     SetComponent(entity, transform);
 }
 
+void Transform2dManager::CopyTransform(Entity entity, const Transform2dManager& other)
+{
+    positionManager_.SetComponent(entity, other.positionManager_.GetComponent(entity));
+    scaleManager_.SetComponent(entity, other.scaleManager_.GetComponent(entity));
+    rotationManager_.SetComponent(entity, other.rotationManager_.GetComponent(entity));
+    SetComponent(entity, other.GetComponent(entity));
+}
+
 void Transform2dManager::AddComponent(Entity entity)
 {
     positionManager_.AddComponent(entity);
@@ -147,7 +165,6 @@ Transform3dManager::Transform3dManager(EntityManager& entityManager) :
 	dirtyManager_(entityManager)
 {
 	entityManager_.get().RegisterOnChangeParent(this);
-	dirtyManager_.RegisterComponentManager(this);
 }
 
 void Transform3dManager::Init()
@@ -157,10 +174,10 @@ void Transform3dManager::Init()
 
 void Transform3dManager::UpdateTransform(Entity entity)
 {
-    Mat4f transform = Mat4f::Identity;
-	transform = Transform3d::Rotate(transform, rotation3DManager_.GetComponent(entity));
-	transform = Transform3d::Scale(transform, scale3DManager_.GetComponent(entity));
-    transform = Transform3d::Translate(transform, position3DManager_.GetComponent(entity));
+	Mat4f transform = Transform3d::TrsMatrixFrom(
+		position3DManager_.GetComponent(entity),
+		rotation3DManager_.GetComponent(entity),
+		scale3DManager_.GetComponent(entity));
 
 	const auto parent = entityManager_.get().GetEntityParent(entity);
 	if (parent != INVALID_ENTITY)
@@ -217,7 +234,16 @@ void Transform3dManager::SetScale(Entity entity, Vec3f scale)
 
 void Transform3dManager::SetRotation(Entity entity, EulerAngles angles)
 {
-	rotation3DManager_.SetComponent(entity, angles);
+	const Quaternion rotation =
+		Quaternion::AngleAxis(angles.z, Vec3f::forward) *
+		Quaternion::AngleAxis(angles.y, Vec3f::up) *
+		Quaternion::AngleAxis(angles.x, Vec3f::right);
+	SetRotation(entity, rotation);
+}
+
+void Transform3dManager::SetRotation(Entity entity, const Quaternion& rotation)
+{
+	rotation3DManager_.SetComponent(entity, rotation);
 	dirtyManager_.SetDirty(entity);
 }
 
@@ -232,6 +258,11 @@ Vec3f Transform3dManager::GetScale(Entity entity) const
 }
 
 EulerAngles Transform3dManager::GetAngles(Entity entity) const
+{
+	return rotation3DManager_.GetComponent(entity).ToEuler();
+}
+
+const Quaternion& Transform3dManager::GetRotation(Entity entity) const
 {
 	return rotation3DManager_.GetComponent(entity);
 }
@@ -251,7 +282,55 @@ void Transform3dManager::Update()
 #ifdef EASY_PROFILE_USE
 	EASY_BLOCK("Update Transform");
 #endif
-	dirtyManager_.UpdateDirtyEntities();
+	dirtyManager_.PopDirtyEntities(dirtyEntities_);
+	UpdateTransforms(dirtyEntities_);
+}
+
+void Transform3dManager::UpdateTransforms(const std::vector<Entity>& entities)
+{
+	const std::size_t count = entities.size();
+	if (count == 0)
+		return;
+	trsBuffer_.resize(count * 10);
+	localTransforms_.resize(count);
+	float* trs = trsBuffer_.data();
+	for (std::size_t i = 0; i < count; i++)
+	{
+		const Entity entity = entities[i];
+		const Vec3f& position = position3DManager_.GetComponent(entity);
+		const Quaternion& rotation = rotation3DManager_.GetComponent(entity);
+		const Vec3f& scale = scale3DManager_.GetComponent(entity);
+		trs[i] = position.x;
+		trs[count + i] = position.y;
+		trs[2 * count + i] = position.z;
+		trs[3 * count + i] = rotation.x;
+		trs[4 * count + i] = rotation.y;
+		trs[5 * count + i] = rotation.z;
+		trs[6 * count + i] = rotation.w;
+		trs[7 * count + i] = scale.x;
+		trs[8 * count + i] = scale.y;
+		trs[9 * count + i] = scale.z;
+	}
+	const TrsSoA trsSoA{
+		trs, trs + count, trs + 2 * count,
+		trs + 3 * count, trs + 4 * count, trs + 5 * count, trs + 6 * count,
+		trs + 7 * count, trs + 8 * count, trs + 9 * count };
+	ComposeTrsBatch(trsSoA, localTransforms_.data(), count);
+
+	//Parents are applied in the dirty order, like UpdateDirtyEntities
+	for (std::size_t i = 0; i < count; i++)
+	{
+		const Entity entity = entities[i];
+		const auto parent = entityManager_.get().GetEntityParent(entity);
+		if (parent != INVALID_ENTITY)
+		{
+			SetComponent(entity, GetComponent(parent) * localTransforms_[i]);
+		}
+		else
+		{
+			SetComponent(entity, localTransforms_[i]);
+		}
+	}
 }
 
 void Transform3dManager::AddComponent(Entity entity)
@@ -260,6 +339,7 @@ void Transform3dManager::AddComponent(Entity entity)
 	scale3DManager_.AddComponent(entity);
 	scale3DManager_.SetComponent(entity, Vec3f::one);
 	rotation3DManager_.AddComponent(entity);
+	rotation3DManager_.SetComponent(entity, Quaternion::Identity());
 	return DoubleBufferComponentManager::AddComponent(entity);
 }
 }
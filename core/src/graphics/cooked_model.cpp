@@ -0,0 +1,271 @@
+/*
+ MIT License
+
+ Copyright (c) 2020 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#include "graphics/cooked_model.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <fmt/format.h>
+#include "engine/log.h"
+#include "mathematics/checksum.h"
+
+#ifdef EASY_PROFILE_USE
+#include "easy/profiler.h"
+#endif
+
+namespace neko
+{
+namespace
+{
+//The blobs are aligned so that the mapped vertices and indices can be read in place
+constexpr std::uint64_t blobAlignment = 16;
+
+std::uint64_t AlignBlobOffset(std::uint64_t offset)
+{
+    return (offset + blobAlignment - 1) / blobAlignment * blobAlignment;
+}
+
+void ComputeMeshBounds(const CookedMeshSource& mesh, CookedMeshEntry& entry)
+{
+    if (mesh.vertexCount == 0)
+    {
+        entry.aabbMin = Vec3f::zero;
+        entry.aabbMax = Vec3f::zero;
+        entry.boundingSphere = {Vec3f::zero, 0.0f};
+        return;
+    }
+    Vec3f aabbMin = mesh.vertices[0].position;
+    Vec3f aabbMax = mesh.vertices[0].position;
+    for (size_t i = 1; i < mesh.vertexCount; i++)
+    {
+        const auto& position = mesh.vertices[i].position;
+        aabbMin = Vec3f(std::min(aabbMin.x, position.x), std::min(aabbMin.y, position.y), std::min(aabbMin.z, position.z));
+        aabbMax = Vec3f(std::max(aabbMax.x, position.x), std::max(aabbMax.y, position.y), std::max(aabbMax.z, position.z));
+    }
+    //Centered on the box, the radius reaches the farthest vertex
+    const Vec3f center = (aabbMin + aabbMax) * 0.5f;
+    float radius2 = 0.0f;
+    for (size_t i = 0; i < mesh.vertexCount; i++)
+    {
+        const Vec3f delta = mesh.vertices[i].position - center;
+        radius2 = std::max(radius2, delta.x * delta.x + delta.y * delta.y + delta.z * delta.z);
+    }
+    entry.aabbMin = aabbMin;
+    entry.aabbMax = aabbMax;
+    entry.boundingSphere = {center, std::sqrt(radius2)};
+}
+
+/**
+ * \brief Checks that count elements of elementSize bytes at offset are inside the file, without overflow
+ */
+bool IsBlobInFile(std::uint64_t offset, std::uint64_t count, std::uint64_t elementSize, size_t fileLength)
+{
+    return offset <= fileLength && count <= (fileLength - offset) / elementSize;
+}
+}
+
+bool WriteCookedModel(std::string_view path, const std::vector<CookedMeshSource>& meshes)
+{
+#ifdef EASY_PROFILE_USE
+    EASY_BLOCK("Write Cooked Model");
+#endif
+    CookedModelHeader header;
+    header.version = CookedModel::formatVersion;
+    header.meshCount = static_cast<std::uint32_t>(meshes.size());
+    std::vector<CookedMeshEntry> entries(meshes.size());
+    std::vector<CookedMeshTexture> textures;
+    std::string stringTable;
+    for (size_t i = 0; i < meshes.size(); i++)
+    {
+        const auto& mesh = meshes[i];
+        auto& entry = entries[i];
+        entry.vertexCount = static_cast<std::uint32_t>(mesh.vertexCount);
+        entry.indexCount = static_cast<std::uint32_t>(mesh.indexCount);
+        entry.firstTexture = static_cast<std::uint32_t>(textures.size());
+        entry.textureCount = static_cast<std::uint32_t>(mesh.textures.size());
+        entry.specularExponent = mesh.specularExponent;
+        ComputeMeshBounds(mesh, entry);
+        for (const auto& texture : mesh.textures)
+        {
+            CookedMeshTexture cookedTexture;
+            cookedTexture.pathOffset = static_cast<std::uint32_t>(stringTable.size());
+            cookedTexture.pathLength = static_cast<std::uint32_t>(texture.path.size());
+            cookedTexture.type = texture.type;
+            textures.push_back(cookedTexture);
+            stringTable += texture.path;
+        }
+    }
+    header.textureCount = static_cast<std::uint32_t>(textures.size());
+    header.stringTableOffset = sizeof(CookedModelHeader) + entries.size() * sizeof(CookedMeshEntry) +
+        textures.size() * sizeof(CookedMeshTexture);
+    header.stringTableByteLength = static_cast<std::uint32_t>(stringTable.size());
+
+    std::uint64_t offset = AlignBlobOffset(header.stringTableOffset + stringTable.size());
+    for (auto& entry : entries)
+    {
+        entry.vertexOffset = offset;
+        offset = AlignBlobOffset(offset + entry.vertexCount * sizeof(MeshVertex));
+    }
+    for (auto& entry : entries)
+    {
+        entry.indexOffset = offset;
+        offset = AlignBlobOffset(offset + entry.indexCount * sizeof(std::uint32_t));
+    }
+
+    std::ofstream os(path.data(), std::ofstream::binary | std::ofstream::trunc);
+    if (!os)
+    {
+        logDebug(fmt::format("[Error] Could not open cooked model: {} for writing", path));
+        return false;
+    }
+    os.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    os.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(CookedMeshEntry));
+    os.write(reinterpret_cast<const char*>(textures.data()), textures.size() * sizeof(CookedMeshTexture));
+    os.write(stringTable.data(), stringTable.size());
+    std::uint64_t position = header.stringTableOffset + stringTable.size();
+    const auto writeBlob = [&os, &position](std::uint64_t blobOffset, const void* data, size_t byteSize)
+    {
+        for (; position < blobOffset; position++)
+        {
+            os.put(0);
+        }
+        os.write(static_cast<const char*>(data), byteSize);
+        position += byteSize;
+    };
+    for (size_t i = 0; i < meshes.size(); i++)
+    {
+        writeBlob(entries[i].vertexOffset, meshes[i].vertices, meshes[i].vertexCount * sizeof(MeshVertex));
+    }
+    for (size_t i = 0; i < meshes.size(); i++)
+    {
+        writeBlob(entries[i].indexOffset, meshes[i].indices, meshes[i].indexCount * sizeof(std::uint32_t));
+    }
+    return static_cast<bool>(os);
+}
+
+bool CookedModel::Load(std::string_view path)
+{
+#ifdef EASY_PROFILE_USE
+    EASY_BLOCK("Load Cooked Model");
+#endif
+    Destroy();
+    if (!FileExists(path))
+    {
+        return false;
+    }
+    file_.Load(path, BufferFile::LoadMode::MAP);
+    const auto* data = file_.dataBuffer;
+    const size_t length = file_.dataLength;
+    CookedModelHeader header;
+    if (data == nullptr || length < sizeof(CookedModelHeader))
+    {
+        logDebug(fmt::format("[Error] Cooked model: {} is too small", path));
+        Destroy();
+        return false;
+    }
+    std::memcpy(&header, data, sizeof(CookedModelHeader));
+    if (header.identifier != CookedModelHeader::identifierValue || header.version != formatVersion)
+    {
+        logDebug(fmt::format("[Error] Cooked model: {} has an unknown identifier or version", path));
+        Destroy();
+        return false;
+    }
+    const std::uint64_t tablesEnd = sizeof(CookedModelHeader) +
+        std::uint64_t(header.meshCount) * sizeof(CookedMeshEntry) +
+        std::uint64_t(header.textureCount) * sizeof(CookedMeshTexture);
+    if (tablesEnd > header.stringTableOffset ||
+        !IsBlobInFile(header.stringTableOffset, header.stringTableByteLength, 1, length))
+    {
+        logDebug(fmt::format("[Error] Cooked model: {} has invalid tables", path));
+        Destroy();
+        return false;
+    }
+    //The tables and blobs are read in place, the mapping is page aligned and the blobs 16 bytes aligned
+    const auto* entries = reinterpret_cast<const CookedMeshEntry*>(data + sizeof(CookedModelHeader));
+    const auto* textures = reinterpret_cast<const CookedMeshTexture*>(entries + header.meshCount);
+    meshes_.reserve(header.meshCount);
+    for (std::uint32_t i = 0; i < header.meshCount; i++)
+    {
+        const auto& entry = entries[i];
+        const bool isValid = entry.vertexOffset % alignof(MeshVertex) == 0 &&
+            entry.indexOffset % alignof(std::uint32_t) == 0 &&
+            IsBlobInFile(entry.vertexOffset, entry.vertexCount, sizeof(MeshVertex), length) &&
+            IsBlobInFile(entry.indexOffset, entry.indexCount, sizeof(std::uint32_t), length) &&
+            entry.firstTexture <= header.textureCount &&
+            entry.textureCount <= header.textureCount - entry.firstTexture;
+        if (!isValid)
+        {
+            logDebug(fmt::format("[Error] Cooked model: {} has an invalid mesh {}", path, i));
+            Destroy();
+            return false;
+        }
+        const auto* indices = reinterpret_cast<const std::uint32_t*>(data + entry.indexOffset);
+        //An index past the vertices would make the draw call read past the vertex buffer
+        if (entry.indexCount > 0 &&
+            *std::max_element(indices, indices + entry.indexCount) >= entry.vertexCount)
+        {
+            logDebug(fmt::format("[Error] Cooked model: {} has an out of range index in mesh {}", path, i));
+            Destroy();
+            return false;
+        }
+        MeshView mesh;
+        mesh.entry = &entry;
+        mesh.vertices = reinterpret_cast<const MeshVertex*>(data + entry.vertexOffset);
+        mesh.indices = indices;
+        mesh.textures = textures + entry.firstTexture;
+        meshes_.push_back(mesh);
+    }
+    for (std::uint32_t i = 0; i < header.textureCount; i++)
+    {
+        if (textures[i].pathOffset > header.stringTableByteLength ||
+            textures[i].pathLength > header.stringTableByteLength - textures[i].pathOffset)
+        {
+            logDebug(fmt::format("[Error] Cooked model: {} has an invalid texture path", path));
+            Destroy();
+            return false;
+        }
+    }
+    stringTable_ = reinterpret_cast<const char*>(data + header.stringTableOffset);
+    return true;
+}
+
+void CookedModel::Destroy()
+{
+    meshes_.clear();
+    stringTable_ = nullptr;
+    file_.Destroy();
+}
+
+std::string_view CookedModel::GetTexturePath(const CookedMeshTexture& texture) const
+{
+    return std::string_view(stringTable_ + texture.pathOffset, texture.pathLength);
+}
+
+std::string CookedModel::GetCookedPath(std::string_view cacheFolder, const BufferFile& sourceFile)
+{
+    return fmt::format("{}/{:016x}{}", cacheFolder,
+        Hash64(sourceFile.dataBuffer, sourceFile.dataLength, formatVersion), cookedExtension);
+}
+}
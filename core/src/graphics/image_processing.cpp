@@ -0,0 +1,863 @@
+/*
+ MIT License
+
+ Copyright (c) 2020 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+#include "graphics/image_processing.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <thread>
+#include <vector>
+
+#include "stb_image.h"
+#include "engine/engine.h"
+#include "engine/intrinsincs.h"
+
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+#if defined(__SSSE3__) || defined(__SSE4_2__)
+#define NEKO_IMAGE_SSSE3
+#endif
+
+#if defined(__F16C__) || defined(__AVX2__)
+#define NEKO_IMAGE_F16C
+#endif
+
+#ifdef EASY_PROFILE_USE
+#include "easy/profiler.h"
+#endif
+
+namespace neko
+{
+namespace
+{
+constexpr int kaiserTapCount = 6;
+//Bands smaller than this are not worth a job
+constexpr std::size_t minBandByteSize = 64 * 1024;
+
+/**
+ * \brief Splits [0, count) in bands run by RunParallelTasks
+ */
+template<typename Func>
+void ForEachBand(std::size_t count, std::size_t elementByteSize, Func func)
+{
+    const std::size_t maxBandCount = std::max(1u, std::thread::hardware_concurrency());
+    const std::size_t bandCount = std::min({count * elementByteSize / minBandByteSize, maxBandCount, count});
+    if (bandCount > 1)
+    {
+        RunParallelTasks(bandCount, [bandCount, count, &func](std::size_t band)
+        {
+            func(count * band / bandCount, count * (band + 1) / bandCount);
+        });
+        return;
+    }
+    func(std::size_t(0), count);
+}
+
+struct SrgbTables
+{
+    std::array<float, 256> toLinear{};
+    //thresholds[i] is the linear value where the nearest 8-bit sRGB value goes from i to i + 1
+    std::array<float, 255> thresholds{};
+};
+
+double SrgbToLinear(double value)
+{
+    return value <= 0.04045 ? value / 12.92 : std::pow((value + 0.055) / 1.055, 2.4);
+}
+
+const SrgbTables& GetSrgbTables()
+{
+    static const SrgbTables tables = []
+    {
+        SrgbTables values;
+        for (std::size_t i = 0; i < values.toLinear.size(); i++)
+        {
+            values.toLinear[i] = static_cast<float>(SrgbToLinear(double(i) / 255.0));
+        }
+        for (std::size_t i = 0; i < values.thresholds.size(); i++)
+        {
+            values.thresholds[i] = static_cast<float>(SrgbToLinear((double(i) + 0.5) / 255.0));
+        }
+        return values;
+    }();
+    return tables;
+}
+
+std::uint8_t LinearToSrgb8(const SrgbTables& tables, float value)
+{
+    //Binary search of the thresholds below the value
+    std::size_t result = 0;
+    for (std::size_t step = 128; step > 0; step >>= 1u)
+    {
+        if (result + step <= tables.thresholds.size() && value >= tables.thresholds[result + step - 1])
+        {
+            result += step;
+        }
+    }
+    return static_cast<std::uint8_t>(result);
+}
+
+double BesselI0(double x)
+{
+    double term = 1.0;
+    double result = 1.0;
+    for (int k = 1; k < 32; k++)
+    {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        result += term;
+    }
+    return result;
+}
+
+/**
+ * \brief Weights of the source pixels -2 to +3 around the two pixels of an output pixel
+ */
+const std::array<float, kaiserTapCount>& GetKaiserWeights()
+{
+    static const std::array<float, kaiserTapCount> weights = []
+    {
+        constexpr double pi = 3.14159265358979323846;
+        constexpr double beta = 4.0;
+        constexpr double halfWidth = kaiserTapCount / 2;
+        std::array<double, kaiserTapCount> values{};
+        double sum = 0.0;
+        for (int i = 0; i < kaiserTapCount; i++)
+        {
+            const double distance = i - (kaiserTapCount - 1) / 2.0;
+            //Cut at half the source frequency
+            const double x = pi * distance / 2.0;
+            const double sinc = std::sin(x) / x;
+            const double ratio = distance / halfWidth;
+            values[i] = sinc * BesselI0(beta * std::sqrt(1.0 - ratio * ratio)) / BesselI0(beta);
+            sum += values[i];
+        }
+        std::array<float, kaiserTapCount> result{};
+        for (int i = 0; i < kaiserTapCount; i++)
+        {
+            result[i] = static_cast<float>(values[i] / sum);
+        }
+        return result;
+    }();
+    return weights;
+}
+
+#if defined(NEKO_IMAGE_SSSE3)
+/**
+ * \brief Sums the horizontal pixel pairs of 16 channels, lo holding the first 8
+ */
+__m128i SumPixelPairs(__m128i lo, __m128i hi, int nbChannels)
+{
+    switch (nbChannels)
+    {
+    case 1:
+        return _mm_hadd_epi16(lo, hi);
+    case 2:
+    {
+        const __m128i even = _mm_castps_si128(
+            _mm_shuffle_ps(_mm_castsi128_ps(lo), _mm_castsi128_ps(hi), _MM_SHUFFLE(2, 0, 2, 0)));
+        const __m128i odd = _mm_castps_si128(
+            _mm_shuffle_ps(_mm_castsi128_ps(lo), _mm_castsi128_ps(hi), _MM_SHUFFLE(3, 1, 3, 1)));
+        return _mm_add_epi16(even, odd);
+    }
+    default:
+        return _mm_add_epi16(_mm_unpacklo_epi64(lo, hi), _mm_unpackhi_epi64(lo, hi));
+    }
+}
+
+__m128 SumPixelPairs(__m128 lo, __m128 hi, int nbChannels)
+{
+    switch (nbChannels)
+    {
+    case 1:
+        return _mm_hadd_ps(lo, hi);
+    case 2:
+        return _mm_add_ps(_mm_shuffle_ps(lo, hi, _MM_SHUFFLE(1, 0, 1, 0)), _mm_shuffle_ps(lo, hi, _MM_SHUFFLE(3, 2, 3, 2)));
+    default:
+        return _mm_add_ps(lo, hi);
+    }
+}
+#elif defined(__aarch64__)
+uint16x8_t SumPixelPairs(uint16x8_t lo, uint16x8_t hi, int nbChannels)
+{
+    switch (nbChannels)
+    {
+    case 1:
+        return vpaddq_u16(lo, hi);
+    case 2:
+    {
+        const uint32x4_t lo32 = vreinterpretq_u32_u16(lo);
+        const uint32x4_t hi32 = vreinterpretq_u32_u16(hi);
+        return vaddq_u16(vreinterpretq_u16_u32(vuzp1q_u32(lo32, hi32)), vreinterpretq_u16_u32(vuzp2q_u32(lo32, hi32)));
+    }
+    default:
+    {
+        const uint64x2_t lo64 = vreinterpretq_u64_u16(lo);
+        const uint64x2_t hi64 = vreinterpretq_u64_u16(hi);
+        return vaddq_u16(vreinterpretq_u16_u64(vuzp1q_u64(lo64, hi64)), vreinterpretq_u16_u64(vuzp2q_u64(lo64, hi64)));
+    }
+    }
+}
+
+float32x4_t SumPixelPairs(float32x4_t lo, float32x4_t hi, int nbChannels)
+{
+    switch (nbChannels)
+    {
+    case 1:
+        return vpaddq_f32(lo, hi);
+    case 2:
+    {
+        const uint64x2_t lo64 = vreinterpretq_u64_f32(lo);
+        const uint64x2_t hi64 = vreinterpretq_u64_f32(hi);
+        return vaddq_f32(vreinterpretq_f32_u64(vuzp1q_u64(lo64, hi64)), vreinterpretq_f32_u64(vuzp2q_u64(lo64, hi64)));
+    }
+    default:
+        return vaddq_f32(lo, hi);
+    }
+}
+#endif
+
+/**
+ * \brief 2x2 box filter of one output row, the vector loops take 16 source channels of both rows at once
+ * and skip the 3 channels images that are scalar
+ */
+void DownsampleRowBox(const std::uint8_t* row0, const std::uint8_t* row1, int srcWidth,
+    std::uint8_t* dst, int dstWidth, int nbChannels)
+{
+    const int dstSize = dstWidth * nbChannels;
+    int i = 0;
+    if (srcWidth > 1 && nbChannels != 3)
+    {
+#if defined(NEKO_IMAGE_SSSE3)
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i two = _mm_set1_epi16(2);
+        for (; i + 8 <= dstSize; i += 8)
+        {
+            const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + 2 * i));
+            const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + 2 * i));
+            const __m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+            const __m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+            const __m128i average = _mm_srli_epi16(_mm_add_epi16(SumPixelPairs(lo, hi, nbChannels), two), 2);
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(average, average));
+        }
+#elif defined(__aarch64__)
+        for (; i + 8 <= dstSize; i += 8)
+        {
+            const uint8x16_t a = vld1q_u8(row0 + 2 * i);
+            const uint8x16_t b = vld1q_u8(row1 + 2 * i);
+            const uint16x8_t lo = vaddl_u8(vget_low_u8(a), vget_low_u8(b));
+            const uint16x8_t hi = vaddl_high_u8(a, b);
+            vst1_u8(dst + i, vmovn_u16(vrshrq_n_u16(SumPixelPairs(lo, hi, nbChannels), 2)));
+        }
+#endif
+    }
+    for (; i < dstSize; i++)
+    {
+        const int x = i / nbChannels;
+        const int channel = i % nbChannels;
+        const int x0 = 2 * x * nbChannels + channel;
+        const int x1 = std::min(2 * x + 1, srcWidth - 1) * nbChannels + channel;
+        dst[i] = static_cast<std::uint8_t>((unsigned(row0[x0]) + row0[x1] + row1[x0] + row1[x1] + 2u) >> 2u);
+    }
+}
+
+void DownsampleRowBox(const float* row0, const float* row1, int srcWidth, float* dst, int dstWidth, int nbChannels)
+{
+    const int dstSize = dstWidth * nbChannels;
+    int i = 0;
+    if (srcWidth > 1 && nbChannels != 3)
+    {
+#if defined(NEKO_IMAGE_SSSE3)
+        const __m128 quarter = _mm_set1_ps(0.25f);
+        for (; i + 4 <= dstSize; i += 4)
+        {
+            const __m128 lo = _mm_add_ps(_mm_loadu_ps(row0 + 2 * i), _mm_loadu_ps(row1 + 2 * i));
+            const __m128 hi = _mm_add_ps(_mm_loadu_ps(row0 + 2 * i + 4), _mm_loadu_ps(row1 + 2 * i + 4));
+            _mm_storeu_ps(dst + i, _mm_mul_ps(SumPixelPairs(lo, hi, nbChannels), quarter));
+        }
+#elif defined(__aarch64__)
+        for (; i + 4 <= dstSize; i += 4)
+        {
+            const float32x4_t lo = vaddq_f32(vld1q_f32(row0 + 2 * i), vld1q_f32(row1 + 2 * i));
+            const float32x4_t hi = vaddq_f32(vld1q_f32(row0 + 2 * i + 4), vld1q_f32(row1 + 2 * i + 4));
+            vst1q_f32(dst + i, vmulq_n_f32(SumPixelPairs(lo, hi, nbChannels), 0.25f));
+        }
+#endif
+    }
+    for (; i < dstSize; i++)
+    {
+        const int x = i / nbChannels;
+        const int channel = i % nbChannels;
+        const int x0 = 2 * x * nbChannels + channel;
+        const int x1 = std::min(2 * x + 1, srcWidth - 1) * nbChannels + channel;
+        dst[i] = (row0[x0] + row0[x1] + row1[x0] + row1[x1]) * 0.25f;
+    }
+}
+
+void HorizontalKaiser(const float* src, int srcWidth, float* dst, int dstWidth, int nbChannels)
+{
+    const auto& weights = GetKaiserWeights();
+    for (int x = 0; x < dstWidth; x++)
+    {
+        const int first = 2 * x - kaiserTapCount / 2 + 1;
+        std::array<const float*, kaiserTapCount> pixels{};
+        for (int tap = 0; tap < kaiserTapCount; tap++)
+        {
+            pixels[tap] = src + std::clamp(first + tap, 0, srcWidth - 1) * nbChannels;
+        }
+        for (int channel = 0; channel < nbChannels; channel++)
+        {
+            float sum = 0.0f;
+            for (int tap = 0; tap < kaiserTapCount; tap++)
+            {
+                sum += weights[tap] * pixels[tap][channel];
+            }
+            dst[x * nbChannels + channel] = sum;
+        }
+    }
+}
+
+void VerticalKaiser(const std::array<const float*, kaiserTapCount>& rows, float* dst, std::size_t count)
+{
+    const auto& weights = GetKaiserWeights();
+    std::size_t i = 0;
+#if defined(__AVX__)
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256 sum = _mm256_mul_ps(_mm256_set1_ps(weights[0]), _mm256_loadu_ps(rows[0] + i));
+        for (int tap = 1; tap < kaiserTapCount; tap++)
+        {
+            sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_set1_ps(weights[tap]), _mm256_loadu_ps(rows[tap] + i)));
+        }
+        _mm256_storeu_ps(dst + i, sum);
+    }
+#elif defined(__SSE__)
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 sum = _mm_mul_ps(_mm_set1_ps(weights[0]), _mm_loadu_ps(rows[0] + i));
+        for (int tap = 1; tap < kaiserTapCount; tap++)
+        {
+            sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(weights[tap]), _mm_loadu_ps(rows[tap] + i)));
+        }
+        _mm_storeu_ps(dst + i, sum);
+    }
+#elif defined(__aarch64__)
+    for (; i + 4 <= count; i += 4)
+    {
+        float32x4_t sum = vmulq_n_f32(vld1q_f32(rows[0] + i), weights[0]);
+        for (int tap = 1; tap < kaiserTapCount; tap++)
+        {
+            sum = vfmaq_n_f32(sum, vld1q_f32(rows[tap] + i), weights[tap]);
+        }
+        vst1q_f32(dst + i, sum);
+    }
+#endif
+    for (; i < count; i++)
+    {
+        float sum = 0.0f;
+        for (int tap = 0; tap < kaiserTapCount; tap++)
+        {
+            sum += weights[tap] * rows[tap][i];
+        }
+        dst[i] = sum;
+    }
+}
+
+void ToFloatRow(const std::uint8_t* src, float* dst, int width, int nbChannels, int srgbChannels)
+{
+    const auto& toLinear = GetSrgbTables().toLinear;
+    for (int x = 0; x < width; x++)
+    {
+        for (int channel = 0; channel < nbChannels; channel++)
+        {
+            const std::uint8_t value = src[x * nbChannels + channel];
+            dst[x * nbChannels + channel] = channel < srgbChannels ? toLinear[value] : value * (1.0f / 255.0f);
+        }
+    }
+}
+
+void FromFloatRow(const float* src, std::uint8_t* dst, int width, int nbChannels, int srgbChannels)
+{
+    const auto& tables = GetSrgbTables();
+    for (int x = 0; x < width; x++)
+    {
+        for (int channel = 0; channel < nbChannels; channel++)
+        {
+            const float value = std::clamp(src[x * nbChannels + channel], 0.0f, 1.0f);
+            dst[x * nbChannels + channel] = channel < srgbChannels ?
+                LinearToSrgb8(tables, value) : static_cast<std::uint8_t>(value * 255.0f + 0.5f);
+        }
+    }
+}
+
+struct ImageLevel
+{
+    const unsigned char* src;
+    int srcWidth;
+    int srcHeight;
+    unsigned char* dst;
+    int dstWidth;
+    int nbChannels;
+    bool hdr;
+    int srgbChannels;
+};
+
+void DownsampleRowsBox(const ImageLevel& level, std::size_t beginRow, std::size_t endRow)
+{
+    const std::size_t srcRowSize = std::size_t(level.srcWidth) * level.nbChannels;
+    const std::size_t dstRowSize = std::size_t(level.dstWidth) * level.nbChannels;
+    std::vector<float> floatRows;
+    if (!level.hdr && level.srgbChannels > 0)
+    {
+        floatRows.resize(2 * srcRowSize + dstRowSize);
+    }
+    for (std::size_t y = beginRow; y < endRow; y++)
+    {
+        const std::size_t y0 = std::min<std::size_t>(2 * y, level.srcHeight - 1);
+        const std::size_t y1 = std::min<std::size_t>(2 * y + 1, level.srcHeight - 1);
+        if (level.hdr)
+        {
+            const auto* src = reinterpret_cast<const float*>(level.src);
+            DownsampleRowBox(src + y0 * srcRowSize, src + y1 * srcRowSize, level.srcWidth,
+                reinterpret_cast<float*>(level.dst) + y * dstRowSize, level.dstWidth, level.nbChannels);
+        }
+        else if (level.srgbChannels > 0)
+        {
+            float* row0 = floatRows.data();
+            float* row1 = row0 + srcRowSize;
+            float* dstRow = row1 + srcRowSize;
+            ToFloatRow(level.src + y0 * srcRowSize, row0, level.srcWidth, level.nbChannels, level.srgbChannels);
+            ToFloatRow(level.src + y1 * srcRowSize, row1, level.srcWidth, level.nbChannels, level.srgbChannels);
+            DownsampleRowBox(row0, row1, level.srcWidth, dstRow, level.dstWidth, level.nbChannels);
+            FromFloatRow(dstRow, level.dst + y * dstRowSize, level.dstWidth, level.nbChannels, level.srgbChannels);
+        }
+        else
+        {
+            DownsampleRowBox(level.src + y0 * srcRowSize, level.src + y1 * srcRowSize, level.srcWidth,
+                level.dst + y * dstRowSize, level.dstWidth, level.nbChannels);
+        }
+    }
+}
+
+void DownsampleRowsKaiser(const ImageLevel& level, std::size_t beginRow, std::size_t endRow)
+{
+    const std::size_t srcRowSize = std::size_t(level.srcWidth) * level.nbChannels;
+    const std::size_t dstRowSize = std::size_t(level.dstWidth) * level.nbChannels;
+    //The horizontally filtered rows are cached, consecutive output rows share four of their six rows
+    constexpr int cacheSize = 8;
+    std::vector<float> cache(cacheSize * dstRowSize);
+    std::array<int, cacheSize> cachedRows{};
+    cachedRows.fill(std::numeric_limits<int>::min());
+    std::vector<float> floatRow(level.hdr ? 0 : srcRowSize);
+    std::vector<float> dstRow(level.hdr ? 0 : dstRowSize);
+    const auto getRow = [&](int row) -> const float*
+    {
+        const int slot = row & (cacheSize - 1);
+        float* cachedRow = cache.data() + slot * dstRowSize;
+        if (cachedRows[slot] != row)
+        {
+            cachedRows[slot] = row;
+            const std::size_t srcRow = std::clamp(row, 0, level.srcHeight - 1);
+            const float* src = reinterpret_cast<const float*>(level.src) + srcRow * srcRowSize;
+            if (!level.hdr)
+            {
+                ToFloatRow(level.src + srcRow * srcRowSize, floatRow.data(), level.srcWidth,
+                    level.nbChannels, level.srgbChannels);
+                src = floatRow.data();
+            }
+            HorizontalKaiser(src, level.srcWidth, cachedRow, level.dstWidth, level.nbChannels);
+        }
+        return cachedRow;
+    };
+    for (std::size_t y = beginRow; y < endRow; y++)
+    {
+        const int first = 2 * static_cast<int>(y) - kaiserTapCount / 2 + 1;
+        std::array<const float*, kaiserTapCount> rows{};
+        for (int tap = 0; tap < kaiserTapCount; tap++)
+        {
+            rows[tap] = getRow(first + tap);
+        }
+        if (level.hdr)
+        {
+            float* dst = reinterpret_cast<float*>(level.dst) + y * dstRowSize;
+            VerticalKaiser(rows, dst, dstRowSize);
+            //The negative lobes can ring below zero
+            std::transform(dst, dst + dstRowSize, dst, [](float value) { return std::max(value, 0.0f); });
+        }
+        else
+        {
+            VerticalKaiser(rows, dstRow.data(), dstRowSize);
+            FromFloatRow(dstRow.data(), level.dst + y * dstRowSize, level.dstWidth, level.nbChannels, level.srgbChannels);
+        }
+    }
+}
+
+std::uint16_t FloatToHalf(float value)
+{
+    std::uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    const std::uint32_t sign = (bits >> 16u) & 0x8000u;
+    bits &= 0x7FFFFFFFu;
+    std::uint32_t half;
+    if (bits >= 0x47800000u)
+    {
+        //Infinity or NaN, NaN stays quiet
+        half = bits > 0x7F800000u ? 0x7E00u : 0x7C00u;
+    }
+    else if (bits < 0x38800000u)
+    {
+        //Subnormal or zero, adding 0.5 aligns the 10 mantissa bits with a round to nearest even
+        float aligned;
+        std::memcpy(&aligned, &bits, sizeof(aligned));
+        aligned += 0.5f;
+        std::memcpy(&half, &aligned, sizeof(half));
+        half -= 0x3F000000u;
+    }
+    else
+    {
+        const std::uint32_t mantissaOdd = (bits >> 13u) & 1u;
+        bits += 0xC8000FFFu + mantissaOdd;
+        half = bits >> 13u;
+    }
+    return static_cast<std::uint16_t>(half | sign);
+}
+
+float HalfToFloat(std::uint16_t half)
+{
+    constexpr std::uint32_t shiftedExponent = 0x7C00u << 13u;
+    std::uint32_t bits = (half & 0x7FFFu) << 13u;
+    const std::uint32_t exponent = bits & shiftedExponent;
+    bits += (127u - 15u) << 23u;
+    float value;
+    if (exponent == shiftedExponent)
+    {
+        bits += (128u - 16u) << 23u;
+        std::memcpy(&value, &bits, sizeof(value));
+    }
+    else if (exponent == 0)
+    {
+        //Subnormal, renormalized by the float subtraction
+        bits += 1u << 23u;
+        std::memcpy(&value, &bits, sizeof(value));
+        value -= 6.103515625e-05f;
+    }
+    else
+    {
+        std::memcpy(&value, &bits, sizeof(value));
+    }
+    return (half & 0x8000u) ? -value : value;
+}
+
+/**
+ * \brief Replaces the buffer of the image with a malloc one of byteSize, like stb_image so that Image::Destroy frees it
+ */
+unsigned char* ReallocateImage(Image& image, std::size_t byteSize)
+{
+    auto* data = static_cast<unsigned char*>(std::malloc(byteSize));
+    if (data == nullptr)
+    {
+        logDebug("[Error] Could not allocate image");
+        return nullptr;
+    }
+    std::swap(image.data, data);
+    return data;
+}
+}
+
+int GetMipLevelCount(int width, int height)
+{
+    int levelCount = 1;
+    int size = std::max(width, height);
+    while (size > 1)
+    {
+        size >>= 1;
+        levelCount++;
+    }
+    return levelCount;
+}
+
+void DownsampleImageLevel(const unsigned char* src, int srcWidth, int srcHeight, unsigned char* dst,
+    int nbChannels, bool hdr, bool srgb, MipFilter filter)
+{
+#ifdef EASY_PROFILE_USE
+    EASY_BLOCK("Downsample Image Level");
+#endif
+    const ImageLevel level{src, srcWidth, srcHeight, dst, std::max(1, srcWidth / 2), nbChannels, hdr,
+        srgb && !hdr && nbChannels >= 3 ? 3 : 0};
+    const std::size_t dstHeight = std::max(1, srcHeight / 2);
+    const std::size_t rowByteSize = std::size_t(srcWidth) * nbChannels * (hdr ? sizeof(float) : 1) * 2;
+    ForEachBand(dstHeight, rowByteSize, [&level, filter](std::size_t beginRow, std::size_t endRow)
+    {
+        if (filter == MipFilter::KAISER)
+        {
+            DownsampleRowsKaiser(level, beginRow, endRow);
+        }
+        else
+        {
+            DownsampleRowsBox(level, beginRow, endRow);
+        }
+    });
+}
+
+void GenerateMipChain(Image& image, bool srgb, MipFilter filter)
+{
+#ifdef EASY_PROFILE_USE
+    EASY_BLOCK("Generate Mip Chain");
+#endif
+    if (image.data == nullptr || image.mipLevels > 1)
+    {
+        return;
+    }
+    const std::size_t levelSize = image.GetLevelByteSize(0);
+    image.mipLevels = GetMipLevelCount(image.width, image.height);
+    if (image.mipLevels == 1)
+    {
+        return;
+    }
+    auto* levelData = ReallocateImage(image, image.GetByteSize());
+    if (levelData == nullptr)
+    {
+        image.mipLevels = 1;
+        return;
+    }
+    std::memcpy(image.data, levelData, levelSize);
+    stbi_image_free(levelData);
+    for (int level = 1; level < image.mipLevels; level++)
+    {
+        DownsampleImageLevel(image.data + image.GetLevelOffset(level - 1),
+            image.GetLevelWidth(level - 1), image.GetLevelHeight(level - 1),
+            image.data + image.GetLevelOffset(level), image.nbChannels, image.hdr, srgb, filter);
+    }
+}
+
+void ExpandRgbToRgba(Image& image)
+{
+#ifdef EASY_PROFILE_USE
+    EASY_BLOCK("Expand RGB to RGBA");
+#endif
+    if (image.data == nullptr || image.nbChannels != 3)
+    {
+        return;
+    }
+    const std::size_t pixelCount = image.GetByteSize() / (3 * (image.hdr ? sizeof(float) : 1));
+    image.nbChannels = 4;
+    auto* rgbData = ReallocateImage(image, image.GetByteSize());
+    if (rgbData == nullptr)
+    {
+        image.nbChannels = 3;
+        return;
+    }
+    const unsigned char* src = rgbData;
+    unsigned char* dst = image.data;
+    const bool hdr = image.hdr;
+    ForEachBand(pixelCount, 4 * (hdr ? sizeof(float) : 1), [src, dst, pixelCount, hdr](std::size_t begin, std::size_t end)
+    {
+        if (hdr)
+        {
+            const auto* rgb = reinterpret_cast<const float*>(src);
+            auto* rgba = reinterpret_cast<float*>(dst);
+            for (std::size_t i = begin; i < end; i++)
+            {
+                rgba[4 * i] = rgb[3 * i];
+                rgba[4 * i + 1] = rgb[3 * i + 1];
+                rgba[4 * i + 2] = rgb[3 * i + 2];
+                rgba[4 * i + 3] = 1.0f;
+            }
+            return;
+        }
+        std::size_t i = begin;
+#if defined(NEKO_IMAGE_SSSE3)
+        const __m128i shuffle = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+        const __m128i alpha = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+        //The 16 bytes load reads two pixels past the four converted ones
+        for (; i + 4 <= end && i + 6 <= pixelCount; i += 4)
+        {
+            const __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 3 * i));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 4 * i),
+                _mm_or_si128(_mm_shuffle_epi8(pixels, shuffle), alpha));
+        }
+#elif defined(__aarch64__)
+        for (; i + 8 <= end; i += 8)
+        {
+            const uint8x8x3_t rgb = vld3_u8(src + 3 * i);
+            const uint8x8x4_t rgba = {{rgb.val[0], rgb.val[1], rgb.val[2], vdup_n_u8(255)}};
+            vst4_u8(dst + 4 * i, rgba);
+        }
+#endif
+        for (; i < end; i++)
+        {
+            dst[4 * i] = src[3 * i];
+            dst[4 * i + 1] = src[3 * i + 1];
+            dst[4 * i + 2] = src[3 * i + 2];
+            dst[4 * i + 3] = 255;
+        }
+    });
+    stbi_image_free(rgbData);
+}
+
+void PremultiplyAlpha(Image& image, bool srgb)
+{
+#ifdef EASY_PROFILE_USE
+    EASY_BLOCK("Premultiply Alpha");
+#endif
+    if (image.data == nullptr || image.nbChannels != 4)
+    {
+        return;
+    }
+    const std::size_t pixelCount = image.GetByteSize() / (4 * (image.hdr ? sizeof(float) : 1));
+    unsigned char* data = image.data;
+    const bool hdr = image.hdr;
+    srgb = srgb && !hdr;
+    ForEachBand(pixelCount, 4 * (hdr ? sizeof(float) : 1), [data, hdr, srgb](std::size_t begin, std::size_t end)
+    {
+        if (hdr)
+        {
+            auto* pixels = reinterpret_cast<float*>(data);
+            for (std::size_t i = begin; i < end; i++)
+            {
+                const float alpha = pixels[4 * i + 3];
+                pixels[4 * i] *= alpha;
+                pixels[4 * i + 1] *= alpha;
+                pixels[4 * i + 2] *= alpha;
+            }
+            return;
+        }
+        if (srgb)
+        {
+            const auto& tables = GetSrgbTables();
+            for (std::size_t i = begin; i < end; i++)
+            {
+                const float alpha = data[4 * i + 3] * (1.0f / 255.0f);
+                for (std::size_t channel = 0; channel < 3; channel++)
+                {
+                    auto& value = data[4 * i + channel];
+                    value = LinearToSrgb8(tables, tables.toLinear[value] * alpha);
+                }
+            }
+            return;
+        }
+        std::size_t i = begin;
+#if defined(NEKO_IMAGE_SSSE3)
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i half = _mm_set1_epi16(128);
+        const __m128i alphaLo = _mm_setr_epi8(3, -1, 3, -1, 3, -1, 3, -1, 7, -1, 7, -1, 7, -1, 7, -1);
+        const __m128i alphaHi = _mm_setr_epi8(11, -1, 11, -1, 11, -1, 11, -1, 15, -1, 15, -1, 15, -1, 15, -1);
+        const __m128i alphaMask = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+        for (; i + 4 <= end; i += 4)
+        {
+            auto* pixelsPtr = reinterpret_cast<__m128i*>(data + 4 * i);
+            const __m128i pixels = _mm_loadu_si128(pixelsPtr);
+            //Rounded division by 255: (x + 128 + ((x + 128) >> 8)) >> 8
+            __m128i lo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(pixels, zero), _mm_shuffle_epi8(pixels, alphaLo)), half);
+            __m128i hi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(pixels, zero), _mm_shuffle_epi8(pixels, alphaHi)), half);
+            lo = _mm_srli_epi16(_mm_add_epi16(lo, _mm_srli_epi16(lo, 8)), 8);
+            hi = _mm_srli_epi16(_mm_add_epi16(hi, _mm_srli_epi16(hi, 8)), 8);
+            const __m128i colors = _mm_andnot_si128(alphaMask, _mm_packus_epi16(lo, hi));
+            _mm_storeu_si128(pixelsPtr, _mm_or_si128(colors, _mm_and_si128(pixels, alphaMask)));
+        }
+#elif defined(__aarch64__)
+        for (; i + 8 <= end; i += 8)
+        {
+            uint8x8x4_t pixels = vld4_u8(data + 4 * i);
+            for (int channel = 0; channel < 3; channel++)
+            {
+                const uint16x8_t product = vmull_u8(pixels.val[channel], pixels.val[3]);
+                pixels.val[channel] = vraddhn_u16(product, vrshrq_n_u16(product, 8));
+            }
+            vst4_u8(data + 4 * i, pixels);
+        }
+#endif
+        for (; i < end; i++)
+        {
+            const unsigned alpha = data[4 * i + 3];
+            for (std::size_t channel = 0; channel < 3; channel++)
+            {
+                const unsigned value = data[4 * i + channel] * alpha + 128u;
+                data[4 * i + channel] = static_cast<std::uint8_t>((value + (value >> 8u)) >> 8u);
+            }
+        }
+    });
+}
+
+void ConvertFloatToHalf(const float* src, std::uint16_t* dst, std::size_t count)
+{
+    ForEachBand(count, sizeof(float), [src, dst](std::size_t begin, std::size_t end)
+    {
+        std::size_t i = begin;
+#if defined(NEKO_IMAGE_F16C)
+        for (; i + 8 <= end; i += 8)
+        {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i),
+                _mm256_cvtps_ph(_mm256_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT));
+        }
+#elif defined(__aarch64__)
+        for (; i + 4 <= end; i += 4)
+        {
+            vst1_u16(dst + i, vreinterpret_u16_f16(vcvt_f16_f32(vld1q_f32(src + i))));
+        }
+#endif
+        for (; i < end; i++)
+        {
+            dst[i] = FloatToHalf(src[i]);
+        }
+    });
+}
+
+void ConvertHalfToFloat(const std::uint16_t* src, float* dst, std::size_t count)
+{
+    ForEachBand(count, sizeof(float), [src, dst](std::size_t begin, std::size_t end)
+    {
+        std::size_t i = begin;
+#if defined(NEKO_IMAGE_F16C)
+        for (; i + 8 <= end; i += 8)
+        {
+            _mm256_storeu_ps(dst + i, _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i))));
+        }
+#elif defined(__aarch64__)
+        for (; i + 4 <= end; i += 4)
+        {
+            vst1q_f32(dst + i, vcvt_f32_f16(vreinterpret_f16_u16(vld1_u16(src + i))));
+        }
+#endif
+        for (; i < end; i++)
+        {
+            dst[i] = HalfToFloat(src[i]);
+        }
+    });
+}
+
+float Srgb8ToLinear(std::uint8_t value)
+{
+    return GetSrgbTables().toLinear[value];
+}
+
+std::uint8_t LinearToSrgb8(float value)
+{
+    return LinearToSrgb8(GetSrgbTables(), std::clamp(value, 0.0f, 1.0f));
+}
+}
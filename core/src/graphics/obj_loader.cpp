@@ -22,5 +22,830 @@
  SOFTWARE.
  */
 
-#define TINYOBJLOADER_IMPLEMENTATION
-#include "tiny_obj_loader.h"
+#include "graphics/obj_loader.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <thread>
+#include <unordered_map>
+#include <fmt/format.h>
+#include "engine/engine.h"
+#include "engine/log.h"
+#include "utilities/file_utility.h"
+
+#ifdef EASY_PROFILE_USE
+#include "easy/profiler.h"
+#endif
+
+namespace neko
+{
+namespace
+{
+//Smaller obj files are parsed in one chunk
+constexpr std::size_t minChunkSize = 256 * 1024;
+constexpr std::int32_t missingObjIndex = std::numeric_limits<std::int32_t>::min();
+constexpr std::uint32_t missingIndex = std::numeric_limits<std::uint32_t>::max();
+
+/**
+ * \brief Face corner as written in the chunk. The positive obj indices are already global, the negative ones
+ * are relative to the chunk until the vertex counts of the previous chunks are known.
+ */
+struct ObjCorner
+{
+    enum RelativeMask : std::uint8_t
+    {
+        POSITION = 1u << 0u,
+        TEX_COORD = 1u << 1u,
+        NORMAL = 1u << 2u
+    };
+    std::array<std::int32_t, 3> indices{missingObjIndex, missingObjIndex, missingObjIndex};
+    std::uint8_t relativeMask = 0;
+};
+
+struct ObjEvent
+{
+    //The event applies from this face of the chunk
+    std::uint32_t faceIndex = 0;
+    bool isMaterial = false;
+    std::string name;
+};
+
+struct ObjChunk
+{
+    std::vector<Vec3f> positions;
+    std::vector<Vec2f> texCoords;
+    std::vector<Vec3f> normals;
+    std::vector<ObjCorner> corners;
+    //End corner of each face
+    std::vector<std::uint32_t> faceEnds;
+    std::vector<ObjEvent> events;
+    std::vector<std::string> mtlLibraries;
+};
+
+struct ObjFaceRange
+{
+    std::uint32_t chunk = 0;
+    std::uint32_t faceBegin = 0;
+    std::uint32_t faceEnd = 0;
+};
+
+struct ObjMeshRanges
+{
+    std::vector<ObjFaceRange> ranges;
+    std::size_t cornerCount = 0;
+};
+
+bool IsBlank(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+const char* SkipBlanks(const char* it, const char* end)
+{
+    while (it < end && IsBlank(*it))
+    {
+        it++;
+    }
+    return it;
+}
+
+std::string_view TrimmedRest(const char* it, const char* end)
+{
+    it = SkipBlanks(it, end);
+    while (end > it && IsBlank(end[-1]))
+    {
+        end--;
+    }
+    return std::string_view(it, end - it);
+}
+
+bool IsKeyword(const char* it, const char* end, std::string_view keyword)
+{
+    const auto length = static_cast<std::size_t>(end - it);
+    return length > keyword.size() && std::memcmp(it, keyword.data(), keyword.size()) == 0 &&
+        IsBlank(it[keyword.size()]);
+}
+
+/**
+ * \brief Decimal float without locale or strtof, the digits past the 19th only scale the exponent.
+ * Returns it unchanged when there is no number.
+ */
+const char* ParseFloat(const char* it, const char* end, float& value)
+{
+    static constexpr std::array<double, 23> powersOf10 =
+    {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+    constexpr std::uint64_t maxMantissa = 1'000'000'000'000'000'000u;
+    const char* start = it = SkipBlanks(it, end);
+    bool isNegative = false;
+    if (it < end && (*it == '-' || *it == '+'))
+    {
+        isNegative = *it == '-';
+        it++;
+    }
+    std::uint64_t mantissa = 0;
+    int exponent = 0;
+    bool hasDigits = false;
+    for (; it < end && unsigned(*it - '0') < 10u; it++)
+    {
+        hasDigits = true;
+        if (mantissa < maxMantissa)
+        {
+            mantissa = mantissa * 10 + unsigned(*it - '0');
+        }
+        else
+        {
+            exponent++;
+        }
+    }
+    if (it < end && *it == '.')
+    {
+        for (it++; it < end && unsigned(*it - '0') < 10u; it++)
+        {
+            hasDigits = true;
+            if (mantissa < maxMantissa)
+            {
+                mantissa = mantissa * 10 + unsigned(*it - '0');
+                exponent--;
+            }
+        }
+    }
+    if (!hasDigits)
+    {
+        return start;
+    }
+    if (it < end && (*it == 'e' || *it == 'E'))
+    {
+        const char* exponentIt = it + 1;
+        bool isExponentNegative = false;
+        if (exponentIt < end && (*exponentIt == '-' || *exponentIt == '+'))
+        {
+            isExponentNegative = *exponentIt == '-';
+            exponentIt++;
+        }
+        int explicitExponent = 0;
+        bool hasExponentDigits = false;
+        for (; exponentIt < end && unsigned(*exponentIt - '0') < 10u; exponentIt++)
+        {
+            hasExponentDigits = true;
+            explicitExponent = std::min(explicitExponent * 10 + (*exponentIt - '0'), 1000);
+        }
+        if (hasExponentDigits)
+        {
+            exponent += isExponentNegative ? -explicitExponent : explicitExponent;
+            it = exponentIt;
+        }
+    }
+    auto result = static_cast<double>(mantissa);
+    if (exponent < 0)
+    {
+        result = -exponent < int(powersOf10.size()) ? result / powersOf10[-exponent] : result * std::pow(10.0, exponent);
+    }
+    else if (exponent > 0)
+    {
+        result = exponent < int(powersOf10.size()) ? result * powersOf10[exponent] : result * std::pow(10.0, exponent);
+    }
+    value = static_cast<float>(isNegative ? -result : result);
+    return it;
+}
+
+const char* ParseInt(const char* it, const char* end, std::int32_t& value)
+{
+    const char* start = it;
+    bool isNegative = false;
+    if (it < end && (*it == '-' || *it == '+'))
+    {
+        isNegative = *it == '-';
+        it++;
+    }
+    std::int64_t result = 0;
+    const char* digits = it;
+    for (; it < end && unsigned(*it - '0') < 10u; it++)
+    {
+        result = std::min<std::int64_t>(result * 10 + (*it - '0'), std::numeric_limits<std::int32_t>::max());
+    }
+    if (it == digits)
+    {
+        return start;
+    }
+    value = static_cast<std::int32_t>(isNegative ? -result : result);
+    return it;
+}
+
+/**
+ * \brief Obj indices start at 1, the negative ones count back from the last vertex of the chunk
+ */
+void SetCornerIndex(ObjCorner& corner, int attribute, std::int32_t objIndex, std::size_t chunkCount)
+{
+    if (objIndex > 0)
+    {
+        corner.indices[attribute] = objIndex - 1;
+    }
+    else if (objIndex < 0)
+    {
+        corner.indices[attribute] = static_cast<std::int32_t>(chunkCount) + objIndex;
+        corner.relativeMask |= std::uint8_t(1u << unsigned(attribute));
+    }
+}
+
+void ParseFace(const char* it, const char* end, ObjChunk& chunk)
+{
+    const auto firstCorner = chunk.corners.size();
+    while (true)
+    {
+        it = SkipBlanks(it, end);
+        if (it >= end || *it == '#')
+        {
+            break;
+        }
+        ObjCorner corner;
+        std::int32_t objIndex = 0;
+        const char* next = ParseInt(it, end, objIndex);
+        if (next == it)
+        {
+            break;
+        }
+        SetCornerIndex(corner, 0, objIndex, chunk.positions.size());
+        it = next;
+        if (it < end && *it == '/')
+        {
+            it++;
+            objIndex = 0;
+            it = ParseInt(it, end, objIndex);
+            SetCornerIndex(corner, 1, objIndex, chunk.texCoords.size());
+            if (it < end && *it == '/')
+            {
+                it++;
+                objIndex = 0;
+                it = ParseInt(it, end, objIndex);
+                SetCornerIndex(corner, 2, objIndex, chunk.normals.size());
+            }
+        }
+        chunk.corners.push_back(corner);
+    }
+    //Lines and points are not meshes
+    if (chunk.corners.size() - firstCorner < 3)
+    {
+        chunk.corners.resize(firstCorner);
+        return;
+    }
+    chunk.faceEnds.push_back(static_cast<std::uint32_t>(chunk.corners.size()));
+}
+
+void ParseLine(const char* it, const char* end, ObjChunk& chunk)
+{
+    it = SkipBlanks(it, end);
+    if (end - it < 2)
+    {
+        return;
+    }
+    const char* values = it + 2;
+    switch (*it)
+    {
+        case 'v':
+        {
+            if (IsBlank(it[1]))
+            {
+                Vec3f position;
+                values = ParseFloat(values, end, position.x);
+                values = ParseFloat(values, end, position.y);
+                ParseFloat(values, end, position.z);
+                chunk.positions.push_back(position);
+            }
+            else if (IsKeyword(it, end, "vt"))
+            {
+                Vec2f texCoords;
+                values = ParseFloat(values + 1, end, texCoords.x);
+                ParseFloat(values, end, texCoords.y);
+                chunk.texCoords.push_back(texCoords);
+            }
+            else if (IsKeyword(it, end, "vn"))
+            {
+                Vec3f normal;
+                values = ParseFloat(values + 1, end, normal.x);
+                values = ParseFloat(values, end, normal.y);
+                ParseFloat(values, end, normal.z);
+                chunk.normals.push_back(normal);
+            }
+            break;
+        }
+        case 'f':
+        {
+            if (IsBlank(it[1]))
+            {
+                ParseFace(values, end, chunk);
+            }
+            break;
+        }
+        case 'o':
+        case 'g':
+        {
+            if (IsBlank(it[1]))
+            {
+                chunk.events.push_back({static_cast<std::uint32_t>(chunk.faceEnds.size()), false,
+                    std::string(TrimmedRest(values, end))});
+            }
+            break;
+        }
+        case 'u':
+        {
+            if (IsKeyword(it, end, "usemtl"))
+            {
+                chunk.events.push_back({static_cast<std::uint32_t>(chunk.faceEnds.size()), true,
+                    std::string(TrimmedRest(it + 6, end))});
+            }
+            break;
+        }
+        case 'm':
+        {
+            if (IsKeyword(it, end, "mtllib"))
+            {
+                chunk.mtlLibraries.emplace_back(TrimmedRest(it + 6, end));
+            }
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+void ParseChunk(const char* it, const char* end, ObjChunk& chunk)
+{
+#ifdef EASY_PROFILE_USE
+    EASY_BLOCK("Parse Obj Chunk");
+#endif
+    while (it < end)
+    {
+        const auto* lineEnd = static_cast<const char*>(std::memchr(it, '\n', end - it));
+        if (lineEnd == nullptr)
+        {
+            lineEnd = end;
+        }
+        ParseLine(it, lineEnd, chunk);
+        it = lineEnd + 1;
+    }
+}
+
+struct ObjAttributes
+{
+    std::vector<Vec3f> positions;
+    std::vector<Vec2f> texCoords;
+    std::vector<Vec3f> normals;
+    //Vertex counts of the chunks before each chunk
+    std::vector<std::array<std::size_t, 3>> chunkBases;
+};
+
+/**
+ * \brief Resolves the corner to 0-based global indices, false when the position is missing or out of range
+ */
+bool ResolveCorner(const ObjCorner& objCorner, const std::array<std::size_t, 3>& chunkBase,
+    const std::array<std::size_t, 3>& counts, std::array<std::uint32_t, 3>& corner)
+{
+    for (int attribute = 0; attribute < 3; attribute++)
+    {
+        const auto objIndex = objCorner.indices[attribute];
+        corner[attribute] = missingIndex;
+        if (objIndex == missingObjIndex)
+        {
+            continue;
+        }
+        const std::int64_t index = objCorner.relativeMask & (1u << unsigned(attribute)) ?
+            std::int64_t(chunkBase[attribute]) + objIndex : objIndex;
+        if (index >= 0 && std::size_t(index) < counts[attribute])
+        {
+            corner[attribute] = static_cast<std::uint32_t>(index);
+        }
+    }
+    return corner[0] != missingIndex;
+}
+
+void GenerateNormalsAndTangents(ObjMesh& mesh, const std::vector<bool>& needsNormal, bool hasTexCoords)
+{
+    auto& vertices = mesh.vertices;
+    const bool hasMissingNormals = std::find(needsNormal.begin(), needsNormal.end(), true) != needsNormal.end();
+    std::vector<Vec3f> tangents;
+    std::vector<Vec3f> bitangents;
+    if (hasTexCoords)
+    {
+        tangents.resize(vertices.size(), Vec3f::zero);
+        bitangents.resize(vertices.size(), Vec3f::zero);
+    }
+    if (!hasMissingNormals && !hasTexCoords)
+    {
+        return;
+    }
+    for (std::size_t i = 0; i + 2 < mesh.indices.size(); i += 3)
+    {
+        const std::array<std::uint32_t, 3> triangle = {mesh.indices[i], mesh.indices[i + 1], mesh.indices[i + 2]};
+        const auto& v0 = vertices[triangle[0]];
+        const Vec3f edge1 = vertices[triangle[1]].position - v0.position;
+        const Vec3f edge2 = vertices[triangle[2]].position - v0.position;
+        if (hasMissingNormals)
+        {
+            //Area weighted, the cross product is normalized with the sum
+            const Vec3f faceNormal = Vec3f::Cross(edge1, edge2);
+            for (const auto vertex : triangle)
+            {
+                if (needsNormal[vertex])
+                {
+                    vertices[vertex].normal += faceNormal;
+                }
+            }
+        }
+        if (hasTexCoords)
+        {
+            const Vec2f deltaUv1 = vertices[triangle[1]].texCoords - v0.texCoords;
+            const Vec2f deltaUv2 = vertices[triangle[2]].texCoords - v0.texCoords;
+            const float determinant = deltaUv1.x * deltaUv2.y - deltaUv2.x * deltaUv1.y;
+            if (std::abs(determinant) < std::numeric_limits<float>::epsilon())
+            {
+                continue;
+            }
+            const float inverse = 1.0f / determinant;
+            const Vec3f tangent = (edge1 * deltaUv2.y - edge2 * deltaUv1.y) * inverse;
+            const Vec3f bitangent = (edge2 * deltaUv1.x - edge1 * deltaUv2.x) * inverse;
+            for (const auto vertex : triangle)
+            {
+                tangents[vertex] += tangent;
+                bitangents[vertex] += bitangent;
+            }
+        }
+    }
+    for (std::size_t i = 0; i < vertices.size(); i++)
+    {
+        auto& vertex = vertices[i];
+        if (needsNormal[i] && vertex.normal.SquareMagnitude() > 0.0f)
+        {
+            vertex.normal = vertex.normal.Normalized();
+        }
+        if (!hasTexCoords)
+        {
+            continue;
+        }
+        //Gram-Schmidt against the normal
+        const Vec3f tangent = tangents[i] - vertex.normal * Vec3f::Dot(vertex.normal, tangents[i]);
+        const Vec3f bitangent = bitangents[i] - vertex.normal * Vec3f::Dot(vertex.normal, bitangents[i]);
+        vertex.tangent = tangent.SquareMagnitude() > 0.0f ? tangent.Normalized() : Vec3f::zero;
+        vertex.bitangent = bitangent.SquareMagnitude() > 0.0f ? bitangent.Normalized() : Vec3f::zero;
+    }
+}
+
+void BuildMesh(const std::vector<ObjChunk>& chunks, const ObjAttributes& attributes,
+    const ObjMeshRanges& meshRanges, bool flipUVs, ObjMesh& mesh)
+{
+#ifdef EASY_PROFILE_USE
+    EASY_BLOCK("Build Obj Mesh");
+#endif
+    const std::array<std::size_t, 3> counts =
+        {attributes.positions.size(), attributes.texCoords.size(), attributes.normals.size()};
+    //Resolved corners of the valid polygons, with the used position range
+    std::vector<std::array<std::uint32_t, 3>> corners;
+    std::vector<std::uint32_t> polygonSizes;
+    corners.reserve(meshRanges.cornerCount);
+    std::uint32_t minPosition = std::numeric_limits<std::uint32_t>::max();
+    std::uint32_t maxPosition = 0;
+    for (const auto& range : meshRanges.ranges)
+    {
+        const auto& chunk = chunks[range.chunk];
+        const auto& chunkBase = attributes.chunkBases[range.chunk];
+        for (auto face = range.faceBegin; face < range.faceEnd; face++)
+        {
+            const std::uint32_t cornerBegin = face == 0 ? 0 : chunk.faceEnds[face - 1];
+            const std::uint32_t cornerEnd = chunk.faceEnds[face];
+            const auto polygonBegin = corners.size();
+            corners.resize(polygonBegin + cornerEnd - cornerBegin);
+            bool isValid = true;
+            for (auto corner = cornerBegin; corner < cornerEnd && isValid; corner++)
+            {
+                auto& resolvedCorner = corners[polygonBegin + corner - cornerBegin];
+                isValid = ResolveCorner(chunk.corners[corner], chunkBase, counts, resolvedCorner);
+                if (isValid)
+                {
+                    minPosition = std::min(minPosition, resolvedCorner[0]);
+                    maxPosition = std::max(maxPosition, resolvedCorner[0]);
+                }
+            }
+            if (!isValid)
+            {
+                corners.resize(polygonBegin);
+                continue;
+            }
+            polygonSizes.push_back(cornerEnd - cornerBegin);
+        }
+    }
+    if (corners.empty())
+    {
+        return;
+    }
+
+    //The identical corners share a vertex, the vertices of a position are chained from its bucket
+    std::vector<std::uint32_t> positionVertices(maxPosition - minPosition + 1, missingIndex);
+    std::vector<std::uint32_t> nextVertices;
+    std::vector<std::array<std::uint32_t, 3>> vertexCorners;
+    std::vector<bool> needsNormal;
+    nextVertices.reserve(positionVertices.size());
+    vertexCorners.reserve(positionVertices.size());
+    mesh.vertices.reserve(positionVertices.size());
+    mesh.indices.reserve(corners.size() * 3);
+    bool hasTexCoords = false;
+    std::size_t polygonBegin = 0;
+    for (const auto polygonSize : polygonSizes)
+    {
+        for (std::size_t i = polygonBegin; i < polygonBegin + polygonSize; i++)
+        {
+            auto& corner = corners[i];
+            auto& bucket = positionVertices[corner[0] - minPosition];
+            auto vertex = bucket;
+            while (vertex != missingIndex && vertexCorners[vertex] != corner)
+            {
+                vertex = nextVertices[vertex];
+            }
+            if (vertex == missingIndex)
+            {
+                vertex = static_cast<std::uint32_t>(mesh.vertices.size());
+                MeshVertex meshVertex{};
+                meshVertex.position = attributes.positions[corner[0]];
+                if (corner[1] != missingIndex)
+                {
+                    meshVertex.texCoords = attributes.texCoords[corner[1]];
+                    if (flipUVs)
+                    {
+                        meshVertex.texCoords.y = 1.0f - meshVertex.texCoords.y;
+                    }
+                    hasTexCoords = true;
+                }
+                if (corner[2] != missingIndex)
+                {
+                    meshVertex.normal = attributes.normals[corner[2]];
+                }
+                mesh.vertices.push_back(meshVertex);
+                needsNormal.push_back(corner[2] == missingIndex);
+                vertexCorners.push_back(corner);
+                nextVertices.push_back(bucket);
+                bucket = vertex;
+            }
+            corner[0] = vertex;
+        }
+        //Polygons are fanned from their first corner, like aiProcess_Triangulate does for convex ones
+        for (std::size_t i = polygonBegin + 1; i + 1 < polygonBegin + polygonSize; i++)
+        {
+            mesh.indices.push_back(corners[polygonBegin][0]);
+            mesh.indices.push_back(corners[i][0]);
+            mesh.indices.push_back(corners[i + 1][0]);
+        }
+        polygonBegin += polygonSize;
+    }
+    GenerateNormalsAndTangents(mesh, needsNormal, hasTexCoords);
+    mesh.aabbMin = mesh.aabbMax = Vec3f::zero;
+    if (!mesh.vertices.empty())
+    {
+        mesh.aabbMin = mesh.aabbMax = mesh.vertices.front().position;
+        for (const auto& vertex : mesh.vertices)
+        {
+            const auto& p = vertex.position;
+            mesh.aabbMin = Vec3f(std::min(mesh.aabbMin.x, p.x), std::min(mesh.aabbMin.y, p.y), std::min(mesh.aabbMin.z, p.z));
+            mesh.aabbMax = Vec3f(std::max(mesh.aabbMax.x, p.x), std::max(mesh.aabbMax.y, p.y), std::max(mesh.aabbMax.z, p.z));
+        }
+    }
+}
+}
+
+bool ParseObj(std::string_view objText, ObjModel& model, std::vector<std::string>& mtlLibraries, bool flipUVs)
+{
+#ifdef EASY_PROFILE_USE
+    EASY_BLOCK("Parse Obj");
+#endif
+    //Line-aligned chunks, each one parsed on its own
+    const std::size_t maxChunkCount = std::max(1u, std::thread::hardware_concurrency()) * 4;
+    const std::size_t chunkCount = std::clamp<std::size_t>(objText.size() / minChunkSize, 1, maxChunkCount);
+    std::vector<const char*> chunkStarts;
+    chunkStarts.reserve(chunkCount + 1);
+    const char* begin = objText.data();
+    const char* end = begin + objText.size();
+    chunkStarts.push_back(begin);
+    for (std::size_t i = 1; i < chunkCount; i++)
+    {
+        const char* split = std::max(begin + objText.size() * i / chunkCount, chunkStarts.back());
+        const auto* lineEnd = static_cast<const char*>(std::memchr(split, '\n', end - split));
+        chunkStarts.push_back(lineEnd == nullptr ? end : lineEnd + 1);
+    }
+    chunkStarts.push_back(end);
+    std::vector<ObjChunk> chunks(chunkCount);
+    RunParallelTasks(chunkCount, [&chunkStarts, &chunks](std::size_t chunk)
+    {
+        ParseChunk(chunkStarts[chunk], chunkStarts[chunk + 1], chunks[chunk]);
+    });
+
+    ObjAttributes attributes;
+    attributes.chunkBases.resize(chunkCount);
+    std::array<std::size_t, 3> totals{};
+    for (std::size_t i = 0; i < chunkCount; i++)
+    {
+        attributes.chunkBases[i] = totals;
+        totals[0] += chunks[i].positions.size();
+        totals[1] += chunks[i].texCoords.size();
+        totals[2] += chunks[i].normals.size();
+    }
+    attributes.positions.resize(totals[0]);
+    attributes.texCoords.resize(totals[1]);
+    attributes.normals.resize(totals[2]);
+    RunParallelTasks(chunkCount, [&chunks, &attributes](std::size_t i)
+    {
+        const auto& chunk = chunks[i];
+        const auto& base = attributes.chunkBases[i];
+        std::copy(chunk.positions.begin(), chunk.positions.end(), attributes.positions.begin() + base[0]);
+        std::copy(chunk.texCoords.begin(), chunk.texCoords.end(), attributes.texCoords.begin() + base[1]);
+        std::copy(chunk.normals.begin(), chunk.normals.end(), attributes.normals.begin() + base[2]);
+    });
+
+    //A new mesh starts at each object, group or material change, like the assimp obj importer
+    model.meshes.clear();
+    model.materials.clear();
+    model.materials.emplace_back().name = "DefaultMaterial";
+    std::unordered_map<std::string, std::uint32_t> materialIndices;
+    std::vector<ObjMeshRanges> meshRanges(1);
+    model.meshes.emplace_back();
+    const auto startMesh = [&model, &meshRanges]()
+    {
+        if (meshRanges.back().ranges.empty())
+        {
+            return;
+        }
+        const auto& previous = model.meshes.back();
+        ObjMesh mesh;
+        mesh.name = previous.name;
+        mesh.materialIndex = previous.materialIndex;
+        model.meshes.push_back(std::move(mesh));
+        meshRanges.emplace_back();
+    };
+    const auto addFaces = [&meshRanges, &chunks](std::uint32_t chunk, std::uint32_t faceBegin, std::uint32_t faceEnd)
+    {
+        if (faceBegin >= faceEnd)
+        {
+            return;
+        }
+        const auto& faceEnds = chunks[chunk].faceEnds;
+        auto& current = meshRanges.back();
+        current.ranges.push_back({chunk, faceBegin, faceEnd});
+        current.cornerCount += faceEnds[faceEnd - 1] - (faceBegin == 0 ? 0 : faceEnds[faceBegin - 1]);
+    };
+    for (std::uint32_t i = 0; i < chunkCount; i++)
+    {
+        auto& chunk = chunks[i];
+        std::uint32_t faceBegin = 0;
+        for (auto& event : chunk.events)
+        {
+            addFaces(i, faceBegin, event.faceIndex);
+            faceBegin = event.faceIndex;
+            if (event.isMaterial)
+            {
+                const auto it = materialIndices.find(event.name);
+                std::uint32_t materialIndex;
+                if (it == materialIndices.end())
+                {
+                    materialIndex = static_cast<std::uint32_t>(model.materials.size());
+                    materialIndices.emplace(event.name, materialIndex);
+                    model.materials.emplace_back().name = event.name;
+                }
+                else
+                {
+                    materialIndex = it->second;
+                }
+                if (materialIndex != model.meshes.back().materialIndex)
+                {
+                    startMesh();
+                    model.meshes.back().materialIndex = materialIndex;
+                }
+            }
+            else if (event.name != model.meshes.back().name)
+            {
+                startMesh();
+                model.meshes.back().name = std::move(event.name);
+            }
+        }
+        addFaces(i, faceBegin, static_cast<std::uint32_t>(chunk.faceEnds.size()));
+        for (auto& mtlLibrary : chunk.mtlLibraries)
+        {
+            if (std::find(mtlLibraries.begin(), mtlLibraries.end(), mtlLibrary) == mtlLibraries.end())
+            {
+                mtlLibraries.push_back(std::move(mtlLibrary));
+            }
+        }
+    }
+    if (meshRanges.back().ranges.empty())
+    {
+        model.meshes.pop_back();
+        meshRanges.pop_back();
+    }
+
+    RunParallelTasks(model.meshes.size(), [&chunks, &attributes, &meshRanges, flipUVs, &model](std::size_t i)
+    {
+        BuildMesh(chunks, attributes, meshRanges[i], flipUVs, model.meshes[i]);
+    });
+    //The polygons with invalid corners are skipped, a mesh can end up empty
+    model.meshes.erase(std::remove_if(model.meshes.begin(), model.meshes.end(), [](const ObjMesh& mesh)
+    {
+        return mesh.indices.empty();
+    }), model.meshes.end());
+    return !model.meshes.empty();
+}
+
+void ParseMtl(std::string_view mtlText, std::vector<ObjMaterial>& materials)
+{
+    ObjMaterial* material = nullptr;
+    const char* it = mtlText.data();
+    const char* end = it + mtlText.size();
+    //Texture options like -bm come before the path, which is the last argument
+    const auto texturePath = [](const char* valueIt, const char* lineEnd)
+    {
+        const auto value = TrimmedRest(valueIt, lineEnd);
+        const auto lastBlank = value.find_last_of(" \t");
+        return std::string(lastBlank == std::string_view::npos ? value : value.substr(lastBlank + 1));
+    };
+    while (it < end)
+    {
+        const auto* lineEnd = static_cast<const char*>(std::memchr(it, '\n', end - it));
+        if (lineEnd == nullptr)
+        {
+            lineEnd = end;
+        }
+        const char* line = SkipBlanks(it, lineEnd);
+        it = lineEnd + 1;
+        if (IsKeyword(line, lineEnd, "newmtl"))
+        {
+            const auto name = TrimmedRest(line + 6, lineEnd);
+            const auto found = std::find_if(materials.begin(), materials.end(), [name](const ObjMaterial& objMaterial)
+            {
+                return objMaterial.name == name;
+            });
+            material = found == materials.end() ? nullptr : &*found;
+        }
+        else if (material == nullptr)
+        {
+            continue;
+        }
+        else if (IsKeyword(line, lineEnd, "Ns"))
+        {
+            ParseFloat(line + 2, lineEnd, material->specularExponent);
+        }
+        else if (IsKeyword(line, lineEnd, "map_Kd"))
+        {
+            material->diffuseMap = texturePath(line + 6, lineEnd);
+        }
+        else if (IsKeyword(line, lineEnd, "map_Ks"))
+        {
+            material->specularMap = texturePath(line + 6, lineEnd);
+        }
+        else if (IsKeyword(line, lineEnd, "map_Bump") || IsKeyword(line, lineEnd, "map_bump"))
+        {
+            material->heightMap = texturePath(line + 8, lineEnd);
+        }
+        else if (IsKeyword(line, lineEnd, "bump"))
+        {
+            material->heightMap = texturePath(line + 4, lineEnd);
+        }
+    }
+}
+
+bool LoadObj(std::string_view path, ObjModel& model, bool flipUVs)
+{
+#ifdef EASY_PROFILE_USE
+    EASY_BLOCK("Load Obj");
+#endif
+    BufferFile objFile;
+    objFile.Load(path, BufferFile::LoadMode::MAP);
+    if (objFile.dataBuffer == nullptr)
+    {
+        logDebug(fmt::format("[Error] Could not load obj file: {}", path));
+        return false;
+    }
+    std::vector<std::string> mtlLibraries;
+    const bool isParsed = ParseObj(std::string_view(reinterpret_cast<const char*>(objFile.dataBuffer),
+        objFile.dataLength), model, mtlLibraries, flipUVs);
+    objFile.Destroy();
+    if (!isParsed)
+    {
+        logDebug(fmt::format("[Error] Obj file: {} has no valid face", path));
+        return false;
+    }
+    const std::string_view directory = path.substr(0, path.find_last_of('/') + 1);
+    for (const auto& mtlLibrary : mtlLibraries)
+    {
+        BufferFile mtlFile;
+        mtlFile.Load(std::string(directory) + mtlLibrary);
+        if (mtlFile.dataBuffer == nullptr)
+        {
+            logDebug(fmt::format("[Warning] Could not load material library: {} of {}", mtlLibrary, path));
+            continue;
+        }
+        ParseMtl(std::string_view(reinterpret_cast<const char*>(mtlFile.dataBuffer), mtlFile.dataLength),
+            model.materials);
+        mtlFile.Destroy();
+    }
+    return true;
+}
+}
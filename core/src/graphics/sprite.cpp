@@ -8,10 +8,11 @@ namespace neko
 {
 void SpriteManager::SetTexture(neko::Entity entity, neko::TextureId textureId)
 {
-    const auto& texture = textureManager_.GetTexture(textureId);
+    const auto textureHandle = textureManager_.GetTextureHandle(textureId);
     auto& sprite = components_[entity];
     sprite.textureId = textureId;
-    sprite.texture = texture;
+    sprite.textureHandle = textureHandle;
+    sprite.texture = textureManager_.GetTexture(textureHandle);
 }
 
 void SpriteManager::Update([[maybe_unused]]neko::seconds dt)
@@ -22,9 +23,9 @@ void SpriteManager::Update([[maybe_unused]]neko::seconds dt)
         if(entityManager_.get().HasComponent(entity, static_cast<EntityMask>(ComponentType::SPRITE2D)))
         {
             auto& sprite = components_[entity];
-            if(sprite.textureId != INVALID_TEXTURE_ID && sprite.texture.name == INVALID_TEXTURE_NAME)
+            if(sprite.textureHandle != INVALID_TEXTURE_HANDLE && sprite.texture.name == INVALID_TEXTURE_NAME)
             {
-                sprite.texture = textureManager_.GetTexture(sprite.textureId);
+                sprite.texture = textureManager_.GetTexture(sprite.textureHandle);
             }
         }
     }
@@ -23,10 +23,14 @@
  */
 #include "graphics/graphics.h"
 #include "graphics/texture.h"
+#include "graphics/image_processing.h"
+#include "graphics/texture_cooker.h"
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
 #include "engine/engine.h"
 #include "utilities/file_utility.h"
+#include "utilities/asset_database.h"
+#include "utilities/asset_archive.h"
 #include <fmt/format.h>
 
 #ifdef EASY_PROFILE_USE
@@ -43,8 +47,9 @@ Image StbImageConvert(const BufferFile& imageFile, bool flipY, bool hdr)
     EASY_BLOCK("Convert Image");
 #endif
     Image image;
-	
-    stbi_set_flip_vertically_on_load(flipY);
+    image.hdr = hdr;
+    //The images are converted on several workers at once
+    stbi_set_flip_vertically_on_load_thread(flipY);
     if (hdr)
     {
         image.data = (unsigned char*)stbi_loadf_from_memory((unsigned char*)(imageFile.dataBuffer),
@@ -60,28 +65,75 @@ Image StbImageConvert(const BufferFile& imageFile, bool flipY, bool hdr)
 
 TextureLoader::TextureLoader(TextureManager& textureManager) :
 	textureManager_(textureManager),
+	diskLoadJob_([this]
+    {
+#ifdef EASY_PROFILE_USE
+        EASY_BLOCK("Load Texture Files");
+#endif
+        //Served from the mounted asset archive when the file is packed
+        if (!AssetArchiveLocator::get().LoadBufferFile(path_, sourceFile_))
+        {
+            sourceFile_.Load(path_);
+        }
+        const auto& textureCooker = textureManager_.GetTextureCooker();
+        if (textureCooker.IsEnabled() && sourceFile_.dataBuffer != nullptr)
+        {
+            cookedPath_ = textureCooker.GetCookedPath(sourceFile_, flags_);
+            if (FileExists(cookedPath_))
+            {
+                cookedFile_.Load(cookedPath_);
+            }
+        }
+    }),
 	convertImageJob_([this]
     {
 	    logDebug("[Texture Manager] Convert buffer file to image");
-        image_ = StbImageConvert(diskLoadJob_.GetBufferFile(), flags_ & Texture::FLIP_Y, flags_ & Texture::HDR);
-        TextureInfo textureInfo{ textureId_, std::move(image_), flags_ };
+        if (cookedFile_.dataBuffer != nullptr)
+        {
+            image_ = LoadKtx2(cookedFile_);
+            cookedFile_.Destroy();
+        }
+        if (image_.data == nullptr)
+        {
+            image_ = textureManager_.IsCookingOnLoad() && !cookedPath_.empty() ?
+                textureManager_.GetTextureCooker().Cook(sourceFile_, flags_, cookedData_) :
+                StbImageConvert(sourceFile_, flags_ & Texture::FLIP_Y, flags_ & Texture::HDR);
+        }
+        if (image_.mipLevels == 1 && flags_ & Texture::MIPMAPS_TEXTURE && textureManager_.IsGeneratingMipmapsOnCpu())
+        {
+            GenerateMipChain(image_, flags_ & Texture::GAMMA_CORRECTION);
+        }
+        TextureInfo textureInfo{ textureHandle_, std::move(image_), flags_ };
         textureManager_.UploadToGpu(std::move(textureInfo));
         logDebug("[Texture Manager] Finish converting buffer file to image");
+        //The disk writes stay on the resource thread
+#ifdef NEKO_SAMETHREAD
+        writeCookedJob_.Execute();
+#else
+        BasicEngine::GetInstance()->ScheduleJob(&writeCookedJob_, JobThreadType::RESOURCE_THREAD);
+#endif
+    }),
+    writeCookedJob_([this]
+    {
+        if (!cookedData_.empty())
+        {
+            TextureCooker::WriteCookedFile(cookedPath_, cookedData_);
+        }
     })
 {
 }
 
-void TextureLoader::SetTextureId(TextureId textureId)
+void TextureLoader::SetTextureHandle(TextureHandle textureHandle)
 {
-	textureId_ = textureId;
-	const auto path = textureManager_.GetPath(textureId_);
-	diskLoadJob_.SetFilePath(path);
+	textureHandle_ = textureHandle;
+	path_ = textureManager_.GetPath(textureHandle_);
 }
 
 void TextureLoader::LoadFromDisk()
 {
-    if (textureId_ != INVALID_TEXTURE_ID)
+    if (textureHandle_ != INVALID_TEXTURE_HANDLE)
     {
+        isLoading_ = true;
 #ifndef NEKO_SAMETHREAD
         BasicEngine::GetInstance()->ScheduleJob(&diskLoadJob_, JobThreadType::RESOURCE_THREAD);
         convertImageJob_.AddDependency(&diskLoadJob_);
@@ -95,35 +147,54 @@ void TextureLoader::LoadFromDisk()
 
 void TextureLoader::Reset()
 {
+	if (isLoading_)
+	{
+		//A job is done before its promise is set, the conversion also finishes after scheduling the write
+		convertImageJob_.Join();
+		writeCookedJob_.Join();
+	}
 	convertImageJob_.Reset();
 	diskLoadJob_.Reset();
+	writeCookedJob_.Reset();
+	sourceFile_.Destroy();
+	cookedFile_.Destroy();
+	cookedPath_.clear();
+	cookedData_.clear();
+	isLoading_ = false;
 }
 
 
 
-TextureManager::TextureManager() : textureLoader_(*this), uploadToGpuJob_([this]()
+TextureManager::TextureManager() : uploadToGpuJob_([this]()
 {
-	CreateTexture();
-	currentUploadedTexture_.textureId = INVALID_TEXTURE_ID;
-})
+    UploadTextures();
+}), textureCooker_(std::make_unique<TextureCooker>())
 {
-
+    SetMaxLoadingTextures(defaultMaxLoadingTextures);
 }
 
+TextureManager::~TextureManager() = default;
+
 TextureId TextureManager::LoadTexture(std::string_view path, Texture::TextureFlags flags)
 {
 	
-	const std::string metaPath = std::string(path) + ".meta";
-    auto metaJson = LoadJson(metaPath);
     TextureId textureId = INVALID_TEXTURE_ID;
-	if(CheckJsonExists(metaJson, "uuid"))
-	{
-        textureId = sole::rebuild(metaJson["uuid"].get<std::string>());
-	}
+    auto& assetDatabase = AssetDatabaseLocator::get();
+    AssetRecord asset;
+    if(assetDatabase.FindAsset(path, asset))
+    {
+        textureId = asset.GetId();
+    }
     else
     {
-        logDebug("[Error] Could not find texture id in json file");
-        return textureId;
+        //The .meta file is only parsed on the first load of the path
+        std::uint32_t metaFlags = AssetArchiveEntry::NONE;
+        if(!LoadAssetMeta(path, textureId, metaFlags))
+        {
+            logDebug("[Error] Could not find texture id in json file");
+            return INVALID_TEXTURE_ID;
+        }
+        assetDatabase.AddAsset(path, textureId, AssetType::TEXTURE, metaFlags);
     }
 
     if (textureId == INVALID_TEXTURE_ID)
@@ -131,106 +202,321 @@ TextureId TextureManager::LoadTexture(std::string_view path, Texture::TextureFla
         logDebug("[Error] Invalid texture id on texture load");
         return textureId;
     }
-    const auto it = texturePathMap_.find(textureId);
-	if(it != texturePathMap_.end())
-	{
-		//Texture is already in queue or even loaded
-        logDebug("[Texture Manager] Texture is already loaded");
-        return textureId;
-	}
-	logDebug(fmt::format("[Texture Manager] Loading texture path: {}", path));
-
-    texturePathMap_[textureId] = std::string(path.data());
+    {
+        //The models request their textures from the OTHER_THREAD workers
 #ifndef NEKO_SAMETHREAD
-	//Put texture in queue
-    TextureInfo textureInfo;
-    textureInfo.textureId = textureId;
-    textureInfo.flags = flags;
-    texturesToLoad_.push(std::move(textureInfo));
-#else
-    textureLoader_.Reset();
-
-    textureLoader_.SetTextureId(textureId);
-    textureLoader_.SetTextureFlags(flags);
-    textureLoader_.LoadFromDisk();
+        std::lock_guard<std::mutex> lock(loadedMutex_);
+#endif
+        const auto it = textureHandles_.find(textureId);
+        if (it != textureHandles_.end())
+        {
+            //Texture is already in queue or even loaded
+            logDebug("[Texture Manager] Texture is already loaded");
+            return textureId;
+        }
+        logDebug(fmt::format("[Texture Manager] Loading texture path: {}", path));
 
-    auto& textureInfo = texturesToUpload_.front();
-    currentUploadedTexture_ = std::move(textureInfo);
-    texturesToUpload_.pop();
-    uploadToGpuJob_.Reset();
-    uploadToGpuJob_.Execute();
+        const TextureHandle textureHandle = textures_.Add({});
+        textureHandles_[textureId] = textureHandle;
+        if (texturePaths_.size() <= textureHandle.index)
+        {
+            texturePaths_.resize(textureHandle.index + 1);
+        }
+        texturePaths_[textureHandle.index] = std::string(path);
+        //Put texture in queue
+        TextureInfo textureInfo;
+        textureInfo.textureHandle = textureHandle;
+        textureInfo.flags = flags;
+        texturesToLoad_.push(std::move(textureInfo));
+    }
+#ifdef NEKO_SAMETHREAD
+    Update(seconds(0.0f));
 #endif
     return textureId;
 }
 
 std::string TextureManager::GetPath(TextureId textureId) const
 {
-	const auto pathIt = texturePathMap_.find(textureId);
-	if (pathIt != texturePathMap_.end())
+	return GetPath(GetTextureHandle(textureId));
+}
+
+std::string TextureManager::GetPath(TextureHandle textureHandle) const
+{
+#ifndef NEKO_SAMETHREAD
+    std::lock_guard<std::mutex> lock(loadedMutex_);
+#endif
+	if (textures_.IsValid(textureHandle))
 	{
-		return pathIt->second;
+		return texturePaths_[textureHandle.index];
 	}
 	return "";
 }
 
 void TextureManager::Init()
 {
+    const auto* engine = BasicEngine::GetInstance();
+    if (engine != nullptr && !engine->config.textureCachePath.empty())
+    {
+        SetTextureCache(engine->config.textureCachePath);
+    }
     TextureManagerLocator::provide(this);
 }
 
+void TextureManager::SetTextureCache(std::string_view cacheFolder, bool cookOnLoad)
+{
+    textureCooker_->SetCacheFolder(cacheFolder);
+    cookOnLoad_ = cookOnLoad;
+}
+
 void TextureManager::Update([[maybe_unused]]seconds dt)
 {
-#ifndef NEKO_SAMETHREAD
-    if (!texturesToLoad_.empty())
+    if (isUploading_ && uploadToGpuJob_.IsDone())
     {
-        if (textureLoader_.IsLoaded() || !textureLoader_.HasStarted())
+        isUploading_ = false;
+        FinishUploadingTextures();
+    }
+    for (auto& textureLoader : textureLoaders_)
+    {
+        if (GetDecodedMemory() >= decodedMemoryBudget_)
+        {
+            break;
+        }
+        if (!textureLoader->IsAvailable())
+        {
+            continue;
+        }
+        TextureInfo textureInfo;
         {
-            logDebug("[Texture Manager] Loading a texture from disk");
-            textureLoader_.Reset();
-            const auto& textureInfo = texturesToLoad_.front();
-            textureLoader_.SetTextureId(textureInfo.textureId);
-            textureLoader_.SetTextureFlags(textureInfo.flags);
-            textureLoader_.LoadFromDisk();
+#ifndef NEKO_SAMETHREAD
+            std::lock_guard<std::mutex> lock(loadedMutex_);
+#endif
+            if (texturesToLoad_.empty())
+            {
+                break;
+            }
+            textureInfo = std::move(texturesToLoad_.front());
             texturesToLoad_.pop();
         }
+        logDebug("[Texture Manager] Loading a texture from disk");
+        textureLoader->Reset();
+        textureLoader->SetTextureHandle(textureInfo.textureHandle);
+        textureLoader->SetTextureFlags(textureInfo.flags);
+        textureLoader->LoadFromDisk();
     }
-	if(!texturesToUpload_.empty() && currentUploadedTexture_.textureId == INVALID_TEXTURE_ID)
+    if (isUploading_)
     {
-
-        logDebug("[Texture Manager] Uploading a texture to the GPU");
-		auto& textureInfo = texturesToUpload_.front();
-        currentUploadedTexture_ = std::move(textureInfo);
-	    texturesToUpload_.pop();
+        return;
+    }
+    {
+#ifndef NEKO_SAMETHREAD
+        std::lock_guard<std::mutex> lock(uploadMutex_);
+#endif
+        while (!texturesToUpload_.empty() && uploadingTextures_.size() < maxUploadsPerFrame_)
+        {
+            uploadingTextures_.push_back(std::move(texturesToUpload_.front()));
+            texturesToUpload_.pop();
+        }
+    }
+    if (!uploadingTextures_.empty())
+    {
+        logDebug(fmt::format("[Texture Manager] Uploading {} textures to the GPU", uploadingTextures_.size()));
         uploadToGpuJob_.Reset();
+        isUploading_ = true;
+#ifndef NEKO_SAMETHREAD
 	    RendererLocator::get().AddPreRenderJob(&uploadToGpuJob_);
-	}
+#else
+        uploadToGpuJob_.Execute();
+        isUploading_ = false;
+        FinishUploadingTextures();
+#endif
+    }
+}
+
+void TextureManager::UploadTextures()
+{
+    for (auto& textureInfo : uploadingTextures_)
+    {
+        const size_t byteSize = textureInfo.image.GetByteSize();
+        const void* imageData = textureInfo.image.data;
+        currentUploadedTexture_ = std::move(textureInfo);
+        CreateTexture();
+        currentUploadedTexture_.image.Destroy();
+        //The texture table is filled by FinishUploadingTextures on the main thread, under the loaded mutex
+        textureInfo = std::move(currentUploadedTexture_);
+        decodedMemory_.fetch_sub(byteSize, std::memory_order_relaxed);
+        MemoryBudgetLocator::get().RecordDeallocation(MemoryTag::TEXTURE, imageData, byteSize);
+    }
+}
+
+void TextureManager::FinishUploadingTextures()
+{
+    std::vector<std::pair<Texture, TextureLoadedCallback>> callbacks;
+    {
+#ifndef NEKO_SAMETHREAD
+        std::lock_guard<std::mutex> lock(loadedMutex_);
+#endif
+        for (const auto& textureInfo : uploadingTextures_)
+        {
+            auto* loadedTexture = textures_.Get(textureInfo.textureHandle);
+            if (loadedTexture != nullptr)
+            {
+                loadedTexture->texture = textureInfo.texture;
+                loadedTexture->isLoaded = true;
+                for (auto& onLoaded : loadedTexture->onLoaded)
+                {
+                    callbacks.emplace_back(textureInfo.texture, std::move(onLoaded));
+                }
+                loadedTexture->onLoaded.clear();
+            }
+        }
+    }
+    uploadingTextures_.clear();
+    //Outside of the lock, a callback can query the texture manager
+    for (auto& [texture, onLoaded] : callbacks)
+    {
+        onLoaded(texture);
+    }
+}
+
+bool TextureManager::AddTextureLoadedCallback(TextureHandle textureHandle, TextureLoadedCallback onLoaded)
+{
+    Texture texture;
+    {
+#ifndef NEKO_SAMETHREAD
+        std::lock_guard<std::mutex> lock(loadedMutex_);
 #endif
+        auto* loadedTexture = textures_.Get(textureHandle);
+        if (loadedTexture == nullptr)
+        {
+            return false;
+        }
+        if (!loadedTexture->isLoaded)
+        {
+            loadedTexture->onLoaded.push_back(std::move(onLoaded));
+            return true;
+        }
+        texture = loadedTexture->texture;
+    }
+    onLoaded(texture);
+    return true;
 }
 
 void TextureManager::Destroy()
 {
-    texturePathMap_.clear();
-    textureMap_.clear();
+    {
+#ifndef NEKO_SAMETHREAD
+        std::lock_guard<std::mutex> lock(loadedMutex_);
+#endif
+        //The generations are kept, the handles given before stay invalid and their callbacks are dropped
+        textures_.Clear();
+        textureHandles_.clear();
+        texturePaths_.clear();
+        texturesToLoad_ = {};
+    }
+#ifndef NEKO_SAMETHREAD
+    std::lock_guard<std::mutex> lock(uploadMutex_);
+#endif
+    //The decoded images dropped before their upload leave the budgets
+    while (!texturesToUpload_.empty())
+    {
+        const auto& image = texturesToUpload_.front().image;
+        decodedMemory_.fetch_sub(image.GetByteSize(), std::memory_order_relaxed);
+        MemoryBudgetLocator::get().RecordDeallocation(MemoryTag::TEXTURE, image.data, image.GetByteSize());
+        texturesToUpload_.pop();
+    }
 }
 
 void TextureManager::UploadToGpu(TextureInfo&& texture)
 {
+    decodedMemory_.fetch_add(texture.image.GetByteSize(), std::memory_order_relaxed);
+    MemoryBudgetLocator::get().RecordAllocation(MemoryTag::TEXTURE, texture.image.data, texture.image.GetByteSize(),
+        NEKO_ALLOCATION_SITE);
+#ifndef NEKO_SAMETHREAD
+    std::lock_guard<std::mutex> lock(uploadMutex_);
+#endif
 	texturesToUpload_.push(std::move(texture));
 }
 
+void TextureManager::SetMaxLoadingTextures(size_t maxLoadingTextures)
+{
+    maxLoadingTextures_ = std::max<size_t>(1, maxLoadingTextures);
+    while (textureLoaders_.size() < maxLoadingTextures_)
+    {
+        textureLoaders_.push_back(std::make_unique<TextureLoader>(*this));
+    }
+    //Busy loaders finish their texture before being removed
+    textureLoaders_.erase(std::remove_if(textureLoaders_.begin() + maxLoadingTextures_, textureLoaders_.end(),
+        [](const std::unique_ptr<TextureLoader>& textureLoader)
+        {
+            return textureLoader->IsAvailable();
+        }), textureLoaders_.end());
+}
+
+size_t TextureManager::GetLoadingTextureCount() const
+{
+    size_t count = uploadingTextures_.size();
+    {
+#ifndef NEKO_SAMETHREAD
+        std::lock_guard<std::mutex> lock(loadedMutex_);
+#endif
+        count += texturesToLoad_.size();
+    }
+    for (const auto& textureLoader : textureLoaders_)
+    {
+        if (!textureLoader->IsAvailable())
+        {
+            count++;
+        }
+    }
+#ifndef NEKO_SAMETHREAD
+    std::lock_guard<std::mutex> lock(uploadMutex_);
+#endif
+    return count + texturesToUpload_.size();
+}
+
 Texture TextureManager::GetTexture(TextureId index) const
 {
-    const auto it = textureMap_.find(index);
-	if(it != textureMap_.end())
-	{
+    return GetTexture(GetTextureHandle(index));
+}
+
+bool TextureManager::IsTextureLoaded(TextureId textureId) const
+{
+    return IsTextureLoaded(GetTextureHandle(textureId));
+}
+
+TextureHandle TextureManager::GetTextureHandle(TextureId textureId) const
+{
+#ifndef NEKO_SAMETHREAD
+    std::lock_guard<std::mutex> lock(loadedMutex_);
+#endif
+    const auto it = textureHandles_.find(textureId);
+    if (it != textureHandles_.end())
+    {
         return it->second;
-	}
+    }
+    return INVALID_TEXTURE_HANDLE;
+}
+
+Texture TextureManager::GetTexture(TextureHandle textureHandle) const
+{
+#ifndef NEKO_SAMETHREAD
+    std::lock_guard<std::mutex> lock(loadedMutex_);
+#endif
+    const auto* loadedTexture = textures_.Get(textureHandle);
+    if (loadedTexture != nullptr)
+    {
+        return loadedTexture->texture;
+    }
     return {};
 }
 
-bool TextureManager::IsTextureLoaded(TextureId textureId) const
+bool TextureManager::IsTextureLoaded(TextureHandle textureHandle) const
 {
-    return textureMap_.find(textureId) != textureMap_.end();
+#ifndef NEKO_SAMETHREAD
+    std::lock_guard<std::mutex> lock(loadedMutex_);
+#endif
+    const auto* loadedTexture = textures_.Get(textureHandle);
+    return loadedTexture != nullptr && loadedTexture->isLoaded;
 }
 
 
@@ -241,15 +527,24 @@ Image::Image(Image&& image) noexcept
 	width = image.width;
 	height = image.height;
 	nbChannels = image.nbChannels;
+	mipLevels = image.mipLevels;
+	hdr = image.hdr;
 }
 
 Image& Image::operator=(Image&& image) noexcept
 {
+	if (this == &image)
+	{
+		return *this;
+	}
+	Destroy();
 	data = image.data;
 	image.data = nullptr;
 	width = image.width;
 	height = image.height;
 	nbChannels = image.nbChannels;
+	mipLevels = image.mipLevels;
+	hdr = image.hdr;
 	return *this;
 }
 
@@ -267,5 +562,30 @@ void Image::Destroy()
     data = nullptr;
     height = -1;
     width = -1;
+    mipLevels = 1;
+}
+
+size_t Image::GetByteSize() const
+{
+    if (data == nullptr)
+    {
+        return 0;
+    }
+    return GetLevelOffset(mipLevels);
+}
+
+size_t Image::GetLevelByteSize(int level) const
+{
+    return size_t(GetLevelWidth(level)) * size_t(GetLevelHeight(level)) * size_t(nbChannels) * (hdr ? sizeof(float) : 1);
+}
+
+size_t Image::GetLevelOffset(int level) const
+{
+    size_t offset = 0;
+    for (int i = 0; i < level; i++)
+    {
+        offset += GetLevelByteSize(i);
+    }
+    return offset;
 }
 }
@@ -0,0 +1,417 @@
+/*
+ MIT License
+
+ Copyright (c) 2020 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+#include "graphics/texture_cooker.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "engine/log.h"
+#include "mathematics/checksum.h"
+#include "utilities/file_utility.h"
+
+#ifdef NEKO_ZSTD
+#include <zstd.h>
+#endif
+
+#ifdef EASY_PROFILE_USE
+#include "easy/profiler.h"
+#endif
+
+namespace neko
+{
+namespace
+{
+#ifdef NEKO_ZSTD
+constexpr int ktx2CompressionLevel = 9;
+#endif
+
+struct Ktx2Format
+{
+    std::uint32_t vkFormat;
+    int nbChannels;
+    bool hdr;
+    bool srgb;
+};
+
+//Vulkan formats of the uncompressed images stb_image decodes to
+constexpr std::array<Ktx2Format, 12> ktx2Formats =
+{{
+    {9, 1, false, false}, //VK_FORMAT_R8_UNORM
+    {16, 2, false, false}, //VK_FORMAT_R8G8_UNORM
+    {23, 3, false, false}, //VK_FORMAT_R8G8B8_UNORM
+    {37, 4, false, false}, //VK_FORMAT_R8G8B8A8_UNORM
+    {29, 3, false, true}, //VK_FORMAT_R8G8B8_SRGB
+    {43, 4, false, true}, //VK_FORMAT_R8G8B8A8_SRGB
+    {100, 1, true, false}, //VK_FORMAT_R32_SFLOAT
+    {103, 2, true, false}, //VK_FORMAT_R32G32_SFLOAT
+    {106, 3, true, false}, //VK_FORMAT_R32G32B32_SFLOAT
+    {109, 4, true, false}, //VK_FORMAT_R32G32B32A32_SFLOAT
+    {15, 1, false, true}, //VK_FORMAT_R8_SRGB
+    {22, 2, false, true}, //VK_FORMAT_R8G8_SRGB
+}};
+
+const Ktx2Format* FindKtx2Format(int nbChannels, bool hdr, bool srgb)
+{
+    const auto it = std::find_if(ktx2Formats.begin(), ktx2Formats.end(), [&](const Ktx2Format& format)
+    {
+        return format.nbChannels == nbChannels && format.hdr == hdr && format.srgb == srgb;
+    });
+    return it == ktx2Formats.end() ? nullptr : &*it;
+}
+
+const Ktx2Format* FindKtx2Format(std::uint32_t vkFormat)
+{
+    const auto it = std::find_if(ktx2Formats.begin(), ktx2Formats.end(), [vkFormat](const Ktx2Format& format)
+    {
+        return format.vkFormat == vkFormat;
+    });
+    return it == ktx2Formats.end() ? nullptr : &*it;
+}
+
+std::vector<std::uint32_t> GenerateKtx2Dfd(const Ktx2Format& format)
+{
+    const std::uint32_t bits = format.hdr ? 32u : 8u;
+    const std::uint32_t nbChannels = format.nbChannels;
+    const std::uint32_t blockSize = 24u + 16u * nbChannels;
+    std::vector<std::uint32_t> dfd;
+    dfd.reserve(1 + blockSize / sizeof(std::uint32_t));
+    dfd.push_back(sizeof(std::uint32_t) + blockSize);
+    //Khronos vendor, basic descriptor block
+    dfd.push_back(0u);
+    //Data format descriptor 1.3
+    dfd.push_back(2u | (blockSize << 16u));
+    //RGBSDA color model, BT709 primaries, linear or sRGB transfer, straight alpha
+    dfd.push_back(1u | (1u << 8u) | ((format.srgb ? 2u : 1u) << 16u));
+    //1x1x1x1 texel block
+    dfd.push_back(0u);
+    dfd.push_back(nbChannels * bits / 8u);
+    dfd.push_back(0u);
+    for (std::uint32_t c = 0; c < nbChannels; c++)
+    {
+        const std::uint32_t channelId = c == 3 ? 15u : c;
+        std::uint32_t qualifiers = format.hdr ? 0xC0u : 0u;
+        if (format.srgb && channelId == 15u)
+        {
+            qualifiers |= 0x10u;
+        }
+        dfd.push_back((c * bits) | ((bits - 1u) << 16u) | ((channelId | qualifiers) << 24u));
+        dfd.push_back(0u);
+        dfd.push_back(format.hdr ? 0xBF800000u : 0u);
+        dfd.push_back(format.hdr ? 0x3F800000u : 255u);
+    }
+    return dfd;
+}
+}
+
+std::vector<unsigned char> EncodeKtx2(const Image& image, bool srgb, [[maybe_unused]] bool supercompress)
+{
+#ifdef EASY_PROFILE_USE
+    EASY_BLOCK("Encode KTX2");
+#endif
+    std::vector<unsigned char> ktxData;
+    if (image.data == nullptr)
+    {
+        return ktxData;
+    }
+    const auto* format = FindKtx2Format(image.nbChannels, image.hdr, srgb && !image.hdr && image.nbChannels >= 3);
+    if (format == nullptr)
+    {
+        logDebug(fmt::format("[Error] No KTX2 format for {} channels image", image.nbChannels));
+        return ktxData;
+    }
+    const auto levelCount = static_cast<size_t>(image.mipLevels);
+    Ktx2Header header;
+    header.vkFormat = format->vkFormat;
+    header.typeSize = image.hdr ? sizeof(float) : 1;
+    header.pixelWidth = image.width;
+    header.pixelHeight = image.height;
+    header.levelCount = image.mipLevels;
+#ifdef NEKO_ZSTD
+    if (supercompress)
+    {
+        header.supercompressionScheme = Ktx2Header::ZSTD;
+    }
+#endif
+    const auto dfd = GenerateKtx2Dfd(*format);
+    header.dfdByteOffset = static_cast<std::uint32_t>(sizeof(Ktx2Header) + levelCount * sizeof(Ktx2LevelIndex));
+    header.dfdByteLength = static_cast<std::uint32_t>(dfd.size() * sizeof(std::uint32_t));
+
+    std::vector<std::vector<unsigned char>> levels(levelCount);
+    for (size_t level = 0; level < levelCount; level++)
+    {
+        const unsigned char* levelData = image.data + image.GetLevelOffset(int(level));
+        const size_t levelSize = image.GetLevelByteSize(int(level));
+#ifdef NEKO_ZSTD
+        if (header.supercompressionScheme == Ktx2Header::ZSTD)
+        {
+            auto& compressed = levels[level];
+            compressed.resize(ZSTD_compressBound(levelSize));
+            const size_t compressedSize = ZSTD_compress(compressed.data(), compressed.size(),
+                levelData, levelSize, ktx2CompressionLevel);
+            if (ZSTD_isError(compressedSize))
+            {
+                logDebug(fmt::format("[Error] Could not compress mip level {}", level));
+                return ktxData;
+            }
+            compressed.resize(compressedSize);
+            continue;
+        }
+#endif
+        levels[level].assign(levelData, levelData + levelSize);
+    }
+
+    //Levels are stored from the smallest, uncompressed ones aligned on the texel size and 4 bytes
+    const std::uint64_t alignment = header.supercompressionScheme == Ktx2Header::NONE ?
+        std::lcm<std::uint64_t>(image.nbChannels * header.typeSize, 4) : 1;
+    std::vector<Ktx2LevelIndex> levelIndex(levelCount);
+    std::uint64_t offset = header.dfdByteOffset + header.dfdByteLength;
+    for (size_t i = levelCount; i > 0; i--)
+    {
+        const size_t level = i - 1;
+        offset = (offset + alignment - 1) / alignment * alignment;
+        levelIndex[level].byteOffset = offset;
+        levelIndex[level].byteLength = levels[level].size();
+        levelIndex[level].uncompressedByteLength = image.GetLevelByteSize(int(level));
+        offset += levels[level].size();
+    }
+
+    ktxData.resize(offset);
+    std::memcpy(ktxData.data(), &header, sizeof(header));
+    std::memcpy(ktxData.data() + sizeof(header), levelIndex.data(), levelIndex.size() * sizeof(Ktx2LevelIndex));
+    std::memcpy(ktxData.data() + header.dfdByteOffset, dfd.data(), header.dfdByteLength);
+    //The alignment padding stays zeroed
+    for (size_t level = 0; level < levelCount; level++)
+    {
+        std::copy(levels[level].begin(), levels[level].end(), ktxData.begin() + levelIndex[level].byteOffset);
+    }
+    return ktxData;
+}
+
+bool WriteKtx2(std::string_view path, const Image& image, bool srgb, bool supercompress)
+{
+    const auto ktxData = EncodeKtx2(image, srgb, supercompress);
+    if (ktxData.empty())
+    {
+        return false;
+    }
+    std::ofstream os(path.data(), std::ofstream::binary | std::ofstream::trunc);
+    if (!os)
+    {
+        logDebug(fmt::format("[Error] Could not open KTX2 file: {} for writing", path));
+        return false;
+    }
+    os.write(reinterpret_cast<const char*>(ktxData.data()), ktxData.size());
+    return static_cast<bool>(os);
+}
+
+Image LoadKtx2(const BufferFile& ktxFile)
+{
+#ifdef EASY_PROFILE_USE
+    EASY_BLOCK("Load KTX2");
+#endif
+    Image image;
+    Ktx2Header header;
+    if (ktxFile.dataBuffer == nullptr || ktxFile.dataLength < sizeof(Ktx2Header))
+    {
+        logDebug("[Error] KTX2 file is too small");
+        return image;
+    }
+    std::memcpy(&header, ktxFile.dataBuffer, sizeof(Ktx2Header));
+    const auto* format = FindKtx2Format(header.vkFormat);
+    if (header.identifier != Ktx2Header::identifierValue || format == nullptr ||
+        header.pixelWidth == 0 || header.pixelHeight == 0 || header.pixelDepth != 0 ||
+        header.layerCount != 0 || header.faceCount != 1 ||
+        (header.supercompressionScheme != Ktx2Header::NONE && header.supercompressionScheme != Ktx2Header::ZSTD))
+    {
+        logDebug("[Error] KTX2 file is not an uncompressed 2d texture");
+        return image;
+    }
+#ifndef NEKO_ZSTD
+    if (header.supercompressionScheme == Ktx2Header::ZSTD)
+    {
+        logDebug("[Error] KTX2 file is supercompressed with zstd but zstd is not available");
+        return image;
+    }
+#endif
+    image.width = static_cast<int>(header.pixelWidth);
+    image.height = static_cast<int>(header.pixelHeight);
+    image.nbChannels = format->nbChannels;
+    image.hdr = format->hdr;
+    image.mipLevels = static_cast<int>(std::max(1u, header.levelCount));
+    const size_t levelIndexEnd = sizeof(Ktx2Header) + image.mipLevels * sizeof(Ktx2LevelIndex);
+    if (image.mipLevels > GetMipLevelCount(image.width, image.height) || levelIndexEnd > ktxFile.dataLength)
+    {
+        logDebug("[Error] KTX2 file has an invalid level index");
+        image.Destroy();
+        return image;
+    }
+    std::vector<Ktx2LevelIndex> levelIndex(image.mipLevels);
+    std::memcpy(levelIndex.data(), ktxFile.dataBuffer + sizeof(Ktx2Header), levelIndex.size() * sizeof(Ktx2LevelIndex));
+
+    //GetByteSize is 0 until data is set
+    image.data = static_cast<unsigned char*>(std::malloc(image.GetLevelOffset(image.mipLevels)));
+    for (int level = 0; level < image.mipLevels && image.data != nullptr; level++)
+    {
+        const auto& index = levelIndex[level];
+        const size_t levelSize = image.GetLevelByteSize(level);
+        unsigned char* levelData = image.data + image.GetLevelOffset(level);
+        bool isValid = index.uncompressedByteLength == levelSize &&
+            index.byteOffset <= ktxFile.dataLength && index.byteLength <= ktxFile.dataLength - index.byteOffset;
+        if (isValid && header.supercompressionScheme == Ktx2Header::NONE)
+        {
+            isValid = index.byteLength == levelSize;
+            if (isValid)
+            {
+                std::memcpy(levelData, ktxFile.dataBuffer + index.byteOffset, levelSize);
+            }
+        }
+#ifdef NEKO_ZSTD
+        else if (isValid)
+        {
+            const size_t decompressedSize = ZSTD_decompress(levelData, levelSize,
+                ktxFile.dataBuffer + index.byteOffset, index.byteLength);
+            isValid = !ZSTD_isError(decompressedSize) && decompressedSize == levelSize;
+        }
+#endif
+        if (!isValid)
+        {
+            logDebug(fmt::format("[Error] KTX2 file has an invalid mip level {}", level));
+            image.Destroy();
+        }
+    }
+    return image;
+}
+
+void TextureCooker::SetCacheFolder(std::string_view cacheFolder)
+{
+    cacheFolder_ = cacheFolder;
+    if (!cacheFolder_.empty() && !IsDirectory(cacheFolder_) && !CreateDirectory(cacheFolder_))
+    {
+        logDebug(fmt::format("[Error] Could not create texture cache folder: {}", cacheFolder_));
+        cacheFolder_.clear();
+    }
+}
+
+std::uint64_t TextureCooker::GetCookKey(const BufferFile& sourceFile, Texture::TextureFlags flags, MipFilter mipFilter)
+{
+    //Only the flags changing the cooked pixels are part of the key, the sampling ones are applied at upload
+    const std::uint64_t cookFlags = flags &
+        (Texture::MIPMAPS_TEXTURE | Texture::GAMMA_CORRECTION | Texture::FLIP_Y | Texture::HDR);
+    return Hash64(sourceFile.dataBuffer, sourceFile.dataLength,
+        (std::uint64_t(cookVersion) << 32u) | (std::uint64_t(mipFilter) << 16u) | cookFlags);
+}
+
+std::string TextureCooker::GetCookedPath(const BufferFile& sourceFile, Texture::TextureFlags flags) const
+{
+    if (!IsEnabled())
+    {
+        return "";
+    }
+    return fmt::format("{}/{:016x}{}", cacheFolder_, GetCookKey(sourceFile, flags, mipFilter_), cookedExtension);
+}
+
+Image TextureCooker::Cook(const BufferFile& sourceFile, Texture::TextureFlags flags,
+    std::vector<unsigned char>& cookedData) const
+{
+#ifdef EASY_PROFILE_USE
+    EASY_BLOCK("Cook Texture");
+#endif
+    cookedData.clear();
+    Image image = StbImageConvert(sourceFile, flags & Texture::FLIP_Y, flags & Texture::HDR);
+    if (image.data == nullptr)
+    {
+        return image;
+    }
+    const bool srgb = flags & Texture::GAMMA_CORRECTION;
+    if (flags & Texture::MIPMAPS_TEXTURE)
+    {
+        GenerateMipChain(image, srgb, mipFilter_);
+    }
+    cookedData = EncodeKtx2(image, srgb, supercompress_);
+    return image;
+}
+
+Image TextureCooker::Cook(const BufferFile& sourceFile, Texture::TextureFlags flags, std::string_view cookedPath) const
+{
+    std::vector<unsigned char> cookedData;
+    Image image = Cook(sourceFile, flags, cookedData);
+    if (!cookedPath.empty())
+    {
+        WriteCookedFile(cookedPath, cookedData);
+    }
+    return image;
+}
+
+bool TextureCooker::WriteCookedFile(std::string_view cookedPath, const std::vector<unsigned char>& cookedData)
+{
+#ifdef EASY_PROFILE_USE
+    EASY_BLOCK("Write Cooked Texture");
+#endif
+    if (cookedData.empty())
+    {
+        return false;
+    }
+    //Several loaders can cook the same content at once, the rename makes the cooked file appear whole
+    const std::string cookedFile(cookedPath);
+    const auto tmpPath = fmt::format("{}.{}.tmp", cookedFile, std::hash<std::thread::id>{}(std::this_thread::get_id()));
+    std::ofstream os(tmpPath, std::ofstream::binary | std::ofstream::trunc);
+    os.write(reinterpret_cast<const char*>(cookedData.data()), cookedData.size());
+    os.close();
+    if (!os || std::rename(tmpPath.c_str(), cookedFile.c_str()) != 0)
+    {
+        logDebug(fmt::format("[Error] Could not write cooked texture: {}", cookedFile));
+        std::remove(tmpPath.c_str());
+        return false;
+    }
+    logDebug(fmt::format("[Texture Cooker] Cooked texture into {}", cookedFile));
+    return true;
+}
+
+bool TextureCooker::CookFile(std::string_view sourcePath, Texture::TextureFlags flags) const
+{
+    BufferFile sourceFile;
+    sourceFile.Load(sourcePath);
+    if (sourceFile.dataBuffer == nullptr)
+    {
+        logDebug(fmt::format("[Error] Could not load texture: {} to cook", sourcePath));
+        return false;
+    }
+    const auto cookedPath = GetCookedPath(sourceFile, flags);
+    bool isCooked = FileExists(cookedPath);
+    if (!isCooked)
+    {
+        const Image image = Cook(sourceFile, flags, cookedPath);
+        isCooked = image.data != nullptr && FileExists(cookedPath);
+    }
+    sourceFile.Destroy();
+    return isCooked;
+}
+}
@@ -0,0 +1,215 @@
+/*
+ MIT License
+
+ Copyright (c) 2020 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#include "graphics/vertex_quantization.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "graphics/image_processing.h"
+
+#ifdef EASY_PROFILE_USE
+#include "easy/profiler.h"
+#endif
+
+namespace neko
+{
+namespace
+{
+constexpr float maxUnorm16 = 65535.0f;
+constexpr float maxSnorm16 = 32767.0f;
+
+std::int16_t ToSnorm16(float value)
+{
+    return static_cast<std::int16_t>(std::lround(std::clamp(value, -1.0f, 1.0f) * maxSnorm16));
+}
+
+//Same as the GL signed normalized conversion
+float FromSnorm16(std::int16_t value)
+{
+    return std::max(static_cast<float>(value) / maxSnorm16, -1.0f);
+}
+
+float SignNotZero(float value)
+{
+    return value >= 0.0f ? 1.0f : -1.0f;
+}
+
+float Angle(const Vec3f& a, const Vec3f& b)
+{
+    return std::acos(std::clamp(Vec3f::Dot(a.Normalized(), b.Normalized()), -1.0f, 1.0f));
+}
+
+bool IsZero(const Vec3f& v)
+{
+    return v.SquareMagnitude() <= std::numeric_limits<float>::epsilon();
+}
+}
+
+std::size_t QuantizedMesh::GetByteSize() const
+{
+    return vertices.size() * sizeof(QuantizedVertex) + shortIndices.size() * sizeof(std::uint16_t) +
+        indices.size() * sizeof(std::uint32_t);
+}
+
+std::array<std::int16_t, 2> EncodeOctahedral(const Vec3f& direction)
+{
+    //Projected on the octahedron, the lower half is folded over the diagonals
+    const float norm1 = std::abs(direction.x) + std::abs(direction.y) + std::abs(direction.z);
+    if (norm1 <= 0.0f)
+    {
+        return {0, 0};
+    }
+    float u = direction.x / norm1;
+    float v = direction.y / norm1;
+    if (direction.z < 0.0f)
+    {
+        const float foldedU = (1.0f - std::abs(v)) * SignNotZero(u);
+        v = (1.0f - std::abs(u)) * SignNotZero(v);
+        u = foldedU;
+    }
+    return {ToSnorm16(u), ToSnorm16(v)};
+}
+
+Vec3f DecodeOctahedral(const std::array<std::int16_t, 2>& octahedral)
+{
+    float u = FromSnorm16(octahedral[0]);
+    float v = FromSnorm16(octahedral[1]);
+    const float z = 1.0f - std::abs(u) - std::abs(v);
+    if (z < 0.0f)
+    {
+        const float unfoldedU = (1.0f - std::abs(v)) * SignNotZero(u);
+        v = (1.0f - std::abs(u)) * SignNotZero(v);
+        u = unfoldedU;
+    }
+    return Vec3f(u, v, z).Normalized();
+}
+
+void QuantizeMesh(const MeshVertex* vertices, std::size_t vertexCount, const std::uint32_t* indices,
+    std::size_t indexCount, QuantizedMesh& quantizedMesh)
+{
+#ifdef EASY_PROFILE_USE
+    EASY_BLOCK("Quantize Mesh");
+#endif
+    Vec3f aabbMin = vertexCount > 0 ? vertices[0].position : Vec3f::zero;
+    Vec3f aabbMax = aabbMin;
+    for (std::size_t i = 0; i < vertexCount; i++)
+    {
+        const auto& p = vertices[i].position;
+        aabbMin = Vec3f(std::min(aabbMin.x, p.x), std::min(aabbMin.y, p.y), std::min(aabbMin.z, p.z));
+        aabbMax = Vec3f(std::max(aabbMax.x, p.x), std::max(aabbMax.y, p.y), std::max(aabbMax.z, p.z));
+    }
+    quantizedMesh.positionOffset = aabbMin;
+    quantizedMesh.positionScale = aabbMax - aabbMin;
+    const auto& scale = quantizedMesh.positionScale;
+    const Vec3f inverseScale(scale.x > 0.0f ? maxUnorm16 / scale.x : 0.0f,
+        scale.y > 0.0f ? maxUnorm16 / scale.y : 0.0f,
+        scale.z > 0.0f ? maxUnorm16 / scale.z : 0.0f);
+
+    //The uvs are converted to half floats all at once
+    std::vector<float> texCoords(vertexCount * 2);
+    std::vector<std::uint16_t> halfTexCoords(vertexCount * 2);
+    for (std::size_t i = 0; i < vertexCount; i++)
+    {
+        texCoords[i * 2] = vertices[i].texCoords.x;
+        texCoords[i * 2 + 1] = vertices[i].texCoords.y;
+    }
+    ConvertFloatToHalf(texCoords.data(), halfTexCoords.data(), texCoords.size());
+
+    quantizedMesh.vertices.resize(vertexCount);
+    for (std::size_t i = 0; i < vertexCount; i++)
+    {
+        const auto& vertex = vertices[i];
+        auto& quantizedVertex = quantizedMesh.vertices[i];
+        const Vec3f position = vertex.position - aabbMin;
+        quantizedVertex.position[0] = static_cast<std::uint16_t>(std::lround(
+            std::clamp(position.x * inverseScale.x, 0.0f, maxUnorm16)));
+        quantizedVertex.position[1] = static_cast<std::uint16_t>(std::lround(
+            std::clamp(position.y * inverseScale.y, 0.0f, maxUnorm16)));
+        quantizedVertex.position[2] = static_cast<std::uint16_t>(std::lround(
+            std::clamp(position.z * inverseScale.z, 0.0f, maxUnorm16)));
+        const float bitangentSign = SignNotZero(
+            Vec3f::Dot(Vec3f::Cross(vertex.normal, vertex.tangent), vertex.bitangent));
+        quantizedVertex.position[3] = bitangentSign > 0.0f ? std::numeric_limits<std::uint16_t>::max() : 0;
+        quantizedVertex.normal = EncodeOctahedral(vertex.normal);
+        quantizedVertex.tangent = EncodeOctahedral(vertex.tangent);
+        quantizedVertex.texCoords = {halfTexCoords[i * 2], halfTexCoords[i * 2 + 1]};
+    }
+
+    quantizedMesh.shortIndices.clear();
+    quantizedMesh.indices.clear();
+    if (vertexCount <= std::size_t(std::numeric_limits<std::uint16_t>::max()) + 1)
+    {
+        quantizedMesh.shortIndices.assign(indices, indices + indexCount);
+    }
+    else
+    {
+        quantizedMesh.indices.assign(indices, indices + indexCount);
+    }
+}
+
+MeshVertex DequantizeVertex(const QuantizedVertex& vertex, const QuantizedMesh& quantizedMesh)
+{
+    MeshVertex meshVertex;
+    const auto& offset = quantizedMesh.positionOffset;
+    const auto& scale = quantizedMesh.positionScale;
+    meshVertex.position = Vec3f(
+        offset.x + static_cast<float>(vertex.position[0]) / maxUnorm16 * scale.x,
+        offset.y + static_cast<float>(vertex.position[1]) / maxUnorm16 * scale.y,
+        offset.z + static_cast<float>(vertex.position[2]) / maxUnorm16 * scale.z);
+    meshVertex.normal = DecodeOctahedral(vertex.normal);
+    meshVertex.tangent = DecodeOctahedral(vertex.tangent);
+    const float bitangentSign = vertex.position[3] > 0 ? 1.0f : -1.0f;
+    meshVertex.bitangent = Vec3f::Cross(meshVertex.normal, meshVertex.tangent) * bitangentSign;
+    std::array<float, 2> texCoords{};
+    ConvertHalfToFloat(vertex.texCoords.data(), texCoords.data(), texCoords.size());
+    meshVertex.texCoords = Vec2f(texCoords[0], texCoords[1]);
+    return meshVertex;
+}
+
+QuantizationError MeasureQuantizationError(const MeshVertex* vertices, const QuantizedMesh& quantizedMesh)
+{
+    QuantizationError error;
+    for (std::size_t i = 0; i < quantizedMesh.vertices.size(); i++)
+    {
+        const auto& vertex = vertices[i];
+        const auto decoded = DequantizeVertex(quantizedMesh.vertices[i], quantizedMesh);
+        error.position = std::max(error.position, (decoded.position - vertex.position).Magnitude());
+        error.texCoords = std::max({error.texCoords, std::abs(decoded.texCoords.x - vertex.texCoords.x),
+            std::abs(decoded.texCoords.y - vertex.texCoords.y)});
+        if (!IsZero(vertex.normal))
+        {
+            error.normalAngle = std::max(error.normalAngle, Angle(decoded.normal, vertex.normal));
+        }
+        if (!IsZero(vertex.tangent))
+        {
+            error.tangentAngle = std::max(error.tangentAngle, Angle(decoded.tangent, vertex.tangent));
+        }
+        if (!IsZero(vertex.bitangent) && !IsZero(decoded.bitangent))
+        {
+            error.bitangentAngle = std::max(error.bitangentAngle, Angle(decoded.bitangent, vertex.bitangent));
+        }
+    }
+    return error;
+}
+}
@@ -0,0 +1,346 @@
+/*
+ MIT License
+
+ Copyright (c) 2020 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+
+#include <algorithm>
+#include <limits>
+
+#include "mathematics/aabb.h"
+
+namespace neko
+{
+/**
+ * \brief Lane helpers of the batch kernels, named so that the unity build batches can use the same names
+ */
+namespace aabb_simd
+{
+namespace
+{
+//Arrays are padded to the widest vector width so every kernel can load full lanes
+constexpr std::size_t paddingCount = 16;
+
+#if defined(__AVX512F__)
+constexpr std::size_t laneCount = 16;
+using Lane = __m512;
+using LaneMask = __mmask16;
+inline Lane Load(const float* p) { return _mm512_loadu_ps(p); }
+inline Lane Set1(float v) { return _mm512_set1_ps(v); }
+inline Lane Add(Lane a, Lane b) { return _mm512_add_ps(a, b); }
+inline Lane Sub(Lane a, Lane b) { return _mm512_sub_ps(a, b); }
+inline Lane Mul(Lane a, Lane b) { return _mm512_mul_ps(a, b); }
+inline Lane Min(Lane a, Lane b) { return _mm512_min_ps(a, b); }
+inline Lane Max(Lane a, Lane b) { return _mm512_max_ps(a, b); }
+inline LaneMask LessEqual(Lane a, Lane b) { return _mm512_cmp_ps_mask(a, b, _CMP_LE_OQ); }
+inline LaneMask And(LaneMask a, LaneMask b) { return a & b; }
+inline std::uint64_t ToBits(LaneMask m) { return m; }
+#elif defined(__AVX2__)
+constexpr std::size_t laneCount = 8;
+using Lane = __m256;
+using LaneMask = __m256;
+inline Lane Load(const float* p) { return _mm256_loadu_ps(p); }
+inline Lane Set1(float v) { return _mm256_set1_ps(v); }
+inline Lane Add(Lane a, Lane b) { return _mm256_add_ps(a, b); }
+inline Lane Sub(Lane a, Lane b) { return _mm256_sub_ps(a, b); }
+inline Lane Mul(Lane a, Lane b) { return _mm256_mul_ps(a, b); }
+inline Lane Min(Lane a, Lane b) { return _mm256_min_ps(a, b); }
+inline Lane Max(Lane a, Lane b) { return _mm256_max_ps(a, b); }
+inline LaneMask LessEqual(Lane a, Lane b) { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+inline LaneMask And(LaneMask a, LaneMask b) { return _mm256_and_ps(a, b); }
+inline std::uint64_t ToBits(LaneMask m) { return static_cast<std::uint32_t>(_mm256_movemask_ps(m)); }
+#elif defined(__SSE__)
+constexpr std::size_t laneCount = 4;
+using Lane = __m128;
+using LaneMask = __m128;
+inline Lane Load(const float* p) { return _mm_loadu_ps(p); }
+inline Lane Set1(float v) { return _mm_set1_ps(v); }
+inline Lane Add(Lane a, Lane b) { return _mm_add_ps(a, b); }
+inline Lane Sub(Lane a, Lane b) { return _mm_sub_ps(a, b); }
+inline Lane Mul(Lane a, Lane b) { return _mm_mul_ps(a, b); }
+inline Lane Min(Lane a, Lane b) { return _mm_min_ps(a, b); }
+inline Lane Max(Lane a, Lane b) { return _mm_max_ps(a, b); }
+inline LaneMask LessEqual(Lane a, Lane b) { return _mm_cmple_ps(a, b); }
+inline LaneMask And(LaneMask a, LaneMask b) { return _mm_and_ps(a, b); }
+inline std::uint64_t ToBits(LaneMask m) { return static_cast<std::uint32_t>(_mm_movemask_ps(m)); }
+#else
+constexpr std::size_t laneCount = 1;
+using Lane = float;
+using LaneMask = bool;
+inline Lane Load(const float* p) { return *p; }
+inline Lane Set1(float v) { return v; }
+inline Lane Add(Lane a, Lane b) { return a + b; }
+inline Lane Sub(Lane a, Lane b) { return a - b; }
+inline Lane Mul(Lane a, Lane b) { return a * b; }
+inline Lane Min(Lane a, Lane b) { return std::min(a, b); }
+inline Lane Max(Lane a, Lane b) { return std::max(a, b); }
+inline LaneMask LessEqual(Lane a, Lane b) { return a <= b; }
+inline LaneMask And(LaneMask a, LaneMask b) { return a && b; }
+inline std::uint64_t ToBits(LaneMask m) { return m ? 1u : 0u; }
+#endif
+
+static_assert(64 % laneCount == 0 && paddingCount % laneCount == 0, "Lanes must not straddle two bitmask words");
+
+std::size_t PaddedSize(std::size_t size)
+{
+    return (size + paddingCount - 1) / paddingCount * paddingCount;
+}
+
+void ResetBitmask(AabbBitmask& result, std::size_t size)
+{
+    result.assign((size + 63) / 64, 0);
+}
+
+void WriteBits(AabbBitmask& result, std::size_t index, std::uint64_t bits, std::size_t size)
+{
+    if (index + laneCount > size)
+    {
+        //Padding boxes are never reported
+        bits &= (std::uint64_t(1) << (size - index)) - 1;
+    }
+    result[index / 64] |= bits << (index % 64);
+}
+
+/**
+ * \brief Slab test on one axis, narrowing [tMin, tMax] with the entry and exit distances
+ */
+inline void RaySlab(Lane lower, Lane upper, Lane origin, Lane invDir, Lane& tMin, Lane& tMax)
+{
+    const Lane t1 = Mul(Sub(lower, origin), invDir);
+    const Lane t2 = Mul(Sub(upper, origin), invDir);
+    tMin = Max(tMin, Min(t1, t2));
+    tMax = Min(tMax, Max(t1, t2));
+}
+}
+}
+
+//-----------------------------------------------------------------------------
+// AabbSoA2d
+//-----------------------------------------------------------------------------
+void AabbSoA2d::Reserve(std::size_t capacity)
+{
+    const std::size_t padded = aabb_simd::PaddedSize(capacity);
+    lowerXs.reserve(padded);
+    lowerYs.reserve(padded);
+    upperXs.reserve(padded);
+    upperYs.reserve(padded);
+}
+
+void AabbSoA2d::Clear()
+{
+    lowerXs.clear();
+    lowerYs.clear();
+    upperXs.clear();
+    upperYs.clear();
+    size_ = 0;
+}
+
+void AabbSoA2d::PushBack(const Aabb2d& aabb)
+{
+    const std::size_t padded = aabb_simd::PaddedSize(size_ + 1);
+    if (padded != lowerXs.size())
+    {
+        lowerXs.resize(padded, 0.0f);
+        lowerYs.resize(padded, 0.0f);
+        upperXs.resize(padded, 0.0f);
+        upperYs.resize(padded, 0.0f);
+    }
+    Set(size_++, aabb);
+}
+
+void AabbSoA2d::Set(std::size_t index, const Aabb2d& aabb)
+{
+    lowerXs[index] = aabb.lowerLeftBound.x;
+    lowerYs[index] = aabb.lowerLeftBound.y;
+    upperXs[index] = aabb.upperRightBound.x;
+    upperYs[index] = aabb.upperRightBound.y;
+}
+
+Aabb2d AabbSoA2d::Get(std::size_t index) const
+{
+    Aabb2d aabb;
+    aabb.lowerLeftBound = Vec2f(lowerXs[index], lowerYs[index]);
+    aabb.upperRightBound = Vec2f(upperXs[index], upperYs[index]);
+    return aabb;
+}
+
+void AabbSoA2d::IntersectAabb(const Aabb2d& aabb, AabbBitmask& result) const
+{
+    using namespace aabb_simd;
+    ResetBitmask(result, size_);
+    const Lane lowerX = Set1(aabb.lowerLeftBound.x);
+    const Lane lowerY = Set1(aabb.lowerLeftBound.y);
+    const Lane upperX = Set1(aabb.upperRightBound.x);
+    const Lane upperY = Set1(aabb.upperRightBound.y);
+    for (std::size_t i = 0; i < size_; i += laneCount)
+    {
+        LaneMask mask = And(LessEqual(Load(&lowerXs[i]), upperX), LessEqual(lowerX, Load(&upperXs[i])));
+        mask = And(mask, And(LessEqual(Load(&lowerYs[i]), upperY), LessEqual(lowerY, Load(&upperYs[i]))));
+        WriteBits(result, i, ToBits(mask), size_);
+    }
+}
+
+void AabbSoA2d::IntersectRay(const Vec2f& dirRay, const Vec2f& origin, AabbBitmask& result) const
+{
+    using namespace aabb_simd;
+    neko_assert(Vec2f(0, 0) != dirRay, "Null Ray Direction");
+    ResetBitmask(result, size_);
+    const Lane originX = Set1(origin.x);
+    const Lane originY = Set1(origin.y);
+    const Lane invDirX = Set1(1.0f / dirRay.x);
+    const Lane invDirY = Set1(1.0f / dirRay.y);
+    const Lane zero = Set1(0.0f);
+    for (std::size_t i = 0; i < size_; i += laneCount)
+    {
+        Lane tMin = Set1(-std::numeric_limits<float>::infinity());
+        Lane tMax = Set1(std::numeric_limits<float>::infinity());
+        RaySlab(Load(&lowerXs[i]), Load(&upperXs[i]), originX, invDirX, tMin, tMax);
+        RaySlab(Load(&lowerYs[i]), Load(&upperYs[i]), originY, invDirY, tMin, tMax);
+        //Boxes behind the origin are rejected, boxes containing it have tMin <= 0 <= tMax
+        WriteBits(result, i, ToBits(And(LessEqual(zero, tMax), LessEqual(tMin, tMax))), size_);
+    }
+}
+
+//-----------------------------------------------------------------------------
+// AabbSoA3d
+//-----------------------------------------------------------------------------
+void AabbSoA3d::Reserve(std::size_t capacity)
+{
+    const std::size_t padded = aabb_simd::PaddedSize(capacity);
+    lowerXs.reserve(padded);
+    lowerYs.reserve(padded);
+    lowerZs.reserve(padded);
+    upperXs.reserve(padded);
+    upperYs.reserve(padded);
+    upperZs.reserve(padded);
+}
+
+void AabbSoA3d::Clear()
+{
+    lowerXs.clear();
+    lowerYs.clear();
+    lowerZs.clear();
+    upperXs.clear();
+    upperYs.clear();
+    upperZs.clear();
+    size_ = 0;
+}
+
+void AabbSoA3d::PushBack(const Aabb3d& aabb)
+{
+    const std::size_t padded = aabb_simd::PaddedSize(size_ + 1);
+    if (padded != lowerXs.size())
+    {
+        lowerXs.resize(padded, 0.0f);
+        lowerYs.resize(padded, 0.0f);
+        lowerZs.resize(padded, 0.0f);
+        upperXs.resize(padded, 0.0f);
+        upperYs.resize(padded, 0.0f);
+        upperZs.resize(padded, 0.0f);
+    }
+    Set(size_++, aabb);
+}
+
+void AabbSoA3d::Set(std::size_t index, const Aabb3d& aabb)
+{
+    lowerXs[index] = aabb.lowerLeftBound.x;
+    lowerYs[index] = aabb.lowerLeftBound.y;
+    lowerZs[index] = aabb.lowerLeftBound.z;
+    upperXs[index] = aabb.upperRightBound.x;
+    upperYs[index] = aabb.upperRightBound.y;
+    upperZs[index] = aabb.upperRightBound.z;
+}
+
+Aabb3d AabbSoA3d::Get(std::size_t index) const
+{
+    Aabb3d aabb;
+    aabb.lowerLeftBound = Vec3f(lowerXs[index], lowerYs[index], lowerZs[index]);
+    aabb.upperRightBound = Vec3f(upperXs[index], upperYs[index], upperZs[index]);
+    return aabb;
+}
+
+void AabbSoA3d::IntersectAabb(const Aabb3d& aabb, AabbBitmask& result) const
+{
+    using namespace aabb_simd;
+    ResetBitmask(result, size_);
+    const Lane lowerX = Set1(aabb.lowerLeftBound.x);
+    const Lane lowerY = Set1(aabb.lowerLeftBound.y);
+    const Lane lowerZ = Set1(aabb.lowerLeftBound.z);
+    const Lane upperX = Set1(aabb.upperRightBound.x);
+    const Lane upperY = Set1(aabb.upperRightBound.y);
+    const Lane upperZ = Set1(aabb.upperRightBound.z);
+    for (std::size_t i = 0; i < size_; i += laneCount)
+    {
+        LaneMask mask = And(LessEqual(Load(&lowerXs[i]), upperX), LessEqual(lowerX, Load(&upperXs[i])));
+        mask = And(mask, And(LessEqual(Load(&lowerYs[i]), upperY), LessEqual(lowerY, Load(&upperYs[i]))));
+        mask = And(mask, And(LessEqual(Load(&lowerZs[i]), upperZ), LessEqual(lowerZ, Load(&upperZs[i]))));
+        WriteBits(result, i, ToBits(mask), size_);
+    }
+}
+
+void AabbSoA3d::IntersectRay(const Vec3f& dirRay, const Vec3f& origin, AabbBitmask& result) const
+{
+    using namespace aabb_simd;
+    neko_assert(Vec3f(0, 0, 0) != dirRay, "Null Ray Direction");
+    ResetBitmask(result, size_);
+    const Lane originX = Set1(origin.x);
+    const Lane originY = Set1(origin.y);
+    const Lane originZ = Set1(origin.z);
+    const Lane invDirX = Set1(1.0f / dirRay.x);
+    const Lane invDirY = Set1(1.0f / dirRay.y);
+    const Lane invDirZ = Set1(1.0f / dirRay.z);
+    const Lane zero = Set1(0.0f);
+    for (std::size_t i = 0; i < size_; i += laneCount)
+    {
+        Lane tMin = Set1(-std::numeric_limits<float>::infinity());
+        Lane tMax = Set1(std::numeric_limits<float>::infinity());
+        RaySlab(Load(&lowerXs[i]), Load(&upperXs[i]), originX, invDirX, tMin, tMax);
+        RaySlab(Load(&lowerYs[i]), Load(&upperYs[i]), originY, invDirY, tMin, tMax);
+        RaySlab(Load(&lowerZs[i]), Load(&upperZs[i]), originZ, invDirZ, tMin, tMax);
+        WriteBits(result, i, ToBits(And(LessEqual(zero, tMax), LessEqual(tMin, tMax))), size_);
+    }
+}
+
+void AabbSoA3d::IntersectFrustum(const Vec4f* planes, std::size_t planeCount, AabbBitmask& result) const
+{
+    using namespace aabb_simd;
+    ResetBitmask(result, size_);
+    const Lane zero = Set1(0.0f);
+    for (std::size_t i = 0; i < size_; i += laneCount)
+    {
+        std::uint64_t bits = ~std::uint64_t(0);
+        for (std::size_t p = 0; p < planeCount && bits != 0; p++)
+        {
+            const Vec4f& plane = planes[p];
+            //Only the corner furthest along the normal needs to be tested
+            const Lane x = Load(plane.x >= 0.0f ? &upperXs[i] : &lowerXs[i]);
+            const Lane y = Load(plane.y >= 0.0f ? &upperYs[i] : &lowerYs[i]);
+            const Lane z = Load(plane.z >= 0.0f ? &upperZs[i] : &lowerZs[i]);
+            const Lane distance = Add(
+                Add(Mul(x, Set1(plane.x)), Mul(y, Set1(plane.y))),
+                Add(Mul(z, Set1(plane.z)), Set1(plane.w)));
+            bits &= ToBits(LessEqual(zero, distance));
+        }
+        WriteBits(result, i, bits & ((std::uint64_t(1) << laneCount) - 1), size_);
+    }
+}
+}
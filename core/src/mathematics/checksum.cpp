@@ -0,0 +1,331 @@
+/*
+ MIT License
+
+ Copyright (c) 2020 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+#include "engine/assert.h"
+#include "engine/intrinsincs.h"
+#include "mathematics/checksum.h"
+
+#if defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#endif
+
+namespace neko
+{
+namespace
+{
+std::uint64_t Read64(const std::uint8_t* data)
+{
+    std::uint64_t value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+constexpr std::array<std::uint32_t, 256> GenerateCrc32cTable()
+{
+    //Reflected Castagnoli polynomial
+    constexpr std::uint32_t polynomial = 0x82F63B78u;
+    std::array<std::uint32_t, 256> table{};
+    for (std::uint32_t i = 0; i < 256; i++)
+    {
+        std::uint32_t crc = i;
+        for (int bit = 0; bit < 8; bit++)
+        {
+            crc = (crc & 1u) ? (crc >> 1u) ^ polynomial : crc >> 1u;
+        }
+        table[i] = crc;
+    }
+    return table;
+}
+
+constexpr auto crc32cTable = GenerateCrc32cTable();
+
+constexpr std::uint64_t prime32_1 = 0x9E3779B1u;
+constexpr std::uint64_t prime32_2 = 0x85EBCA77u;
+constexpr std::uint64_t prime32_3 = 0xC2B2AE3Du;
+constexpr std::uint64_t prime64_1 = 0x9E3779B185EBCA87ull;
+constexpr std::uint64_t prime64_2 = 0xC2B2AE3D27D4EB4Full;
+constexpr std::uint64_t prime64_3 = 0x165667B19E3779F9ull;
+constexpr std::uint64_t prime64_4 = 0x85EBCA77C2B2AE63ull;
+constexpr std::uint64_t prime64_5 = 0x27D4EB2F165667C5ull;
+
+constexpr std::size_t hashLaneCount = 8;
+constexpr std::size_t stripeSize = hashLaneCount * sizeof(std::uint64_t);
+constexpr std::size_t stripesPerBlock = 16;
+constexpr std::size_t secretSize = 24;
+//Each stripe of a block uses the secret shifted by one lane, the scramble uses the last lanes
+constexpr std::size_t scrambleOffset = secretSize - hashLaneCount;
+constexpr std::size_t lastStripeOffset = scrambleOffset - 1;
+
+using Secret = std::array<std::uint64_t, secretSize>;
+using Accumulator = std::array<std::uint64_t, hashLaneCount>;
+
+constexpr Secret GenerateSecret()
+{
+    //splitmix64 sequence
+    Secret secret{};
+    std::uint64_t state = prime64_5;
+    for (auto& value : secret)
+    {
+        state += 0x9E3779B97F4A7C15ull;
+        std::uint64_t z = state;
+        z = (z ^ (z >> 30u)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27u)) * 0x94D049BB133111EBull;
+        value = z ^ (z >> 31u);
+    }
+    return secret;
+}
+
+constexpr Secret defaultSecret = GenerateSecret();
+
+std::uint64_t Mul128Fold64(std::uint64_t lhs, std::uint64_t rhs)
+{
+#if defined(__SIZEOF_INT128__)
+    const auto product = static_cast<unsigned __int128>(lhs) * rhs;
+    return static_cast<std::uint64_t>(product) ^ static_cast<std::uint64_t>(product >> 64u);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    std::uint64_t high;
+    const std::uint64_t low = _umul128(lhs, rhs, &high);
+    return low ^ high;
+#else
+    const std::uint64_t loLo = (lhs & 0xFFFFFFFFu) * (rhs & 0xFFFFFFFFu);
+    const std::uint64_t hiLo = (lhs >> 32u) * (rhs & 0xFFFFFFFFu);
+    const std::uint64_t loHi = (lhs & 0xFFFFFFFFu) * (rhs >> 32u);
+    const std::uint64_t hiHi = (lhs >> 32u) * (rhs >> 32u);
+    const std::uint64_t cross = (loLo >> 32u) + (hiLo & 0xFFFFFFFFu) + loHi;
+    const std::uint64_t high = (hiLo >> 32u) + (cross >> 32u) + hiHi;
+    const std::uint64_t low = (cross << 32u) | (loLo & 0xFFFFFFFFu);
+    return low ^ high;
+#endif
+}
+
+std::uint64_t Avalanche(std::uint64_t h)
+{
+    h ^= h >> 37u;
+    h *= 0x165667919E3779F9ull;
+    h ^= h >> 32u;
+    return h;
+}
+
+#if defined(__AVX2__)
+/**
+ * \brief Same arithmetic as the scalar accumulation, four lanes per register
+ */
+void AccumulateStripes(Accumulator& acc, const std::uint8_t* data, std::size_t stripeCount, const std::uint64_t* secret)
+{
+    __m256i acc0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(acc.data()));
+    __m256i acc1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(acc.data() + 4));
+    for (std::size_t n = 0; n < stripeCount; n++)
+    {
+        const std::uint8_t* stripe = data + n * stripeSize;
+        const std::uint64_t* key = secret + n;
+        const __m256i data0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(stripe));
+        const __m256i data1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(stripe + 32));
+        const __m256i dataKey0 = _mm256_xor_si256(data0, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(key)));
+        const __m256i dataKey1 = _mm256_xor_si256(data1, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(key + 4)));
+        //low 32 bits * high 32 bits of every lane
+        const __m256i product0 = _mm256_mul_epu32(dataKey0, _mm256_shuffle_epi32(dataKey0, _MM_SHUFFLE(0, 3, 0, 1)));
+        const __m256i product1 = _mm256_mul_epu32(dataKey1, _mm256_shuffle_epi32(dataKey1, _MM_SHUFFLE(0, 3, 0, 1)));
+        //The data is also added to the neighbour lane
+        acc0 = _mm256_add_epi64(acc0, _mm256_add_epi64(product0, _mm256_shuffle_epi32(data0, _MM_SHUFFLE(1, 0, 3, 2))));
+        acc1 = _mm256_add_epi64(acc1, _mm256_add_epi64(product1, _mm256_shuffle_epi32(data1, _MM_SHUFFLE(1, 0, 3, 2))));
+    }
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(acc.data()), acc0);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(acc.data() + 4), acc1);
+}
+
+void ScrambleAccumulator(Accumulator& acc, const std::uint64_t* secret)
+{
+    const __m256i prime = _mm256_set1_epi64x(static_cast<long long>(prime32_1));
+    for (std::size_t i = 0; i < hashLaneCount; i += 4)
+    {
+        __m256i value = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(acc.data() + i));
+        value = _mm256_xor_si256(value, _mm256_srli_epi64(value, 47));
+        value = _mm256_xor_si256(value, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(secret + i)));
+        //64 bits multiplication by a 32 bits prime
+        const __m256i productLow = _mm256_mul_epu32(value, prime);
+        const __m256i productHigh = _mm256_mul_epu32(_mm256_srli_epi64(value, 32), prime);
+        value = _mm256_add_epi64(productLow, _mm256_slli_epi64(productHigh, 32));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(acc.data() + i), value);
+    }
+}
+#else
+void AccumulateStripes(Accumulator& acc, const std::uint8_t* data, std::size_t stripeCount, const std::uint64_t* secret)
+{
+    for (std::size_t n = 0; n < stripeCount; n++)
+    {
+        const std::uint8_t* stripe = data + n * stripeSize;
+        const std::uint64_t* key = secret + n;
+        for (std::size_t i = 0; i < hashLaneCount; i++)
+        {
+            const std::uint64_t dataValue = Read64(stripe + i * sizeof(std::uint64_t));
+            const std::uint64_t dataKey = dataValue ^ key[i];
+            acc[i ^ 1u] += dataValue;
+            acc[i] += (dataKey & 0xFFFFFFFFu) * (dataKey >> 32u);
+        }
+    }
+}
+
+void ScrambleAccumulator(Accumulator& acc, const std::uint64_t* secret)
+{
+    for (std::size_t i = 0; i < hashLaneCount; i++)
+    {
+        std::uint64_t value = acc[i];
+        value ^= value >> 47u;
+        value ^= secret[i];
+        acc[i] = value * prime32_1;
+    }
+}
+#endif
+}
+
+std::uint32_t Crc32c(const void* data, std::size_t size, std::uint32_t crc)
+{
+    const auto* bytes = static_cast<const std::uint8_t*>(data);
+    crc = ~crc;
+#if defined(__SSE4_2__) && (defined(__x86_64__) || defined(_M_X64))
+    std::uint64_t crc64 = crc;
+    for (; size >= sizeof(std::uint64_t); size -= sizeof(std::uint64_t), bytes += sizeof(std::uint64_t))
+    {
+        crc64 = _mm_crc32_u64(crc64, Read64(bytes));
+    }
+    crc = static_cast<std::uint32_t>(crc64);
+    for (; size > 0; size--, bytes++)
+    {
+        crc = _mm_crc32_u8(crc, *bytes);
+    }
+#elif defined(__ARM_FEATURE_CRC32)
+    for (; size >= sizeof(std::uint64_t); size -= sizeof(std::uint64_t), bytes += sizeof(std::uint64_t))
+    {
+        crc = __crc32cd(crc, Read64(bytes));
+    }
+    for (; size > 0; size--, bytes++)
+    {
+        crc = __crc32cb(crc, *bytes);
+    }
+#else
+    for (; size > 0; size--, bytes++)
+    {
+        crc = crc32cTable[(crc ^ *bytes) & 0xFFu] ^ (crc >> 8u);
+    }
+#endif
+    return ~crc;
+}
+
+std::uint64_t Hash64(const void* data, std::size_t size, std::uint64_t seed)
+{
+    Secret secret = defaultSecret;
+    if (seed != 0)
+    {
+        for (std::size_t i = 0; i < secretSize; i += 2)
+        {
+            secret[i] += seed;
+            secret[i + 1] -= seed;
+        }
+    }
+    Accumulator acc{ prime32_3, prime64_1, prime64_2, prime64_3, prime64_4, prime32_2, prime64_5, prime32_1 };
+
+    const auto* bytes = static_cast<const std::uint8_t*>(data);
+    const std::size_t blockSize = stripeSize * stripesPerBlock;
+    const std::size_t blockCount = size / blockSize;
+    for (std::size_t block = 0; block < blockCount; block++)
+    {
+        AccumulateStripes(acc, bytes + block * blockSize, stripesPerBlock, secret.data());
+        ScrambleAccumulator(acc, secret.data() + scrambleOffset);
+    }
+    const std::uint8_t* remaining = bytes + blockCount * blockSize;
+    const std::size_t remainingSize = size - blockCount * blockSize;
+    const std::size_t stripeCount = remainingSize / stripeSize;
+    AccumulateStripes(acc, remaining, stripeCount, secret.data());
+    const std::size_t tailSize = remainingSize - stripeCount * stripeSize;
+    if (tailSize > 0)
+    {
+        //The last partial stripe is padded with zeros, the length is mixed in below
+        std::array<std::uint8_t, stripeSize> lastStripe{};
+        std::memcpy(lastStripe.data(), remaining + stripeCount * stripeSize, tailSize);
+        AccumulateStripes(acc, lastStripe.data(), 1, secret.data() + lastStripeOffset);
+    }
+
+    std::uint64_t result = static_cast<std::uint64_t>(size) * prime64_1;
+    for (std::size_t i = 0; i < hashLaneCount; i += 2)
+    {
+        result += Mul128Fold64(acc[i] ^ secret[i + 1], acc[i + 1] ^ secret[i + 2]);
+    }
+    return Avalanche(result);
+}
+
+ChunkedChecksum::ChunkedChecksum(std::size_t chunkSize) :
+    chunkSize_(chunkSize != 0 ? chunkSize : defaultChunkSize)
+{
+    neko_assert(chunkSize != 0, "ChunkedChecksum cannot have empty chunks")
+}
+
+void ChunkedChecksum::SetDirty(std::size_t offset, std::size_t size)
+{
+    if (size == 0)
+        return;
+    const std::size_t firstChunk = offset / chunkSize_;
+    const std::size_t lastChunk = (offset + size - 1) / chunkSize_;
+    if (dirtyChunks_.size() <= lastChunk)
+    {
+        dirtyChunks_.resize(lastChunk + 1, true);
+    }
+    std::fill(dirtyChunks_.begin() + firstChunk, dirtyChunks_.begin() + lastChunk + 1, true);
+}
+
+void ChunkedChecksum::SetAllDirty()
+{
+    allDirty_ = true;
+}
+
+std::uint64_t ChunkedChecksum::Update(const void* data, std::size_t size)
+{
+    const auto* bytes = static_cast<const std::uint8_t*>(data);
+    const std::size_t chunkCount = (size + chunkSize_ - 1) / chunkSize_;
+    chunkHashes_.resize(chunkCount, 0);
+    dirtyChunks_.resize(std::max(dirtyChunks_.size(), chunkCount), true);
+    if (size != size_)
+    {
+        //The last chunk of the previous size might have been partial
+        const std::size_t firstChanged = std::min(std::min(size, size_) / chunkSize_, dirtyChunks_.size());
+        std::fill(dirtyChunks_.begin() + firstChanged, dirtyChunks_.end(), true);
+        size_ = size;
+    }
+    for (std::size_t i = 0; i < chunkCount; i++)
+    {
+        if (!allDirty_ && !dirtyChunks_[i])
+            continue;
+        const std::size_t offset = i * chunkSize_;
+        chunkHashes_[i] = Hash64(bytes + offset, std::min(chunkSize_, size - offset));
+        dirtyChunks_[i] = false;
+    }
+    allDirty_ = false;
+    hash_ = Hash64(chunkHashes_.data(), chunkHashes_.size() * sizeof(std::uint64_t), size);
+    return hash_;
+}
+}
@@ -0,0 +1,744 @@
+/*
+ MIT License
+
+ Copyright (c) 2020 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#include <atomic>
+#include <cstring>
+
+#include "mathematics/matrix_batch.h"
+
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define NEKO_BATCH_X86
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define NEKO_TARGET(isa) __attribute__((target(isa)))
+#else
+//MSVC allows any intrinsics without changing the architecture flags
+#define NEKO_TARGET(isa)
+#endif
+
+namespace neko
+{
+namespace
+{
+struct Mat4BatchKernels
+{
+	SimdLevel level;
+	void (*multiply)(const Mat4f* lhs, const Mat4f* rhs, Mat4f* result, std::size_t count);
+	void (*transformVec4)(const Mat4f& transform, const Vec4f* points, Vec4f* result, std::size_t count);
+	void (*transformVec3)(const Mat4f& transform, const Vec3f* points, Vec3f* result, std::size_t count);
+	void (*composeTrs)(const TrsSoA& trs, Mat4f* result, std::size_t count);
+};
+
+inline const float* Data(const Mat4f& m)
+{
+	return &m[0][0];
+}
+
+inline float* Data(Mat4f& m)
+{
+	return &m[0][0];
+}
+
+void MultiplyScalar(const Mat4f* lhs, const Mat4f* rhs, Mat4f* result, std::size_t count)
+{
+	for (std::size_t i = 0; i < count; i++)
+	{
+		const float* a = Data(lhs[i]);
+		const float* b = Data(rhs[i]);
+		float v[16];
+		for (int column = 0; column < 4; column++)
+		{
+			for (int row = 0; row < 4; row++)
+			{
+				v[column * 4 + row] =
+					a[row] * b[column * 4] +
+					a[4 + row] * b[column * 4 + 1] +
+					a[8 + row] * b[column * 4 + 2] +
+					a[12 + row] * b[column * 4 + 3];
+			}
+		}
+		std::memcpy(Data(result[i]), v, sizeof(v));
+	}
+}
+
+void TransformVec4Scalar(const Mat4f& transform, const Vec4f* points, Vec4f* result, std::size_t count)
+{
+	const float* m = Data(transform);
+	for (std::size_t i = 0; i < count; i++)
+	{
+		const Vec4f p = points[i];
+		for (int row = 0; row < 4; row++)
+		{
+			result[i][row] = m[row] * p.x + m[4 + row] * p.y + m[8 + row] * p.z + m[12 + row] * p.w;
+		}
+	}
+}
+
+void TransformVec3Scalar(const Mat4f& transform, const Vec3f* points, Vec3f* result, std::size_t count)
+{
+	const float* m = Data(transform);
+	for (std::size_t i = 0; i < count; i++)
+	{
+		const Vec3f p = points[i];
+		for (int row = 0; row < 3; row++)
+		{
+			result[i][row] = m[row] * p.x + m[4 + row] * p.y + m[8 + row] * p.z + m[12 + row];
+		}
+	}
+}
+
+void ComposeTrsRange(const TrsSoA& trs, Mat4f* result, std::size_t begin, std::size_t end)
+{
+	for (std::size_t i = begin; i < end; i++)
+	{
+		const float x = trs.rotationX[i];
+		const float y = trs.rotationY[i];
+		const float z = trs.rotationZ[i];
+		const float w = trs.rotationW[i];
+		const float xx = x * x, yy = y * y, zz = z * z;
+		const float xy = x * y, xz = x * z, yz = y * z;
+		const float wx = w * x, wy = w * y, wz = w * z;
+		const float sx = trs.scaleX[i];
+		const float sy = trs.scaleY[i];
+		const float sz = trs.scaleZ[i];
+		float* m = Data(result[i]);
+		m[0] = (1.0f - 2.0f * (yy + zz)) * sx;
+		m[1] = 2.0f * (xy + wz) * sx;
+		m[2] = 2.0f * (xz - wy) * sx;
+		m[3] = 0.0f;
+		m[4] = 2.0f * (xy - wz) * sy;
+		m[5] = (1.0f - 2.0f * (xx + zz)) * sy;
+		m[6] = 2.0f * (yz + wx) * sy;
+		m[7] = 0.0f;
+		m[8] = 2.0f * (xz + wy) * sz;
+		m[9] = 2.0f * (yz - wx) * sz;
+		m[10] = (1.0f - 2.0f * (xx + yy)) * sz;
+		m[11] = 0.0f;
+		m[12] = trs.positionX[i];
+		m[13] = trs.positionY[i];
+		m[14] = trs.positionZ[i];
+		m[15] = 1.0f;
+	}
+}
+
+void ComposeTrsScalar(const TrsSoA& trs, Mat4f* result, std::size_t count)
+{
+	ComposeTrsRange(trs, result, 0, count);
+}
+
+constexpr Mat4BatchKernels scalarKernels{
+	SimdLevel::SCALAR, MultiplyScalar, TransformVec4Scalar, TransformVec3Scalar, ComposeTrsScalar };
+
+#if defined(NEKO_BATCH_X86)
+
+/**
+ * \brief Transposes the rows of four entities and stores them as the given column of each matrix
+ */
+inline void StoreColumn(__m128 x, __m128 y, __m128 z, __m128 w, Mat4f* result, int column)
+{
+	_MM_TRANSPOSE4_PS(x, y, z, w);
+	_mm_store_ps(Data(result[0]) + column * 4, x);
+	_mm_store_ps(Data(result[1]) + column * 4, y);
+	_mm_store_ps(Data(result[2]) + column * 4, z);
+	_mm_store_ps(Data(result[3]) + column * 4, w);
+}
+
+NEKO_TARGET("sse4.1")
+void MultiplySse4(const Mat4f* lhs, const Mat4f* rhs, Mat4f* result, std::size_t count)
+{
+	for (std::size_t i = 0; i < count; i++)
+	{
+		const float* a = Data(lhs[i]);
+		const float* b = Data(rhs[i]);
+		const __m128 c0 = _mm_load_ps(a);
+		const __m128 c1 = _mm_load_ps(a + 4);
+		const __m128 c2 = _mm_load_ps(a + 8);
+		const __m128 c3 = _mm_load_ps(a + 12);
+		__m128 v[4];
+		for (int column = 0; column < 4; column++)
+		{
+			const __m128 r = _mm_load_ps(b + column * 4);
+			const __m128 x = _mm_shuffle_ps(r, r, _MM_SHUFFLE(0, 0, 0, 0));
+			const __m128 y = _mm_shuffle_ps(r, r, _MM_SHUFFLE(1, 1, 1, 1));
+			const __m128 z = _mm_shuffle_ps(r, r, _MM_SHUFFLE(2, 2, 2, 2));
+			const __m128 w = _mm_shuffle_ps(r, r, _MM_SHUFFLE(3, 3, 3, 3));
+			v[column] = _mm_add_ps(
+				_mm_add_ps(_mm_mul_ps(c0, x), _mm_mul_ps(c1, y)),
+				_mm_add_ps(_mm_mul_ps(c2, z), _mm_mul_ps(c3, w)));
+		}
+		float* out = Data(result[i]);
+		for (int column = 0; column < 4; column++)
+		{
+			_mm_store_ps(out + column * 4, v[column]);
+		}
+	}
+}
+
+NEKO_TARGET("sse4.1")
+void TransformVec4Sse4(const Mat4f& transform, const Vec4f* points, Vec4f* result, std::size_t count)
+{
+	const float* m = Data(transform);
+	const __m128 c0 = _mm_load_ps(m);
+	const __m128 c1 = _mm_load_ps(m + 4);
+	const __m128 c2 = _mm_load_ps(m + 8);
+	const __m128 c3 = _mm_load_ps(m + 12);
+	for (std::size_t i = 0; i < count; i++)
+	{
+		const __m128 p = _mm_load_ps(&points[i][0]);
+		const __m128 x = _mm_shuffle_ps(p, p, _MM_SHUFFLE(0, 0, 0, 0));
+		const __m128 y = _mm_shuffle_ps(p, p, _MM_SHUFFLE(1, 1, 1, 1));
+		const __m128 z = _mm_shuffle_ps(p, p, _MM_SHUFFLE(2, 2, 2, 2));
+		const __m128 w = _mm_shuffle_ps(p, p, _MM_SHUFFLE(3, 3, 3, 3));
+		_mm_store_ps(&result[i][0], _mm_add_ps(
+			_mm_add_ps(_mm_mul_ps(c0, x), _mm_mul_ps(c1, y)),
+			_mm_add_ps(_mm_mul_ps(c2, z), _mm_mul_ps(c3, w))));
+	}
+}
+
+/**
+ * \brief Writes the xyz lanes of v without touching the next element of a tightly packed Vec3f array
+ */
+inline void StoreVec3(Vec3f& result, __m128 v)
+{
+	_mm_storel_pi(reinterpret_cast<__m64*>(&result[0]), v);
+	_mm_store_ss(&result[2], _mm_movehl_ps(v, v));
+}
+
+NEKO_TARGET("sse4.1")
+void TransformVec3Sse4(const Mat4f& transform, const Vec3f* points, Vec3f* result, std::size_t count)
+{
+	const float* m = Data(transform);
+	const __m128 c0 = _mm_load_ps(m);
+	const __m128 c1 = _mm_load_ps(m + 4);
+	const __m128 c2 = _mm_load_ps(m + 8);
+	const __m128 c3 = _mm_load_ps(m + 12);
+	for (std::size_t i = 0; i < count; i++)
+	{
+		const __m128 x = _mm_set1_ps(points[i].x);
+		const __m128 y = _mm_set1_ps(points[i].y);
+		const __m128 z = _mm_set1_ps(points[i].z);
+		StoreVec3(result[i], _mm_add_ps(
+			_mm_add_ps(_mm_mul_ps(c0, x), _mm_mul_ps(c1, y)),
+			_mm_add_ps(_mm_mul_ps(c2, z), c3)));
+	}
+}
+
+NEKO_TARGET("sse4.1")
+void ComposeTrsSse4(const TrsSoA& trs, Mat4f* result, std::size_t count)
+{
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 two = _mm_set1_ps(2.0f);
+	const __m128 zero = _mm_setzero_ps();
+	std::size_t i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		const __m128 x = _mm_loadu_ps(trs.rotationX + i);
+		const __m128 y = _mm_loadu_ps(trs.rotationY + i);
+		const __m128 z = _mm_loadu_ps(trs.rotationZ + i);
+		const __m128 w = _mm_loadu_ps(trs.rotationW + i);
+		const __m128 xx = _mm_mul_ps(x, x), yy = _mm_mul_ps(y, y), zz = _mm_mul_ps(z, z);
+		const __m128 xy = _mm_mul_ps(x, y), xz = _mm_mul_ps(x, z), yz = _mm_mul_ps(y, z);
+		const __m128 wx = _mm_mul_ps(w, x), wy = _mm_mul_ps(w, y), wz = _mm_mul_ps(w, z);
+		const __m128 sx = _mm_loadu_ps(trs.scaleX + i);
+		const __m128 sy = _mm_loadu_ps(trs.scaleY + i);
+		const __m128 sz = _mm_loadu_ps(trs.scaleZ + i);
+
+		StoreColumn(
+			_mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz))), sx),
+			_mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xy, wz)), sx),
+			_mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xz, wy)), sx),
+			zero, result + i, 0);
+		StoreColumn(
+			_mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xy, wz)), sy),
+			_mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz))), sy),
+			_mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(yz, wx)), sy),
+			zero, result + i, 1);
+		StoreColumn(
+			_mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xz, wy)), sz),
+			_mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(yz, wx)), sz),
+			_mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy))), sz),
+			zero, result + i, 2);
+		StoreColumn(
+			_mm_loadu_ps(trs.positionX + i),
+			_mm_loadu_ps(trs.positionY + i),
+			_mm_loadu_ps(trs.positionZ + i),
+			one, result + i, 3);
+	}
+	ComposeTrsRange(trs, result, i, count);
+}
+
+constexpr Mat4BatchKernels sse4Kernels{
+	SimdLevel::SSE4, MultiplySse4, TransformVec4Sse4, TransformVec3Sse4, ComposeTrsSse4 };
+
+NEKO_TARGET("avx2,fma")
+void MultiplyAvx2(const Mat4f* lhs, const Mat4f* rhs, Mat4f* result, std::size_t count)
+{
+	for (std::size_t i = 0; i < count; i++)
+	{
+		const float* a = Data(lhs[i]);
+		const float* b = Data(rhs[i]);
+		//Each lhs column is duplicated in both 128-bit lanes to compute two result columns at once
+		const __m256 c0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(a));
+		const __m256 c1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(a + 4));
+		const __m256 c2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(a + 8));
+		const __m256 c3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(a + 12));
+		__m256 v[2];
+		for (int half = 0; half < 2; half++)
+		{
+			const __m256 r = _mm256_loadu_ps(b + half * 8);
+			v[half] = _mm256_mul_ps(c0, _mm256_shuffle_ps(r, r, _MM_SHUFFLE(0, 0, 0, 0)));
+			v[half] = _mm256_fmadd_ps(c1, _mm256_shuffle_ps(r, r, _MM_SHUFFLE(1, 1, 1, 1)), v[half]);
+			v[half] = _mm256_fmadd_ps(c2, _mm256_shuffle_ps(r, r, _MM_SHUFFLE(2, 2, 2, 2)), v[half]);
+			v[half] = _mm256_fmadd_ps(c3, _mm256_shuffle_ps(r, r, _MM_SHUFFLE(3, 3, 3, 3)), v[half]);
+		}
+		float* out = Data(result[i]);
+		_mm256_storeu_ps(out, v[0]);
+		_mm256_storeu_ps(out + 8, v[1]);
+	}
+}
+
+NEKO_TARGET("avx2,fma")
+void TransformVec4Avx2(const Mat4f& transform, const Vec4f* points, Vec4f* result, std::size_t count)
+{
+	const float* m = Data(transform);
+	const __m256 c0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m));
+	const __m256 c1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m + 4));
+	const __m256 c2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m + 8));
+	const __m256 c3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m + 12));
+	std::size_t i = 0;
+	for (; i + 2 <= count; i += 2)
+	{
+		const __m256 p = _mm256_loadu_ps(&points[i][0]);
+		__m256 v = _mm256_mul_ps(c0, _mm256_shuffle_ps(p, p, _MM_SHUFFLE(0, 0, 0, 0)));
+		v = _mm256_fmadd_ps(c1, _mm256_shuffle_ps(p, p, _MM_SHUFFLE(1, 1, 1, 1)), v);
+		v = _mm256_fmadd_ps(c2, _mm256_shuffle_ps(p, p, _MM_SHUFFLE(2, 2, 2, 2)), v);
+		v = _mm256_fmadd_ps(c3, _mm256_shuffle_ps(p, p, _MM_SHUFFLE(3, 3, 3, 3)), v);
+		_mm256_storeu_ps(&result[i][0], v);
+	}
+	TransformVec4Sse4(transform, points + i, result + i, count - i);
+}
+
+NEKO_TARGET("avx2,fma")
+void TransformVec3Avx2(const Mat4f& transform, const Vec3f* points, Vec3f* result, std::size_t count)
+{
+	//Vec3f are packed on 12 bytes, so each point is computed in a 128-bit register with fma
+	const float* m = Data(transform);
+	const __m128 c0 = _mm_load_ps(m);
+	const __m128 c1 = _mm_load_ps(m + 4);
+	const __m128 c2 = _mm_load_ps(m + 8);
+	const __m128 c3 = _mm_load_ps(m + 12);
+	for (std::size_t i = 0; i < count; i++)
+	{
+		__m128 v = _mm_fmadd_ps(c0, _mm_set1_ps(points[i].x), c3);
+		v = _mm_fmadd_ps(c1, _mm_set1_ps(points[i].y), v);
+		v = _mm_fmadd_ps(c2, _mm_set1_ps(points[i].z), v);
+		StoreVec3(result[i], v);
+	}
+}
+
+NEKO_TARGET("avx2,fma")
+void ComposeTrsAvx2(const TrsSoA& trs, Mat4f* result, std::size_t count)
+{
+	const __m256 one = _mm256_set1_ps(1.0f);
+	const __m256 two = _mm256_set1_ps(2.0f);
+	const __m256 zero = _mm256_setzero_ps();
+	std::size_t i = 0;
+	for (; i + 8 <= count; i += 8)
+	{
+		const __m256 x = _mm256_loadu_ps(trs.rotationX + i);
+		const __m256 y = _mm256_loadu_ps(trs.rotationY + i);
+		const __m256 z = _mm256_loadu_ps(trs.rotationZ + i);
+		const __m256 w = _mm256_loadu_ps(trs.rotationW + i);
+		const __m256 xx = _mm256_mul_ps(x, x), yy = _mm256_mul_ps(y, y), zz = _mm256_mul_ps(z, z);
+		const __m256 xy = _mm256_mul_ps(x, y), xz = _mm256_mul_ps(x, z), yz = _mm256_mul_ps(y, z);
+		const __m256 wx = _mm256_mul_ps(w, x), wy = _mm256_mul_ps(w, y), wz = _mm256_mul_ps(w, z);
+		const __m256 sx = _mm256_loadu_ps(trs.scaleX + i);
+		const __m256 sy = _mm256_loadu_ps(trs.scaleY + i);
+		const __m256 sz = _mm256_loadu_ps(trs.scaleZ + i);
+
+		const __m256 columns[4][4] = {
+			{
+				_mm256_mul_ps(_mm256_fnmadd_ps(two, _mm256_add_ps(yy, zz), one), sx),
+				_mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(xy, wz)), sx),
+				_mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(xz, wy)), sx),
+				zero
+			},
+			{
+				_mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(xy, wz)), sy),
+				_mm256_mul_ps(_mm256_fnmadd_ps(two, _mm256_add_ps(xx, zz), one), sy),
+				_mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(yz, wx)), sy),
+				zero
+			},
+			{
+				_mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(xz, wy)), sz),
+				_mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(yz, wx)), sz),
+				_mm256_mul_ps(_mm256_fnmadd_ps(two, _mm256_add_ps(xx, yy), one), sz),
+				zero
+			},
+			{
+				_mm256_loadu_ps(trs.positionX + i),
+				_mm256_loadu_ps(trs.positionY + i),
+				_mm256_loadu_ps(trs.positionZ + i),
+				one
+			}
+		};
+		for (int column = 0; column < 4; column++)
+		{
+			const __m256* c = columns[column];
+			StoreColumn(
+				_mm256_castps256_ps128(c[0]), _mm256_castps256_ps128(c[1]),
+				_mm256_castps256_ps128(c[2]), _mm256_castps256_ps128(c[3]),
+				result + i, column);
+			StoreColumn(
+				_mm256_extractf128_ps(c[0], 1), _mm256_extractf128_ps(c[1], 1),
+				_mm256_extractf128_ps(c[2], 1), _mm256_extractf128_ps(c[3], 1),
+				result + i + 4, column);
+		}
+	}
+	ComposeTrsRange(trs, result, i, count);
+}
+
+constexpr Mat4BatchKernels avx2Kernels{
+	SimdLevel::AVX2, MultiplyAvx2, TransformVec4Avx2, TransformVec3Avx2, ComposeTrsAvx2 };
+
+NEKO_TARGET("avx512f,avx2,fma")
+void MultiplyAvx512(const Mat4f* lhs, const Mat4f* rhs, Mat4f* result, std::size_t count)
+{
+	for (std::size_t i = 0; i < count; i++)
+	{
+		const float* a = Data(lhs[i]);
+		//Each lhs column is duplicated in the four 128-bit lanes to compute the whole matrix at once
+		const __m512 c0 = _mm512_broadcast_f32x4(_mm_load_ps(a));
+		const __m512 c1 = _mm512_broadcast_f32x4(_mm_load_ps(a + 4));
+		const __m512 c2 = _mm512_broadcast_f32x4(_mm_load_ps(a + 8));
+		const __m512 c3 = _mm512_broadcast_f32x4(_mm_load_ps(a + 12));
+		const __m512 r = _mm512_loadu_ps(Data(rhs[i]));
+		__m512 v = _mm512_mul_ps(c0, _mm512_permute_ps(r, _MM_SHUFFLE(0, 0, 0, 0)));
+		v = _mm512_fmadd_ps(c1, _mm512_permute_ps(r, _MM_SHUFFLE(1, 1, 1, 1)), v);
+		v = _mm512_fmadd_ps(c2, _mm512_permute_ps(r, _MM_SHUFFLE(2, 2, 2, 2)), v);
+		v = _mm512_fmadd_ps(c3, _mm512_permute_ps(r, _MM_SHUFFLE(3, 3, 3, 3)), v);
+		_mm512_storeu_ps(Data(result[i]), v);
+	}
+}
+
+NEKO_TARGET("avx512f,avx2,fma")
+void TransformVec4Avx512(const Mat4f& transform, const Vec4f* points, Vec4f* result, std::size_t count)
+{
+	const float* m = Data(transform);
+	const __m512 c0 = _mm512_broadcast_f32x4(_mm_load_ps(m));
+	const __m512 c1 = _mm512_broadcast_f32x4(_mm_load_ps(m + 4));
+	const __m512 c2 = _mm512_broadcast_f32x4(_mm_load_ps(m + 8));
+	const __m512 c3 = _mm512_broadcast_f32x4(_mm_load_ps(m + 12));
+	std::size_t i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		const __m512 p = _mm512_loadu_ps(&points[i][0]);
+		__m512 v = _mm512_mul_ps(c0, _mm512_permute_ps(p, _MM_SHUFFLE(0, 0, 0, 0)));
+		v = _mm512_fmadd_ps(c1, _mm512_permute_ps(p, _MM_SHUFFLE(1, 1, 1, 1)), v);
+		v = _mm512_fmadd_ps(c2, _mm512_permute_ps(p, _MM_SHUFFLE(2, 2, 2, 2)), v);
+		v = _mm512_fmadd_ps(c3, _mm512_permute_ps(p, _MM_SHUFFLE(3, 3, 3, 3)), v);
+		_mm512_storeu_ps(&result[i][0], v);
+	}
+	TransformVec4Avx2(transform, points + i, result + i, count - i);
+}
+
+NEKO_TARGET("avx512f,avx2,fma")
+void ComposeTrsAvx512(const TrsSoA& trs, Mat4f* result, std::size_t count)
+{
+	const __m512 one = _mm512_set1_ps(1.0f);
+	const __m512 two = _mm512_set1_ps(2.0f);
+	const __m512 zero = _mm512_setzero_ps();
+	std::size_t i = 0;
+	for (; i + 16 <= count; i += 16)
+	{
+		const __m512 x = _mm512_loadu_ps(trs.rotationX + i);
+		const __m512 y = _mm512_loadu_ps(trs.rotationY + i);
+		const __m512 z = _mm512_loadu_ps(trs.rotationZ + i);
+		const __m512 w = _mm512_loadu_ps(trs.rotationW + i);
+		const __m512 xx = _mm512_mul_ps(x, x), yy = _mm512_mul_ps(y, y), zz = _mm512_mul_ps(z, z);
+		const __m512 xy = _mm512_mul_ps(x, y), xz = _mm512_mul_ps(x, z), yz = _mm512_mul_ps(y, z);
+		const __m512 wx = _mm512_mul_ps(w, x), wy = _mm512_mul_ps(w, y), wz = _mm512_mul_ps(w, z);
+		const __m512 sx = _mm512_loadu_ps(trs.scaleX + i);
+		const __m512 sy = _mm512_loadu_ps(trs.scaleY + i);
+		const __m512 sz = _mm512_loadu_ps(trs.scaleZ + i);
+
+		const __m512 columns[4][4] = {
+			{
+				_mm512_mul_ps(_mm512_fnmadd_ps(two, _mm512_add_ps(yy, zz), one), sx),
+				_mm512_mul_ps(_mm512_mul_ps(two, _mm512_add_ps(xy, wz)), sx),
+				_mm512_mul_ps(_mm512_mul_ps(two, _mm512_sub_ps(xz, wy)), sx),
+				zero
+			},
+			{
+				_mm512_mul_ps(_mm512_mul_ps(two, _mm512_sub_ps(xy, wz)), sy),
+				_mm512_mul_ps(_mm512_fnmadd_ps(two, _mm512_add_ps(xx, zz), one), sy),
+				_mm512_mul_ps(_mm512_mul_ps(two, _mm512_add_ps(yz, wx)), sy),
+				zero
+			},
+			{
+				_mm512_mul_ps(_mm512_mul_ps(two, _mm512_add_ps(xz, wy)), sz),
+				_mm512_mul_ps(_mm512_mul_ps(two, _mm512_sub_ps(yz, wx)), sz),
+				_mm512_mul_ps(_mm512_fnmadd_ps(two, _mm512_add_ps(xx, yy), one), sz),
+				zero
+			},
+			{
+				_mm512_loadu_ps(trs.positionX + i),
+				_mm512_loadu_ps(trs.positionY + i),
+				_mm512_loadu_ps(trs.positionZ + i),
+				one
+			}
+		};
+		for (int column = 0; column < 4; column++)
+		{
+			const __m512* c = columns[column];
+			StoreColumn(
+				_mm512_extractf32x4_ps(c[0], 0), _mm512_extractf32x4_ps(c[1], 0),
+				_mm512_extractf32x4_ps(c[2], 0), _mm512_extractf32x4_ps(c[3], 0),
+				result + i, column);
+			StoreColumn(
+				_mm512_extractf32x4_ps(c[0], 1), _mm512_extractf32x4_ps(c[1], 1),
+				_mm512_extractf32x4_ps(c[2], 1), _mm512_extractf32x4_ps(c[3], 1),
+				result + i + 4, column);
+			StoreColumn(
+				_mm512_extractf32x4_ps(c[0], 2), _mm512_extractf32x4_ps(c[1], 2),
+				_mm512_extractf32x4_ps(c[2], 2), _mm512_extractf32x4_ps(c[3], 2),
+				result + i + 8, column);
+			StoreColumn(
+				_mm512_extractf32x4_ps(c[0], 3), _mm512_extractf32x4_ps(c[1], 3),
+				_mm512_extractf32x4_ps(c[2], 3), _mm512_extractf32x4_ps(c[3], 3),
+				result + i + 12, column);
+		}
+	}
+	ComposeTrsRange(trs, result, i, count);
+}
+
+constexpr Mat4BatchKernels avx512Kernels{
+	SimdLevel::AVX512, MultiplyAvx512, TransformVec4Avx512, TransformVec3Avx2, ComposeTrsAvx512 };
+
+#endif
+
+#if defined(__aarch64__)
+
+void MultiplyNeon(const Mat4f* lhs, const Mat4f* rhs, Mat4f* result, std::size_t count)
+{
+	for (std::size_t i = 0; i < count; i++)
+	{
+		const float* a = Data(lhs[i]);
+		const float* b = Data(rhs[i]);
+		const float32x4_t c0 = vld1q_f32(a);
+		const float32x4_t c1 = vld1q_f32(a + 4);
+		const float32x4_t c2 = vld1q_f32(a + 8);
+		const float32x4_t c3 = vld1q_f32(a + 12);
+		float32x4_t v[4];
+		for (int column = 0; column < 4; column++)
+		{
+			const float32x4_t r = vld1q_f32(b + column * 4);
+			v[column] = vmulq_laneq_f32(c0, r, 0);
+			v[column] = vfmaq_laneq_f32(v[column], c1, r, 1);
+			v[column] = vfmaq_laneq_f32(v[column], c2, r, 2);
+			v[column] = vfmaq_laneq_f32(v[column], c3, r, 3);
+		}
+		float* out = Data(result[i]);
+		for (int column = 0; column < 4; column++)
+		{
+			vst1q_f32(out + column * 4, v[column]);
+		}
+	}
+}
+
+void TransformVec4Neon(const Mat4f& transform, const Vec4f* points, Vec4f* result, std::size_t count)
+{
+	const float* m = Data(transform);
+	const float32x4_t c0 = vld1q_f32(m);
+	const float32x4_t c1 = vld1q_f32(m + 4);
+	const float32x4_t c2 = vld1q_f32(m + 8);
+	const float32x4_t c3 = vld1q_f32(m + 12);
+	for (std::size_t i = 0; i < count; i++)
+	{
+		const float32x4_t p = vld1q_f32(&points[i][0]);
+		float32x4_t v = vmulq_laneq_f32(c0, p, 0);
+		v = vfmaq_laneq_f32(v, c1, p, 1);
+		v = vfmaq_laneq_f32(v, c2, p, 2);
+		v = vfmaq_laneq_f32(v, c3, p, 3);
+		vst1q_f32(&result[i][0], v);
+	}
+}
+
+void TransformVec3Neon(const Mat4f& transform, const Vec3f* points, Vec3f* result, std::size_t count)
+{
+	const float* m = Data(transform);
+	const float32x4_t c0 = vld1q_f32(m);
+	const float32x4_t c1 = vld1q_f32(m + 4);
+	const float32x4_t c2 = vld1q_f32(m + 8);
+	const float32x4_t c3 = vld1q_f32(m + 12);
+	for (std::size_t i = 0; i < count; i++)
+	{
+		float32x4_t v = vfmaq_n_f32(c3, c0, points[i].x);
+		v = vfmaq_n_f32(v, c1, points[i].y);
+		v = vfmaq_n_f32(v, c2, points[i].z);
+		vst1_f32(&result[i][0], vget_low_f32(v));
+		result[i][2] = vgetq_lane_f32(v, 2);
+	}
+}
+
+void ComposeTrsNeon(const TrsSoA& trs, Mat4f* result, std::size_t count)
+{
+	const float32x4_t one = vdupq_n_f32(1.0f);
+	const float32x4_t two = vdupq_n_f32(2.0f);
+	const float32x4_t zero = vdupq_n_f32(0.0f);
+	std::size_t i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		const float32x4_t x = vld1q_f32(trs.rotationX + i);
+		const float32x4_t y = vld1q_f32(trs.rotationY + i);
+		const float32x4_t z = vld1q_f32(trs.rotationZ + i);
+		const float32x4_t w = vld1q_f32(trs.rotationW + i);
+		const float32x4_t xx = vmulq_f32(x, x), yy = vmulq_f32(y, y), zz = vmulq_f32(z, z);
+		const float32x4_t xy = vmulq_f32(x, y), xz = vmulq_f32(x, z), yz = vmulq_f32(y, z);
+		const float32x4_t wx = vmulq_f32(w, x), wy = vmulq_f32(w, y), wz = vmulq_f32(w, z);
+		const float32x4_t sx = vld1q_f32(trs.scaleX + i);
+		const float32x4_t sy = vld1q_f32(trs.scaleY + i);
+		const float32x4_t sz = vld1q_f32(trs.scaleZ + i);
+
+		//vst4q interleaves the four rows, writing one column of four consecutive matrices
+		const float32x4x4_t columns[4] = {
+			{ {
+				vmulq_f32(vfmsq_f32(one, two, vaddq_f32(yy, zz)), sx),
+				vmulq_f32(vmulq_f32(two, vaddq_f32(xy, wz)), sx),
+				vmulq_f32(vmulq_f32(two, vsubq_f32(xz, wy)), sx),
+				zero
+			} },
+			{ {
+				vmulq_f32(vmulq_f32(two, vsubq_f32(xy, wz)), sy),
+				vmulq_f32(vfmsq_f32(one, two, vaddq_f32(xx, zz)), sy),
+				vmulq_f32(vmulq_f32(two, vaddq_f32(yz, wx)), sy),
+				zero
+			} },
+			{ {
+				vmulq_f32(vmulq_f32(two, vaddq_f32(xz, wy)), sz),
+				vmulq_f32(vmulq_f32(two, vsubq_f32(yz, wx)), sz),
+				vmulq_f32(vfmsq_f32(one, two, vaddq_f32(xx, yy)), sz),
+				zero
+			} },
+			{ {
+				vld1q_f32(trs.positionX + i),
+				vld1q_f32(trs.positionY + i),
+				vld1q_f32(trs.positionZ + i),
+				one
+			} }
+		};
+		for (int column = 0; column < 4; column++)
+		{
+			float rows[16];
+			vst4q_f32(rows, columns[column]);
+			for (int entity = 0; entity < 4; entity++)
+			{
+				vst1q_f32(Data(result[i + entity]) + column * 4, vld1q_f32(rows + entity * 4));
+			}
+		}
+	}
+	ComposeTrsRange(trs, result, i, count);
+}
+
+constexpr Mat4BatchKernels neonKernels{
+	SimdLevel::NEON, MultiplyNeon, TransformVec4Neon, TransformVec3Neon, ComposeTrsNeon };
+
+#endif
+
+const Mat4BatchKernels* GetKernelsFor(SimdLevel level)
+{
+	switch (level)
+	{
+#if defined(NEKO_BATCH_X86)
+	case SimdLevel::SSE4:
+		return &sse4Kernels;
+	case SimdLevel::AVX2:
+		return &avx2Kernels;
+	case SimdLevel::AVX512:
+		return &avx512Kernels;
+#endif
+#if defined(__aarch64__)
+	case SimdLevel::NEON:
+		return &neonKernels;
+#endif
+	default:
+		return &scalarKernels;
+	}
+}
+
+std::atomic<const Mat4BatchKernels*> currentKernels{ nullptr };
+
+const Mat4BatchKernels& GetKernels()
+{
+	const Mat4BatchKernels* kernels = currentKernels.load(std::memory_order_acquire);
+	if (kernels == nullptr)
+	{
+		kernels = GetKernelsFor(GetCpuSimdLevel());
+		currentKernels.store(kernels, std::memory_order_release);
+	}
+	return *kernels;
+}
+}
+
+SimdLevel GetMat4BatchLevel()
+{
+	return GetKernels().level;
+}
+
+bool SetMat4BatchLevel(SimdLevel level)
+{
+	if (!IsSimdLevelSupported(level))
+		return false;
+	const Mat4BatchKernels* kernels = GetKernelsFor(level);
+	if (kernels->level != level)
+		return false;
+	currentKernels.store(kernels, std::memory_order_release);
+	return true;
+}
+
+void MultiplyMat4Batch(const Mat4f* lhs, const Mat4f* rhs, Mat4f* result, std::size_t count)
+{
+	GetKernels().multiply(lhs, rhs, result, count);
+}
+
+void TransformPointsBatch(const Mat4f& transform, const Vec4f* points, Vec4f* result, std::size_t count)
+{
+	GetKernels().transformVec4(transform, points, result, count);
+}
+
+void TransformPointsBatch(const Mat4f& transform, const Vec3f* points, Vec3f* result, std::size_t count)
+{
+	GetKernels().transformVec3(transform, points, result, count);
+}
+
+void ComposeTrsBatch(const TrsSoA& trs, Mat4f* result, std::size_t count)
+{
+	GetKernels().composeTrs(trs, result, count);
+}
+}
@@ -174,6 +174,26 @@ Mat4f const RotationMatrixFrom(const Quaternion& q)
 }
 
 
+Mat4f const TrsMatrixFrom(const Vec3f& translation, const Quaternion& rotation, const Vec3f& scale)
+{
+    const float xx = rotation.x * rotation.x;
+    const float yy = rotation.y * rotation.y;
+    const float zz = rotation.z * rotation.z;
+    const float xy = rotation.x * rotation.y;
+    const float xz = rotation.x * rotation.z;
+    const float yz = rotation.y * rotation.z;
+    const float wx = rotation.w * rotation.x;
+    const float wy = rotation.w * rotation.y;
+    const float wz = rotation.w * rotation.z;
+
+    return Mat4f(
+            std::array<Vec4f, 4>
+                    {
+                            Vec4f((1.0f - 2.0f * (yy + zz)) * scale[0], 2.0f * (xy + wz) * scale[0], 2.0f * (xz - wy) * scale[0], 0),
+                            Vec4f(2.0f * (xy - wz) * scale[1], (1.0f - 2.0f * (xx + zz)) * scale[1], 2.0f * (yz + wx) * scale[1], 0),
+                            Vec4f(2.0f * (xz + wy) * scale[2], 2.0f * (yz - wx) * scale[2], (1.0f - 2.0f * (xx + yy)) * scale[2], 0),
+                            Vec4f(translation[0], translation[1], translation[2], 1)});
+}
 
 
 Mat4f Translate(const Mat4f& transform, const Vec3f translation)
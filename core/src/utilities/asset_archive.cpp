@@ -0,0 +1,475 @@
+/*
+ MIT License
+
+ Copyright (c) 2020 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#include "utilities/asset_archive.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <numeric>
+
+#include <fmt/format.h>
+
+#include "engine/log.h"
+#include "mathematics/checksum.h"
+#include "utilities/json_utility.h"
+
+#ifdef NEKO_ZSTD
+#include <zstd.h>
+#endif
+
+#ifdef EASY_PROFILE_USE
+#include "easy/profiler.h"
+#endif
+
+namespace neko
+{
+namespace
+{
+constexpr std::uint64_t AlignOffset(std::uint64_t offset, std::uint64_t alignment)
+{
+    return (offset + alignment - 1) / alignment * alignment;
+}
+
+std::uint64_t HashPath(std::string_view path)
+{
+    return Hash64(path.data(), path.size());
+}
+
+bool IsLowerId(const AssetArchiveEntry& entry, const sole::uuid& id)
+{
+    return entry.uuidAb < id.ab || (entry.uuidAb == id.ab && entry.uuidCd < id.cd);
+}
+}
+
+AssetType GetAssetType(std::string_view path)
+{
+    std::string extension = GetFilenameExtension(path);
+    std::transform(extension.begin(), extension.end(), extension.begin(),
+                   [](char c) { return static_cast<char>(std::tolower(c)); });
+    constexpr std::array<std::string_view, 10> imgExtensions = {
+        ".jpeg", ".jpg", ".png", ".bmp", ".hdr", ".ktx", ".dds", ".pam", ".ppm", ".pgm"};
+    if (std::find(imgExtensions.begin(), imgExtensions.end(), extension) != imgExtensions.end())
+    {
+        return AssetType::TEXTURE;
+    }
+    if (extension == ".mtl" || extension == ".mat")
+    {
+        return AssetType::MTL;
+    }
+    if (extension == ".obj")
+    {
+        return AssetType::OBJ;
+    }
+    if (extension == ".vert")
+    {
+        return AssetType::VERT_SHADER;
+    }
+    if (extension == ".frag")
+    {
+        return AssetType::FRAG_SHADER;
+    }
+    if (extension == ".ttf")
+    {
+        return AssetType::FONT;
+    }
+    return AssetType::UNKNOWN;
+}
+
+std::string MakeAssetPath(std::string_view path, std::string_view mountPath)
+{
+    std::string assetPath = MakeGeneric(path);
+    const std::string genericMountPath = MakeGeneric(mountPath);
+    if (!genericMountPath.empty() && assetPath.compare(0, genericMountPath.size(), genericMountPath) == 0)
+    {
+        assetPath.erase(0, genericMountPath.size());
+    }
+    const auto start = assetPath.find_first_not_of('/');
+    return start == std::string::npos ? std::string() : assetPath.substr(start);
+}
+
+bool LoadAssetMeta(std::string_view assetPath, sole::uuid& id, std::uint32_t& flags)
+{
+    const std::string metaPath = std::string(assetPath) + ".meta";
+    if (!FileExists(metaPath))
+    {
+        return false;
+    }
+    const auto metaJson = LoadJson(metaPath);
+    const auto bakeFlag = [&metaJson, &flags](const char* name, AssetArchiveEntry::Flags flag)
+    {
+        if (CheckJsonParameter(metaJson, name, json::value_t::boolean) && metaJson[name].get<bool>())
+        {
+            flags |= flag;
+        }
+    };
+    bakeFlag("linear", AssetArchiveEntry::LINEAR);
+    bakeFlag("ktx2", AssetArchiveEntry::KTX2);
+    bakeFlag("genmipmap", AssetArchiveEntry::GENMIPMAP);
+    if (!CheckJsonParameter(metaJson, "uuid", json::value_t::string))
+    {
+        return false;
+    }
+    id = sole::rebuild(metaJson["uuid"].get<std::string>());
+    flags |= AssetArchiveEntry::HAS_META;
+    return true;
+}
+
+sole::uuid AssetArchiveEntry::GetId() const
+{
+    sole::uuid id;
+    id.ab = uuidAb;
+    id.cd = uuidCd;
+    return id;
+}
+
+AssetArchiveWriter::AssetArchiveWriter(std::uint32_t alignment) : alignment_(std::max(alignment, 8u))
+{
+}
+
+bool AssetArchiveWriter::AddFile(std::string_view filePath, std::string_view archivePath, bool compress)
+{
+    BufferFile file;
+    file.Load(filePath, BufferFile::LoadMode::READ);
+    if (file.dataBuffer == nullptr)
+    {
+        return false;
+    }
+    sole::uuid id = sole::uuid();
+    std::uint32_t flags = AssetArchiveEntry::NONE;
+    LoadAssetMeta(filePath, id, flags);
+    AddData(archivePath, file.dataBuffer, file.dataLength, id, GetAssetType(filePath), flags, compress);
+    return true;
+}
+
+void AssetArchiveWriter::AddData(
+    std::string_view archivePath,
+    const unsigned char* data,
+    size_t length,
+    const sole::uuid& id,
+    AssetType type,
+    std::uint32_t flags,
+    [[maybe_unused]] bool compress)
+{
+    PendingEntry pendingEntry;
+    pendingEntry.path = MakeGeneric(archivePath);
+    auto& entry = pendingEntry.entry;
+    entry.uuidAb = id.ab;
+    entry.uuidCd = id.cd;
+    entry.pathHash = HashPath(pendingEntry.path);
+    entry.originalSize = length;
+    entry.pathLength = static_cast<std::uint32_t>(pendingEntry.path.size());
+    entry.type = type;
+    entry.flags = flags & ~AssetArchiveEntry::COMPRESSED;
+#ifdef NEKO_ZSTD
+    if (compress && length > 0)
+    {
+        pendingEntry.data.resize(ZSTD_compressBound(length));
+        const size_t compressedSize = ZSTD_compress(
+            pendingEntry.data.data(), pendingEntry.data.size(), data, length, compressionLevel);
+        if (!ZSTD_isError(compressedSize) && compressedSize < length)
+        {
+            pendingEntry.data.resize(compressedSize);
+            entry.flags |= AssetArchiveEntry::COMPRESSED;
+        }
+    }
+#endif
+    if (!entry.HasFlag(AssetArchiveEntry::COMPRESSED))
+    {
+        pendingEntry.data.assign(data, data + length);
+    }
+    entry.size = pendingEntry.data.size();
+
+    const auto it = pathIndices_.find(pendingEntry.path);
+    if (it != pathIndices_.end())
+    {
+        logDebug(fmt::format("[Warning] Asset archive path added twice: {}", pendingEntry.path));
+        entries_[it->second] = std::move(pendingEntry);
+        return;
+    }
+    pathIndices_[pendingEntry.path] = entries_.size();
+    entries_.push_back(std::move(pendingEntry));
+}
+
+size_t AssetArchiveWriter::AddDirectory(std::string_view folderPath, bool compress)
+{
+    size_t count = 0;
+    IterateDirectory(folderPath, [this, folderPath, compress, &count](std::string_view filePath)
+    {
+        if (GetFilenameExtension(filePath) == ".meta")
+        {
+            return;
+        }
+        if (AddFile(filePath, GetRelativePath(filePath, folderPath), compress))
+        {
+            count++;
+        }
+    }, true);
+    return count;
+}
+
+bool AssetArchiveWriter::Write(std::string_view archivePath) const
+{
+    //Entries sorted by uuid for the binary search, by path for assets without meta
+    std::vector<size_t> order(entries_.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [this](size_t a, size_t b)
+    {
+        const auto& entryA = entries_[a];
+        const auto& entryB = entries_[b];
+        const auto idA = entryA.entry.GetId();
+        const auto idB = entryB.entry.GetId();
+        if (idA != idB)
+        {
+            return idA < idB;
+        }
+        return entryA.path < entryB.path;
+    });
+
+    AssetArchiveHeader header;
+    header.entryCount = static_cast<std::uint32_t>(entries_.size());
+    header.alignment = alignment_;
+    header.entriesOffset = sizeof(AssetArchiveHeader);
+    header.pathIndexOffset = header.entriesOffset + entries_.size() * sizeof(AssetArchiveEntry);
+    header.pathTableOffset = header.pathIndexOffset + entries_.size() * sizeof(std::uint32_t);
+
+    std::vector<AssetArchiveEntry> entries(entries_.size());
+    std::string pathTable;
+    for (size_t i = 0; i < order.size(); i++)
+    {
+        const auto& pendingEntry = entries_[order[i]];
+        entries[i] = pendingEntry.entry;
+        entries[i].pathOffset = static_cast<std::uint32_t>(pathTable.size());
+        pathTable += pendingEntry.path;
+        pathTable.push_back('\0');
+    }
+    header.pathTableSize = pathTable.size();
+    header.dataOffset = AlignOffset(header.pathTableOffset + header.pathTableSize, alignment_);
+
+    std::uint64_t offset = header.dataOffset;
+    for (auto& entry : entries)
+    {
+        entry.offset = offset;
+        //At least one zero byte after the data keeps the views null-terminated
+        offset = AlignOffset(offset + entry.size + 1, alignment_);
+    }
+    //A mapped file filling its last page would be read instead, see BufferFile::Map
+    constexpr std::uint64_t pageSize = 4096;
+    if (offset % pageSize == 0)
+    {
+        offset += alignment_;
+    }
+    header.archiveSize = offset;
+
+    std::vector<std::uint32_t> pathIndex(entries.size());
+    std::iota(pathIndex.begin(), pathIndex.end(), 0u);
+    std::sort(pathIndex.begin(), pathIndex.end(), [&entries](std::uint32_t a, std::uint32_t b)
+    {
+        return entries[a].pathHash < entries[b].pathHash;
+    });
+
+    std::ofstream os(archivePath.data(), std::ofstream::binary | std::ofstream::trunc);
+    if (!os)
+    {
+        logDebug(fmt::format("[Error] Could not open asset archive: {} for writing", archivePath));
+        return false;
+    }
+    os.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    os.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(AssetArchiveEntry));
+    os.write(reinterpret_cast<const char*>(pathIndex.data()), pathIndex.size() * sizeof(std::uint32_t));
+    os.write(pathTable.data(), pathTable.size());
+    std::uint64_t position = header.pathTableOffset + header.pathTableSize;
+    const std::vector<char> padding(alignment_ + 1, 0);
+    const auto pad = [&os, &position, &padding](std::uint64_t target)
+    {
+        while (position < target)
+        {
+            const auto count = std::min<std::uint64_t>(target - position, padding.size());
+            os.write(padding.data(), count);
+            position += count;
+        }
+    };
+    for (size_t i = 0; i < entries.size(); i++)
+    {
+        const auto& data = entries_[order[i]].data;
+        pad(entries[i].offset);
+        os.write(reinterpret_cast<const char*>(data.data()), data.size());
+        position += data.size();
+    }
+    pad(header.archiveSize);
+    return static_cast<bool>(os);
+}
+
+bool AssetArchive::Open(std::string_view archivePath, std::string_view mountPath)
+{
+#ifdef EASY_PROFILE_USE
+    EASY_BLOCK("Open Asset Archive");
+#endif
+    Close();
+    archiveFile_.Load(archivePath, BufferFile::LoadMode::MAP);
+    if (archiveFile_.dataBuffer == nullptr || archiveFile_.dataLength < sizeof(AssetArchiveHeader))
+    {
+        logDebug(fmt::format("[Error] Could not open asset archive: {}", archivePath));
+        archiveFile_.Destroy();
+        return false;
+    }
+    const unsigned char* data = archiveFile_.dataBuffer;
+    header_ = reinterpret_cast<const AssetArchiveHeader*>(data);
+    entries_ = reinterpret_cast<const AssetArchiveEntry*>(data + header_->entriesOffset);
+    pathIndex_ = reinterpret_cast<const std::uint32_t*>(data + header_->pathIndexOffset);
+    pathTable_ = reinterpret_cast<const char*>(data + header_->pathTableOffset);
+    if (!Validate())
+    {
+        logDebug(fmt::format("[Error] Invalid asset archive: {}", archivePath));
+        Close();
+        return false;
+    }
+    mountPath_ = mountPath;
+    return true;
+}
+
+void AssetArchive::Close()
+{
+    header_ = nullptr;
+    entries_ = nullptr;
+    pathIndex_ = nullptr;
+    pathTable_ = nullptr;
+    mountPath_.clear();
+    archiveFile_.Destroy();
+}
+
+bool AssetArchive::Validate() const
+{
+    const std::uint64_t archiveSize = archiveFile_.dataLength;
+    if (header_->magic != AssetArchiveHeader::magicValue ||
+        header_->version != AssetArchiveHeader::currentVersion ||
+        header_->archiveSize != archiveSize)
+    {
+        return false;
+    }
+    const std::uint64_t entryCount = header_->entryCount;
+    if (header_->entriesOffset % alignof(AssetArchiveEntry) != 0 ||
+        header_->pathIndexOffset % alignof(std::uint32_t) != 0 ||
+        header_->entriesOffset + entryCount * sizeof(AssetArchiveEntry) > header_->pathIndexOffset ||
+        header_->pathIndexOffset + entryCount * sizeof(std::uint32_t) > header_->pathTableOffset ||
+        header_->pathTableOffset + header_->pathTableSize > header_->dataOffset ||
+        header_->dataOffset > archiveSize)
+    {
+        return false;
+    }
+    for (std::uint64_t i = 0; i < entryCount; i++)
+    {
+        const auto& entry = entries_[i];
+        if (entry.offset < header_->dataOffset ||
+            entry.offset + entry.size >= archiveSize ||
+            std::uint64_t(entry.pathOffset) + entry.pathLength >= header_->pathTableSize ||
+            pathIndex_[i] >= entryCount)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+const AssetArchiveEntry* AssetArchive::FindEntry(std::string_view path) const
+{
+    if (!IsOpen())
+    {
+        return nullptr;
+    }
+    const std::string archivePath = MakeAssetPath(path, mountPath_);
+    const std::uint64_t pathHash = HashPath(archivePath);
+    const auto* end = pathIndex_ + header_->entryCount;
+    auto* it = std::lower_bound(pathIndex_, end, pathHash, [this](std::uint32_t index, std::uint64_t hash)
+    {
+        return entries_[index].pathHash < hash;
+    });
+    for (; it != end && entries_[*it].pathHash == pathHash; ++it)
+    {
+        const auto& entry = entries_[*it];
+        if (GetPath(entry) == archivePath)
+        {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+const AssetArchiveEntry* AssetArchive::FindEntry(const sole::uuid& id) const
+{
+    if (!IsOpen() || id == sole::uuid())
+    {
+        return nullptr;
+    }
+    const auto* end = entries_ + header_->entryCount;
+    const auto* it = std::lower_bound(entries_, end, id, IsLowerId);
+    if (it != end && it->uuidAb == id.ab && it->uuidCd == id.cd)
+    {
+        return it;
+    }
+    return nullptr;
+}
+
+bool AssetArchive::LoadBufferFile(std::string_view path, BufferFile& bufferFile) const
+{
+    const auto* entry = FindEntry(path);
+    if (entry == nullptr)
+    {
+        return false;
+    }
+    return LoadBufferFile(*entry, bufferFile);
+}
+
+bool AssetArchive::LoadBufferFile(const AssetArchiveEntry& entry, BufferFile& bufferFile) const
+{
+    const unsigned char* data = archiveFile_.dataBuffer + entry.offset;
+    if (!entry.HasFlag(AssetArchiveEntry::COMPRESSED))
+    {
+        bufferFile.LoadView(data, entry.size);
+        return true;
+    }
+#ifdef NEKO_ZSTD
+    bufferFile.Destroy();
+    bufferFile.dataBuffer = new unsigned char[entry.originalSize + 1];
+    bufferFile.dataBuffer[entry.originalSize] = 0;
+    bufferFile.dataLength = entry.originalSize;
+    const size_t decompressedSize = ZSTD_decompress(bufferFile.dataBuffer, entry.originalSize, data, entry.size);
+    if (ZSTD_isError(decompressedSize) || decompressedSize != entry.originalSize)
+    {
+        logDebug(fmt::format("[Error] Could not decompress asset: {}", GetPath(entry)));
+        bufferFile.Destroy();
+        return false;
+    }
+    return true;
+#else
+    logDebug(fmt::format("[Error] Asset: {} is compressed and zstd is not available", GetPath(entry)));
+    return false;
+#endif
+}
+
+std::string_view AssetArchive::GetPath(const AssetArchiveEntry& entry) const
+{
+    return std::string_view(pathTable_ + entry.pathOffset, entry.pathLength);
+}
+}
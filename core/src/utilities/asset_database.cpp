@@ -0,0 +1,249 @@
+/*
+ MIT License
+
+ Copyright (c) 2020 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#include "utilities/asset_database.h"
+
+#include <cstring>
+#include <fstream>
+
+#include <fmt/format.h>
+
+#include "engine/log.h"
+#include "mathematics/checksum.h"
+
+#ifdef EASY_PROFILE_USE
+#include "easy/profiler.h"
+#endif
+
+namespace neko
+{
+
+sole::uuid AssetRecord::GetId() const
+{
+    sole::uuid id;
+    id.ab = uuidAb;
+    id.cd = uuidCd;
+    return id;
+}
+
+size_t AssetDatabase::Build(std::string_view dataFolder)
+{
+#ifdef EASY_PROFILE_USE
+    EASY_BLOCK("Build Asset Database");
+#endif
+    const size_t previousCount = GetAssetCount();
+    IterateDirectory(dataFolder, [this, dataFolder](std::string_view filePath)
+    {
+        constexpr std::string_view metaExtension = ".meta";
+        if (GetFilenameExtension(filePath) != metaExtension)
+        {
+            return;
+        }
+        const std::string_view assetPath = filePath.substr(0, filePath.size() - metaExtension.size());
+        sole::uuid id;
+        std::uint32_t flags = AssetArchiveEntry::NONE;
+        if (LoadAssetMeta(assetPath, id, flags))
+        {
+#ifndef NEKO_SAMETHREAD
+            std::lock_guard<std::mutex> lock(mutex_);
+#endif
+            AddRecord(GetRelativePath(assetPath, dataFolder), id, GetAssetType(assetPath), flags);
+        }
+    }, true);
+    return GetAssetCount() - previousCount;
+}
+
+size_t AssetDatabase::Build(const AssetArchive& assetArchive)
+{
+#ifndef NEKO_SAMETHREAD
+    std::lock_guard<std::mutex> lock(mutex_);
+#endif
+    const size_t previousCount = records_.size();
+    for (size_t i = 0; i < assetArchive.GetEntryCount(); i++)
+    {
+        const auto& entry = assetArchive.GetEntry(i);
+        if (entry.HasFlag(AssetArchiveEntry::HAS_META))
+        {
+            AddRecord(
+                assetArchive.GetPath(entry),
+                entry.GetId(),
+                entry.type,
+                entry.flags & ~AssetArchiveEntry::COMPRESSED);
+        }
+    }
+    return records_.size() - previousCount;
+}
+
+bool AssetDatabase::Load(std::string_view databasePath)
+{
+#ifdef EASY_PROFILE_USE
+    EASY_BLOCK("Load Asset Database");
+#endif
+    BufferFile databaseFile;
+    databaseFile.Load(databasePath, BufferFile::LoadMode::READ);
+    AssetDatabaseHeader header;
+    if (databaseFile.dataBuffer == nullptr || databaseFile.dataLength < sizeof(header))
+    {
+        logDebug(fmt::format("[Error] Could not open asset database: {}", databasePath));
+        return false;
+    }
+    std::memcpy(&header, databaseFile.dataBuffer, sizeof(header));
+    const size_t recordsSize = size_t(header.recordCount) * sizeof(AssetRecord);
+    if (header.magic != AssetDatabaseHeader::magicValue ||
+        header.version != AssetDatabaseHeader::currentVersion ||
+        databaseFile.dataLength != sizeof(header) + recordsSize + header.pathTableSize)
+    {
+        logDebug(fmt::format("[Error] Invalid asset database: {}", databasePath));
+        return false;
+    }
+    std::vector<AssetRecord> records(header.recordCount);
+    std::memcpy(records.data(), databaseFile.dataBuffer + sizeof(header), recordsSize);
+    const char* pathTable = reinterpret_cast<const char*>(databaseFile.dataBuffer + sizeof(header) + recordsSize);
+#ifndef NEKO_SAMETHREAD
+    std::lock_guard<std::mutex> lock(mutex_);
+#endif
+    for (const auto& record : records)
+    {
+        if (std::uint64_t(record.pathOffset) + record.pathLength >= header.pathTableSize)
+        {
+            logDebug(fmt::format("[Error] Invalid asset database: {}", databasePath));
+            return false;
+        }
+        AddRecord(
+            std::string_view(pathTable + record.pathOffset, record.pathLength),
+            record.GetId(),
+            record.type,
+            record.flags);
+    }
+    return true;
+}
+
+bool AssetDatabase::Write(std::string_view databasePath) const
+{
+#ifndef NEKO_SAMETHREAD
+    std::lock_guard<std::mutex> lock(mutex_);
+#endif
+    AssetDatabaseHeader header;
+    header.recordCount = static_cast<std::uint32_t>(records_.size());
+    header.pathTableSize = static_cast<std::uint32_t>(pathTable_.size());
+    std::ofstream os(databasePath.data(), std::ofstream::binary | std::ofstream::trunc);
+    if (!os)
+    {
+        logDebug(fmt::format("[Error] Could not open asset database: {} for writing", databasePath));
+        return false;
+    }
+    os.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    os.write(reinterpret_cast<const char*>(records_.data()), records_.size() * sizeof(AssetRecord));
+    os.write(pathTable_.data(), pathTable_.size());
+    return static_cast<bool>(os);
+}
+
+void AssetDatabase::Clear()
+{
+#ifndef NEKO_SAMETHREAD
+    std::lock_guard<std::mutex> lock(mutex_);
+#endif
+    records_.clear();
+    pathTable_.clear();
+    pathHashMap_.clear();
+}
+
+bool AssetDatabase::FindAsset(std::string_view path, AssetRecord& record) const
+{
+    const std::string assetPath = MakeAssetPath(path, mountPath_);
+    const std::uint64_t pathHash = Hash64(assetPath.data(), assetPath.size());
+#ifndef NEKO_SAMETHREAD
+    std::lock_guard<std::mutex> lock(mutex_);
+#endif
+    const auto it = pathHashMap_.find(pathHash);
+    if (it == pathHashMap_.end() || GetRecordPath(records_[it->second]) != assetPath)
+    {
+        return false;
+    }
+    record = records_[it->second];
+    return true;
+}
+
+void AssetDatabase::AddAsset(std::string_view path, const sole::uuid& id, AssetType type, std::uint32_t flags)
+{
+    const std::string assetPath = MakeAssetPath(path, mountPath_);
+#ifndef NEKO_SAMETHREAD
+    std::lock_guard<std::mutex> lock(mutex_);
+#endif
+    AddRecord(assetPath, id, type, flags);
+}
+
+std::string AssetDatabase::GetPath(const AssetRecord& record) const
+{
+#ifndef NEKO_SAMETHREAD
+    std::lock_guard<std::mutex> lock(mutex_);
+#endif
+    return std::string(GetRecordPath(record));
+}
+
+size_t AssetDatabase::GetAssetCount() const
+{
+#ifndef NEKO_SAMETHREAD
+    std::lock_guard<std::mutex> lock(mutex_);
+#endif
+    return records_.size();
+}
+
+std::string_view AssetDatabase::GetRecordPath(const AssetRecord& record) const
+{
+    return std::string_view(pathTable_.data() + record.pathOffset, record.pathLength);
+}
+
+void AssetDatabase::AddRecord(std::string_view assetPath, const sole::uuid& id, AssetType type, std::uint32_t flags)
+{
+    const std::uint64_t pathHash = Hash64(assetPath.data(), assetPath.size());
+    const auto it = pathHashMap_.find(pathHash);
+    if (it != pathHashMap_.end())
+    {
+        auto& record = records_[it->second];
+        if (GetRecordPath(record) != assetPath)
+        {
+            logDebug(fmt::format("[Warning] Asset path hash collision between: {} and {}", GetRecordPath(record), assetPath));
+            return;
+        }
+        record.uuidAb = id.ab;
+        record.uuidCd = id.cd;
+        record.type = type;
+        record.flags = flags;
+        return;
+    }
+    AssetRecord record;
+    record.uuidAb = id.ab;
+    record.uuidCd = id.cd;
+    record.pathHash = pathHash;
+    record.type = type;
+    record.flags = flags;
+    record.pathOffset = static_cast<std::uint32_t>(pathTable_.size());
+    record.pathLength = static_cast<std::uint32_t>(assetPath.size());
+    pathTable_.append(assetPath);
+    pathTable_.push_back('\0');
+    pathHashMap_.emplace(pathHash, static_cast<std::uint32_t>(records_.size()));
+    records_.push_back(record);
+}
+}
@@ -22,6 +22,7 @@
  SOFTWARE.
  */
 #include <utilities/file_utility.h>
+#include <utilities/asset_archive.h>
 #include <sstream>
 #include <functional>
 #include "engine/log.h"
@@ -51,7 +52,13 @@ Java_swiss_sae_gpr5300_MainActivity_load(JNIEnv *env, [[maybe_unused]] jclass cl
 }
 namespace neko
 {
-ResourceJob::ResourceJob() : Job([this]{bufferFile_.Load(filePath_);})
+ResourceJob::ResourceJob() : Job([this]
+{
+	if (!AssetArchiveLocator::get().LoadBufferFile(filePath_, bufferFile_))
+	{
+		bufferFile_.Load(filePath_, loadMode_);
+	}
+})
 {
 }
 void ResourceJob::SetFilePath(std::string_view path)
@@ -102,7 +109,7 @@ const std::string LoadFile(const std::string& path)
 }
 
 
-void BufferFile::Load(std::string_view path)
+void BufferFile::Load(std::string_view path, [[maybe_unused]] LoadMode loadMode)
 {
 	AAsset* file = AAssetManager_open(assetManager, path.data(), AASSET_MODE_BUFFER);
 	if (file == nullptr)
@@ -119,11 +126,23 @@ void BufferFile::Load(std::string_view path)
 	AAsset_close(file);
 }
 
+void BufferFile::LoadView(const unsigned char* data, size_t length)
+{
+	Destroy();
+	dataBuffer = const_cast<unsigned char*>(data);
+	dataLength = length;
+	isView_ = true;
+}
+
 void BufferFile::Destroy()
 {
-	delete[] dataBuffer;
+	if (!isView_)
+	{
+		delete[] dataBuffer;
+	}
 	dataBuffer = nullptr;
 	dataLength = 0;
+	isView_ = false;
 }
 
 
@@ -157,6 +176,13 @@ namespace fs = std::filesystem;
 namespace fs = std::filesystem;
 #endif
 
+#if defined(__linux__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 namespace neko
 {
 ResourceJob::ResourceJob() : Job([this]
@@ -165,7 +191,11 @@ ResourceJob::ResourceJob() : Job([this]
 		EASY_BLOCK("Load Resource");
 #endif
     bufferFile_.Destroy();
-    bufferFile_.Load(filePath_);
+    //Served from the mounted asset archive when the file is packed
+    if(!AssetArchiveLocator::get().LoadBufferFile(filePath_, bufferFile_))
+    {
+        bufferFile_.Load(filePath_, loadMode_);
+    }
 })
 {
 }
@@ -182,12 +212,16 @@ void ResourceJob::Reset()
 }
 
 
-void BufferFile::Load(std::string_view path)
+void BufferFile::Load(std::string_view path, LoadMode loadMode)
 {
     if(dataBuffer != nullptr)
     {
         Destroy();
     }
+    if(loadMode != LoadMode::READ && Map(path, loadMode == LoadMode::MAP ? 0 : mapSizeThreshold))
+    {
+        return;
+    }
     std::ifstream is(path.data(),std::ifstream::binary);
     if(!is)
     {
@@ -207,14 +241,79 @@ void BufferFile::Load(std::string_view path)
     }
 }
 
+#if defined(__linux__)
+bool BufferFile::Map(std::string_view path, size_t minSize)
+{
+    const int fd = open(std::string(path).c_str(), O_RDONLY | O_CLOEXEC);
+    if(fd < 0)
+    {
+        return false;
+    }
+    struct stat fileStat{};
+    if(fstat(fd, &fileStat) != 0 || !S_ISREG(fileStat.st_mode))
+    {
+        close(fd);
+        return false;
+    }
+    const auto fileSize = static_cast<size_t>(fileStat.st_size);
+    const auto pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    //The end of the last page is filled with zeros and keeps the buffer null-terminated,
+    //a file filling its last page has no room for it and is read instead
+    if(fileSize == 0 || fileSize < minSize || fileSize % pageSize == 0)
+    {
+        close(fd);
+        return false;
+    }
+    void* address = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    //The mapping keeps its own reference to the file
+    close(fd);
+    if(address == MAP_FAILED)
+    {
+        logDebug(fmt::format("[Warning] Could not map file: {}, reading it instead", path));
+        return false;
+    }
+    madvise(address, fileSize, MADV_SEQUENTIAL);
+    madvise(address, fileSize, MADV_WILLNEED);
+    dataBuffer = static_cast<unsigned char*>(address);
+    dataLength = fileSize;
+    isMapped_ = true;
+    return true;
+}
+#else
+bool BufferFile::Map([[maybe_unused]] std::string_view path, [[maybe_unused]] size_t minSize)
+{
+    return false;
+}
+#endif
+
+void BufferFile::LoadView(const unsigned char* data, size_t length)
+{
+    Destroy();
+    dataBuffer = const_cast<unsigned char*>(data);
+    dataLength = length;
+    isView_ = true;
+}
+
 void BufferFile::Destroy()
 {
-    if(dataBuffer != nullptr)
+    //A view does not own its memory, it is only forgotten
+    if(dataBuffer != nullptr && !isView_)
     {
-        delete[] dataBuffer;
-        dataBuffer = nullptr;
-        dataLength = 0;
+#if defined(__linux__)
+        if(isMapped_)
+        {
+            munmap(dataBuffer, dataLength);
+        }
+        else
+#endif
+        {
+            delete[] dataBuffer;
+        }
     }
+    dataBuffer = nullptr;
+    dataLength = 0;
+    isMapped_ = false;
+    isView_ = false;
 }
 
 BufferFile::~BufferFile()
@@ -226,16 +325,29 @@ BufferFile::BufferFile(BufferFile&& bufferFile) noexcept
 {
     this->dataBuffer = bufferFile.dataBuffer;
     this->dataLength = bufferFile.dataLength;
+    this->isMapped_ = bufferFile.isMapped_;
+    this->isView_ = bufferFile.isView_;
     bufferFile.dataBuffer = nullptr;
     bufferFile.dataLength = 0;
+    bufferFile.isMapped_ = false;
+    bufferFile.isView_ = false;
 }
 
 BufferFile& BufferFile::operator=(BufferFile&& bufferFile) noexcept
 {
+    if(this == &bufferFile)
+    {
+        return *this;
+    }
+    Destroy();
     this->dataBuffer = bufferFile.dataBuffer;
     this->dataLength = bufferFile.dataLength;
+    this->isMapped_ = bufferFile.isMapped_;
+    this->isView_ = bufferFile.isView_;
     bufferFile.dataBuffer = nullptr;
     bufferFile.dataLength = 0;
+    bufferFile.isMapped_ = false;
+    bufferFile.isView_ = false;
     return *this;
 }
 
@@ -0,0 +1,34 @@
+#version 300 es
+
+//QuantizedVertex layout, the attributes are normalized by the vertex fetch
+layout (location = 0) in vec4 aPos;
+layout (location = 1) in vec2 aTexCoords;
+layout (location = 2) in vec2 aNormal;
+
+out vec2 TexCoords;
+out vec3 Normal;
+uniform mat4 model;
+uniform mat4 view;
+uniform mat4 projection;
+uniform mat4 normalMatrix;
+//Mesh AABB
+uniform vec3 positionOffset;
+uniform vec3 positionScale;
+
+vec3 DecodeOctahedral(vec2 e)
+{
+    vec3 v = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    if (v.z < 0.0)
+    {
+        v.xy = (1.0 - abs(v.yx)) * vec2(v.x >= 0.0 ? 1.0 : -1.0, v.y >= 0.0 ? 1.0 : -1.0);
+    }
+    return normalize(v);
+}
+
+void main()
+{
+    TexCoords = aTexCoords;
+    Normal = mat3(normalMatrix) * DecodeOctahedral(aNormal);
+    vec3 position = positionOffset + aPos.xyz * positionScale;
+    gl_Position = projection * view * model * vec4(position, 1.0);
+}
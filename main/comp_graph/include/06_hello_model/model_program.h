@@ -41,7 +41,10 @@ private:
 	sdl::Camera3D camera_;
 	gl::TextureManager textureManager_;
 	assimp::Model model_;
+	assimp::Model quantizedModel_;
 	gl::Shader shader_;
+	gl::Shader quantizedShader_;
+	bool useQuantizedModel_ = false;
 	Mat4f projection_{ Mat4f::Identity };
 };
 }
@@ -26,6 +26,7 @@
 #include "mathematics/vector.h"
 #include "mathematics/matrix.h"
 #include "mathematics/transform.h"
+#include "imgui.h"
 
 namespace neko
 {
@@ -37,10 +38,15 @@ void HelloModelProgram::Init()
 	const std::string path = config.dataRootPath + "model/nanosuit2/nanosuit.obj";
     glCheckError();
 	model_.LoadModel(path);
+	quantizedModel_.SetVertexCompression(true);
+	quantizedModel_.LoadModel(path);
 	camera_.Init();
     shader_.LoadFromFile(
             config.dataRootPath + "shaders/06_hello_model/model.vert",
             config.dataRootPath + "shaders/06_hello_model/model.frag");
+    quantizedShader_.LoadFromFile(
+            config.dataRootPath + "shaders/06_hello_model/model_quantized.vert",
+            config.dataRootPath + "shaders/06_hello_model/model.frag");
 
 	glCheckError();
 
@@ -63,33 +69,45 @@ void HelloModelProgram::Update(seconds dt)
 void HelloModelProgram::Destroy()
 {
 	model_.Destroy();
+	quantizedModel_.Destroy();
 	shader_.Destroy();
+	quantizedShader_.Destroy();
 	textureManager_.Destroy();
 }
 
 void HelloModelProgram::DrawImGui()
 {
+	ImGui::Begin("Model Program");
+	ImGui::Checkbox("Quantized Vertices", &useQuantizedModel_);
+	const auto& model = useQuantizedModel_ ? quantizedModel_ : model_;
+	if (model.IsLoaded())
+	{
+		ImGui::Text("GPU mesh data: %.2f MB", static_cast<float>(model.GetGpuByteSize()) / (1024.0f * 1024.0f));
+	}
+	ImGui::End();
 }
 
 void HelloModelProgram::Render()
 {
-	if (shader_.GetProgram() == 0)
+	auto& model3d = useQuantizedModel_ ? quantizedModel_ : model_;
+	auto& shader = useQuantizedModel_ ? quantizedShader_ : shader_;
+	if (shader.GetProgram() == 0)
 		return;
     glCheckError();
 	std::lock_guard<std::mutex> lock(updateMutex_);
-	if(!model_.IsLoaded())
+	if(!model3d.IsLoaded())
 		return;
 
 	glCheckError();
-	shader_.Bind();
-	shader_.SetMat4("view", camera_.GenerateViewMatrix());
-	shader_.SetMat4("projection", projection_);
+	shader.Bind();
+	shader.SetMat4("view", camera_.GenerateViewMatrix());
+	shader.SetMat4("projection", projection_);
 	Mat4f model = Mat4f::Identity;
 	model = Transform3d::Rotate(model, degree_t(180.0f), Vec3f::up);
 	model = Transform3d::Scale(model, Vec3f(0.1f, 0.1f, 0.1f));
-	shader_.SetMat4("model", model);
-	shader_.SetMat4("normalMatrix", model.Inverse().Transpose());
-	model_.Draw(shader_);
+	shader.SetMat4("model", model);
+	shader.SetMat4("normalMatrix", model.Inverse().Transpose());
+	model3d.Draw(shader);
 }
 
 void HelloModelProgram::OnEvent(const SDL_Event& event)
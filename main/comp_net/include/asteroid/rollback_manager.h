@@ -25,6 +25,8 @@
 #pragma once
 #include "game.h"
 #include "engine/transform.h"
+#include "engine/custom_allocator.h"
+#include "engine/memory_budget.h"
 #include "asteroid/packet_type.h"
 #include "asteroid/physics_manager.h"
 #include "player_character.h"
@@ -97,8 +99,22 @@ private:
     static const size_t windowBufferSize = 5 * 50;
 	std::array<std::uint32_t, maxPlayerNmb> lastReceivedFrame_{};
 	std::array<std::array<net::PlayerInput, windowBufferSize>, maxPlayerNmb> inputs_{};
-	std::vector<CreatedEntity> createdEntities_;
-	std::vector<DestroyedBullet> destroyedBullets_;
+	/**
+	 * \brief Worst case of the rollback window, every player creating a bullet each frame.
+	 * The destroyed bullets are the ones created in the window and the few alive before it.
+	 */
+	static constexpr size_t maxRollbackEvents = windowBufferSize * maxPlayerNmb;
+	/**
+	 * \brief Arena backing the created entities and destroyed bullets buffers, allocated once at startup.
+	 * Both buffers are reserved at their worst case, the margin holds the allocation headers.
+	 */
+	static constexpr size_t rollbackMemorySize =
+		maxRollbackEvents * (sizeof(CreatedEntity) + sizeof(DestroyedBullet)) + 1024;
+	std::vector<std::uint8_t> rollbackMemory_;
+	FreeListAllocator rollbackAllocator_;
+	TaggedAllocator rollbackTaggedAllocator_;
+	AllocatorVector<CreatedEntity> createdEntities_;
+	AllocatorVector<DestroyedBullet> destroyedBullets_;
 public:
 	[[nodiscard]] const std::array<net::PlayerInput, windowBufferSize>& GetInputs(net::PlayerNumber playerNumber) const
 	{
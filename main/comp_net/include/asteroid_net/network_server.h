@@ -5,6 +5,7 @@
 #include "asteroid/game.h"
 #include "asteroid/packet_type.h"
 #include "asteroid/game_manager.h"
+#include "engine/memory_budget.h"
 
 namespace neko::net
 {
@@ -36,6 +37,10 @@ public:
     void Destroy() override;
 
     void SetTcpPort(unsigned short i);
+    /**
+     * \brief The per subsystem memory snapshot is logged at this period, 0 only keeps the accounting
+     */
+    void SetMemoryBudgetLogPeriod(seconds period) { memoryBudgetLogPeriod_ = period; }
 
     bool IsOpen();
 
@@ -60,6 +65,9 @@ private:
     std::array<ClientInfo, asteroid::maxPlayerNmb> clientMap_{};
     //Server game manager
     asteroid::GameManager gameManager_;
+    //The server runs for days, the growth of each subsystem is logged without attaching a profiler
+    MemoryBudgetManager memoryBudgetManager_;
+    seconds memoryBudgetLogPeriod_{60.0f};
 
     unsigned short tcpPort_ = 12345;
     unsigned short udpPort_ = 12345;
@@ -201,10 +201,7 @@ void ClientGameManager::Update(seconds dt)
 
             if (entityManager_.HasComponent(entity, EntityMask(neko::ComponentType::TRANSFORM2D)))
             {
-                transformManager_.SetPosition(entity, rollbackManager_.GetTransformManager().GetPosition(entity));
-                transformManager_.SetScale(entity, rollbackManager_.GetTransformManager().GetScale(entity));
-                transformManager_.SetRotation(entity, rollbackManager_.GetTransformManager().GetRotation(entity));
-                transformManager_.UpdateDirtyComponent(entity);
+                transformManager_.CopyTransform(entity, rollbackManager_.GetTransformManager());
             }
         }
     }
@@ -24,6 +24,7 @@
 #include <engine/conversion.h>
 #include "asteroid/rollback_manager.h"
 #include "asteroid/game_manager.h"
+#include "mathematics/checksum.h"
 
 #ifdef EASY_PROFILE_USE
 #include "easy/profiler.h"
@@ -39,12 +40,20 @@ RollbackManager::RollbackManager(GameManager& gameManager, EntityManager& entity
 	currentPhysicsManager_(entityManager), currentPlayerManager_(entityManager, currentPhysicsManager_, gameManager_),
 	currentBulletManager_(entityManager, gameManager),
 	lastValidatePhysicsManager_(entityManager),
-	lastValidatePlayerManager_(entityManager, lastValidatePhysicsManager_, gameManager_), lastValidateBulletManager_(entityManager, gameManager)
+	lastValidatePlayerManager_(entityManager, lastValidatePhysicsManager_, gameManager_), lastValidateBulletManager_(entityManager, gameManager),
+	rollbackMemory_(rollbackMemorySize),
+	rollbackAllocator_(rollbackMemorySize, rollbackMemory_.data()),
+	rollbackTaggedAllocator_(rollbackAllocator_, MemoryTag::ROLLBACK),
+	createdEntities_(StlAllocator<CreatedEntity>(rollbackTaggedAllocator_)),
+	destroyedBullets_(StlAllocator<DestroyedBullet>(rollbackTaggedAllocator_))
 {
 	for(auto& input: inputs_)
 	{
 		std::fill(input.begin(), input.end(), 0u);
 	}
+	//The buffers never grow in the arena, going over the worst case aborts in the allocator
+	createdEntities_.reserve(maxRollbackEvents);
+	destroyedBullets_.reserve(maxRollbackEvents);
     lastValidatePhysicsManager_.RegisterCollisionListener(*this);
 }
 
@@ -244,40 +253,16 @@ void RollbackManager::ConfirmFrame(net::Frame newValidateFrame, const std::array
 }
 PhysicsState RollbackManager::GetValidatePhysicsState(net::PlayerNumber playerNumber) const
 {
-	PhysicsState state = 0;
     const Entity playerEntity = gameManager_.GetEntityFromPlayerNumber(playerNumber);
     const auto& playerBody = lastValidatePhysicsManager_.GetBody(playerEntity);
 
-    const auto pos = playerBody.position;
-	const auto* posPtr = reinterpret_cast<const PhysicsState*>(&pos);
-	//Adding position
-	for(size_t i = 0; i < sizeof(Vec2f)/sizeof(PhysicsState); i++)
-	{
-		state += posPtr[i];
-	}
-
-	//Adding velocity
-	const auto velocity = playerBody.velocity;
-	const auto* velocityPtr = reinterpret_cast<const PhysicsState*>(&velocity);
-	for(size_t i = 0; i < sizeof(Vec2f)/sizeof(PhysicsState); i++)
-    {
-	    state += velocityPtr[i];
-    }
-    //Adding rotation
-    const auto angle = playerBody.rotation.value();
-    const auto* anglePtr = reinterpret_cast<const PhysicsState*>(&angle);
-    for (size_t i = 0; i < sizeof(float) / sizeof(PhysicsState); i++)
-    {
-        state += anglePtr[i];
-    }
-    //Adding angular Velocity
-    const auto angularVelocity = playerBody.angularVelocity.value();
-    const auto* angularVelPtr = reinterpret_cast<const PhysicsState*>(&angularVelocity);
-    for (size_t i = 0; i < sizeof(float) / sizeof(PhysicsState); i++)
-    {
-        state += angularVelPtr[i];
-    }
-	return state;
+    const std::array<float, 6> bodyState{
+        playerBody.position.x, playerBody.position.y,
+        playerBody.velocity.x, playerBody.velocity.y,
+        playerBody.rotation.value(), playerBody.angularVelocity.value() };
+    //Fold the crc to the PhysicsState size sent in the packets
+    const std::uint32_t crc = Crc32c(bodyState.data(), sizeof(bodyState));
+    return static_cast<PhysicsState>(crc ^ (crc >> 16u));
 }
 
 void RollbackManager::SpawnPlayer(net::PlayerNumber playerNumber, Entity entity, Vec2f position, degree_t rotation)
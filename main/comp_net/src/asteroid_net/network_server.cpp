@@ -129,6 +129,14 @@ void ServerNetworkManager::Init()
 	}
 	udpSocket_.setBlocking(false);
 	logDebug(fmt::format("[Server] Udp Socket on port: {}", udpPort_));
+	memoryBudgetManager_.Init();
+	if (memoryBudgetLogPeriod_.count() > 0.0f)
+	{
+		memoryBudgetManager_.SetSnapshotCallback(memoryBudgetLogPeriod_, [](const MemoryBudgetSnapshot& snapshot)
+		{
+			logDebug(FormatMemoryBudgetSnapshot(snapshot));
+		});
+	}
 	gameManager_.Init();
 	status_ = status_ | OPEN;
 
@@ -136,6 +144,7 @@ void ServerNetworkManager::Init()
 
 void ServerNetworkManager::Update(seconds dt)
 {
+	memoryBudgetManager_.Update(dt);
 	if (lastSocketIndex_ < asteroid::maxPlayerNmb)
 	{
 		const sf::Socket::Status status = tcpListener_.accept(
@@ -189,7 +198,7 @@ void ServerNetworkManager::Update(seconds dt)
 
 void ServerNetworkManager::Destroy()
 {
-
+	memoryBudgetManager_.Destroy();
 }
 
 void ServerNetworkManager::SetTcpPort(unsigned short i)
@@ -0,0 +1,137 @@
+/*
+ MIT License
+
+ Copyright (c) 2020 SAE Institute Switzerland AG
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in all
+ copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ SOFTWARE.
+ */
+
+#include <string_view>
+
+#include <fmt/format.h>
+
+#include "engine/log.h"
+#include "graphics/texture_cooker.h"
+#include "utilities/asset_archive.h"
+#include "utilities/asset_database.h"
+
+/**
+ * \brief Packs a validated data folder with its .meta files into an asset archive and/or an asset database,
+ * and/or cooks its textures with the default flags into a texture cache
+ * usage: asset_packer <data folder> [--archive <archive path>] [--database <database path>] [--cook <cache folder>] [--compress]
+ */
+int main(int argc, char** argv)
+{
+    constexpr std::string_view usage =
+        "Usage: asset_packer <data folder> [--archive <archive path>] [--database <database path>] "
+        "[--cook <cache folder>] [--compress]";
+    if (argc < 4)
+    {
+        logDebug(std::string(usage));
+        return 1;
+    }
+    const std::string_view dataFolder = argv[1];
+    std::string_view archivePath;
+    std::string_view databasePath;
+    std::string_view cacheFolder;
+    bool compress = false;
+    for (int i = 2; i < argc; i++)
+    {
+        const std::string_view argument = argv[i];
+        if (argument.empty())
+        {
+            continue;
+        }
+        if (argument == "--compress")
+        {
+            compress = true;
+        }
+        else if (argument == "--archive" && i + 1 < argc)
+        {
+            archivePath = argv[++i];
+        }
+        else if (argument == "--database" && i + 1 < argc)
+        {
+            databasePath = argv[++i];
+        }
+        else if (argument == "--cook" && i + 1 < argc)
+        {
+            cacheFolder = argv[++i];
+        }
+        else
+        {
+            logDebug(std::string(usage));
+            return 1;
+        }
+    }
+    if (!neko::IsDirectory(dataFolder))
+    {
+        logDebug(fmt::format("[Error] Data folder: {} does not exist", dataFolder));
+        return 1;
+    }
+
+    if (!archivePath.empty())
+    {
+        neko::AssetArchiveWriter writer;
+        const size_t count = writer.AddDirectory(dataFolder, compress);
+        if (!writer.Write(archivePath))
+        {
+            return 1;
+        }
+        logDebug(fmt::format("[Asset Packer] Packed {} assets from {} into {}", count, dataFolder, archivePath));
+    }
+    if (!databasePath.empty())
+    {
+        neko::AssetDatabase database;
+        const size_t count = database.Build(dataFolder);
+        if (!database.Write(databasePath))
+        {
+            return 1;
+        }
+        logDebug(fmt::format("[Asset Packer] Wrote {} assets from {} into {}", count, dataFolder, databasePath));
+    }
+    if (!cacheFolder.empty())
+    {
+        neko::TextureCooker textureCooker;
+        textureCooker.SetCacheFolder(cacheFolder);
+        textureCooker.SetSupercompression(compress);
+        if (!textureCooker.IsEnabled())
+        {
+            return 1;
+        }
+        size_t count = 0;
+        neko::IterateDirectory(dataFolder, [&textureCooker, &count](const std::string_view path)
+        {
+            if (!neko::IsRegularFile(path) || neko::GetAssetType(path) != neko::AssetType::TEXTURE)
+            {
+                return;
+            }
+            const bool hdr = neko::GetFilenameExtension(path) == ".hdr";
+            const auto flags = hdr ? neko::Texture::TextureFlags(neko::Texture::DEFAULT | neko::Texture::HDR) :
+                neko::Texture::DEFAULT;
+            //The ktx and dds textures are already GPU-ready and are skipped by the decoder
+            if (textureCooker.CookFile(path, flags))
+            {
+                count++;
+            }
+        }, true);
+        logDebug(fmt::format("[Asset Packer] Cooked {} textures from {} into {}", count, dataFolder, cacheFolder));
+    }
+    return 0;
+}
@@ -22,12 +22,17 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.
 */
 #include <iostream>
+#include <cmath>
 #include <fstream>
 #include <xxhash.hpp>
 #include <sole.hpp>
 #include <gtest/gtest.h>
 #include "utilities/file_utility.h"
 #include "engine/engine.h"
+#include "graphics/cooked_model.h"
+#include "graphics/obj_loader.h"
+#include "graphics/vertex_quantization.h"
+#include "mathematics/const.h"
 
 TEST(Engine, TestUUIDToStringToUUID)
 {
@@ -68,4 +73,296 @@ TEST(Engine, TestAssetImport)
 	EXPECT_NE(fileHashes[0], fileHashes[1]);
 	EXPECT_NE(fileHashes[1], fileHashes[2]);
 	EXPECT_NE(fileHashes[2], fileHashes[0]);
-}
\ No newline at end of file
+}
+
+TEST(Engine, TestCookedModel)
+{
+	const std::string folderPath = "cooked_model_data";
+	neko::CreateDirectory(folderPath);
+	std::vector<neko::MeshVertex> quadVertices(4);
+	for (size_t i = 0; i < quadVertices.size(); i++)
+	{
+		quadVertices[i].position = neko::Vec3f(float(i % 2) * 2.0f, float(i / 2), -1.0f);
+		quadVertices[i].texCoords = neko::Vec2f(float(i % 2), float(i / 2));
+	}
+	const std::vector<std::uint32_t> quadIndices = {0, 1, 2, 1, 3, 2};
+	std::vector<neko::MeshVertex> triangleVertices(3);
+	triangleVertices[1].position = neko::Vec3f(1.0f, 0.0f, 0.0f);
+	triangleVertices[2].position = neko::Vec3f(0.0f, 1.0f, 0.0f);
+	const std::vector<std::uint32_t> triangleIndices = {0, 1, 2};
+
+	std::vector<neko::CookedMeshSource> meshes(2);
+	meshes[0].vertices = quadVertices.data();
+	meshes[0].vertexCount = quadVertices.size();
+	meshes[0].indices = quadIndices.data();
+	meshes[0].indexCount = quadIndices.size();
+	meshes[0].specularExponent = 32.0f;
+	meshes[0].textures = {{"diffuse.png", 0}, {"textures/specular.png", 1}};
+	meshes[1].vertices = triangleVertices.data();
+	meshes[1].vertexCount = triangleVertices.size();
+	meshes[1].indices = triangleIndices.data();
+	meshes[1].indexCount = triangleIndices.size();
+	const std::string cookedPath = folderPath + "/model.nmesh";
+	ASSERT_TRUE(neko::WriteCookedModel(cookedPath, meshes));
+
+	neko::CookedModel cookedModel;
+	ASSERT_TRUE(cookedModel.Load(cookedPath));
+	ASSERT_EQ(cookedModel.GetMeshCount(), 2u);
+	const auto& quad = cookedModel.GetMesh(0);
+	ASSERT_EQ(quad.entry->vertexCount, quadVertices.size());
+	ASSERT_EQ(quad.entry->indexCount, quadIndices.size());
+	EXPECT_EQ(reinterpret_cast<std::uintptr_t>(quad.vertices) % 16, 0u);
+	for (size_t i = 0; i < quadVertices.size(); i++)
+	{
+		EXPECT_EQ(quad.vertices[i].position, quadVertices[i].position);
+		EXPECT_EQ(quad.vertices[i].texCoords, quadVertices[i].texCoords);
+	}
+	for (size_t i = 0; i < quadIndices.size(); i++)
+	{
+		EXPECT_EQ(quad.indices[i], quadIndices[i]);
+	}
+	EXPECT_EQ(quad.entry->aabbMin, neko::Vec3f(0.0f, 0.0f, -1.0f));
+	EXPECT_EQ(quad.entry->aabbMax, neko::Vec3f(2.0f, 1.0f, -1.0f));
+	EXPECT_EQ(quad.entry->boundingSphere.center_, neko::Vec3f(1.0f, 0.5f, -1.0f));
+	EXPECT_FLOAT_EQ(quad.entry->boundingSphere.radius_, std::sqrt(1.25f));
+	EXPECT_FLOAT_EQ(quad.entry->specularExponent, 32.0f);
+	ASSERT_EQ(quad.entry->textureCount, 2u);
+	EXPECT_EQ(cookedModel.GetTexturePath(quad.textures[0]), "diffuse.png");
+	EXPECT_EQ(cookedModel.GetTexturePath(quad.textures[1]), "textures/specular.png");
+	EXPECT_EQ(quad.textures[1].type, 1u);
+	const auto& triangle = cookedModel.GetMesh(1);
+	EXPECT_EQ(triangle.entry->textureCount, 0u);
+	EXPECT_EQ(triangle.indices[2], 2u);
+	EXPECT_EQ(triangle.vertices[2].position, triangleVertices[2].position);
+	cookedModel.Destroy();
+
+	//A truncated file is rejected instead of read out of bounds
+	neko::BufferFile cookedFile;
+	cookedFile.Load(cookedPath, neko::BufferFile::LoadMode::READ);
+	const std::string truncatedPath = folderPath + "/truncated.nmesh";
+	std::ofstream(truncatedPath, std::ofstream::binary).write(
+		reinterpret_cast<const char*>(cookedFile.dataBuffer), cookedFile.dataLength - 4);
+	cookedFile.Destroy();
+	EXPECT_FALSE(cookedModel.Load(truncatedPath));
+	EXPECT_FALSE(cookedModel.IsLoaded());
+	EXPECT_FALSE(cookedModel.Load(folderPath + "/missing.nmesh"));
+
+	//An index past the vertices of its mesh is rejected
+	const std::vector<std::uint32_t> corruptIndices = {0, 1, 3};
+	meshes[1].indices = corruptIndices.data();
+	const std::string corruptPath = folderPath + "/corrupt.nmesh";
+	ASSERT_TRUE(neko::WriteCookedModel(corruptPath, meshes));
+	EXPECT_FALSE(cookedModel.Load(corruptPath));
+	EXPECT_FALSE(cookedModel.IsLoaded());
+
+	neko::RemoveDirectory(folderPath);
+}
+
+TEST(Engine, TestObjParser)
+{
+	const std::string_view objText =
+		"# quad and triangle\n"
+		"mtllib cube.mtl\n"
+		"v 0 0 0\n"
+		"v 1.0 0 0\n"
+		"v 1 1.5e0 0\n"
+		"v -0.0 1.5 0\r\n"
+		"vt 0 0\n"
+		"vt 1 0\n"
+		"vt 1 1\n"
+		"vt 0 1\n"
+		"vn 0 0 1\n"
+		"o Quad\n"
+		"usemtl Red\n"
+		"f 1/1/1 2/2/1 3/3/1 4/4/1\n"
+		"f 1/1/1 3/3/1 4/4/1\n"
+		"o Triangle\n"
+		"v 0 0 2\n"
+		"v 2 0 2\n"
+		"v 0 2 2\n"
+		"f -3 -2 -1\n"
+		"usemtl Blue\n"
+		"f 5 6 7 100\n";
+	neko::ObjModel model;
+	std::vector<std::string> mtlLibraries;
+	ASSERT_TRUE(neko::ParseObj(objText, model, mtlLibraries));
+	ASSERT_EQ(mtlLibraries.size(), 1u);
+	EXPECT_EQ(mtlLibraries[0], "cube.mtl");
+	//The face with an out of range index is skipped and its mesh dropped
+	ASSERT_EQ(model.meshes.size(), 2u);
+	ASSERT_EQ(model.materials.size(), 3u);
+	EXPECT_EQ(model.materials[1].name, "Red");
+
+	const auto& quad = model.meshes[0];
+	EXPECT_EQ(quad.name, "Quad");
+	EXPECT_EQ(quad.materialIndex, 1u);
+	//The second face reuses the corners of the first one
+	EXPECT_EQ(quad.vertices.size(), 4u);
+	ASSERT_EQ(quad.indices.size(), 9u);
+	const std::vector<std::uint32_t> quadIndices = {0, 1, 2, 0, 2, 3, 0, 2, 3};
+	for (size_t i = 0; i < quadIndices.size(); i++)
+	{
+		EXPECT_EQ(quad.indices[i], quadIndices[i]);
+	}
+	EXPECT_EQ(quad.vertices[2].position, neko::Vec3f(1.0f, 1.5f, 0.0f));
+	//The v texture coordinate is flipped
+	EXPECT_EQ(quad.vertices[3].texCoords, neko::Vec2f(0.0f, 0.0f));
+	EXPECT_EQ(quad.vertices[0].normal, neko::Vec3f(0.0f, 0.0f, 1.0f));
+	EXPECT_NEAR(quad.vertices[0].tangent.x, 1.0f, 1e-5f);
+	EXPECT_NEAR(quad.vertices[0].bitangent.y, -1.0f, 1e-5f);
+	EXPECT_EQ(quad.aabbMin, neko::Vec3f(0.0f, 0.0f, 0.0f));
+	EXPECT_EQ(quad.aabbMax, neko::Vec3f(1.0f, 1.5f, 0.0f));
+
+	const auto& triangle = model.meshes[1];
+	EXPECT_EQ(triangle.name, "Triangle");
+	EXPECT_EQ(triangle.materialIndex, 1u);
+	ASSERT_EQ(triangle.vertices.size(), 3u);
+	EXPECT_EQ(triangle.vertices[1].position, neko::Vec3f(2.0f, 0.0f, 2.0f));
+	//Normals are generated when the obj has none
+	EXPECT_NEAR(triangle.vertices[0].normal.z, 1.0f, 1e-5f);
+
+	neko::ParseMtl(
+		"newmtl Blue\n"
+		"map_Kd blue.png\n"
+		"newmtl Red\n"
+		"Ns 96.0\n"
+		"map_Kd -s 1 1 1 red.png\n"
+		"bump -bm 0.5 red_normal.png\n",
+		model.materials);
+	EXPECT_FLOAT_EQ(model.materials[1].specularExponent, 96.0f);
+	EXPECT_EQ(model.materials[1].diffuseMap, "red.png");
+	EXPECT_EQ(model.materials[1].heightMap, "red_normal.png");
+	EXPECT_TRUE(model.materials[1].specularMap.empty());
+	EXPECT_EQ(model.materials[2].diffuseMap, "blue.png");
+}
+
+TEST(Engine, TestObjParserChunks)
+{
+	//Big enough to be split in several chunks, with negative indices crossing them
+	std::string objText;
+	const int quadCount = 40000;
+	for (int i = 0; i < quadCount; i++)
+	{
+		const float x = float(i);
+		objText += "v " + std::to_string(x) + " 0 0\nv " + std::to_string(x + 1.0f) + " 0 0\n";
+		objText += "v " + std::to_string(x + 1.0f) + " 1 0\nv " + std::to_string(x) + " 1 0\n";
+		objText += "f -4 -3 -2 -1\n";
+	}
+	neko::ObjModel model;
+	std::vector<std::string> mtlLibraries;
+	ASSERT_TRUE(neko::ParseObj(objText, model, mtlLibraries));
+	ASSERT_EQ(model.meshes.size(), 1u);
+	const auto& mesh = model.meshes[0];
+	ASSERT_EQ(mesh.vertices.size(), size_t(quadCount) * 4);
+	ASSERT_EQ(mesh.indices.size(), size_t(quadCount) * 6);
+	for (int i = 0; i < quadCount; i += 997)
+	{
+		EXPECT_EQ(mesh.vertices[i * 4 + 2].position, neko::Vec3f(float(i) + 1.0f, 1.0f, 0.0f));
+	}
+	EXPECT_EQ(mesh.aabbMax, neko::Vec3f(float(quadCount), 1.0f, 0.0f));
+}
+
+TEST(Engine, TestOctahedralEncoding)
+{
+	//Float acos cannot resolve much below this close to 1
+	const float maxAngle = 0.001f;
+	for (int i = 0; i < 64; i++)
+	{
+		for (int j = 0; j < 32; j++)
+		{
+			const float phi = float(i) / 64.0f * 2.0f * neko::PI;
+			const float theta = float(j) / 31.0f * neko::PI;
+			const neko::Vec3f direction(
+				std::sin(theta) * std::cos(phi), std::sin(theta) * std::sin(phi), std::cos(theta));
+			const auto decoded = neko::DecodeOctahedral(neko::EncodeOctahedral(direction));
+			EXPECT_NEAR(decoded.Magnitude(), 1.0f, 1e-5f);
+			EXPECT_LT(std::acos(std::min(neko::Vec3f::Dot(decoded, direction), 1.0f)), maxAngle);
+		}
+	}
+	//The poles and the folded edges
+	const neko::Vec3f axes[] = {
+		neko::Vec3f(0, 0, 1), neko::Vec3f(0, 0, -1), neko::Vec3f(1, 0, 0), neko::Vec3f(0, -1, 0)};
+	for (const auto& axis : axes)
+	{
+		const auto decoded = neko::DecodeOctahedral(neko::EncodeOctahedral(axis));
+		EXPECT_NEAR(neko::Vec3f::Dot(decoded, axis), 1.0f, 1e-6f);
+	}
+}
+
+TEST(Engine, TestVertexQuantization)
+{
+	const auto buildGrid = [](size_t size, std::vector<neko::MeshVertex>& vertices,
+		std::vector<std::uint32_t>& indices)
+	{
+		vertices.resize(size * size);
+		for (size_t y = 0; y < size; y++)
+		{
+			for (size_t x = 0; x < size; x++)
+			{
+				const float u = float(x) / float(size - 1);
+				const float v = float(y) / float(size - 1);
+				auto& vertex = vertices[y * size + x];
+				vertex.position = neko::Vec3f(u * 4.0f - 2.0f, std::sin(u * 6.0f) * 0.5f, v * -10.0f);
+				vertex.normal = neko::Vec3f(-std::cos(u * 6.0f) * 3.0f, 1.0f, 0.0f).Normalized();
+				vertex.tangent = neko::Vec3f(1.0f, std::cos(u * 6.0f) * 3.0f, 0.0f).Normalized();
+				//Mirrored uvs on half of the grid flip the bitangent
+				vertex.bitangent = neko::Vec3f::Cross(vertex.normal, vertex.tangent) * (x < size / 2 ? 1.0f : -1.0f);
+				vertex.texCoords = neko::Vec2f(u, v);
+			}
+		}
+		indices.clear();
+		for (size_t y = 0; y + 1 < size; y++)
+		{
+			for (size_t x = 0; x + 1 < size; x++)
+			{
+				const auto i = std::uint32_t(y * size + x);
+				const auto next = std::uint32_t(i + size);
+				indices.insert(indices.end(), {i, i + 1, next, i + 1, next + 1, next});
+			}
+		}
+	};
+	std::vector<neko::MeshVertex> vertices;
+	std::vector<std::uint32_t> indices;
+	buildGrid(64, vertices, indices);
+	neko::QuantizedMesh quantizedMesh;
+	neko::QuantizeMesh(vertices.data(), vertices.size(), indices.data(), indices.size(), quantizedMesh);
+	ASSERT_EQ(quantizedMesh.vertices.size(), vertices.size());
+	ASSERT_TRUE(quantizedMesh.HasShortIndices());
+	ASSERT_EQ(quantizedMesh.GetIndexCount(), indices.size());
+	for (size_t i = 0; i < indices.size(); i++)
+	{
+		EXPECT_EQ(quantizedMesh.shortIndices[i], indices[i]);
+	}
+	EXPECT_FLOAT_EQ(quantizedMesh.positionOffset.x, -2.0f);
+	EXPECT_FLOAT_EQ(quantizedMesh.positionOffset.z, -10.0f);
+	EXPECT_FLOAT_EQ(quantizedMesh.positionScale.z, 10.0f);
+
+	const auto error = neko::MeasureQuantizationError(vertices.data(), quantizedMesh);
+	//Within one step of the largest extent
+	EXPECT_LT(error.position, 10.0f / 65535.0f);
+	EXPECT_LT(error.normalAngle, 0.001f);
+	EXPECT_LT(error.tangentAngle, 0.001f);
+	EXPECT_LT(error.bitangentAngle, 0.002f);
+	//Half float precision around 1.0
+	EXPECT_LE(error.texCoords, 1.0f / 2048.0f);
+
+	const size_t floatSize = vertices.size() * sizeof(neko::MeshVertex) + indices.size() * sizeof(std::uint32_t);
+	EXPECT_LT(quantizedMesh.GetByteSize() * 2, floatSize);
+
+	//More than 65536 vertices cannot use 16-bit indices
+	buildGrid(257, vertices, indices);
+	neko::QuantizeMesh(vertices.data(), vertices.size(), indices.data(), indices.size(), quantizedMesh);
+	EXPECT_FALSE(quantizedMesh.HasShortIndices());
+	ASSERT_EQ(quantizedMesh.indices.size(), indices.size());
+	EXPECT_EQ(quantizedMesh.indices.back(), indices.back());
+
+	//A flat mesh keeps its constant coordinate
+	std::vector<neko::MeshVertex> flatVertices(3);
+	flatVertices[1].position = neko::Vec3f(1.0f, 0.0f, 3.0f);
+	flatVertices[2].position = neko::Vec3f(0.0f, 1.0f, 3.0f);
+	flatVertices[0].position = neko::Vec3f(0.0f, 0.0f, 3.0f);
+	const std::uint32_t flatIndices[] = {0, 1, 2};
+	neko::QuantizeMesh(flatVertices.data(), flatVertices.size(), flatIndices, 3, quantizedMesh);
+	EXPECT_EQ(neko::DequantizeVertex(quantizedMesh.vertices[1], quantizedMesh).position, flatVertices[1].position);
+	EXPECT_FLOAT_EQ(neko::DequantizeVertex(quantizedMesh.vertices[2], quantizedMesh).position.z, 3.0f);
+}
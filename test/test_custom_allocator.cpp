@@ -3,8 +3,14 @@
 //
 
 #include "engine/custom_allocator.h"
+#include "engine/frame_allocator.h"
+#include "engine/memory_budget.h"
 #include "gtest/gtest.h"
 #include <random>
+#include <thread>
+#include <queue>
+#include <mutex>
+#include <atomic>
 
 TEST(Engine, TestCustomAllocatorAlignment)
 {
@@ -91,6 +97,75 @@ TEST(Engine, TestFreeListAllocator)
 
 }
 
+TEST(Engine, TestTlsfAllocator)
+{
+    const size_t length = 100;
+    const size_t allocateNmb = 10;
+    void* data = calloc(length * 2, sizeof(int) * 4);
+    neko::TlsfAllocator allocator = neko::TlsfAllocator(sizeof(int) * 4 * (length * 2), data);
+    std::vector<int*> ptr;
+    ptr.reserve(length/allocateNmb);
+    for (size_t i = 0; i < length/allocateNmb; i++)
+    {
+        int* v = (int*) allocator.Allocate(sizeof(int)*allocateNmb, alignof(int));
+        ptr.push_back(v);
+        for(size_t j = 0; j < allocateNmb; j++)
+        {
+            v[j] = rand();
+        }
+    }
+    std::cout << "Used Memory: " << allocator.GetUsedMemory() << "B for total size: " << allocator.GetSize() << "B"
+              << std::endl;
+    std::random_device rd;
+    std::mt19937 g(rd());
+    std::shuffle(ptr.begin(), ptr.end(), g);
+    std::for_each(ptr.begin(), ptr.end(), [&allocator](int* p) { allocator.Deallocate(p); });
+    EXPECT_EQ(allocator.GetUsedMemory(), 0);
+    free(data);
+}
+
+TEST(Engine, TestTlsfAllocatorChurn)
+{
+    const size_t memorySize = 1 << 20;
+    const size_t allocationNmb = 1000;
+    void* data = calloc(memorySize, 1);
+    neko::TlsfAllocator allocator = neko::TlsfAllocator(memorySize, data);
+    std::mt19937 g(0);
+    std::uniform_int_distribution<size_t> sizeDistribution(1, 512);
+    std::uniform_int_distribution<size_t> alignmentDistribution(0, 6);
+    std::vector<std::pair<std::uint8_t*, size_t>> allocations;
+    allocations.reserve(allocationNmb);
+    for (size_t round = 0; round < 10; round++)
+    {
+        while (allocations.size() < allocationNmb)
+        {
+            const size_t size = sizeDistribution(g);
+            const size_t alignment = size_t(1) << alignmentDistribution(g);
+            auto* p = static_cast<std::uint8_t*>(allocator.Allocate(size, alignment));
+            ASSERT_NE(p, nullptr);
+            EXPECT_EQ(neko::Allocator::CalculateAlignForwardAdjustment(p, alignment), 0);
+            std::fill(p, p + size, std::uint8_t(size));
+            allocations.emplace_back(p, size);
+        }
+        std::shuffle(allocations.begin(), allocations.end(), g);
+        //Freeing half of the allocations, checking that no other allocation overwrote them
+        for (size_t i = 0; i < allocationNmb / 2; i++)
+        {
+            const auto [p, size] = allocations.back();
+            EXPECT_TRUE(std::all_of(p, p + size, [size](std::uint8_t v) { return v == std::uint8_t(size); }));
+            allocator.Deallocate(p);
+            allocations.pop_back();
+        }
+    }
+    std::for_each(allocations.begin(), allocations.end(), [&allocator](auto& allocation) { allocator.Deallocate(allocation.first); });
+    EXPECT_EQ(allocator.GetUsedMemory(), 0);
+    //All blocks are coalesced back into one
+    void* p = allocator.Allocate(memorySize / 2, alignof(int));
+    EXPECT_NE(p, nullptr);
+    allocator.Deallocate(p);
+    free(data);
+}
+
 TEST(Engine, TestPoolAllocator)
 {
     struct Prout
@@ -118,4 +193,248 @@ TEST(Engine, TestPoolAllocator)
     std::for_each(ptr.begin(), ptr.end(), [&allocator](Prout* p) { allocator.Deallocate(p); });
     free(data);
 
-}
\ No newline at end of file
+}
+
+TEST(Engine, TestConcurrentPoolAllocator)
+{
+    struct Packet
+    {
+        std::uint64_t id = 0;
+        float value = 0.0f;
+    };
+    const size_t length = 16;
+    const size_t packetNmb = 10'000;
+    const size_t maxQueueSize = 256;
+    void* data = calloc(length + 1, sizeof(Packet));
+    neko::ConcurrentPoolAllocator<Packet> allocator(sizeof(Packet) * (length + 1), data, true);
+
+    std::mutex queueMutex;
+    std::queue<Packet*> packets;
+    std::atomic<bool> producerDone{false};
+    size_t validPacketNmb = 0;
+    std::thread producer([&]
+    {
+        for (size_t i = 0; i < packetNmb; i++)
+        {
+            while (true)
+            {
+                std::lock_guard<std::mutex> lock(queueMutex);
+                if (packets.size() < maxQueueSize)
+                    break;
+            }
+            auto* packet = new(allocator.Allocate(sizeof(Packet), alignof(Packet))) Packet{i, float(i)};
+            std::lock_guard<std::mutex> lock(queueMutex);
+            packets.push(packet);
+        }
+        producerDone = true;
+    });
+    std::thread consumer([&]
+    {
+        while (true)
+        {
+            Packet* packet = nullptr;
+            {
+                std::lock_guard<std::mutex> lock(queueMutex);
+                if (!packets.empty())
+                {
+                    packet = packets.front();
+                    packets.pop();
+                }
+            }
+            if (packet == nullptr)
+            {
+                if (producerDone)
+                {
+                    std::lock_guard<std::mutex> lock(queueMutex);
+                    if (packets.empty())
+                        break;
+                }
+                continue;
+            }
+            if (float(packet->id) == packet->value)
+                validPacketNmb++;
+            allocator.Deallocate(packet);
+        }
+    });
+    producer.join();
+    consumer.join();
+    EXPECT_EQ(validPacketNmb, packetNmb);
+    EXPECT_EQ(allocator.GetUsedMemory(), 0);
+    std::cout << "Concurrent Pool Allocator chunks: " << allocator.GetChunkNmb() << std::endl;
+    free(data);
+}
+
+TEST(Engine, TestConcurrentPoolAllocatorThreadExit)
+{
+    struct Packet
+    {
+        std::uint64_t id = 0;
+        float value = 0.0f;
+    };
+    using Allocator = neko::ConcurrentPoolAllocator<Packet>;
+    const size_t length = 256;
+    void* data = calloc(length + 1, sizeof(Packet));
+    Allocator allocator(sizeof(Packet) * (length + 1), data);
+
+    //Each thread leaves blocks in its magazine, more threads than magazines are created one after the other
+    const size_t threadNmb = 3 * Allocator::maxThreadNmb;
+    std::atomic<size_t> allocationNmb{0};
+    std::uint32_t maxThreadIndex = 0;
+    for (size_t i = 0; i < threadNmb; i++)
+    {
+        std::thread thread([&]
+        {
+            maxThreadIndex = std::max(maxThreadIndex, neko::GetThreadCacheIndex());
+            void* p = allocator.Allocate(sizeof(Packet), alignof(Packet));
+            if (p != nullptr)
+            {
+                allocationNmb++;
+                allocator.Deallocate(p);
+            }
+        });
+        thread.join();
+    }
+    EXPECT_EQ(allocationNmb.load(), threadNmb);
+    EXPECT_LT(maxThreadIndex, Allocator::maxThreadNmb);
+    EXPECT_EQ(allocator.GetUsedMemory(), 0);
+
+    //No block is stranded in the magazines of the exited threads
+    std::vector<void*> blocks;
+    for (size_t i = 0; i < length; i++)
+    {
+        blocks.push_back(allocator.Allocate(sizeof(Packet), alignof(Packet)));
+        ASSERT_NE(blocks.back(), nullptr);
+    }
+    for (auto* block : blocks)
+    {
+        allocator.Deallocate(block);
+    }
+    EXPECT_EQ(allocator.GetUsedMemory(), 0);
+    free(data);
+}
+
+TEST(Engine, TestStlAllocator)
+{
+    const size_t length = 100;
+    const size_t memorySize = 4096;
+    void* data = calloc(memorySize, 1);
+    neko::FreeListAllocator allocator = neko::FreeListAllocator(memorySize, data);
+    {
+        neko::AllocatorVector<int> v{neko::StlAllocator<int>(allocator)};
+        for (size_t i = 0; i < length; i++)
+        {
+            v.push_back(static_cast<int>(i));
+        }
+        EXPECT_GT(allocator.GetUsedMemory(), 0);
+        for (size_t i = 0; i < length; i++)
+        {
+            EXPECT_EQ(v[i], static_cast<int>(i));
+        }
+        neko::AllocatorVector<int>(v.get_allocator()).swap(v);
+        EXPECT_EQ(allocator.GetUsedMemory(), 0);
+        v.push_back(3);
+        EXPECT_EQ(v.get_allocator(), neko::StlAllocator<float>(allocator));
+    }
+    EXPECT_EQ(allocator.GetUsedMemory(), 0);
+    free(data);
+}
+
+TEST(Engine, TestStlAllocatorExhausted)
+{
+    const size_t memorySize = 256;
+    void* data = calloc(memorySize, 1);
+    neko::FreeListAllocator allocator = neko::FreeListAllocator(memorySize, data);
+    neko::AllocatorVector<int> v{neko::StlAllocator<int>(allocator)};
+    //A full arena fails loudly instead of handing a null pointer to the vector
+    EXPECT_DEATH(v.reserve(memorySize), "no room");
+    free(data);
+}
+
+TEST(Engine, TestFrameAllocator)
+{
+    neko::FrameAllocator& frameAllocator = neko::FrameAllocator::Get();
+    int* previous = static_cast<int*>(frameAllocator.Allocate(sizeof(int), alignof(int)));
+    *previous = 42;
+    neko::FrameAllocator::NewFrame();
+    {
+        neko::AllocatorVector<int> v{neko::GetFrameStlAllocator<int>()};
+        for (int i = 0; i < 100; i++)
+        {
+            v.push_back(i);
+        }
+        EXPECT_EQ(v[99], 99);
+        //Allocation from previous frame stays valid
+        EXPECT_EQ(*previous, 42);
+    }
+    neko::FrameAllocator::NewFrame();
+    int* current = static_cast<int*>(frameAllocator.Allocate(sizeof(int), alignof(int)));
+    //Two frames later, the first buffer is reused
+    EXPECT_EQ(current, previous);
+#ifdef __neko_dbg__
+    EXPECT_EQ(*reinterpret_cast<std::uint8_t*>(current), neko::FrameAllocator::poisonValue);
+#endif
+    EXPECT_EQ(frameAllocator.GetFrameIndex(), neko::FrameAllocator::GetGlobalFrameIndex());
+
+    neko::FrameAllocator* otherThreadAllocator = nullptr;
+    std::thread otherThread([&otherThreadAllocator]
+    {
+        otherThreadAllocator = &neko::FrameAllocator::Get();
+        otherThreadAllocator->Allocate(sizeof(int), alignof(int));
+    });
+    otherThread.join();
+    EXPECT_NE(otherThreadAllocator, &frameAllocator);
+}
+
+TEST(Engine, TestMemoryBudget)
+{
+    const size_t memorySize = 4096;
+    void* data = calloc(memorySize, 1);
+    neko::FreeListAllocator freeListAllocator(memorySize, data);
+    neko::MemoryBudgetManager memoryBudgetManager;
+    memoryBudgetManager.Init();
+    memoryBudgetManager.SetBudget(neko::MemoryTag::ROLLBACK, 256);
+    size_t overrunNmb = 0;
+    memoryBudgetManager.SetOverrunCallback([&overrunNmb](neko::MemoryTag tag, size_t currentMemory, size_t budget)
+    {
+        EXPECT_EQ(tag, neko::MemoryTag::ROLLBACK);
+        EXPECT_GT(currentMemory, budget);
+        overrunNmb++;
+    });
+    size_t snapshotNmb = 0;
+    memoryBudgetManager.SetSnapshotCallback(neko::seconds(1.0f), [&snapshotNmb](const neko::MemoryBudgetSnapshot& snapshot)
+    {
+        EXPECT_EQ(snapshot[static_cast<size_t>(neko::MemoryTag::ROLLBACK)].allocationNmb, 3);
+        snapshotNmb++;
+    });
+    {
+        neko::TaggedAllocator allocator(freeListAllocator, neko::MemoryTag::ROLLBACK);
+        void* p1 = allocator.AllocateFrom(100, alignof(int), NEKO_ALLOCATION_SITE);
+        void* p2 = allocator.Allocate(100, alignof(int));
+        EXPECT_EQ(overrunNmb, 0);
+        void* p3 = allocator.Allocate(100, alignof(int));
+        EXPECT_EQ(overrunNmb, 1);
+        const auto stats = memoryBudgetManager.GetStats(neko::MemoryTag::ROLLBACK);
+        EXPECT_EQ(stats.currentMemory, freeListAllocator.GetUsedMemory());
+        EXPECT_EQ(stats.allocationNmb, 3);
+#ifdef __neko_dbg__
+        EXPECT_EQ(memoryBudgetManager.GetAllocationSites(neko::MemoryTag::ROLLBACK).size(), 2);
+#endif
+        memoryBudgetManager.Update(neko::seconds(0.5f));
+        EXPECT_EQ(snapshotNmb, 0);
+        memoryBudgetManager.Update(neko::seconds(0.6f));
+        EXPECT_EQ(snapshotNmb, 1);
+
+        allocator.Deallocate(p3);
+        allocator.Deallocate(p2);
+        allocator.Deallocate(p1);
+    }
+    const auto stats = memoryBudgetManager.GetStats(neko::MemoryTag::ROLLBACK);
+    EXPECT_EQ(stats.currentMemory, 0);
+    EXPECT_GE(stats.peakMemory, 300);
+    //Freeing memory allocated before the manager was provided does not wrap the counters
+    memoryBudgetManager.RecordAllocation(neko::MemoryTag::MESH, data, 64);
+    memoryBudgetManager.RecordDeallocation(neko::MemoryTag::MESH, data, 128);
+    EXPECT_EQ(memoryBudgetManager.GetStats(neko::MemoryTag::MESH).currentMemory, 0);
+    memoryBudgetManager.Destroy();
+    free(data);
+}
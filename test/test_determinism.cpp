@@ -3,6 +3,9 @@
 #include "mathematics/checksum.h"
 #include "mathematics/vector.h"
 
+#include <string>
+#include <vector>
+
 #include <fmt/format.h>
 
 TEST(CompNet, FloatDeterminism)
@@ -17,4 +20,80 @@ TEST(CompNet, FloatDeterminism)
     checksum += neko::Checksum<std::uint8_t>(p);
   }
   logDebug(fmt::format("Float checksum: {}", checksum));
-}
\ No newline at end of file
+}
+TEST(CompNet, Crc32c)
+{
+  const std::string check = "123456789";
+  EXPECT_EQ(neko::Crc32c(check.data(), check.size()), 0xE3069283u);
+  EXPECT_EQ(neko::Crc32c(check.data() + 4, 5, neko::Crc32c(check.data(), 4)), 0xE3069283u);
+  EXPECT_EQ(neko::Crc32c(check.data(), 0), 0u);
+}
+
+TEST(CompNet, Hash64)
+{
+  std::vector<std::uint8_t> buffer(100000);
+  for (size_t i = 0; i < buffer.size(); i++)
+  {
+    buffer[i] = static_cast<std::uint8_t>(i * 131 + 7);
+  }
+  //Every instruction set must give the same hashes to compare them between machines
+  EXPECT_EQ(neko::Hash64(buffer.data(), 0), 0xf03bb01c6706af00ull);
+  EXPECT_EQ(neko::Hash64(buffer.data(), 9), 0x024229880ac2f481ull);
+  EXPECT_EQ(neko::Hash64(buffer.data(), 65), 0x4fb7c73f419399f0ull);
+  EXPECT_EQ(neko::Hash64(buffer.data(), 1100), 0x5a2cf45bf6a2d9bdull);
+  EXPECT_EQ(neko::Hash64(buffer.data(), buffer.size()), 0xf08b6bea41c6d542ull);
+  EXPECT_EQ(neko::Hash64(buffer.data(), 1000, 42), 0x57cab5d85ae04862ull);
+
+  //Swapping two entities must change the hash
+  std::vector<neko::Vec2f> positions(256);
+  for (size_t i = 0; i < positions.size(); i++)
+  {
+    positions[i] = neko::Vec2f(static_cast<float>(i), -static_cast<float>(i));
+  }
+  const auto hash = neko::Hash64(positions);
+  std::swap(positions[3], positions[11]);
+  EXPECT_NE(neko::Hash64(positions), hash);
+  std::swap(positions[3], positions[11]);
+  EXPECT_EQ(neko::Hash64(positions), hash);
+}
+
+TEST(CompNet, ChunkedChecksum)
+{
+  std::vector<neko::Vec2f> positions(1000, neko::Vec2f::one);
+  neko::ChunkedChecksum checksum(256);
+  const auto initialHash = checksum.Update(positions.data(), positions.size() * sizeof(neko::Vec2f));
+
+  positions[500] = neko::Vec2f(2.0f, 3.0f);
+  checksum.SetDirty(500 * sizeof(neko::Vec2f), sizeof(neko::Vec2f));
+  const auto dirtyHash = checksum.Update(positions.data(), positions.size() * sizeof(neko::Vec2f));
+  EXPECT_NE(dirtyHash, initialHash);
+  neko::ChunkedChecksum fullChecksum(256);
+  EXPECT_EQ(fullChecksum.Update(positions.data(), positions.size() * sizeof(neko::Vec2f)), dirtyHash);
+
+  //Without SetDirty the modification is not seen
+  positions[0] = neko::Vec2f::zero;
+  EXPECT_EQ(checksum.Update(positions.data(), positions.size() * sizeof(neko::Vec2f)), dirtyHash);
+  checksum.SetAllDirty();
+  positions.push_back(neko::Vec2f::one);
+  fullChecksum.SetAllDirty();
+  EXPECT_EQ(checksum.Update(positions.data(), positions.size() * sizeof(neko::Vec2f)),
+    fullChecksum.Update(positions.data(), positions.size() * sizeof(neko::Vec2f)));
+
+  //A resize rehashes the last chunks
+  positions.resize(300);
+  positions[299] = neko::Vec2f(5.0f, 5.0f);
+  neko::ChunkedChecksum resizedChecksum(256);
+  EXPECT_EQ(checksum.Update(positions.data(), positions.size() * sizeof(neko::Vec2f)),
+    resizedChecksum.Update(positions.data(), positions.size() * sizeof(neko::Vec2f)));
+
+  //Empty chunks would divide by zero
+#ifdef NEKO_ASSERT
+  EXPECT_DEATH(neko::ChunkedChecksum(0), "empty chunks");
+#else
+  neko::ChunkedChecksum emptyChunkChecksum(0);
+  EXPECT_EQ(emptyChunkChecksum.GetChunkSize(), neko::ChunkedChecksum::defaultChunkSize);
+  neko::ChunkedChecksum defaultChecksum;
+  EXPECT_EQ(emptyChunkChecksum.Update(positions.data(), positions.size() * sizeof(neko::Vec2f)),
+    defaultChecksum.Update(positions.data(), positions.size() * sizeof(neko::Vec2f)));
+#endif
+}
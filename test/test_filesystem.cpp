@@ -3,9 +3,15 @@
 //
 
 #include "utilities/file_utility.h"
+#include "utilities/asset_archive.h"
+#include "utilities/asset_database.h"
 #include <gtest/gtest.h>
 
+#include <cstring>
+#include <thread>
+
 #include <filesystem>
+#include <fmt/format.h>
 namespace fs = std::filesystem;
 
 TEST(Engine, TestFilesystem)
@@ -27,4 +33,215 @@ TEST(Engine, TestPathCompare)
     //EXPECT_TRUE(fs::absolute(texture1) == fs::absolute(texture2));
     EXPECT_TRUE(texture1 != texture3);
 	
-}
\ No newline at end of file
+}
+TEST(Engine, TestBufferFileMapping)
+{
+    const std::string bigPath = "buffer_file_big.bin";
+    const std::string smallPath = "buffer_file_small.txt";
+    {
+        //Not a multiple of the page size to keep the null termination in the mapping
+        std::string content(neko::BufferFile::mapSizeThreshold + 123, 'a');
+        for (size_t i = 0; i < content.size(); i++)
+        {
+            content[i] = static_cast<char>('a' + i % 26);
+        }
+        neko::WriteStringToFile(bigPath, content);
+        neko::WriteStringToFile(smallPath, "small file");
+    }
+
+    neko::BufferFile bigFile;
+    bigFile.Load(bigPath);
+    ASSERT_NE(bigFile.dataBuffer, nullptr);
+    EXPECT_EQ(bigFile.dataLength, neko::BufferFile::mapSizeThreshold + 123);
+    EXPECT_EQ(bigFile.dataBuffer[bigFile.dataLength], 0);
+    EXPECT_EQ(bigFile.dataBuffer[27], 'b');
+#ifdef __linux__
+    EXPECT_TRUE(bigFile.IsMapped());
+#endif
+
+    neko::BufferFile readFile;
+    readFile.Load(bigPath, neko::BufferFile::LoadMode::READ);
+    EXPECT_FALSE(readFile.IsMapped());
+    ASSERT_EQ(readFile.dataLength, bigFile.dataLength);
+    EXPECT_EQ(std::memcmp(readFile.dataBuffer, bigFile.dataBuffer, bigFile.dataLength), 0);
+
+    neko::BufferFile smallFile;
+    smallFile.Load(smallPath);
+    EXPECT_FALSE(smallFile.IsMapped());
+    EXPECT_STREQ(reinterpret_cast<const char*>(smallFile.dataBuffer), "small file");
+    smallFile.Load(smallPath, neko::BufferFile::LoadMode::MAP);
+    EXPECT_STREQ(reinterpret_cast<const char*>(smallFile.dataBuffer), "small file");
+
+    //Moving keeps the mapping, the moved buffer is unmapped once
+    neko::BufferFile movedFile = std::move(bigFile);
+    EXPECT_EQ(bigFile.dataBuffer, nullptr);
+    EXPECT_FALSE(bigFile.IsMapped());
+    EXPECT_EQ(movedFile.dataBuffer[27], 'b');
+    movedFile = std::move(smallFile);
+    EXPECT_STREQ(reinterpret_cast<const char*>(movedFile.dataBuffer), "small file");
+
+    movedFile.Destroy();
+    readFile.Destroy();
+    fs::remove(bigPath);
+    fs::remove(smallPath);
+}
+
+TEST(Engine, TestAssetArchive)
+{
+    const std::string folderPath = "asset_archive_data";
+    const std::string archivePath = "asset_archive_test.nkpk";
+    const std::string textureUuid = "5a4a8b52-2f2b-11eb-adc1-0242ac120002";
+    neko::CreateDirectory(folderPath);
+    neko::CreateDirectory(folderPath + "/sprites");
+    neko::WriteStringToFile(folderPath + "/sprites/wall.png", "not really a png");
+    neko::WriteStringToFile(folderPath + "/sprites/wall.png.meta",
+        "{\"uuid\": \"" + textureUuid + "\", \"linear\": false, \"ktx2\": true}");
+    neko::WriteStringToFile(folderPath + "/scene.json", "{}");
+    const std::string bigContent(100'000, 'n');
+    neko::WriteStringToFile(folderPath + "/big.txt", bigContent);
+
+    neko::AssetArchiveWriter writer;
+    EXPECT_EQ(writer.AddDirectory(folderPath, true), 3u);
+    ASSERT_TRUE(writer.Write(archivePath));
+
+    neko::AssetArchive archive;
+    ASSERT_TRUE(archive.Open(archivePath, "../data/"));
+    EXPECT_EQ(archive.GetEntryCount(), 3u);
+
+    const auto* texture = archive.FindEntry("../data/sprites/wall.png");
+    ASSERT_NE(texture, nullptr);
+    EXPECT_EQ(archive.GetPath(*texture), "sprites/wall.png");
+    EXPECT_TRUE(texture->GetId() == sole::rebuild(textureUuid));
+    EXPECT_EQ(texture->type, neko::AssetType::TEXTURE);
+    EXPECT_TRUE(texture->HasFlag(neko::AssetArchiveEntry::HAS_META));
+    EXPECT_TRUE(texture->HasFlag(neko::AssetArchiveEntry::KTX2));
+    EXPECT_FALSE(texture->HasFlag(neko::AssetArchiveEntry::LINEAR));
+    EXPECT_EQ(archive.FindEntry(sole::rebuild(textureUuid)), texture);
+    EXPECT_EQ(texture->offset % neko::AssetArchiveWriter::defaultAlignment, 0u);
+
+    //Uncompressed entries are null-terminated views in the archive
+    neko::BufferFile textureFile;
+    ASSERT_TRUE(archive.LoadBufferFile("sprites/wall.png", textureFile));
+    EXPECT_TRUE(textureFile.IsView());
+    EXPECT_STREQ(reinterpret_cast<const char*>(textureFile.dataBuffer), "not really a png");
+    textureFile.Destroy();
+
+    const auto* scene = archive.FindEntry("scene.json");
+    ASSERT_NE(scene, nullptr);
+    EXPECT_FALSE(scene->HasFlag(neko::AssetArchiveEntry::HAS_META));
+    EXPECT_EQ(archive.FindEntry(scene->GetId()), nullptr);
+
+    neko::BufferFile bigFile;
+    ASSERT_TRUE(archive.LoadBufferFile("../data/big.txt", bigFile));
+    ASSERT_EQ(bigFile.dataLength, bigContent.size());
+    EXPECT_EQ(bigFile.dataBuffer[bigFile.dataLength], 0);
+    EXPECT_EQ(std::memcmp(bigFile.dataBuffer, bigContent.data(), bigContent.size()), 0);
+#ifdef NEKO_ZSTD
+    EXPECT_TRUE(archive.FindEntry("big.txt")->HasFlag(neko::AssetArchiveEntry::COMPRESSED));
+    EXPECT_FALSE(bigFile.IsView());
+#endif
+    bigFile.Destroy();
+
+    EXPECT_EQ(archive.FindEntry("../data/sprites/missing.png"), nullptr);
+    EXPECT_FALSE(archive.LoadBufferFile("missing.txt", bigFile));
+
+    archive.Close();
+    EXPECT_FALSE(archive.IsOpen());
+    fs::remove(archivePath);
+    neko::RemoveDirectory(folderPath);
+}
+
+TEST(Engine, TestAssetDatabase)
+{
+    const std::string folderPath = "asset_database_data";
+    const std::string databasePath = "asset_database_test.nkdb";
+    const std::string textureUuid = "7f1e8a36-2f2b-11eb-adc1-0242ac120002";
+    const std::string fontUuid = "8c0f3c2e-2f2b-11eb-adc1-0242ac120002";
+    neko::CreateDirectory(folderPath);
+    neko::CreateDirectory(folderPath + "/fonts");
+    neko::WriteStringToFile(folderPath + "/wall.jpg", "");
+    neko::WriteStringToFile(folderPath + "/wall.jpg.meta", "{\"uuid\": \"" + textureUuid + "\", \"linear\": true}");
+    neko::WriteStringToFile(folderPath + "/fonts/title.ttf", "");
+    neko::WriteStringToFile(folderPath + "/fonts/title.ttf.meta", "{\"uuid\": \"" + fontUuid + "\"}");
+    neko::WriteStringToFile(folderPath + "/no_uuid.png.meta", "{\"linear\": true}");
+
+    {
+        neko::AssetDatabase database;
+        EXPECT_EQ(database.Build(folderPath), 2u);
+        ASSERT_TRUE(database.Write(databasePath));
+    }
+
+    neko::AssetDatabase database;
+    database.SetMountPath("../data/");
+    ASSERT_TRUE(database.Load(databasePath));
+    EXPECT_EQ(database.GetAssetCount(), 2u);
+
+    neko::AssetRecord texture;
+    ASSERT_TRUE(database.FindAsset("../data/wall.jpg", texture));
+    EXPECT_TRUE(texture.GetId() == sole::rebuild(textureUuid));
+    EXPECT_EQ(texture.type, neko::AssetType::TEXTURE);
+    EXPECT_TRUE(texture.HasFlag(neko::AssetArchiveEntry::LINEAR));
+    neko::AssetRecord mountedTexture;
+    ASSERT_TRUE(database.FindAsset("wall.jpg", mountedTexture));
+    EXPECT_EQ(mountedTexture.pathHash, texture.pathHash);
+
+    neko::AssetRecord font;
+    ASSERT_TRUE(database.FindAsset("..\\data\\fonts\\title.ttf", font));
+    EXPECT_TRUE(font.GetId() == sole::rebuild(fontUuid));
+    EXPECT_EQ(font.type, neko::AssetType::FONT);
+    neko::AssetRecord unknown;
+    EXPECT_FALSE(database.FindAsset("../data/no_uuid.png", unknown));
+
+    //Loaders register the assets parsed from their .meta file
+    const auto newId = sole::uuid4();
+    database.AddAsset("../data/sprites/new.png", newId, neko::AssetType::TEXTURE, neko::AssetArchiveEntry::HAS_META);
+    neko::AssetRecord newTexture;
+    ASSERT_TRUE(database.FindAsset("sprites/new.png", newTexture));
+    EXPECT_TRUE(newTexture.GetId() == newId);
+    EXPECT_EQ(database.GetPath(newTexture), "sprites/new.png");
+
+    fs::remove(databasePath);
+    neko::RemoveDirectory(folderPath);
+}
+
+TEST(Engine, TestAssetDatabaseConcurrentAccess)
+{
+    constexpr int threadCount = 4;
+    constexpr int assetCount = 256;
+    neko::AssetDatabase database;
+    std::vector<std::vector<sole::uuid>> ids(threadCount);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; t++)
+    {
+        ids[t].resize(assetCount);
+        threads.emplace_back([&database, &ids, t]
+        {
+            //The loaders register their assets while the others look theirs up
+            for (int i = 0; i < assetCount; i++)
+            {
+                const std::string path = fmt::format("sprites/thread{}/texture{}.png", t, i);
+                neko::AssetRecord record;
+                if (!database.FindAsset(path, record))
+                {
+                    ids[t][i] = sole::uuid4();
+                    database.AddAsset(path, ids[t][i], neko::AssetType::TEXTURE, neko::AssetArchiveEntry::HAS_META);
+                }
+                database.FindAsset(fmt::format("sprites/thread0/texture{}.png", i), record);
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    EXPECT_EQ(database.GetAssetCount(), size_t(threadCount * assetCount));
+    for (int t = 0; t < threadCount; t++)
+    {
+        for (int i = 0; i < assetCount; i++)
+        {
+            neko::AssetRecord record;
+            ASSERT_TRUE(database.FindAsset(fmt::format("sprites/thread{}/texture{}.png", t, i), record));
+            EXPECT_TRUE(record.GetId() == ids[t][i]);
+        }
+    }
+}
@@ -54,4 +54,20 @@ TEST(Engine, TestJobSystem)
     //EXPECT_EQ(TASKS_COUNT, doneTasks);
 }
 
+TEST(Engine, TestCancelJob)
+{
+    //Without workers the jobs stay in their queue
+    JobSystem jobSystem;
+    bool isExecuted = false;
+    Job job([&isExecuted] { isExecuted = true; });
+    Job otherJob;
+    jobSystem.ScheduleJob(&otherJob, JobThreadType::RESOURCE_THREAD);
+    jobSystem.ScheduleJob(&job, JobThreadType::RESOURCE_THREAD);
+    EXPECT_FALSE(jobSystem.CancelJob(&job, JobThreadType::OTHER_THREAD));
+    EXPECT_TRUE(jobSystem.CancelJob(&job, JobThreadType::RESOURCE_THREAD));
+    EXPECT_FALSE(jobSystem.CancelJob(&job, JobThreadType::RESOURCE_THREAD));
+    EXPECT_TRUE(jobSystem.CancelJob(&otherJob, JobThreadType::RESOURCE_THREAD));
+    EXPECT_FALSE(isExecuted);
+}
+
 }
@@ -4,14 +4,21 @@
 #ifdef WIN32
 #define _USE_MATH_DEFINES
 #endif
+#include <algorithm>
 #include <cmath>
+#include <cstring>
+#include <limits>
 #include <random>
 #include <gtest/gtest.h>
 #include <mathematics/func_table.h>
 #include <mathematics/aabb.h>
+#include <mathematics/aabb_tree.h>
+#include <mathematics/affine2d.h>
 
 #include <mathematics/quaternion.h>
 #include <mathematics/matrix.h>
+#include <mathematics/matrix_batch.h>
+#include <mathematics/transform.h>
 #include "mathematics/vector.h"
 
 
@@ -28,7 +35,6 @@ void RandomFill(std::vector<float>& numbers, float start = -maxNmb, float end =
 TEST(Engine, TestSinTable)
 {
 	neko::FuncTable<float> sinFuncTable(0.0f, neko::PI, [](float x) { return neko::Sin(neko::radian_t(x)); });
-	sinFuncTable.GenerateTable();
 	const size_t sampleSize = 1024;
 	std::vector<float> localNumbers(sampleSize);
 	RandomFill(localNumbers, 0.0f, M_PI);
@@ -42,6 +48,65 @@ TEST(Engine, TestSinTable)
 	EXPECT_LT(error, 0.01f);
 }
 
+TEST(Engine, TestFuncTableInterpolation)
+{
+	//The table does not start at zero
+	constexpr neko::FuncTable<float, 64> linearTable(1.0f, 3.0f,
+		[](float x) { return static_cast<float>(neko::ConstexprSin(x)); });
+	constexpr neko::FuncTable<float, 64, neko::FuncTableInterpolation::CUBIC> cubicTable(1.0f, 3.0f,
+		[](float x) { return static_cast<float>(neko::ConstexprSin(x)); });
+	static_assert(linearTable.GetStart() == 1.0f);
+
+	const size_t sampleSize = 1024;
+	std::vector<float> localNumbers(sampleSize);
+	RandomFill(localNumbers, 1.0f, 3.0f);
+	std::vector<float> linearValues(sampleSize);
+	std::vector<float> cubicValues(sampleSize);
+	linearTable.GetValues(localNumbers.data(), linearValues.data(), sampleSize);
+	cubicTable.GetValues(localNumbers.data(), cubicValues.data(), sampleSize);
+	for (size_t i = 0; i < sampleSize; i++)
+	{
+		const float v = localNumbers[i];
+		const float expected = std::sin(v);
+		//step^2 / 8 for the linear interpolation of sin
+		EXPECT_NEAR(linearTable.GetValue(v), expected, 1.3e-4f);
+		EXPECT_NEAR(cubicTable.GetValue(v), expected, 1e-6f);
+		EXPECT_NEAR(linearValues[i], linearTable.GetValue(v), 1e-6f);
+		EXPECT_NEAR(cubicValues[i], cubicTable.GetValue(v), 1e-6f);
+	}
+	//Values outside of the table are clamped
+	EXPECT_FLOAT_EQ(linearTable.GetValue(0.0f), std::sin(1.0f));
+	EXPECT_FLOAT_EQ(cubicTable.GetValue(10.0f), std::sin(3.0f));
+	//NaN reads the start of the table instead of out of bounds
+	EXPECT_NEAR(linearTable.GetValue(std::numeric_limits<float>::quiet_NaN()), std::sin(1.0f), 1e-6f);
+	EXPECT_NEAR(cubicTable.GetValue(std::numeric_limits<float>::quiet_NaN()), std::sin(1.0f), 1e-6f);
+	std::vector<float> nans(sampleSize, std::numeric_limits<float>::quiet_NaN());
+	linearTable.GetValues(nans.data(), linearValues.data(), sampleSize);
+	cubicTable.GetValues(nans.data(), cubicValues.data(), sampleSize);
+	EXPECT_TRUE(std::all_of(linearValues.begin(), linearValues.end(),
+		[](float value) { return std::abs(value - std::sin(1.0f)) < 1e-6f; }));
+	EXPECT_TRUE(std::all_of(cubicValues.begin(), cubicValues.end(),
+		[](float value) { return std::abs(value - std::sin(1.0f)) < 1e-6f; }));
+}
+
+TEST(Engine, TestLutFunctions)
+{
+	const size_t sampleSize = 4096;
+	std::vector<float> localNumbers(sampleSize * 2);
+	RandomFill(localNumbers, -100.0f, 100.0f);
+	for (size_t i = 0; i < sampleSize; i++)
+	{
+		const float x = localNumbers[i];
+		const float y = localNumbers[sampleSize + i];
+		EXPECT_NEAR(neko::SinLut(neko::radian_t(x)), std::sin(x), 5e-6f);
+		EXPECT_NEAR(neko::CosLut(neko::radian_t(x)), std::cos(x), 5e-6f);
+		EXPECT_NEAR(neko::Atan2Lut(y, x).value(), std::atan2(y, x), 1e-6f);
+		const float z = x * 0.8f;
+		EXPECT_NEAR(static_cast<double>(neko::ExpLut(z)) / std::exp(static_cast<double>(z)), 1.0, 2e-6);
+	}
+	EXPECT_EQ(neko::Atan2Lut(0.0f, 0.0f).value(), 0.0f);
+}
+
 TEST(Engine, Quaternion_Dot)
 {
     neko::Quaternion q1 = neko::Quaternion(1,0,0,0);
@@ -107,6 +172,41 @@ TEST(Engine, Quaternion_FromEuler)
     //TODO
 }
 
+TEST(Engine, Quaternion_ToEuler)
+{
+    //Euler angles are applied around x, then y, then z
+    const neko::EulerAngles angles(neko::degree_t(30.0f), neko::degree_t(-45.0f), neko::degree_t(60.0f));
+    const neko::Quaternion q =
+        neko::Quaternion::AngleAxis(angles.z, neko::Vec3f(0, 0, 1)) *
+        neko::Quaternion::AngleAxis(angles.y, neko::Vec3f(0, 1, 0)) *
+        neko::Quaternion::AngleAxis(angles.x, neko::Vec3f(1, 0, 0));
+
+    const neko::EulerAngles result = q.ToEuler();
+    EXPECT_NEAR(result.x.value(), angles.x.value(), 0.01f);
+    EXPECT_NEAR(result.y.value(), angles.y.value(), 0.01f);
+    EXPECT_NEAR(result.z.value(), angles.z.value(), 0.01f);
+}
+
+TEST(Engine, TrsMatrixFromQuaternion)
+{
+    const neko::Vec3f translation(1.0f, -2.0f, 3.0f);
+    const neko::Quaternion rotation = neko::Quaternion::Normalized(neko::Quaternion(0.1f, 0.2f, 0.3f, 0.9f));
+    const neko::Vec3f scale(2.0f, 0.5f, 1.5f);
+    const neko::Mat4f trs = neko::Transform3d::TrsMatrixFrom(translation, rotation, scale);
+    //Transform3d::RotationMatrixFrom(Quaternion) stores the rotation row by row
+    const neko::Mat4f expected = neko::Transform3d::TranslationMatrixFrom(translation).MultiplyNaive(
+        neko::Transform3d::RotationMatrixFrom(rotation).Transpose().MultiplyNaive(
+            neko::Transform3d::ScalingMatrixFrom(scale)));
+    EXPECT_LT(neko::Mat4f::MatrixDifference(trs, expected), 0.001f);
+
+    //A rotation of 90 degrees around z sends the x axis on the y axis
+    const neko::Mat4f rotationZ = neko::Transform3d::TrsMatrixFrom(neko::Vec3f::zero,
+        neko::Quaternion::AngleAxis(neko::degree_t(90.0f), neko::Vec3f(0, 0, 1)),
+        neko::Vec3f::one);
+    EXPECT_NEAR(rotationZ[0][0], 0.0f, 0.0001f);
+    EXPECT_NEAR(rotationZ[0][1], 1.0f, 0.0001f);
+}
+
 TEST(Aabb, Aabb2d_Aabb2d)
 {
     //Same Aabb
@@ -656,6 +756,249 @@ TEST(Aabb, TestAabb)
     EXPECT_TRUE(aabb3.IntersectAabb(aabb4));
 }
 
+TEST(Aabb, AabbSoA2d)
+{
+    //Not a multiple of the vector width to check the padding is never reported
+    const size_t count = 101;
+    std::vector<float> numbers(count * 4);
+    RandomFill(numbers, -10.0f, 10.0f);
+    neko::AabbSoA2d soa;
+    std::vector<neko::Aabb2d> aabbs(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        aabbs[i].FromCenterExtends(neko::Vec2f(numbers[i * 4], numbers[i * 4 + 1]),
+            neko::Vec2f(numbers[i * 4 + 2], numbers[i * 4 + 3]) * 0.2f);
+        soa.PushBack(aabbs[i]);
+    }
+    ASSERT_EQ(soa.Size(), count);
+
+    neko::Aabb2d other;
+    other.FromCenterExtends(neko::Vec2f(1.0f, -2.0f), neko::Vec2f(3.0f, 2.0f));
+    neko::AabbBitmask result;
+    soa.IntersectAabb(other, result);
+    ASSERT_EQ(result.size(), (count + 63) / 64);
+    for (size_t i = 0; i < count; i++)
+    {
+        EXPECT_EQ(neko::IsBitSet(result, i), aabbs[i].IntersectAabb(other));
+    }
+    EXPECT_EQ(result.back() >> (count % 64), 0u);
+
+    const neko::Vec2f origin(-5.0f, -5.0f);
+    const neko::Vec2f dirRay(1.0f, 0.7f);
+    soa.IntersectRay(dirRay, origin, result);
+    for (size_t i = 0; i < count; i++)
+    {
+        EXPECT_EQ(neko::IsBitSet(result, i), aabbs[i].IntersectRay(dirRay, origin));
+    }
+}
+
+TEST(Aabb, AabbSoA3d)
+{
+    const size_t count = 101;
+    std::vector<float> numbers(count * 6);
+    RandomFill(numbers, -10.0f, 10.0f);
+    neko::AabbSoA3d soa;
+    std::vector<neko::Aabb3d> aabbs(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        aabbs[i].FromCenterExtends(neko::Vec3f(numbers[i * 6], numbers[i * 6 + 1], numbers[i * 6 + 2]),
+            neko::Vec3f(numbers[i * 6 + 3], numbers[i * 6 + 4], numbers[i * 6 + 5]) * 0.2f);
+        soa.PushBack(aabbs[i]);
+    }
+    EXPECT_EQ(soa.Get(count - 1).upperRightBound, aabbs[count - 1].upperRightBound);
+
+    neko::Aabb3d other;
+    other.FromCenterExtends(neko::Vec3f(1.0f, -2.0f, 0.5f), neko::Vec3f(3.0f, 2.0f, 4.0f));
+    neko::AabbBitmask result;
+    soa.IntersectAabb(other, result);
+    for (size_t i = 0; i < count; i++)
+    {
+        EXPECT_EQ(neko::IsBitSet(result, i), aabbs[i].IntersectAabb(other));
+    }
+
+    const neko::Vec3f origin(-5.0f, -5.0f, -5.0f);
+    const neko::Vec3f dirRay(1.0f, 0.7f, 0.9f);
+    soa.IntersectRay(dirRay, origin, result);
+    for (size_t i = 0; i < count; i++)
+    {
+        EXPECT_EQ(neko::IsBitSet(result, i), aabbs[i].IntersectRay(dirRay, origin));
+    }
+
+    //Box frustum from -4 to 4 on every axis
+    const std::array<neko::Vec4f, 6> planes{
+        neko::Vec4f(1, 0, 0, 4), neko::Vec4f(-1, 0, 0, 4),
+        neko::Vec4f(0, 1, 0, 4), neko::Vec4f(0, -1, 0, 4),
+        neko::Vec4f(0, 0, 1, 4), neko::Vec4f(0, 0, -1, 4) };
+    neko::Aabb3d frustumBox;
+    frustumBox.FromCenterExtends(neko::Vec3f::zero, neko::Vec3f(4.0f, 4.0f, 4.0f));
+    soa.IntersectFrustum(planes.data(), planes.size(), result);
+    for (size_t i = 0; i < count; i++)
+    {
+        EXPECT_EQ(neko::IsBitSet(result, i), aabbs[i].IntersectAabb(frustumBox));
+    }
+
+    soa.Clear();
+    soa.IntersectAabb(other, result);
+    EXPECT_TRUE(result.empty());
+}
+
+TEST(Aabb, AabbTree2d)
+{
+    const size_t count = 500;
+    std::vector<float> numbers(count * 4);
+    RandomFill(numbers, -50.0f, 50.0f);
+    neko::AabbTree2d tree;
+    std::vector<neko::AabbProxy> proxies(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        neko::Aabb2d aabb;
+        aabb.FromCenterExtends(neko::Vec2f(numbers[i * 4], numbers[i * 4 + 1]),
+            neko::Vec2f(numbers[i * 4 + 2], numbers[i * 4 + 3]) * 0.02f);
+        proxies[i] = tree.CreateProxy(aabb, static_cast<neko::Index>(i));
+    }
+    EXPECT_TRUE(tree.Validate());
+    EXPECT_EQ(tree.GetProxyCount(), count);
+    //A balanced tree of 500 leaves should stay far below a linked list
+    EXPECT_LT(tree.GetHeight(), 20);
+
+    const neko::Vec2f point(numbers[0], numbers[1]);
+    std::vector<neko::Index> found;
+    tree.QueryPoint(point, [&](neko::AabbProxy proxy)
+    {
+        found.push_back(tree.GetUserData(proxy));
+        return true;
+    });
+    EXPECT_NE(std::find(found.begin(), found.end(), 0u), found.end());
+    for (size_t i = 0; i < count; i++)
+    {
+        const bool expected = tree.GetFatAabb(proxies[i]).ContainsPoint(point);
+        EXPECT_EQ(std::find(found.begin(), found.end(), i) != found.end(), expected);
+    }
+}
+
+TEST(Aabb, AabbTree3d)
+{
+    const size_t count = 1000;
+    std::vector<float> numbers(count * 6);
+    RandomFill(numbers, -50.0f, 50.0f);
+    neko::AabbTree3d tree;
+    std::vector<neko::AabbProxy> proxies(count);
+    std::vector<neko::Aabb3d> aabbs(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        aabbs[i].FromCenterExtends(neko::Vec3f(numbers[i * 6], numbers[i * 6 + 1], numbers[i * 6 + 2]),
+            neko::Vec3f(numbers[i * 6 + 3], numbers[i * 6 + 4], numbers[i * 6 + 5]) * 0.05f);
+        proxies[i] = tree.CreateProxy(aabbs[i], static_cast<neko::Index>(i));
+    }
+    ASSERT_TRUE(tree.Validate());
+
+    //Small moves stay inside the fat AABB, large ones reinsert the proxy
+    const neko::Vec3f smallMove(0.05f, 0.0f, 0.0f);
+    const neko::Vec3f largeMove(5.0f, -3.0f, 1.0f);
+    neko::Aabb3d moved = aabbs[0];
+    moved.lowerLeftBound += smallMove;
+    moved.upperRightBound += smallMove;
+    EXPECT_FALSE(tree.MoveProxy(proxies[0], moved, smallMove));
+    for (size_t i = 0; i < count; i += 3)
+    {
+        aabbs[i].lowerLeftBound += largeMove;
+        aabbs[i].upperRightBound += largeMove;
+        EXPECT_TRUE(tree.MoveProxy(proxies[i], aabbs[i], largeMove));
+    }
+    for (size_t i = 1; i < count; i += 7)
+    {
+        tree.DestroyProxy(proxies[i]);
+        proxies[i] = neko::INVALID_AABB_PROXY;
+    }
+    ASSERT_TRUE(tree.Validate());
+
+    const auto isAlive = [&](size_t i) { return proxies[i] != neko::INVALID_AABB_PROXY; };
+    const auto collect = [&](auto query)
+    {
+        std::vector<bool> found(count, false);
+        query([&](neko::AabbProxy proxy)
+        {
+            found[tree.GetUserData(proxy)] = true;
+            return true;
+        });
+        return found;
+    };
+
+    neko::Aabb3d queryAabb;
+    queryAabb.FromCenterExtends(neko::Vec3f(5.0f, 0.0f, -5.0f), neko::Vec3f(20.0f, 15.0f, 10.0f));
+    auto found = collect([&](auto callback) { tree.QueryAabb(queryAabb, callback); });
+    for (size_t i = 0; i < count; i++)
+    {
+        EXPECT_EQ(found[i], isAlive(i) && tree.GetFatAabb(proxies[i]).IntersectAabb(queryAabb));
+    }
+
+    const neko::Vec3f origin(-60.0f, -10.0f, 3.0f);
+    const neko::Vec3f dirRay = neko::Vec3f(1.0f, 0.2f, -0.1f).Normalized();
+    found = collect([&](auto callback) { tree.RayCast(origin, dirRay, 1000.0f, callback); });
+    for (size_t i = 0; i < count; i++)
+    {
+        EXPECT_EQ(found[i], isAlive(i) && tree.GetFatAabb(proxies[i]).IntersectRay(dirRay, origin));
+    }
+
+    const std::array<neko::Vec4f, 6> planes{
+        neko::Vec4f(1, 0, 0, 10), neko::Vec4f(-1, 0, 0, 10),
+        neko::Vec4f(0, 1, 0, 10), neko::Vec4f(0, -1, 0, 10),
+        neko::Vec4f(0, 0, 1, 10), neko::Vec4f(0, 0, -1, 10) };
+    neko::Aabb3d frustumBox;
+    frustumBox.FromCenterExtends(neko::Vec3f::zero, neko::Vec3f(10.0f, 10.0f, 10.0f));
+    found = collect([&](auto callback) { tree.QueryFrustum(planes.data(), planes.size(), callback); });
+    for (size_t i = 0; i < count; i++)
+    {
+        EXPECT_EQ(found[i], isAlive(i) && tree.GetFatAabb(proxies[i]).IntersectAabb(frustumBox));
+    }
+
+    size_t pairCount = 0;
+    tree.QueryOverlapPairs([&](neko::AabbProxy a, neko::AabbProxy b)
+    {
+        EXPECT_LT(a, b);
+        pairCount++;
+        return true;
+    });
+    size_t expectedPairCount = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        for (size_t j = i + 1; j < count && isAlive(i); j++)
+        {
+            if (isAlive(j) && tree.GetFatAabb(proxies[i]).IntersectAabb(tree.GetFatAabb(proxies[j])))
+                expectedPairCount++;
+        }
+    }
+    EXPECT_EQ(pairCount, expectedPairCount);
+
+    tree.Clear();
+    EXPECT_TRUE(tree.Validate());
+    EXPECT_EQ(tree.GetHeight(), 0);
+}
+
+TEST(Engine, Affine2f)
+{
+    const neko::Vec2f translation(3.0f, -1.0f);
+    const neko::degree_t angle(35.0f);
+    const neko::Vec2f scale(2.0f, 0.5f);
+    const neko::Affine2f affine = neko::Affine2f::FromTrs(translation, angle, scale);
+    //Transform3d::RotationMatrixFrom(Quaternion) stores the rotation row by row
+    const neko::Mat4f expected = neko::Transform3d::TranslationMatrixFrom(neko::Vec3f(translation, 0.0f)).MultiplyNaive(
+        neko::Transform3d::RotationMatrixFrom(neko::Quaternion::AngleAxis(angle, neko::Vec3f::forward)).Transpose().MultiplyNaive(
+            neko::Transform3d::ScalingMatrixFrom(neko::Vec3f(scale, 1.0f))));
+    EXPECT_LT(neko::Mat4f::MatrixDifference(affine.ToMat4(), expected), 0.001f);
+
+    const neko::Affine2f child = neko::Affine2f::FromTrs(neko::Vec2f(-0.5f, 4.0f), neko::degree_t(-80.0f), neko::Vec2f::one);
+    const neko::Affine2f world = affine * child;
+    EXPECT_LT(neko::Mat4f::MatrixDifference(world.ToMat4(), affine.ToMat4().MultiplyNaive(child.ToMat4())), 0.001f);
+
+    const neko::Vec2f point(1.0f, 2.0f);
+    const neko::Vec2f transformed = world.TransformPoint(point);
+    const neko::Vec2f expectedPoint = affine.TransformPoint(child.TransformPoint(point));
+    EXPECT_NEAR(transformed.x, expectedPoint.x, 0.001f);
+    EXPECT_NEAR(transformed.y, expectedPoint.y, 0.001f);
+    EXPECT_EQ(sizeof(neko::Affine2f), 24u);
+}
+
 TEST(Engine, Matrix3Det)
 {
 	const neko::Mat3f m1 = neko::Mat3f(std::array<neko::Vec3f, 3>
@@ -738,3 +1081,104 @@ TEST(Engine, TestMatrix4)
 	EXPECT_LT(neko::Mat4f::MatrixDifference(mInvCalculus, mInv), 0.01f);
 	EXPECT_GT(neko::Mat4f::MatrixDifference(mInvCalculus, neko::Mat4f::Identity), 0.01f);
 }
+
+TEST(Engine, TestMatrix4Batch)
+{
+	//Odd count to go through the tail of every vector width
+	const size_t count = 37;
+	std::vector<float> numbers(count * 16);
+	std::vector<neko::Mat4f> lhs(count), rhs(count), expected(count);
+	std::vector<neko::Vec4f> points4(count), expected4(count);
+	std::vector<neko::Vec3f> points3(count), expected3(count);
+	std::vector<float> position[3], rotation[4], scale[3];
+	const auto fill = [&numbers](float start, float end)
+	{
+		RandomFill(numbers, start, end);
+		return numbers.data();
+	};
+	for (size_t i = 0; i < count; i++)
+	{
+		std::memcpy(&lhs[i][0][0], fill(-10.0f, 10.0f), 16 * sizeof(float));
+		std::memcpy(&rhs[i][0][0], fill(-10.0f, 10.0f), 16 * sizeof(float));
+		const float* p = fill(-10.0f, 10.0f);
+		points4[i] = neko::Vec4f(p[0], p[1], p[2], p[3]);
+		points3[i] = neko::Vec3f(p[4], p[5], p[6]);
+	}
+	for (auto& v : position)
+	{
+		v = std::vector<float>(fill(-maxNmb, maxNmb), numbers.data() + count);
+	}
+	for (auto& v : scale)
+	{
+		v = std::vector<float>(fill(0.1f, 10.0f), numbers.data() + count);
+	}
+	for (size_t i = 0; i < count; i++)
+	{
+		const float* q = fill(-1.0f, 1.0f);
+		const neko::Quaternion rot = neko::Quaternion::Normalized(neko::Quaternion(q[0], q[1], q[2], q[3]));
+		for (int axis = 0; axis < 4; axis++)
+		{
+			rotation[axis].push_back(rot[axis]);
+		}
+	}
+	const neko::TrsSoA trs{
+		position[0].data(), position[1].data(), position[2].data(),
+		rotation[0].data(), rotation[1].data(), rotation[2].data(), rotation[3].data(),
+		scale[0].data(), scale[1].data(), scale[2].data() };
+
+	const neko::Mat4f& transform = lhs[0];
+	std::vector<neko::Mat4f> expectedTrs(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		expected[i] = lhs[i].MultiplyNaive(rhs[i]);
+		const neko::Mat4f point4Matrix(std::array<neko::Vec4f, 4>{ points4[i], points4[i], points4[i], points4[i] });
+		expected4[i] = transform.MultiplyNaive(point4Matrix)[0];
+		const neko::Vec4f point3(points3[i].x, points3[i].y, points3[i].z, 1.0f);
+		const neko::Mat4f point3Matrix(std::array<neko::Vec4f, 4>{ point3, point3, point3, point3 });
+		const neko::Vec4f transformed3 = transform.MultiplyNaive(point3Matrix)[0];
+		expected3[i] = neko::Vec3f(transformed3.x, transformed3.y, transformed3.z);
+		const neko::Quaternion rot(rotation[0][i], rotation[1][i], rotation[2][i], rotation[3][i]);
+		//Transform3d::RotationMatrixFrom(Quaternion) stores the rotation row by row
+		expectedTrs[i] = neko::Transform3d::TranslationMatrixFrom(neko::Vec3f(position[0][i], position[1][i], position[2][i])).MultiplyNaive(
+			neko::Transform3d::RotationMatrixFrom(rot).Transpose().MultiplyNaive(
+				neko::Transform3d::ScalingMatrixFrom(neko::Vec3f(scale[0][i], scale[1][i], scale[2][i]))));
+	}
+
+	const neko::SimdLevel defaultLevel = neko::GetMat4BatchLevel();
+	EXPECT_EQ(defaultLevel, neko::GetCpuSimdLevel());
+	for (auto level : { neko::SimdLevel::SCALAR, neko::SimdLevel::SSE4, neko::SimdLevel::AVX2,
+		neko::SimdLevel::AVX512, neko::SimdLevel::NEON })
+	{
+		if (!neko::SetMat4BatchLevel(level))
+		{
+			EXPECT_FALSE(neko::IsSimdLevelSupported(level));
+			continue;
+		}
+		SCOPED_TRACE(neko::GetSimdLevelName(level));
+		EXPECT_EQ(neko::GetMat4BatchLevel(), level);
+
+		std::vector<neko::Mat4f> result = lhs;
+		neko::MultiplyMat4Batch(result.data(), rhs.data(), result.data(), count);
+		for (size_t i = 0; i < count; i++)
+		{
+			EXPECT_LT(neko::Mat4f::MatrixDifference(result[i], expected[i]), 0.1f);
+		}
+
+		std::vector<neko::Vec4f> result4 = points4;
+		neko::TransformPointsBatch(transform, result4.data(), result4.data(), count);
+		std::vector<neko::Vec3f> result3 = points3;
+		neko::TransformPointsBatch(transform, result3.data(), result3.data(), count);
+		for (size_t i = 0; i < count; i++)
+		{
+			EXPECT_LT((result4[i] - expected4[i]).Magnitude(), 0.1f);
+			EXPECT_LT((result3[i] - expected3[i]).Magnitude(), 0.1f);
+		}
+
+		neko::ComposeTrsBatch(trs, result.data(), count);
+		for (size_t i = 0; i < count; i++)
+		{
+			EXPECT_LT(neko::Mat4f::MatrixDifference(result[i], expectedTrs[i]), 0.01f);
+		}
+	}
+	EXPECT_TRUE(neko::SetMat4BatchLevel(defaultLevel));
+}
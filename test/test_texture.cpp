@@ -0,0 +1,731 @@
+/*
+MIT License
+
+Copyright (c) 2019 SAE Institute Switzerland AG
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <fmt/format.h>
+
+#include "engine/engine.h"
+#include "graphics/graphics.h"
+#include "graphics/image_processing.h"
+#include "graphics/texture.h"
+#include "graphics/texture_cooker.h"
+#include "utilities/file_utility.h"
+
+namespace neko
+{
+class HeadlessEngine : public BasicEngine
+{
+public:
+    explicit HeadlessEngine(Configuration* engineConfig = nullptr) : BasicEngine(engineConfig) {}
+    void ManageEvent() override {}
+};
+
+/**
+ * \brief Runs the pre render jobs right away, like a render thread that never waits
+ */
+class ImmediateRenderer : public RendererInterface
+{
+public:
+    void Render([[maybe_unused]] RenderCommandInterface* command) override {}
+    void AddPreRenderJob(Job* job) override { job->Execute(); }
+    void RegisterSyncBuffersFunction([[maybe_unused]] SyncBuffersInterface* syncBuffersInterface) override {}
+};
+
+class NullGpuTextureManager : public TextureManager
+{
+public:
+    size_t maxDecodedMemory = 0;
+    int maxMipLevels = 0;
+    std::atomic<size_t> createdTextureCount{0};
+protected:
+    void CreateTexture() override
+    {
+        createdTextureCount++;
+        maxDecodedMemory = std::max(maxDecodedMemory, GetDecodedMemory());
+        const auto& image = currentUploadedTexture_.image;
+        maxMipLevels = std::max(maxMipLevels, image.mipLevels);
+        currentUploadedTexture_.texture = {1, Vec2i(image.width, image.height)};
+    }
+};
+}
+
+TEST(Engine, TestTextureLoadingThroughput)
+{
+    const std::string folderPath = "texture_loading_data";
+    constexpr int textureCount = 64;
+    constexpr int textureSize = 256;
+    neko::CreateDirectory(folderPath);
+    std::vector<std::string> texturePaths;
+    for (int i = 0; i < textureCount; i++)
+    {
+        //Binary ppm decoded by stb_image
+        std::string content = fmt::format("P6\n{} {}\n255\n", textureSize, textureSize);
+        content.append(textureSize * textureSize * 3, static_cast<char>(i));
+        const std::string path = fmt::format("{}/texture{}.ppm", folderPath, i);
+        neko::WriteStringToFile(path, content);
+        neko::WriteStringToFile(path + ".meta", fmt::format("{{\"uuid\": \"{}\"}}", sole::uuid4().str()));
+        texturePaths.push_back(path);
+    }
+
+    neko::HeadlessEngine engine;
+    engine.Init();
+    neko::ImmediateRenderer renderer;
+    neko::RendererLocator::provide(&renderer);
+    neko::NullGpuTextureManager textureManager;
+    textureManager.SetMaxLoadingTextures(8);
+    //Room for about four decoded textures waiting for the GPU
+    const size_t decodedMemoryBudget = 4 * textureSize * textureSize * 3;
+    textureManager.SetDecodedMemoryBudget(decodedMemoryBudget);
+
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<neko::TextureId> textureIds;
+    for (const auto& path : texturePaths)
+    {
+        textureIds.push_back(textureManager.LoadTexture(path));
+        EXPECT_TRUE(textureIds.back() != neko::INVALID_TEXTURE_ID);
+    }
+    int loadedCallbackCount = 0;
+    for (const auto& textureId : textureIds)
+    {
+        EXPECT_TRUE(textureManager.AddTextureLoadedCallback(textureManager.GetTextureHandle(textureId),
+            [&loadedCallbackCount](const neko::Texture& texture)
+        {
+            EXPECT_EQ(texture.size, neko::Vec2i(textureSize, textureSize));
+            loadedCallbackCount++;
+        }));
+    }
+    int frameCount = 0;
+    while (textureManager.GetLoadingTextureCount() > 0 && frameCount < 100'000)
+    {
+        textureManager.Update(neko::seconds(0.0f));
+        frameCount++;
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    const auto duration = std::chrono::duration_cast<std::chrono::duration<double>>(
+        std::chrono::steady_clock::now() - start);
+    std::cout << fmt::format("Loaded {} textures in {} frames and {:.3f} s: {:.1f} textures/s\n",
+        textureCount, frameCount, duration.count(), textureCount / duration.count());
+
+    std::vector<neko::TextureHandle> textureHandles;
+    for (const auto& textureId : textureIds)
+    {
+        ASSERT_TRUE(textureManager.IsTextureLoaded(textureId));
+        const auto texture = textureManager.GetTexture(textureId);
+        EXPECT_EQ(texture.size, neko::Vec2i(textureSize, textureSize));
+        textureHandles.push_back(textureManager.GetTextureHandle(textureId));
+        EXPECT_TRUE(textureManager.IsTextureLoaded(textureHandles.back()));
+        EXPECT_EQ(textureManager.GetTexture(textureHandles.back()).size, neko::Vec2i(textureSize, textureSize));
+    }
+    EXPECT_EQ(loadedCallbackCount, textureCount);
+    //A texture already loaded calls back right away
+    EXPECT_TRUE(textureManager.AddTextureLoadedCallback(textureHandles.front(),
+        [&loadedCallbackCount](const neko::Texture&) { loadedCallbackCount++; }));
+    EXPECT_EQ(loadedCallbackCount, textureCount + 1);
+    EXPECT_EQ(textureManager.GetDecodedMemory(), 0u);
+    //The budget is only checked before a load starts, the loads in flight can go over it
+    EXPECT_LE(textureManager.maxDecodedMemory, decodedMemoryBudget + 8 * textureSize * textureSize * 3);
+
+    textureManager.Destroy();
+    //The handles do not outlive the textures, even when the slots are reused
+    EXPECT_TRUE(textureManager.GetTextureHandle(textureIds.front()) == neko::INVALID_TEXTURE_HANDLE);
+    const auto reloadedHandle = textureManager.GetTextureHandle(textureManager.LoadTexture(texturePaths.front()));
+    EXPECT_LT(reloadedHandle.index, static_cast<std::uint32_t>(textureCount));
+    for (const auto& textureHandle : textureHandles)
+    {
+        EXPECT_FALSE(textureManager.IsTextureLoaded(textureHandle));
+        EXPECT_EQ(textureManager.GetTexture(textureHandle).name, neko::INVALID_TEXTURE_NAME);
+        EXPECT_FALSE(textureManager.AddTextureLoadedCallback(textureHandle, [](const neko::Texture&) {}));
+    }
+    frameCount = 0;
+    while (!textureManager.IsTextureLoaded(reloadedHandle) && frameCount < 100'000)
+    {
+        textureManager.Update(neko::seconds(0.0f));
+        frameCount++;
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    ASSERT_TRUE(textureManager.IsTextureLoaded(reloadedHandle));
+    textureManager.Destroy();
+    neko::RendererLocator::provide(nullptr);
+    engine.Destroy();
+    neko::RemoveDirectory(folderPath);
+}
+
+TEST(Engine, TestTextureConcurrentLoadRequests)
+{
+    const std::string folderPath = "texture_concurrent_data";
+    constexpr int textureCount = 16;
+    constexpr int threadCount = 4;
+    constexpr int textureSize = 16;
+    neko::CreateDirectory(folderPath);
+    std::vector<std::string> texturePaths;
+    std::vector<neko::TextureId> metaIds;
+    for (int i = 0; i < textureCount; i++)
+    {
+        std::string content = fmt::format("P6\n{} {}\n255\n", textureSize, textureSize);
+        content.append(textureSize * textureSize * 3, static_cast<char>(i));
+        const std::string path = fmt::format("{}/texture{}.ppm", folderPath, i);
+        neko::WriteStringToFile(path, content);
+        metaIds.push_back(sole::uuid4());
+        neko::WriteStringToFile(path + ".meta", fmt::format("{{\"uuid\": \"{}\"}}", metaIds.back().str()));
+        texturePaths.push_back(path);
+    }
+
+    neko::HeadlessEngine engine;
+    engine.Init();
+    neko::ImmediateRenderer renderer;
+    neko::RendererLocator::provide(&renderer);
+    neko::NullGpuTextureManager textureManager;
+
+    //Like models processed on the workers, every thread requests all the textures
+    std::vector<std::vector<neko::TextureId>> textureIds(threadCount);
+    std::atomic<int> finishedThreads{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; t++)
+    {
+        threads.emplace_back([&, t]
+        {
+            for (const auto& path : texturePaths)
+            {
+                textureIds[t].push_back(textureManager.LoadTexture(path));
+            }
+            finishedThreads++;
+        });
+    }
+    int frameCount = 0;
+    while ((finishedThreads < threadCount || textureManager.GetLoadingTextureCount() > 0) && frameCount < 100'000)
+    {
+        textureManager.Update(neko::seconds(0.0f));
+        //The main and render threads read the table while the requests grow it
+        for (const auto& textureId : metaIds)
+        {
+            const auto textureHandle = textureManager.GetTextureHandle(textureId);
+            if (textureManager.IsTextureLoaded(textureHandle))
+            {
+                EXPECT_EQ(textureManager.GetTexture(textureHandle).size, neko::Vec2i(textureSize, textureSize));
+            }
+            EXPECT_TRUE(textureManager.GetPath(textureHandle).empty() == (textureHandle == neko::INVALID_TEXTURE_HANDLE));
+        }
+        frameCount++;
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    std::vector<neko::TextureHandle> textureHandles;
+    for (int i = 0; i < textureCount; i++)
+    {
+        const auto textureId = textureIds[0][i];
+        ASSERT_TRUE(textureId == metaIds[i]);
+        for (int t = 1; t < threadCount; t++)
+        {
+            EXPECT_TRUE(textureIds[t][i] == textureId);
+        }
+        //The same texture requested from several threads gets one handle
+        const auto textureHandle = textureManager.GetTextureHandle(textureId);
+        EXPECT_TRUE(std::none_of(textureHandles.begin(), textureHandles.end(),
+            [textureHandle](neko::TextureHandle handle) { return handle == textureHandle; }));
+        textureHandles.push_back(textureHandle);
+        ASSERT_TRUE(textureManager.IsTextureLoaded(textureHandle));
+        EXPECT_EQ(textureManager.GetTexture(textureHandle).size, neko::Vec2i(textureSize, textureSize));
+        EXPECT_EQ(textureManager.GetPath(textureHandle), texturePaths[i]);
+    }
+    textureManager.Destroy();
+    neko::RendererLocator::provide(nullptr);
+    engine.Destroy();
+    neko::RemoveDirectory(folderPath);
+}
+
+TEST(Engine, TestTextureDestroyBeforeUpload)
+{
+    const std::string folderPath = "texture_destroy_data";
+    constexpr int textureCount = 4;
+    constexpr int textureSize = 16;
+    neko::CreateDirectory(folderPath);
+    std::vector<std::string> texturePaths;
+    for (int i = 0; i < textureCount; i++)
+    {
+        std::string content = fmt::format("P6\n{} {}\n255\n", textureSize, textureSize);
+        content.append(textureSize * textureSize * 3, static_cast<char>(i));
+        const std::string path = fmt::format("{}/texture{}.ppm", folderPath, i);
+        neko::WriteStringToFile(path, content);
+        neko::WriteStringToFile(path + ".meta", fmt::format("{{\"uuid\": \"{}\"}}", sole::uuid4().str()));
+        texturePaths.push_back(path);
+    }
+
+    neko::Configuration config;
+    config.trackMemoryBudgets = true;
+    neko::HeadlessEngine engine(&config);
+    engine.Init();
+    neko::ImmediateRenderer renderer;
+    neko::RendererLocator::provide(&renderer);
+    neko::NullGpuTextureManager textureManager;
+    for (const auto& path : texturePaths)
+    {
+        textureManager.LoadTexture(path);
+    }
+    //The images decoded after this Update wait for an upload that never comes
+    textureManager.Update(neko::seconds(0.0f));
+    const size_t imageSize = textureSize * textureSize * 3;
+    const auto getWaitingMemory = [&textureManager, imageSize]
+    {
+        return textureCount * imageSize - textureManager.createdTextureCount * imageSize;
+    };
+    int frameCount = 0;
+    while (textureManager.GetDecodedMemory() < getWaitingMemory() && frameCount < 100'000)
+    {
+        frameCount++;
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    const size_t decodedMemory = getWaitingMemory();
+    ASSERT_EQ(textureManager.GetDecodedMemory(), decodedMemory);
+    auto& memoryBudget = static_cast<neko::MemoryBudgetManager&>(neko::MemoryBudgetLocator::get());
+    EXPECT_EQ(memoryBudget.GetStats(neko::MemoryTag::TEXTURE).currentMemory, decodedMemory);
+
+    textureManager.Destroy();
+    EXPECT_EQ(textureManager.GetDecodedMemory(), 0u);
+    EXPECT_EQ(memoryBudget.GetStats(neko::MemoryTag::TEXTURE).currentMemory, 0u);
+    //The textures uploaded by the first Update are finished, to stale handles
+    frameCount = 0;
+    while (textureManager.GetLoadingTextureCount() > 0 && frameCount < 100'000)
+    {
+        textureManager.Update(neko::seconds(0.0f));
+        frameCount++;
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    EXPECT_EQ(textureManager.GetLoadingTextureCount(), 0u);
+    neko::RendererLocator::provide(nullptr);
+    engine.Destroy();
+    neko::RemoveDirectory(folderPath);
+}
+
+TEST(Engine, TestResourceTable)
+{
+    neko::ResourceTable<int> table;
+    const auto first = table.Add(1);
+    const auto second = table.Add(2);
+    EXPECT_EQ(table.Size(), 2u);
+    ASSERT_NE(table.Get(second), nullptr);
+    EXPECT_EQ(*table.Get(second), 2);
+    EXPECT_FALSE(table.IsValid(neko::ResourceHandle<int>()));
+
+    EXPECT_TRUE(table.Remove(first));
+    EXPECT_FALSE(table.Remove(first));
+    EXPECT_EQ(table.Get(first), nullptr);
+    //The freed slot is reused with a new generation
+    const auto third = table.Add(3);
+    EXPECT_EQ(third.index, first.index);
+    EXPECT_NE(third.generation, first.generation);
+    EXPECT_EQ(table.Get(first), nullptr);
+    EXPECT_EQ(*table.Get(third), 3);
+
+    table.Clear();
+    EXPECT_EQ(table.Size(), 0u);
+    EXPECT_FALSE(table.IsValid(second));
+    EXPECT_FALSE(table.IsValid(third));
+    int sum = 0;
+    table.Add(4);
+    table.ForEach([&sum](int value) { sum += value; });
+    EXPECT_EQ(sum, 4);
+}
+
+namespace
+{
+std::string GenerateCookerPpm(int width, int height)
+{
+    std::string content = fmt::format("P6\n{} {}\n255\n", width, height);
+    for (int y = 0; y < height; y++)
+    {
+        for (int x = 0; x < width; x++)
+        {
+            content.push_back(static_cast<char>((x * 7 + y * 3) & 0xFF));
+            content.push_back(static_cast<char>(x));
+            content.push_back(static_cast<char>(y));
+        }
+    }
+    return content;
+}
+}
+
+TEST(Engine, TestTextureCooker)
+{
+    const std::string cacheFolder = "texture_cooker_cache";
+    constexpr int width = 37;
+    constexpr int height = 20;
+    const std::string content = GenerateCookerPpm(width, height);
+    neko::BufferFile sourceFile;
+    sourceFile.LoadView(reinterpret_cast<const unsigned char*>(content.data()), content.size());
+
+    neko::TextureCooker textureCooker;
+    EXPECT_FALSE(textureCooker.IsEnabled());
+    textureCooker.SetCacheFolder(cacheFolder);
+    ASSERT_TRUE(textureCooker.IsEnabled());
+    const auto cookedPath = textureCooker.GetCookedPath(sourceFile, neko::Texture::DEFAULT);
+    //Sampling flags do not change the cooked pixels, the others do
+    EXPECT_EQ(cookedPath, textureCooker.GetCookedPath(sourceFile,
+        neko::Texture::TextureFlags(neko::Texture::MIPMAPS_TEXTURE | neko::Texture::CLAMP_WRAP)));
+    EXPECT_NE(cookedPath, textureCooker.GetCookedPath(sourceFile,
+        neko::Texture::TextureFlags(neko::Texture::DEFAULT | neko::Texture::FLIP_Y)));
+
+    const auto cookedImage = textureCooker.Cook(sourceFile, neko::Texture::DEFAULT, cookedPath);
+    ASSERT_TRUE(neko::FileExists(cookedPath));
+    EXPECT_EQ(cookedImage.mipLevels, neko::GetMipLevelCount(width, height));
+    EXPECT_EQ(cookedImage.mipLevels, 6);
+
+    neko::BufferFile cookedFile;
+    cookedFile.Load(cookedPath);
+    ASSERT_GE(cookedFile.dataLength, sizeof(neko::Ktx2Header));
+    neko::Ktx2Header header;
+    std::memcpy(&header, cookedFile.dataBuffer, sizeof(header));
+    EXPECT_TRUE(header.identifier == neko::Ktx2Header::identifierValue);
+    EXPECT_EQ(header.vkFormat, 23u);
+    EXPECT_EQ(header.pixelWidth, std::uint32_t(width));
+    EXPECT_EQ(header.pixelHeight, std::uint32_t(height));
+    EXPECT_EQ(header.levelCount, 6u);
+
+    const auto loadedImage = neko::LoadKtx2(cookedFile);
+    ASSERT_NE(loadedImage.data, nullptr);
+    ASSERT_EQ(loadedImage.GetByteSize(), cookedImage.GetByteSize());
+    EXPECT_EQ(std::memcmp(loadedImage.data, cookedImage.data, cookedImage.GetByteSize()), 0);
+
+    const auto decodedImage = neko::StbImageConvert(sourceFile);
+    ASSERT_EQ(decodedImage.GetByteSize(), loadedImage.GetLevelByteSize(0));
+    EXPECT_EQ(std::memcmp(decodedImage.data, loadedImage.data, decodedImage.GetByteSize()), 0);
+    //Level 1 is the rounded average of the 2x2 blocks of level 0
+    const unsigned char* level1 = loadedImage.data + loadedImage.GetLevelOffset(1);
+    EXPECT_EQ(loadedImage.GetLevelWidth(1), width / 2);
+    EXPECT_EQ(loadedImage.GetLevelHeight(1), height / 2);
+    for (int y = 0; y < height / 2; y++)
+    {
+        for (int x = 0; x < width / 2; x++)
+        {
+            for (int c = 0; c < 3; c++)
+            {
+                unsigned sum = 2;
+                for (int i = 0; i < 4; i++)
+                {
+                    sum += decodedImage.data[((2 * y + i / 2) * width + 2 * x + i % 2) * 3 + c];
+                }
+                ASSERT_EQ(level1[(y * (width / 2) + x) * 3 + c], sum / 4);
+            }
+        }
+    }
+    const unsigned char* lastLevel = loadedImage.data + loadedImage.GetLevelOffset(loadedImage.mipLevels - 1);
+    EXPECT_EQ(loadedImage.GetLevelByteSize(loadedImage.mipLevels - 1), 3u);
+    EXPECT_NE(lastLevel[1], 0);
+
+    //A truncated cooked file is rejected
+    const std::string truncatedContent(reinterpret_cast<const char*>(cookedFile.dataBuffer), cookedFile.dataLength / 2);
+    neko::BufferFile truncatedFile;
+    truncatedFile.LoadView(reinterpret_cast<const unsigned char*>(truncatedContent.data()), truncatedContent.size());
+    EXPECT_EQ(neko::LoadKtx2(truncatedFile).data, nullptr);
+    truncatedFile.Destroy();
+    cookedFile.Destroy();
+    sourceFile.Destroy();
+    neko::RemoveDirectory(cacheFolder);
+}
+
+TEST(Engine, TestTextureCacheLoading)
+{
+    const std::string folderPath = "texture_cache_data";
+    const std::string cacheFolder = "texture_cache_data/cache";
+    constexpr int textureSize = 64;
+    neko::CreateDirectory(folderPath);
+    const std::string path = folderPath + "/texture.ppm";
+    neko::WriteStringToFile(path, GenerateCookerPpm(textureSize, textureSize));
+    neko::WriteStringToFile(path + ".meta", fmt::format("{{\"uuid\": \"{}\"}}", sole::uuid4().str()));
+
+    neko::HeadlessEngine engine;
+    engine.Init();
+    neko::ImmediateRenderer renderer;
+    neko::RendererLocator::provide(&renderer);
+    const auto loadTexture = [&path](neko::NullGpuTextureManager& textureManager)
+    {
+        const auto textureId = textureManager.LoadTexture(path);
+        int frameCount = 0;
+        while (textureManager.GetLoadingTextureCount() > 0 && frameCount < 100'000)
+        {
+            textureManager.Update(neko::seconds(0.0f));
+            frameCount++;
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+        EXPECT_TRUE(textureManager.IsTextureLoaded(textureId));
+        EXPECT_EQ(textureManager.GetTexture(textureId).size, neko::Vec2i(textureSize, textureSize));
+        textureManager.Destroy();
+    };
+    //The first load cooks the texture
+    {
+        neko::NullGpuTextureManager textureManager;
+        textureManager.SetTextureCache(cacheFolder);
+        loadTexture(textureManager);
+        EXPECT_EQ(textureManager.maxMipLevels, neko::GetMipLevelCount(textureSize, textureSize));
+    }
+    size_t cookedCount = 0;
+    neko::IterateDirectory(cacheFolder, [&cookedCount](const std::string_view cookedPath)
+    {
+        EXPECT_EQ(neko::GetFilenameExtension(cookedPath), neko::TextureCooker::cookedExtension);
+        cookedCount++;
+    });
+    EXPECT_EQ(cookedCount, 1u);
+    //The next loads read the cooked mip chain without cooking
+    {
+        neko::NullGpuTextureManager textureManager;
+        textureManager.SetTextureCache(cacheFolder, false);
+        loadTexture(textureManager);
+        EXPECT_EQ(textureManager.maxMipLevels, neko::GetMipLevelCount(textureSize, textureSize));
+    }
+    //Without cache the source is decoded and the GPU generates the mip chain
+    {
+        neko::NullGpuTextureManager textureManager;
+        loadTexture(textureManager);
+        EXPECT_EQ(textureManager.maxMipLevels, 1);
+    }
+
+    neko::RendererLocator::provide(nullptr);
+    engine.Destroy();
+    neko::RemoveDirectory(folderPath);
+}
+
+namespace
+{
+neko::Image GenerateRandomImage(int width, int height, int nbChannels, bool hdr, unsigned seed)
+{
+    std::mt19937 generator(seed);
+    std::uniform_int_distribution<int> distribution(0, 255);
+    neko::Image image;
+    image.width = width;
+    image.height = height;
+    image.nbChannels = nbChannels;
+    image.hdr = hdr;
+    const size_t count = size_t(width) * height * nbChannels;
+    image.data = static_cast<unsigned char*>(std::malloc(count * (hdr ? sizeof(float) : 1)));
+    for (size_t i = 0; i < count; i++)
+    {
+        if (hdr)
+        {
+            reinterpret_cast<float*>(image.data)[i] = float(distribution(generator)) / 16.0f;
+        }
+        else
+        {
+            image.data[i] = static_cast<unsigned char>(distribution(generator));
+        }
+    }
+    return image;
+}
+
+/**
+ * \brief Scalar 2x2 box filter, sRGB colors averaged in linear space with std::pow
+ */
+void ReferenceDownsample(const unsigned char* src, int srcWidth, int srcHeight, unsigned char* dst, int nbChannels, bool srgb)
+{
+    const auto toLinear = [](int value)
+    {
+        const double v = value / 255.0;
+        return v <= 0.04045 ? v / 12.92 : std::pow((v + 0.055) / 1.055, 2.4);
+    };
+    const int dstWidth = std::max(1, srcWidth / 2);
+    const int dstHeight = std::max(1, srcHeight / 2);
+    for (int y = 0; y < dstHeight; y++)
+    {
+        for (int x = 0; x < dstWidth; x++)
+        {
+            const int x0 = 2 * x;
+            const int x1 = std::min(2 * x + 1, srcWidth - 1);
+            const int y0 = 2 * y;
+            const int y1 = std::min(2 * y + 1, srcHeight - 1);
+            for (int c = 0; c < nbChannels; c++)
+            {
+                const int a = src[(y0 * srcWidth + x0) * nbChannels + c];
+                const int b = src[(y0 * srcWidth + x1) * nbChannels + c];
+                const int d = src[(y1 * srcWidth + x0) * nbChannels + c];
+                const int e = src[(y1 * srcWidth + x1) * nbChannels + c];
+                int value = (a + b + d + e + 2) / 4;
+                if (srgb && c < 3)
+                {
+                    const double linear = (toLinear(a) + toLinear(b) + toLinear(d) + toLinear(e)) / 4.0;
+                    const double encoded = linear <= 0.0031308 ? linear * 12.92 : 1.055 * std::pow(linear, 1.0 / 2.4) - 0.055;
+                    value = int(encoded * 255.0 + 0.5);
+                }
+                dst[(y * dstWidth + x) * nbChannels + c] = static_cast<unsigned char>(value);
+            }
+        }
+    }
+}
+}
+
+TEST(Engine, TestImageBoxMipChain)
+{
+    for (int nbChannels = 1; nbChannels <= 4; nbChannels++)
+    {
+        for (const bool srgb : {false, true})
+        {
+            auto image = GenerateRandomImage(67, 45, nbChannels, false, nbChannels);
+            neko::GenerateMipChain(image, srgb);
+            ASSERT_EQ(image.mipLevels, 7);
+            const bool srgbColors = srgb && nbChannels >= 3;
+            for (int level = 1; level < image.mipLevels; level++)
+            {
+                std::vector<unsigned char> expected(image.GetLevelByteSize(level));
+                ReferenceDownsample(image.data + image.GetLevelOffset(level - 1), image.GetLevelWidth(level - 1),
+                    image.GetLevelHeight(level - 1), expected.data(), nbChannels, srgbColors);
+                const unsigned char* result = image.data + image.GetLevelOffset(level);
+                for (size_t i = 0; i < expected.size(); i++)
+                {
+                    //Exact for the linear average, the sRGB encoding can round the other way at ties
+                    ASSERT_LE(std::abs(int(result[i]) - int(expected[i])), srgbColors ? 1 : 0)
+                        << "channels: " << nbChannels << " level: " << level << " index: " << i;
+                }
+            }
+        }
+    }
+}
+
+TEST(Engine, TestImageKaiserMipChain)
+{
+    neko::Image image = GenerateRandomImage(40, 24, 4, false, 7);
+    std::fill(image.data, image.data + image.GetByteSize(), static_cast<unsigned char>(200));
+    neko::GenerateMipChain(image, true, neko::MipFilter::KAISER);
+    ASSERT_EQ(image.mipLevels, 6);
+    //The weights are normalized, a flat image stays flat
+    EXPECT_TRUE(std::all_of(image.data, image.data + image.GetByteSize(), [](unsigned char value) { return value == 200; }));
+
+    neko::Image hdrImage = GenerateRandomImage(33, 64, 3, true, 11);
+    const auto* level0 = reinterpret_cast<const float*>(hdrImage.data);
+    double average = 0.0;
+    for (size_t i = 0; i < hdrImage.GetLevelByteSize(0) / sizeof(float); i++)
+    {
+        average += static_cast<double>(level0[i]);
+    }
+    average /= double(hdrImage.GetLevelByteSize(0) / sizeof(float));
+    neko::GenerateMipChain(hdrImage, false, neko::MipFilter::KAISER);
+    ASSERT_EQ(hdrImage.mipLevels, 7);
+    const auto* lastLevel = reinterpret_cast<const float*>(hdrImage.data + hdrImage.GetLevelOffset(6));
+    for (int c = 0; c < 3; c++)
+    {
+        EXPECT_GE(lastLevel[c], 0.0f);
+        EXPECT_NEAR(lastLevel[c], average, average * 0.5);
+    }
+}
+
+TEST(Engine, TestImageConversions)
+{
+    auto rgbImage = GenerateRandomImage(31, 17, 3, false, 3);
+    const std::vector<unsigned char> rgb(rgbImage.data, rgbImage.data + rgbImage.GetByteSize());
+    neko::GenerateMipChain(rgbImage);
+    std::vector<unsigned char> rgbMips(rgbImage.data, rgbImage.data + rgbImage.GetByteSize());
+    neko::ExpandRgbToRgba(rgbImage);
+    ASSERT_EQ(rgbImage.nbChannels, 4);
+    ASSERT_EQ(rgbImage.GetByteSize(), rgbMips.size() / 3 * 4);
+    for (size_t i = 0; i < rgbMips.size() / 3; i++)
+    {
+        ASSERT_EQ(rgbImage.data[4 * i], rgbMips[3 * i]);
+        ASSERT_EQ(rgbImage.data[4 * i + 1], rgbMips[3 * i + 1]);
+        ASSERT_EQ(rgbImage.data[4 * i + 2], rgbMips[3 * i + 2]);
+        ASSERT_EQ(rgbImage.data[4 * i + 3], 255);
+    }
+
+    auto rgbaImage = GenerateRandomImage(29, 13, 4, false, 5);
+    const std::vector<unsigned char> rgba(rgbaImage.data, rgbaImage.data + rgbaImage.GetByteSize());
+    neko::PremultiplyAlpha(rgbaImage);
+    for (size_t i = 0; i < rgba.size(); i++)
+    {
+        const int alpha = rgba[i / 4 * 4 + 3];
+        const int expected = i % 4 == 3 ? alpha : int(std::lround(rgba[i] * alpha / 255.0));
+        ASSERT_EQ(rgbaImage.data[i], expected) << "index: " << i;
+    }
+
+    auto srgbImage = GenerateRandomImage(29, 13, 4, false, 5);
+    neko::PremultiplyAlpha(srgbImage, true);
+    for (size_t i = 0; i < rgba.size(); i++)
+    {
+        const float alpha = rgba[i / 4 * 4 + 3] / 255.0f;
+        const int expected = i % 4 == 3 ? rgba[i] : neko::LinearToSrgb8(neko::Srgb8ToLinear(rgba[i]) * alpha);
+        ASSERT_EQ(srgbImage.data[i], expected);
+    }
+    for (int value = 0; value < 256; value++)
+    {
+        EXPECT_EQ(neko::LinearToSrgb8(neko::Srgb8ToLinear(std::uint8_t(value))), value);
+    }
+}
+
+TEST(Engine, TestImageHalfConversion)
+{
+    const std::vector<float> values = {0.0f, -0.0f, 1.0f, -2.0f, 0.5f, 65504.0f, 65520.0f, 1e-8f,
+        5.9604645e-08f, 6.1035156e-05f, 0.1f, std::numeric_limits<float>::infinity(), 1.0009765625f, 1.00048828125f};
+    const std::vector<std::uint16_t> expected = {0x0000, 0x8000, 0x3C00, 0xC000, 0x3800, 0x7BFF, 0x7C00, 0x0000,
+        0x0001, 0x0400, 0x2E66, 0x7C00, 0x3C01, 0x3C00};
+    std::vector<std::uint16_t> halves(values.size());
+    neko::ConvertFloatToHalf(values.data(), halves.data(), values.size());
+    for (size_t i = 0; i < values.size(); i++)
+    {
+        EXPECT_EQ(halves[i], expected[i]) << "value: " << values[i];
+    }
+
+    //Every half but the NaNs survives a round trip, on the vector and scalar paths
+    std::vector<std::uint16_t> allHalves;
+    for (std::uint32_t half = 0; half < 0x10000u; half++)
+    {
+        if ((half & 0x7C00u) != 0x7C00u || (half & 0x03FFu) == 0)
+        {
+            allHalves.push_back(static_cast<std::uint16_t>(half));
+        }
+    }
+    std::vector<float> floats(allHalves.size());
+    neko::ConvertHalfToFloat(allHalves.data(), floats.data(), allHalves.size());
+    EXPECT_EQ(floats[0x3C00], 1.0f);
+    std::vector<std::uint16_t> roundTrip(allHalves.size());
+    neko::ConvertFloatToHalf(floats.data(), roundTrip.data(), floats.size());
+    EXPECT_TRUE(roundTrip == allHalves);
+    neko::ConvertFloatToHalf(floats.data() + 1, roundTrip.data() + 1, 5);
+    EXPECT_TRUE(roundTrip == allHalves);
+}
+
+TEST(Engine, TestImageProcessingBands)
+{
+    auto serialImage = GenerateRandomImage(1024, 768, 4, false, 13);
+    auto parallelImage = GenerateRandomImage(1024, 768, 4, false, 13);
+    neko::GenerateMipChain(serialImage, true, neko::MipFilter::KAISER);
+    neko::PremultiplyAlpha(serialImage);
+
+    //The bands are spread on the workers of a running engine
+    neko::HeadlessEngine engine;
+    engine.Init();
+    neko::GenerateMipChain(parallelImage, true, neko::MipFilter::KAISER);
+    neko::PremultiplyAlpha(parallelImage);
+    engine.Destroy();
+
+    ASSERT_EQ(serialImage.GetByteSize(), parallelImage.GetByteSize());
+    EXPECT_EQ(std::memcmp(serialImage.data, parallelImage.data, serialImage.GetByteSize()), 0);
+}
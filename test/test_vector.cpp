@@ -4,6 +4,7 @@
 
 #include <gtest/gtest.h>
 #include <iostream>
+#include <random>
 
 #include <mathematics/vector_nvec.h>
 
@@ -22,4 +23,119 @@ TEST(Engine, TestVector)
         EXPECT_TRUE(tet-array[0].Magnitude() < 0.01f);
     }
 }
+
+template<int N>
+void CheckNVec3()
+{
+    std::mt19937 g(N);
+    std::uniform_real_distribution<float> dist(-10.0f, 10.0f);
+    std::array<Vec3f, N> a, b, c;
+    for (int i = 0; i < N; i++)
+    {
+        a[i] = Vec3f(dist(g), dist(g), dist(g));
+        b[i] = Vec3f(dist(g), dist(g), dist(g));
+        c[i] = Vec3f(dist(g), dist(g), dist(g));
+    }
+    NVec3<float, N> va(a.data(), N);
+    const NVec3<float, N> vb(b.data(), N);
+    const NVec3<float, N> vc(c.data(), N);
+
+    const auto dot = NVec3<float, N>::DotIntrinsics(va, vb);
+    const auto dotVec = NVec3<float, N>::DotIntrinsics(va, b[0]);
+    const auto magnitude = va.MagnitudeIntrinsics();
+    const auto normalized = va.NormalizedIntrinsics();
+    const auto cross = NVec3<float, N>::CrossIntrinsics(va, vb);
+    const auto min = NVec3<float, N>::MinIntrinsics(va, vb);
+    const auto max = NVec3<float, N>::MaxIntrinsics(va, vb);
+    const auto fma = NVec3<float, N>::MultiplyAddIntrinsics(va, vb, vc);
+    const auto lerp = NVec3<float, N>::LerpIntrinsics(va, vb, 0.25f);
+    const auto reflect = NVec3<float, N>::ReflectIntrinsics(va, vb);
+    std::array<Vec3f, N> unpacked;
+    cross.Store(unpacked.data());
+    for (int i = 0; i < N; i++)
+    {
+        EXPECT_NEAR(dot[i], Vec3f::Dot(a[i], b[i]), 0.01f);
+        EXPECT_NEAR(dotVec[i], Vec3f::Dot(a[i], b[0]), 0.01f);
+        EXPECT_NEAR(magnitude[i], a[i].Magnitude(), 0.01f);
+        EXPECT_LT((normalized.Get(i) - a[i].Normalized()).Magnitude(), 0.01f);
+        EXPECT_LT((unpacked[i] - Vec3f::Cross(a[i], b[i])).Magnitude(), 0.01f);
+        EXPECT_LT((min.Get(i) - Vec3f(std::min(a[i].x, b[i].x), std::min(a[i].y, b[i].y), std::min(a[i].z, b[i].z))).Magnitude(), 0.01f);
+        EXPECT_LT((max.Get(i) - Vec3f(std::max(a[i].x, b[i].x), std::max(a[i].y, b[i].y), std::max(a[i].z, b[i].z))).Magnitude(), 0.01f);
+        EXPECT_LT((fma.Get(i) - Vec3f(a[i].x * b[i].x + c[i].x, a[i].y * b[i].y + c[i].y, a[i].z * b[i].z + c[i].z)).Magnitude(), 0.01f);
+        EXPECT_LT((lerp.Get(i) - Vec3f::Lerp(a[i], b[i], 0.25f)).Magnitude(), 0.01f);
+        EXPECT_LT((reflect.Get(i) - Vec3f::Reflect(a[i], b[i])).Magnitude(), 0.01f);
+    }
+}
+
+template<int N>
+void CheckNVec4()
+{
+    std::mt19937 g(N);
+    std::uniform_real_distribution<float> dist(-10.0f, 10.0f);
+    std::array<Vec4f, N> a, b, c;
+    for (int i = 0; i < N; i++)
+    {
+        a[i] = Vec4f(dist(g), dist(g), dist(g), dist(g));
+        b[i] = Vec4f(dist(g), dist(g), dist(g), dist(g));
+        c[i] = Vec4f(dist(g), dist(g), dist(g), dist(g));
+    }
+    NVec4<float, N> va(a.data(), N);
+    const NVec4<float, N> vb(b.data(), N);
+    const NVec4<float, N> vc(c.data(), N);
+
+    const auto dot = NVec4<float, N>::DotIntrinsics(va, vb);
+    const auto dotVec = NVec4<float, N>::DotIntrinsics(va, b[0]);
+    const auto squareMagnitude = va.SquareMagnitudeIntrinsics();
+    const auto normalized = va.NormalizedIntrinsics();
+    const auto min = NVec4<float, N>::MinIntrinsics(va, vb);
+    const auto max = NVec4<float, N>::MaxIntrinsics(va, vb);
+    const auto fma = NVec4<float, N>::MultiplyAddIntrinsics(va, vb, vc);
+    const auto lerp = NVec4<float, N>::LerpIntrinsics(va, vb, 0.75f);
+    std::array<Vec4f, N> unpacked;
+    lerp.Store(unpacked.data());
+    for (int i = 0; i < N; i++)
+    {
+        EXPECT_NEAR(dot[i], Vec4f::Dot(a[i], b[i]), 0.01f);
+        EXPECT_NEAR(dotVec[i], Vec4f::Dot(a[i], b[0]), 0.01f);
+        EXPECT_NEAR(squareMagnitude[i], a[i].SquareMagnitude(), 0.01f);
+        EXPECT_LT((normalized.Get(i) - a[i] * (1.0f / a[i].Magnitude())).Magnitude(), 0.01f);
+        EXPECT_LT((min.Get(i) - Vec4f(std::min(a[i].x, b[i].x), std::min(a[i].y, b[i].y), std::min(a[i].z, b[i].z), std::min(a[i].w, b[i].w))).Magnitude(), 0.01f);
+        EXPECT_LT((max.Get(i) - Vec4f(std::max(a[i].x, b[i].x), std::max(a[i].y, b[i].y), std::max(a[i].z, b[i].z), std::max(a[i].w, b[i].w))).Magnitude(), 0.01f);
+        EXPECT_LT((fma.Get(i) - Vec4f(a[i].x * b[i].x + c[i].x, a[i].y * b[i].y + c[i].y, a[i].z * b[i].z + c[i].z, a[i].w * b[i].w + c[i].w)).Magnitude(), 0.01f);
+        EXPECT_LT((unpacked[i] - Vec4f::Lerp(a[i], b[i], 0.75f)).Magnitude(), 0.01f);
+    }
+}
+
+TEST(Engine, TestNVec3)
+{
+    CheckNVec3<4>();
+    CheckNVec3<8>();
+    CheckNVec3<16>();
+    //Width without intrinsics goes through the scalar formulas
+    CheckNVec3<2>();
+}
+
+TEST(Engine, TestNVec4)
+{
+    CheckNVec4<4>();
+    CheckNVec4<8>();
+    CheckNVec4<16>();
+    CheckNVec4<2>();
+}
+
+TEST(Engine, TestNVec3PackPartial)
+{
+    const std::array<Vec3f, 3> aos{ Vec3f(1, 2, 3), Vec3f(4, 5, 6), Vec3f(7, 8, 9) };
+    const EightVec3f soa(aos.data(), static_cast<int>(aos.size()));
+    std::array<Vec3f, 3> unpacked;
+    (soa + Vec3f(1, 1, 1)).Store(unpacked.data(), static_cast<int>(unpacked.size()));
+    for (size_t i = 0; i < aos.size(); i++)
+    {
+        EXPECT_LT((unpacked[i] - (aos[i] + Vec3f(1, 1, 1))).Magnitude(), 0.01f);
+    }
+    for (int i = static_cast<int>(aos.size()); i < 8; i++)
+    {
+        EXPECT_FLOAT_EQ(soa.xs[i], 0.0f);
+    }
+}
 }